@@ -0,0 +1,219 @@
+/**
+ *  @file bench_util.c
+ *  @brief Synthetic datasets, timers and report helpers shared by the benchmarks.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <sys/resource.h>
+#include "bench_util.h"
+#include "sz.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+const char* bench_field_names[BENCH_FIELD_NUM] = {"smooth", "noisy", "sparse"};
+
+int bench_field_kind(const char* name)
+{
+	int i;
+	for(i = 0; i < BENCH_FIELD_NUM; i++)
+		if(strcmp(name, bench_field_names[i]) == 0)
+			return i;
+	return -1;
+}
+
+void bench_field_dims(size_t nbEle, int nbDim, size_t dims[4])
+{
+	int i;
+	size_t n = (size_t)floor(pow((double)nbEle, 1.0/nbDim) + 0.5);
+	for(i = 0; i < 4; i++)
+		dims[i] = i < nbDim ? n : 0;
+	if(nbDim == 1)
+		dims[0] = nbEle;
+}
+
+//splitmix64: the same sequence on every platform, unlike rand()
+static uint64_t bench_next(uint64_t* state)
+{
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static double bench_uniform(uint64_t* state)
+{
+	return (bench_next(state) >> 11) * (1.0/9007199254740992.0);
+}
+
+/**
+ * Fill a 1D-4D field in C order. All the kinds share the same smooth component,
+ * so the ratios of the three kinds can be compared with each other.
+ *
+ * @return the field (to be freed by the caller), or NULL if the dimensions are invalid
+ * */
+float* bench_generate_field(int kind, int nbDim, const size_t dims[4], uint64_t seed)
+{
+	size_t i, nbEle = 1, idx[4] = {0, 0, 0, 0};
+	int d;
+	double freq[4] = {1.3, 0.7, 2.1, 0.45}, phase[4];
+	uint64_t state = seed;
+
+	if(nbDim < 1 || nbDim > 4 || kind < 0 || kind >= BENCH_FIELD_NUM)
+		return NULL;
+	for(d = 0; d < nbDim; d++)
+	{
+		if(dims[d] == 0)
+			return NULL;
+		nbEle *= dims[d];
+		phase[d] = 2*M_PI*bench_uniform(&state);
+	}
+
+	float* data = (float*)malloc(nbEle*sizeof(float));
+	if(data == NULL)
+		return NULL;
+	for(i = 0; i < nbEle; i++)
+	{
+		double v = 0, sum = 0;
+		for(d = 0; d < nbDim; d++)
+		{
+			double u = (double)idx[d]/dims[d];
+			v += sin(2*M_PI*freq[d]*u + phase[d]);
+			sum += u;
+		}
+		v += 0.5*cos(2*M_PI*3.1*sum) + 0.25*sin(2*M_PI*7.3*sum + 1);
+		if(kind == BENCH_FIELD_NOISY)
+			v += 0.05*nbDim*(2*bench_uniform(&state) - 1); //the amplitude of the waves grows with nbDim
+		else if(kind == BENCH_FIELD_SPARSE && bench_uniform(&state) < 0.95)
+			v = 0;
+		data[i] = (float)(100*v);
+
+		for(d = nbDim-1; d >= 0; d--) //increase the multi-dimensional index, the last dimension fastest
+		{
+			if(++idx[d] < dims[d])
+				break;
+			idx[d] = 0;
+		}
+	}
+	return data;
+}
+
+double bench_clock()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1E-9;
+}
+
+/**
+ * Restart the peak resident set size accounting, so that the next bench_peak_rss_kb()
+ * covers only the following run (Linux >= 4.0; elsewhere the peak of the whole process is reported).
+ * */
+void bench_reset_peak_rss()
+{
+	FILE* f = fopen("/proc/self/clear_refs", "w");
+	if(f != NULL)
+	{
+		fputs("5", f);
+		fclose(f);
+	}
+}
+
+long bench_peak_rss_kb()
+{
+	char line[256];
+	long kb = -1;
+	FILE* f = fopen("/proc/self/status", "r");
+	if(f != NULL)
+	{
+		while(fgets(line, sizeof(line), f) != NULL)
+			if(strncmp(line, "VmHWM:", 6) == 0)
+			{
+				kb = atol(line + 6);
+				break;
+			}
+		fclose(f);
+	}
+	if(kb < 0)
+	{
+		struct rusage usage;
+		getrusage(RUSAGE_SELF, &usage);
+		kb = usage.ru_maxrss;
+#ifdef __APPLE__
+		kb /= 1024; //bytes on macOS
+#endif
+	}
+	return kb;
+}
+
+void bench_value_range(const float* data, size_t nbEle, float* min, float* max)
+{
+	size_t i;
+	*min = *max = data[0];
+	for(i = 1; i < nbEle; i++)
+	{
+		if(data[i] < *min)
+			*min = data[i];
+		else if(data[i] > *max)
+			*max = data[i];
+	}
+}
+
+double bench_psnr(const float* ori, const float* dec, size_t nbEle, double valueRange, double* maxErr)
+{
+	size_t i;
+	double sum = 0;
+	*maxErr = 0;
+	for(i = 0; i < nbEle; i++)
+	{
+		double err = fabs((double)ori[i] - dec[i]);
+		if(err > *maxErr)
+			*maxErr = err;
+		sum += err*err;
+	}
+	if(sum == 0)
+		return INFINITY;
+	return 20*log10(valueRange) - 10*log10(sum/nbEle);
+}
+
+/**
+ * Split a comma-separated list (e.g., "1,2,4") into at most maxItems items.
+ *
+ * @return the number of items
+ * */
+int bench_parse_list(const char* text, char items[][16], int maxItems)
+{
+	int n = 0;
+	while(*text != '\0' && n < maxItems)
+	{
+		size_t len = strcspn(text, ",");
+		if(len > 0)
+		{
+			if(len > 15)
+				len = 15;
+			memcpy(items[n], text, len);
+			items[n++][len] = '\0';
+		}
+		text += strcspn(text, ",");
+		if(*text == ',')
+			text++;
+	}
+	return n;
+}
+
+void bench_json_begin(FILE* out, const char* tool, uint64_t seed)
+{
+	fprintf(out, "{\n\"tool\": \"%s\",\n\"version\": \"%d.%d.%d.%d\",\n\"seed\": %llu,\n\"results\": [",
+		tool, SZ_VER_MAJOR, SZ_VER_MINOR, SZ_VER_BUILD, SZ_VER_REVISION, (unsigned long long)seed);
+}
+
+void bench_json_end(FILE* out)
+{
+	fprintf(out, "\n]\n}\n");
+}
@@ -0,0 +1,50 @@
+/**
+ *  @file bench_util.h
+ *  @brief Synthetic datasets, timers and report helpers shared by the benchmarks.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _BENCH_UTIL_H
+#define _BENCH_UTIL_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define BENCH_FIELD_SMOOTH 0 //sum of low-frequency waves: the best case of the predictors
+#define BENCH_FIELD_NOISY 1 //the smooth field plus 5% white noise
+#define BENCH_FIELD_SPARSE 2 //95% exact zeros, the rest from the smooth field
+#define BENCH_FIELD_NUM 3
+
+#define BENCH_DEFAULT_SEED 20200101
+
+extern const char* bench_field_names[BENCH_FIELD_NUM];
+
+int bench_field_kind(const char* name);
+
+/*dims[0] is the slowest dimension (r4 ... r1 in the SZ argument order)*/
+void bench_field_dims(size_t nbEle, int nbDim, size_t dims[4]);
+float* bench_generate_field(int kind, int nbDim, const size_t dims[4], uint64_t seed);
+
+double bench_clock();
+void bench_reset_peak_rss();
+long bench_peak_rss_kb();
+
+void bench_value_range(const float* data, size_t nbEle, float* min, float* max);
+double bench_psnr(const float* ori, const float* dec, size_t nbEle, double valueRange, double* maxErr);
+
+int bench_parse_list(const char* text, char items[][16], int maxItems);
+
+void bench_json_begin(FILE* out, const char* tool, uint64_t seed);
+void bench_json_end(FILE* out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _BENCH_UTIL_H  ----- */
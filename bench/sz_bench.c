@@ -0,0 +1,354 @@
+/**
+ *  @file sz_bench.c
+ *  @brief End-to-end benchmark: sweeps synthetic fields, error bounds, compression modes and thread counts,
+ *  and reports throughput, compression ratio, PSNR and peak RSS as JSON.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "sz.h"
+#include "sz_omp.h"
+#include "bench_util.h"
+
+#define BENCH_MAX_ITEMS 16
+
+#define BENCH_MODE_LORENZO 0
+#define BENCH_MODE_REGRESSION 1
+#define BENCH_MODE_PWREL 2
+#define BENCH_MODE_RANDOMACCESS 3
+#define BENCH_MODE_OPENMP 4
+#define BENCH_MODE_NUM 5
+
+static const char* bench_mode_names[BENCH_MODE_NUM] = {"lorenzo", "regression", "pwrel", "ra", "omp"};
+static const char* bench_stage_names[SZ_STAGE_NUM] = {"rangeScan", "intervalOpt", "predictQuant", "huffmanBuild", "encode", "lossless", "serialize"};
+
+static sz_exedata bench_exe; //the execution parameters after SZ_Init(), copied by every run
+
+/*One of the threads that compress (and then decompress) the same field concurrently, each with its own SZ context*/
+typedef struct bench_worker
+{
+	pthread_t thread;
+	const float* data;
+	size_t r[5];
+	const sz_params* params;
+	int repeats;
+	int decompress; //0: compression phase; 1: decompression phase
+	unsigned char* bytes;
+	size_t outSize;
+	float* decData;
+	sz_perf_stats stats;
+} bench_worker;
+
+static void* bench_run_worker(void* arg)
+{
+	bench_worker* w = (bench_worker*)arg;
+	sz_params cpr, dec;
+	sz_exedata exe;
+	int i;
+
+	memcpy(&cpr, w->params, sizeof(sz_params));
+	memcpy(&exe, &bench_exe, sizeof(sz_exedata));
+	memset(&dec, 0, sizeof(sz_params));
+	sz_thread_context ctx = {&cpr, &dec, &exe, &w->stats};
+	sz_thread_context* previous = SZ_bindThreadContext(&ctx);
+
+	for(i = 0; i < w->repeats; i++)
+	{
+		if(w->decompress)
+		{
+			free(w->decData);
+			w->decData = (float*)SZ_decompress(SZ_FLOAT, w->bytes, w->outSize, w->r[4], w->r[3], w->r[2], w->r[1], w->r[0]);
+		}
+		else
+		{
+			free(w->bytes);
+			w->bytes = SZ_compress(SZ_FLOAT, (void*)w->data, &w->outSize, w->r[4], w->r[3], w->r[2], w->r[1], w->r[0]);
+		}
+	}
+
+	SZ_bindThreadContext(previous);
+	return NULL;
+}
+
+/**
+ * Run one phase on all the workers: the first one runs in the calling thread.
+ *
+ * @return the wall time of the phase
+ * */
+static double bench_run_phase(bench_worker* workers, int nbThreads, int decompress)
+{
+	int i;
+	double start = bench_clock();
+	for(i = 0; i < nbThreads; i++)
+	{
+		workers[i].decompress = decompress;
+		if(i > 0)
+			pthread_create(&workers[i].thread, NULL, bench_run_worker, &workers[i]);
+	}
+	bench_run_worker(&workers[0]);
+	for(i = 1; i < nbThreads; i++)
+		pthread_join(workers[i].thread, NULL);
+	return bench_clock() - start;
+}
+
+/**
+ * The OpenMP code path: only 3D fields with absolute error bounds are supported by it.
+ * */
+static int bench_run_openmp(bench_worker* w, int nbThreads, double* compTime, double* decompTime)
+{
+	int i;
+	double start;
+	sz_set_num_threads(nbThreads);
+
+	start = bench_clock();
+	for(i = 0; i < w->repeats; i++)
+	{
+		free(w->bytes);
+		w->bytes = SZ_compress_float_3D_MDQ_openmp((float*)w->data, w->r[2], w->r[1], w->r[0], w->params->absErrBound, &w->outSize);
+	}
+	*compTime = bench_clock() - start;
+	if(w->bytes == NULL)
+		return SZ_NSCS;
+
+	start = bench_clock();
+	for(i = 0; i < w->repeats; i++)
+	{
+		free(w->decData);
+		w->decData = NULL;
+		decompressDataSeries_float_3D_openmp(&w->decData, w->r[2], w->r[1], w->r[0], w->bytes + 1+3+MetaDataByteLength);
+	}
+	*decompTime = bench_clock() - start;
+	return SZ_SCES;
+}
+
+static void usage()
+{
+	printf("Usage: sz_bench [options]\n");
+	printf("Options (lists are comma-separated):\n");
+	printf("	-f <fields> : synthetic fields among smooth,noisy,sparse (default: all)\n");
+	printf("	-d <dims> : dimensionalities among 1,2,3,4 (default: all)\n");
+	printf("	-e <bounds> : error bounds, relative to the value range (default: 1E-2,1E-3,1E-4)\n");
+	printf("	-m <modes> : modes among lorenzo,regression,pwrel,ra,omp (default: all)\n");
+	printf("	-t <threads> : thread counts (default: 1,2,4)\n");
+	printf("	-N <count> : number of elements per field (default: 4194304)\n");
+	printf("	-r <repeats> : compressions and decompressions per measurement (default: 3)\n");
+	printf("	-s <seed> : seed of the synthetic fields (default: %d)\n", BENCH_DEFAULT_SEED);
+	printf("	-c <config> : SZ configuration file providing the other parameters\n");
+	printf("	-o <file> : JSON output file, - for stdout (default: sz_bench.json)\n");
+	printf("* modes:\n");
+	printf("	lorenzo, regression : REL error bound without/with the linear regression predictor\n");
+	printf("	pwrel : point-wise relative error bound\n");
+	printf("	ra : random access (needs a library built with BUILD_RANDOMACCESS)\n");
+	printf("	omp : the OpenMP code path (3D fields only; -t sets the number of OpenMP threads)\n");
+	printf("	With the other modes, -t is the number of concurrent compressions of the field, each with its own context.\n");
+	printf("* example: sz_bench -f smooth -d 3 -e 1E-3 -m lorenzo,omp -t 1,4 -o bench.json\n");
+	exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+	char fields[BENCH_MAX_ITEMS][16], dims[BENCH_MAX_ITEMS][16], bounds[BENCH_MAX_ITEMS][16], modes[BENCH_MAX_ITEMS][16], threads[BENCH_MAX_ITEMS][16];
+	int nbFields = bench_parse_list("smooth,noisy,sparse", fields, BENCH_MAX_ITEMS);
+	int nbDims = bench_parse_list("1,2,3,4", dims, BENCH_MAX_ITEMS);
+	int nbBounds = bench_parse_list("1E-2,1E-3,1E-4", bounds, BENCH_MAX_ITEMS);
+	int nbModes = bench_parse_list("lorenzo,regression,pwrel,ra,omp", modes, BENCH_MAX_ITEMS);
+	int nbThreadCounts = bench_parse_list("1,2,4", threads, BENCH_MAX_ITEMS);
+	size_t nbEle = 4194304;
+	int repeats = 3;
+	uint64_t seed = BENCH_DEFAULT_SEED;
+	char* conPath = NULL;
+	char* outPath = "sz_bench.json";
+	int i, f, d, e, m, t, k, first = 1;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] != '-' || argv[i][2] || i+1 >= argc)
+			usage();
+		switch(argv[i][1])
+		{
+		case 'f': nbFields = bench_parse_list(argv[++i], fields, BENCH_MAX_ITEMS); break;
+		case 'd': nbDims = bench_parse_list(argv[++i], dims, BENCH_MAX_ITEMS); break;
+		case 'e': nbBounds = bench_parse_list(argv[++i], bounds, BENCH_MAX_ITEMS); break;
+		case 'm': nbModes = bench_parse_list(argv[++i], modes, BENCH_MAX_ITEMS); break;
+		case 't': nbThreadCounts = bench_parse_list(argv[++i], threads, BENCH_MAX_ITEMS); break;
+		case 'N': nbEle = strtoull(argv[++i], NULL, 10); break;
+		case 'r': repeats = atoi(argv[++i]); break;
+		case 's': seed = strtoull(argv[++i], NULL, 10); break;
+		case 'c': conPath = argv[++i]; break;
+		case 'o': outPath = argv[++i]; break;
+		default: usage();
+		}
+	}
+	if(nbEle < 64 || repeats < 1)
+		usage();
+
+	if(SZ_Init(conPath) == SZ_NSCS)
+	{
+		printf("Error: cannot initialize SZ with the configuration file %s\n", conPath);
+		exit(0);
+	}
+	memcpy(&bench_exe, exe_params, sizeof(sz_exedata));
+
+	FILE* out = strcmp(outPath, "-") == 0 ? stdout : fopen(outPath, "w");
+	if(out == NULL)
+	{
+		printf("Error: cannot write %s\n", outPath);
+		exit(0);
+	}
+	bench_json_begin(out, "sz_bench", seed);
+
+	for(f = 0; f < nbFields; f++)
+	for(d = 0; d < nbDims; d++)
+	{
+		int kind = bench_field_kind(fields[f]);
+		int nbDim = atoi(dims[d]);
+		size_t dim[4];
+		if(kind < 0 || nbDim < 1 || nbDim > 4)
+		{
+			fprintf(stderr, "Warning: skipping the unknown field %s (%s D)\n", fields[f], dims[d]);
+			continue;
+		}
+		bench_field_dims(nbEle, nbDim, dim);
+		float* data = bench_generate_field(kind, nbDim, dim, seed);
+		if(data == NULL)
+		{
+			printf("Error: cannot generate the %s field\n", fields[f]);
+			exit(0);
+		}
+
+		size_t r[5] = {0, 0, 0, 0, 0}, n = 1; //r1 (fastest) ... r5
+		for(k = 0; k < nbDim; k++)
+		{
+			r[k] = dim[nbDim-1-k];
+			n *= r[k];
+		}
+		float min, max;
+		bench_value_range(data, n, &min, &max);
+		double valueRange = max - min;
+
+		for(e = 0; e < nbBounds; e++)
+		for(m = 0; m < nbModes; m++)
+		for(t = 0; t < nbThreadCounts; t++)
+		{
+			double errBound = atof(bounds[e]);
+			int nbThreads = atoi(threads[t]);
+			int mode;
+			for(mode = 0; mode < BENCH_MODE_NUM; mode++)
+				if(strcmp(modes[m], bench_mode_names[mode]) == 0)
+					break;
+			if(mode == BENCH_MODE_NUM || nbThreads < 1)
+			{
+				fprintf(stderr, "Warning: skipping the unknown mode %s (%s threads)\n", modes[m], threads[t]);
+				continue;
+			}
+#ifndef HAVE_RANDOMACCESS
+			if(mode == BENCH_MODE_RANDOMACCESS)
+			{
+				fprintf(stderr, "Warning: skipping mode ra, the library is built without BUILD_RANDOMACCESS\n");
+				continue;
+			}
+#endif
+			if(mode == BENCH_MODE_OPENMP && nbDim != 3)
+				continue;
+
+			sz_params params;
+			memcpy(&params, confparams_cpr, sizeof(sz_params));
+			params.errorBoundMode = REL;
+			params.relBoundRatio = errBound;
+			params.randomAccess = 0;
+			if(mode == BENCH_MODE_LORENZO)
+				params.withRegression = SZ_NO_REGRESSION;
+			else if(mode == BENCH_MODE_REGRESSION)
+				params.withRegression = SZ_WITH_LINEAR_REGRESSION;
+			else if(mode == BENCH_MODE_PWREL)
+			{
+				params.errorBoundMode = PW_REL;
+				params.pw_relBoundRatio = errBound;
+			}
+			else if(mode == BENCH_MODE_RANDOMACCESS)
+				params.randomAccess = 1;
+			else if(mode == BENCH_MODE_OPENMP)
+			{
+				params.errorBoundMode = ABS;
+				params.absErrBound = errBound*valueRange;
+			}
+
+			bench_worker* workers = (bench_worker*)calloc(nbThreads, sizeof(bench_worker));
+			for(k = 0; k < nbThreads; k++)
+			{
+				workers[k].data = data;
+				memcpy(workers[k].r, r, sizeof(r));
+				workers[k].params = &params;
+				workers[k].repeats = repeats;
+			}
+
+			double compTime = 0, decompTime = 0;
+			int status = SZ_SCES;
+			bench_reset_peak_rss();
+			if(mode == BENCH_MODE_OPENMP)
+			{
+				sz_params* global = confparams_cpr;
+				confparams_cpr = &params; //the OpenMP code path reads (and updates) the global parameters
+				status = bench_run_openmp(&workers[0], nbThreads, &compTime, &decompTime);
+				confparams_cpr = global;
+				memcpy(exe_params, &bench_exe, sizeof(sz_exedata));
+			}
+			else
+			{
+				compTime = bench_run_phase(workers, nbThreads, 0);
+				for(k = 0; k < nbThreads && status == SZ_SCES; k++)
+					if(workers[k].bytes == NULL)
+						status = SZ_NSCS;
+				if(status == SZ_SCES)
+					decompTime = bench_run_phase(workers, nbThreads, 1);
+			}
+			long peakRSS = bench_peak_rss_kb();
+			if(status == SZ_SCES && workers[0].decData == NULL)
+				status = SZ_NSCS;
+
+			size_t totalBytes = n*sizeof(float)*repeats*(mode == BENCH_MODE_OPENMP ? 1 : nbThreads);
+			fprintf(out, "%s\n{\"field\": \"%s\", \"dims\": [", first ? "" : ",", fields[f]);
+			for(k = 0; k < nbDim; k++)
+				fprintf(out, "%s%zu", k == 0 ? "" : ", ", dim[k]);
+			fprintf(out, "], \"mode\": \"%s\", \"errorBound\": %g, \"threads\": %d, \"repeats\": %d, \"status\": \"%s\"",
+				bench_mode_names[mode], errBound, nbThreads, repeats, status == SZ_SCES ? "ok" : "failed");
+			if(status == SZ_SCES)
+			{
+				double maxErr;
+				double psnr = bench_psnr(data, workers[0].decData, n, valueRange, &maxErr);
+				fprintf(out, ", \"compressMBps\": %.3f, \"decompressMBps\": %.3f, \"ratio\": %.4f, \"psnr\": %.3f, \"maxError\": %g",
+					totalBytes/compTime/1E6, totalBytes/decompTime/1E6, (double)n*sizeof(float)/workers[0].outSize,
+					isinf(psnr) ? 999.0 : psnr, maxErr);
+				if(workers[0].stats.totalTime > 0)
+				{
+					fprintf(out, ", \"stageSeconds\": {");
+					for(k = 0; k < SZ_STAGE_NUM; k++)
+						fprintf(out, "%s\"%s\": %.6f", k == 0 ? "" : ", ", bench_stage_names[k], workers[0].stats.stage[k].time);
+					fprintf(out, "}");
+				}
+			}
+			fprintf(out, ", \"peakRSSKB\": %ld}", peakRSS);
+			fflush(out);
+			first = 0;
+
+			for(k = 0; k < nbThreads; k++)
+			{
+				free(workers[k].bytes);
+				free(workers[k].decData);
+			}
+			free(workers);
+		}
+		free(data);
+	}
+
+	bench_json_end(out);
+	if(out != stdout)
+		fclose(out);
+	SZ_Finalize();
+	return 0;
+}
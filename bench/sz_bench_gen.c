@@ -0,0 +1,76 @@
+/**
+ *  @file sz_bench_gen.c
+ *  @brief Writes the synthetic fields of the benchmarks as raw binary files, so that they can be
+ *  used with the command-line tools (e.g., sz -z -f -i <file> -3 <dims>).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sz.h"
+#include "rw.h"
+#include "bench_util.h"
+
+static void usage()
+{
+	printf("Usage: sz_bench_gen -f <field> -d <dims> -N <count> [-s <seed>] -o <file>\n");
+	printf("	-f <field> : smooth, noisy or sparse\n");
+	printf("	-d <dims> : number of dimensions (1-4)\n");
+	printf("	-N <count> : approximate number of elements (rounded to a hypercube)\n");
+	printf("	-s <seed> : seed of the field (default: %d)\n", BENCH_DEFAULT_SEED);
+	printf("	-o <file> : output file (single precision, native byte order)\n");
+	exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+	char* fieldName = NULL;
+	char* outPath = NULL;
+	int nbDim = 0, i, status = SZ_SCES;
+	size_t nbEle = 0, dims[4];
+	uint64_t seed = BENCH_DEFAULT_SEED;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] != '-' || argv[i][2] || i+1 >= argc)
+			usage();
+		switch(argv[i][1])
+		{
+		case 'f': fieldName = argv[++i]; break;
+		case 'd': nbDim = atoi(argv[++i]); break;
+		case 'N': nbEle = strtoull(argv[++i], NULL, 10); break;
+		case 's': seed = strtoull(argv[++i], NULL, 10); break;
+		case 'o': outPath = argv[++i]; break;
+		default: usage();
+		}
+	}
+	if(fieldName == NULL || outPath == NULL || bench_field_kind(fieldName) < 0 || nbDim < 1 || nbDim > 4 || nbEle == 0)
+		usage();
+
+	bench_field_dims(nbEle, nbDim, dims);
+	float* data = bench_generate_field(bench_field_kind(fieldName), nbDim, dims, seed);
+	if(data == NULL)
+	{
+		printf("Error: cannot generate the %s field\n", fieldName);
+		exit(0);
+	}
+	nbEle = 1;
+	for(i = 0; i < nbDim; i++)
+		nbEle *= dims[i];
+	writeFloatData_inBytes(data, nbEle, outPath, &status);
+	free(data);
+	if(status != SZ_SCES)
+	{
+		printf("Error: cannot write %s\n", outPath);
+		exit(0);
+	}
+
+	//the dimensions in the order of the command-line tools (fastest first)
+	printf("%s:", outPath);
+	for(i = nbDim-1; i >= 0; i--)
+		printf(" %zu", dims[i]);
+	printf("\n");
+	return 0;
+}
@@ -0,0 +1,223 @@
+/**
+ *  @file sz_kernel_bench.c
+ *  @brief Kernel-level benchmark of the hot paths of the compressor: interval optimization,
+ *  Huffman encoding/decoding and the lossless stage, reported as JSON.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sz.h"
+#include "bench_util.h"
+
+typedef struct bench_kernel_result
+{
+	double bestTime;
+	size_t bytesIn;
+	size_t bytesOut;
+} bench_kernel_result;
+
+static int first = 1;
+
+/*The throughput is given on the uncompressed side of the kernel*/
+static void bench_report(FILE* out, const char* kernel, const char* field, const bench_kernel_result* res, int repeats)
+{
+	size_t bytes = res->bytesIn > res->bytesOut ? res->bytesIn : res->bytesOut;
+	fprintf(out, "%s\n{\"kernel\": \"%s\", \"field\": \"%s\", \"repeats\": %d, \"bytesIn\": %zu, \"bytesOut\": %zu, \"seconds\": %.6f, \"MBps\": %.3f}",
+		first ? "" : ",", kernel, field, repeats, res->bytesIn, res->bytesOut, res->bestTime, bytes/res->bestTime/1E6);
+	fflush(out);
+	first = 0;
+}
+
+static void bench_update(bench_kernel_result* res, double start)
+{
+	double t = bench_clock() - start;
+	if(res->bestTime == 0 || t < res->bestTime)
+		res->bestTime = t;
+}
+
+/**
+ * Quantize the field with the 1D Lorenzo predictor on the decompressed values, as the compressors do,
+ * so that the Huffman and lossless kernels see a realistic distribution of codes.
+ * */
+static int* bench_quantize(const float* data, size_t nbEle, double realPrecision, int radius)
+{
+	size_t i;
+	int* codes = (int*)malloc(nbEle*sizeof(int));
+	float pred = data[0];
+	codes[0] = 0;
+	for(i = 1; i < nbEle; i++)
+	{
+		double diff = data[i] - pred;
+		double itvNum = fabs(diff)/realPrecision + 1;
+		if(itvNum < 2*radius)
+		{
+			if(diff < 0)
+				itvNum = -itvNum;
+			codes[i] = (int)(itvNum/2) + radius;
+			pred = pred + 2*(codes[i] - radius)*realPrecision;
+		}
+		else
+		{
+			codes[i] = 0;
+			pred = data[i];
+		}
+	}
+	return codes;
+}
+
+static void usage()
+{
+	printf("Usage: sz_kernel_bench [options]\n");
+	printf("Options:\n");
+	printf("	-f <field> : smooth, noisy or sparse (default: smooth)\n");
+	printf("	-N <count> : number of elements of the 3D field (default: 4194304)\n");
+	printf("	-e <bound> : error bound, relative to the value range (default: 1E-4)\n");
+	printf("	-r <repeats> : runs per kernel, the best one is reported (default: 5)\n");
+	printf("	-s <seed> : seed of the synthetic field (default: %d)\n", BENCH_DEFAULT_SEED);
+	printf("	-o <file> : JSON output file, - for stdout (default: sz_kernel_bench.json)\n");
+	exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+	char* fieldName = "smooth";
+	size_t nbEle = 4194304;
+	double errBound = 1E-4;
+	int repeats = 5;
+	uint64_t seed = BENCH_DEFAULT_SEED;
+	char* outPath = "sz_kernel_bench.json";
+	int i;
+
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] != '-' || argv[i][2] || i+1 >= argc)
+			usage();
+		switch(argv[i][1])
+		{
+		case 'f': fieldName = argv[++i]; break;
+		case 'N': nbEle = strtoull(argv[++i], NULL, 10); break;
+		case 'e': errBound = atof(argv[++i]); break;
+		case 'r': repeats = atoi(argv[++i]); break;
+		case 's': seed = strtoull(argv[++i], NULL, 10); break;
+		case 'o': outPath = argv[++i]; break;
+		default: usage();
+		}
+	}
+	int kind = bench_field_kind(fieldName);
+	if(kind < 0 || nbEle < 64 || repeats < 1)
+		usage();
+
+	SZ_Init(NULL);
+	size_t dims[4];
+	bench_field_dims(nbEle, 3, dims);
+	nbEle = dims[0]*dims[1]*dims[2];
+	float* data = bench_generate_field(kind, 3, dims, seed);
+	float min, max;
+	bench_value_range(data, nbEle, &min, &max);
+	double realPrecision = errBound*(max - min);
+
+	FILE* out = strcmp(outPath, "-") == 0 ? stdout : fopen(outPath, "w");
+	if(out == NULL)
+	{
+		printf("Error: cannot write %s\n", outPath);
+		exit(0);
+	}
+	bench_json_begin(out, "sz_kernel_bench", seed);
+
+	//interval optimization
+	bench_kernel_result res = {0, nbEle*sizeof(float), 0};
+	unsigned int intervals = 0;
+	for(i = 0; i < repeats; i++)
+	{
+		double start = bench_clock();
+		intervals = optimize_intervals_float_3D(data, dims[0], dims[1], dims[2], realPrecision);
+		bench_update(&res, start);
+	}
+	bench_report(out, "optimize_intervals_float_3D", fieldName, &res, repeats);
+
+	//Huffman coding of the quantization codes (tree construction included)
+	int* codes = bench_quantize(data, nbEle, realPrecision, intervals/2);
+	unsigned char* huffBytes = NULL;
+	size_t huffSize = 0;
+	memset(&res, 0, sizeof(res));
+	res.bytesIn = nbEle*sizeof(int);
+	for(i = 0; i < repeats; i++)
+	{
+		free(huffBytes);
+		double start = bench_clock();
+		HuffmanTree* huffmanTree = createHuffmanTree(intervals*2);
+		encode_withTree(huffmanTree, codes, nbEle, &huffBytes, &huffSize);
+		SZ_ReleaseHuffman(huffmanTree);
+		bench_update(&res, start);
+	}
+	res.bytesOut = huffSize;
+	bench_report(out, "huffman_encode", fieldName, &res, repeats);
+
+	int* decodes = (int*)malloc(nbEle*sizeof(int));
+	memset(&res, 0, sizeof(res));
+	res.bytesIn = huffSize;
+	res.bytesOut = nbEle*sizeof(int);
+	for(i = 0; i < repeats; i++)
+	{
+		double start = bench_clock();
+		HuffmanTree* huffmanTree = createHuffmanTree(intervals*2);
+		decode_withTree(huffmanTree, huffBytes, nbEle, decodes);
+		SZ_ReleaseHuffman(huffmanTree);
+		bench_update(&res, start);
+	}
+	if(memcmp(codes, decodes, nbEle*sizeof(int)) != 0)
+		fprintf(stderr, "Error: the Huffman decoding does not match the input\n");
+	bench_report(out, "huffman_decode", fieldName, &res, repeats);
+
+	//lossless stage on the Huffman output, as in the compressors
+	int compressors[2] = {ZSTD_COMPRESSOR, GZIP_COMPRESSOR};
+	const char* names[2][2] = {{"zstd_compress", "zstd_decompress"}, {"gzip_compress", "gzip_decompress"}};
+	int c;
+	for(c = 0; c < 2; c++)
+	{
+		unsigned char* cmpBytes = NULL;
+		unsigned char* decBytes = NULL;
+		unsigned long cmpSize = 0;
+		memset(&res, 0, sizeof(res));
+		res.bytesIn = huffSize;
+		for(i = 0; i < repeats; i++)
+		{
+			free(cmpBytes);
+			double start = bench_clock();
+			cmpSize = sz_lossless_compress(compressors[c], confparams_cpr->gzipMode, huffBytes, huffSize, &cmpBytes);
+			bench_update(&res, start);
+		}
+		res.bytesOut = cmpSize;
+		bench_report(out, names[c][0], fieldName, &res, repeats);
+
+		memset(&res, 0, sizeof(res));
+		res.bytesIn = cmpSize;
+		res.bytesOut = huffSize;
+		for(i = 0; i < repeats; i++)
+		{
+			free(decBytes);
+			double start = bench_clock();
+			sz_lossless_decompress(compressors[c], cmpBytes, cmpSize, &decBytes, huffSize);
+			bench_update(&res, start);
+		}
+		if(memcmp(decBytes, huffBytes, huffSize) != 0)
+			fprintf(stderr, "Error: %s does not match the input\n", names[c][1]);
+		bench_report(out, names[c][1], fieldName, &res, repeats);
+		free(cmpBytes);
+		free(decBytes);
+	}
+
+	bench_json_end(out);
+	if(out != stdout)
+		fclose(out);
+	free(decodes);
+	free(codes);
+	free(huffBytes);
+	free(data);
+	SZ_Finalize();
+	return 0;
+}
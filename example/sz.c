@@ -52,11 +52,14 @@ void usage()
 	printf("		PSNR (peak signal-to-noise ratio)\n");
 	printf("		NORM (norm2 error : sqrt(sum(xi-xi')^2)\n"); 
 	printf("		PW_REL (point-wise relative error bound)\n");
+	printf("		FIXED_RATIO (error bound searched for a compression ratio or a bit rate)\n");
 	printf("	-A <absolute error bound>: specifying absolute error bound\n");
 	printf("	-R <value_range based relative error bound>: specifying relative error bound\n");
 	printf("	-P <point-wise relative error bound>: specifying point-wise relative error bound\n");
 	printf("	-S <PSNR>: specifying PSNR\n");
 	printf("	-N <normErr>: specifying normErr\n");
+	printf("	-F <ratio>: specifying the target compression ratio (FIXED_RATIO)\n");
+	printf("	-B <bits per value>: specifying the target bit rate (FIXED_RATIO)\n");
 	printf("* input data file:\n");
 	printf("	-i <original data file> : original data file\n");
 	printf("	-s <compressed data file> : compressed data file in decompression\n");
@@ -108,6 +111,8 @@ int main(int argc, char* argv[])
 	char* pwrErrorBound = NULL;
 	char* psnr_ = NULL;
 	char* normError = NULL;
+	char* fixedRatio = NULL;
+	char* fixedBitRate = NULL;
 	
 	size_t r5 = 0;
 	size_t r4 = 0;
@@ -248,6 +253,16 @@ int main(int argc, char* argv[])
 				usage();
 			psnr_ = argv[i];
 			break;
+		case 'F':
+			if (++i == argc)
+				usage();
+			fixedRatio = argv[i];
+			break;
+		case 'B':
+			if (++i == argc)
+				usage();
+			fixedBitRate = argv[i];
+			break;
 		default: 
 			usage();
 			break;
@@ -307,6 +322,8 @@ int main(int argc, char* argv[])
 			errorBoundMode = PW_REL;
 		else if(strcmp(errBoundMode, "NORM")==0)
 			errorBoundMode = NORM;
+		else if(strcmp(errBoundMode, "FIXED_RATIO")==0)
+			errorBoundMode = FIXED_RATIO;
 		else
 		{
 			printf("Error: wrong error bound mode setting by using the option '-M'\n");
@@ -336,6 +353,15 @@ int main(int argc, char* argv[])
 		if(normError != NULL)
 			confparams_cpr->normErr = atof(normError);
 
+		if(fixedRatio != NULL)
+			confparams_cpr->fixedRatio = atof(fixedRatio);
+
+		if(fixedBitRate != NULL)
+		{
+			confparams_cpr->fixedRatio = 0;
+			confparams_cpr->fixedBitRate = atof(fixedBitRate);
+		}
+
 		size_t outSize;	
 		if(dataType == 0) //single precision
 		{
@@ -0,0 +1,547 @@
+/**
+ *  @file sz_batch.c
+ *  @brief Batch compression/decompression of many files (or of the files of directories) by a pool of threads.
+ *  The files are read, compressed and written in a pipeline: the main thread reads the inputs, the workers
+ *  (de)compress them, each with its own SZ context, and a writer thread stores the results, so that the I/O
+ *  of some files overlaps the compression of others. The bytes held by the pipeline are bounded (-m).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "sz.h"
+#include "rw.h"
+
+#define BATCH_PATH_LENGTH 1024
+#define BATCH_DEFAULT_MEMORY 1024 //MB held by the pipeline (input and output buffers)
+
+/*One file going through the pipeline*/
+typedef struct batch_job
+{
+	char inPath[BATCH_PATH_LENGTH];
+	char outPath[BATCH_PATH_LENGTH];
+	void* data; //the original data (read for the compression, produced by the decompression)
+	size_t nbEle;
+	unsigned char* bytes; //the compressed bytes
+	size_t byteLength;
+	size_t footprint; //bytes reserved in the memory budget until the job is written
+	double time; //(de)compression time
+	int status;
+	struct batch_job* next;
+} batch_job;
+
+typedef struct batch_queue
+{
+	batch_job* head;
+	batch_job* tail;
+} batch_queue;
+
+/*The state shared by the reader (main thread), the workers and the writer*/
+typedef struct batch_pipeline
+{
+	pthread_mutex_t lock;
+	pthread_cond_t workReady; //a job was read
+	pthread_cond_t writeReady; //a job was (de)compressed
+	pthread_cond_t spaceFree; //a job was written and its memory released
+	batch_queue work;
+	batch_queue write;
+	int readDone; //all the jobs were read
+	int nbRead;
+	int nbWritten;
+	size_t inFlight; //bytes reserved by the jobs not written yet
+	size_t memLimit;
+
+	int isCompression;
+	int dataType;
+	size_t r[5]; //r5, r4, r3, r2, r1; all 0 to compress every file as 1D data
+	char* outDir;
+	int verbose;
+	sz_params* params;
+	sz_exedata* exe;
+
+	//aggregate results (updated by the writer)
+	int nbFailed;
+	size_t rawBytes;
+	size_t cmpBytes;
+	double workTime;
+} batch_pipeline;
+
+static void batch_push(batch_queue* q, batch_job* job)
+{
+	job->next = NULL;
+	if(q->tail == NULL)
+		q->head = job;
+	else
+		q->tail->next = job;
+	q->tail = job;
+}
+
+static batch_job* batch_pop(batch_queue* q)
+{
+	batch_job* job = q->head;
+	if(job != NULL)
+	{
+		q->head = job->next;
+		if(q->head == NULL)
+			q->tail = NULL;
+	}
+	return job;
+}
+
+static size_t batch_type_size(int dataType)
+{
+	return dataType == SZ_FLOAT ? sizeof(float) : sizeof(double);
+}
+
+static void* batch_run_worker(void* arg)
+{
+	batch_pipeline* p = (batch_pipeline*)arg;
+	sz_params cpr, dec;
+	sz_exedata exe;
+
+	memcpy(&cpr, p->params, sizeof(sz_params));
+	memcpy(&exe, p->exe, sizeof(sz_exedata));
+	memset(&dec, 0, sizeof(sz_params));
+	sz_thread_context ctx = {&cpr, &dec, &exe};
+	sz_thread_context* previous = SZ_bindThreadContext(&ctx);
+
+	while(1)
+	{
+		pthread_mutex_lock(&p->lock);
+		while(p->work.head == NULL && !p->readDone)
+			pthread_cond_wait(&p->workReady, &p->lock);
+		batch_job* job = batch_pop(&p->work);
+		pthread_mutex_unlock(&p->lock);
+		if(job == NULL)
+			break;
+
+		double start = sz_stats_clock();
+		if(p->isCompression)
+		{
+			size_t r1 = p->r[0]+p->r[1]+p->r[2]+p->r[3]+p->r[4] == 0 ? job->nbEle : p->r[4];
+			job->bytes = SZ_compress(p->dataType, job->data, &job->byteLength, p->r[0], p->r[1], p->r[2], p->r[3], r1);
+			free(job->data);
+			job->data = NULL;
+		}
+		else
+		{
+			job->data = SZ_decompress(p->dataType, job->bytes, job->byteLength, p->r[0], p->r[1], p->r[2], p->r[3], p->r[4]);
+			free(job->bytes);
+			job->bytes = NULL;
+		}
+		job->time = sz_stats_clock() - start;
+		if(job->bytes == NULL && job->data == NULL)
+		{
+			printf("Error: %s cannot be %s!\n", job->inPath, p->isCompression ? "compressed" : "decompressed");
+			job->status = SZ_NSCS;
+		}
+
+		pthread_mutex_lock(&p->lock);
+		batch_push(&p->write, job);
+		pthread_cond_signal(&p->writeReady);
+		pthread_mutex_unlock(&p->lock);
+	}
+
+	SZ_bindThreadContext(previous);
+	return NULL;
+}
+
+static void* batch_run_writer(void* arg)
+{
+	batch_pipeline* p = (batch_pipeline*)arg;
+	while(1)
+	{
+		pthread_mutex_lock(&p->lock);
+		while(p->write.head == NULL && !(p->readDone && p->nbWritten == p->nbRead))
+			pthread_cond_wait(&p->writeReady, &p->lock);
+		batch_job* job = batch_pop(&p->write);
+		pthread_mutex_unlock(&p->lock);
+		if(job == NULL)
+			break;
+
+		if(job->status == SZ_SCES)
+		{
+			if(p->isCompression)
+				writeByteData(job->bytes, job->byteLength, job->outPath, &job->status);
+			else if(p->dataType == SZ_FLOAT)
+				writeFloatData_inBytes((float*)job->data, job->nbEle, job->outPath, &job->status);
+			else
+				writeDoubleData_inBytes((double*)job->data, job->nbEle, job->outPath, &job->status);
+			if(job->status != SZ_SCES)
+				printf("Error: %s cannot be written!\n", job->outPath);
+		}
+
+		pthread_mutex_lock(&p->lock);
+		if(job->status == SZ_SCES)
+		{
+			size_t rawSize = job->nbEle*batch_type_size(p->dataType);
+			p->rawBytes += rawSize;
+			p->cmpBytes += job->byteLength;
+			p->workTime += job->time;
+			if(p->verbose)
+				printf("%s -> %s: ratio %.3f, %.3f MB/s\n", job->inPath, job->outPath, (double)rawSize/job->byteLength, rawSize/job->time/1E6);
+		}
+		else
+			p->nbFailed++;
+		p->nbWritten++;
+		p->inFlight -= job->footprint;
+		pthread_cond_signal(&p->spaceFree);
+		pthread_mutex_unlock(&p->lock);
+
+		free(job->data);
+		free(job->bytes);
+		free(job);
+	}
+	return NULL;
+}
+
+/**
+ * Read one input file, once the memory budget has room for it (a file larger than the whole budget
+ * is processed alone), and hand it to the workers.
+ * */
+static void batch_read(batch_pipeline* p, char* path)
+{
+	int status = SZ_SCES;
+	size_t fileSize = checkFileSize(path, &status);
+	size_t typeSize = batch_type_size(p->dataType);
+	size_t nbEle = computeDataLength(p->r[0], p->r[1], p->r[2], p->r[3], p->r[4]);
+	batch_job* job = (batch_job*)calloc(1, sizeof(batch_job));
+	job->status = status;
+	snprintf(job->inPath, BATCH_PATH_LENGTH, "%s", path);
+	if(p->outDir == NULL)
+		snprintf(job->outPath, BATCH_PATH_LENGTH, "%s%s", path, p->isCompression ? ".sz" : ".out");
+	else
+	{
+		char* name = strrchr(path, '/');
+		snprintf(job->outPath, BATCH_PATH_LENGTH, "%s/%s%s", p->outDir, name == NULL ? path : name+1, p->isCompression ? ".sz" : ".out");
+	}
+	//the compressed bytes take at most about the size of the original data
+	job->footprint = status != SZ_SCES ? 0 : (p->isCompression ? 2*fileSize : fileSize + nbEle*typeSize);
+
+	pthread_mutex_lock(&p->lock);
+	while(p->inFlight > 0 && p->inFlight + job->footprint > p->memLimit)
+		pthread_cond_wait(&p->spaceFree, &p->lock);
+	p->inFlight += job->footprint;
+	p->nbRead++;
+	pthread_mutex_unlock(&p->lock);
+
+	if(job->status == SZ_SCES)
+	{
+		if(!p->isCompression)
+		{
+			job->bytes = readByteData(path, &job->byteLength, &job->status);
+			job->nbEle = nbEle;
+		}
+		else if(p->dataType == SZ_FLOAT)
+			job->data = readFloatData(path, &job->nbEle, &job->status);
+		else
+			job->data = readDoubleData(path, &job->nbEle, &job->status);
+	}
+	if(job->status != SZ_SCES)
+		printf("Error: %s cannot be read!\n", path);
+	else if(nbEle != 0 && job->nbEle != nbEle)
+	{
+		printf("Error: %s has %zu values, the dimensions give %zu\n", path, job->nbEle, nbEle);
+		job->status = SZ_NSCS;
+	}
+	pthread_mutex_lock(&p->lock);
+	if(job->status == SZ_SCES)
+	{
+		batch_push(&p->work, job);
+		pthread_cond_signal(&p->workReady);
+	}
+	else
+	{
+		batch_push(&p->write, job); //reported and released by the writer
+		pthread_cond_signal(&p->writeReady);
+	}
+	pthread_mutex_unlock(&p->lock);
+}
+
+static int batch_compare_paths(const void* a, const void* b)
+{
+	return strcmp(*(char* const*)a, *(char* const*)b);
+}
+
+/**
+ * Process the regular files of a directory (not recursively), in the order of their names.
+ * The compressed files (*.sz) are the inputs of the decompression and are skipped by the compression.
+ * */
+static void batch_read_directory(batch_pipeline* p, char* dirPath)
+{
+	DIR* dir = opendir(dirPath);
+	struct dirent* entry;
+	struct stat st;
+	char** paths = NULL;
+	size_t i, count = 0, capacity = 0;
+	if(dir == NULL)
+	{
+		printf("Error: cannot open the directory %s\n", dirPath);
+		return;
+	}
+	while((entry = readdir(dir)) != NULL)
+	{
+		size_t len = strlen(entry->d_name);
+		int isCmp = len > 3 && strcmp(entry->d_name+len-3, ".sz") == 0;
+		if(entry->d_name[0] == '.' || isCmp != !p->isCompression)
+			continue;
+		char* path = (char*)malloc(strlen(dirPath)+len+2);
+		sprintf(path, "%s/%s", dirPath, entry->d_name);
+		if(stat(path, &st) != 0 || !S_ISREG(st.st_mode))
+		{
+			free(path);
+			continue;
+		}
+		if(count == capacity)
+		{
+			capacity = capacity == 0 ? 64 : 2*capacity;
+			paths = (char**)realloc(paths, capacity*sizeof(char*));
+		}
+		paths[count++] = path;
+	}
+	closedir(dir);
+
+	qsort(paths, count, sizeof(char*), batch_compare_paths);
+	for(i = 0; i < count; i++)
+	{
+		batch_read(p, paths[i]);
+		free(paths[i]);
+	}
+	free(paths);
+}
+
+static void usage()
+{
+	printf("Usage: sz-batch <options> <files or directories>\n");
+	printf("Options:\n");
+	printf("* operation type:\n");
+	printf("	-z : compression (<file>.sz is written for every input file)\n");
+	printf("	-x : decompression (<file>.out is written for every input file; the *.sz files of the directories)\n");
+	printf("	-h: print the help information\n");
+	printf("* data type:\n");
+	printf("	-f: single precision (float type)\n");
+	printf("	-d: double precision (double type)\n");
+	printf("* configuration file: \n");
+	printf("	-c <configuration file> : configuration file sz.config\n");
+	printf("* error control: (the error control parameters here will overwrite the setting in sz.config)\n");
+	printf("	-M <error bound mode> : ABS, REL, ABS_AND_REL, ABS_OR_REL, PSNR, NORM, PW_REL or FIXED_RATIO (see sz -h)\n");
+	printf("	-A <absolute error bound>: specifying absolute error bound\n");
+	printf("	-R <value_range based relative error bound>: specifying relative error bound\n");
+	printf("	-P <point-wise relative error bound>: specifying point-wise relative error bound\n");
+	printf("	-S <PSNR>: specifying PSNR\n");
+	printf("	-N <normErr>: specifying normErr\n");
+	printf("	-F <ratio>: specifying the target compression ratio (FIXED_RATIO)\n");
+	printf("	-B <bits per value>: specifying the target bit rate (FIXED_RATIO)\n");
+	printf("* dimensions (the same for all the files): \n");
+	printf("	-1 <nx> : dimension for 1D data such as data[nx]\n");
+	printf("	-2 <nx> <ny> : dimensions for 2D data such as data[ny][nx]\n");
+	printf("	-3 <nx> <ny> <nz> : dimensions for 3D data such as data[nz][ny][nx] \n");
+	printf("	-4 <nx> <ny> <nz> <np>: dimensions for 4D data such as data[np][nz][ny][nx] \n");
+	printf("	(without dimensions, every file is compressed as 1D data; the decompression needs them)\n");
+	printf("* pipeline:\n");
+	printf("	-j <threads> : number of compression threads (default: 1)\n");
+	printf("	-m <MB> : bound on the memory held by the files in flight (default: %d)\n", BATCH_DEFAULT_MEMORY);
+	printf("	-o <directory> : output directory (default: next to the input files)\n");
+	printf("	-l : print the result of every file\n");
+	printf("* examples: \n");
+	printf("	sz-batch -z -f -c sz.config -M REL -R 1E-4 -3 8 8 128 -j 4 testdata/x86/*.dat\n");
+	printf("	sz-batch -x -f -3 8 8 128 -j 4 -o /tmp/out testdata/x86\n");
+	exit(0);
+}
+
+int main(int argc, char* argv[])
+{
+	batch_pipeline p;
+	int isCompression = -1000; //1 : compression ; 0: decompression
+	int dataType = 0; //0: single precision ; 1: double precision
+	int nbThreads = 1;
+	int memory = BATCH_DEFAULT_MEMORY;
+	char* conPath = NULL;
+	char* errBoundMode = NULL;
+	char* absErrorBound = NULL;
+	char* relErrorBound = NULL;
+	char* pwrErrorBound = NULL;
+	char* psnr_ = NULL;
+	char* normError = NULL;
+	char* fixedRatio = NULL;
+	char* fixedBitRate = NULL;
+	char** inputs = (char**)malloc(argc*sizeof(char*));
+	int nbInputs = 0;
+	size_t r5 = 0, r4 = 0, r3 = 0, r2 = 0, r1 = 0;
+	int i;
+
+	memset(&p, 0, sizeof(p));
+	if(argc == 1)
+		usage();
+	for(i = 1; i < argc; i++)
+	{
+		if(argv[i][0] != '-')
+		{
+			inputs[nbInputs++] = argv[i];
+			continue;
+		}
+		if(argv[i][2])
+			usage();
+		switch(argv[i][1])
+		{
+		case 'h': usage();
+		case 'z': isCompression = 1; break;
+		case 'x': isCompression = 0; break;
+		case 'f': dataType = 0; break;
+		case 'd': dataType = 1; break;
+		case 'l': p.verbose = 1; break;
+		case '1':
+			if (++i == argc || sscanf(argv[i], "%zu", &r1) != 1)
+				usage();
+			break;
+		case '2':
+			if (++i == argc || sscanf(argv[i], "%zu", &r1) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r2) != 1)
+				usage();
+			break;
+		case '3':
+			if (++i == argc || sscanf(argv[i], "%zu", &r1) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r2) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r3) != 1)
+				usage();
+			break;
+		case '4':
+			if (++i == argc || sscanf(argv[i], "%zu", &r1) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r2) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r3) != 1 ||
+				++i == argc || sscanf(argv[i], "%zu", &r4) != 1)
+				usage();
+			break;
+		default:
+			if (++i == argc)
+				usage();
+			switch(argv[i-1][1])
+			{
+			case 'c': conPath = argv[i]; break;
+			case 'M': errBoundMode = argv[i]; break;
+			case 'A': absErrorBound = argv[i]; break;
+			case 'R': relErrorBound = argv[i]; break;
+			case 'P': pwrErrorBound = argv[i]; break;
+			case 'S': psnr_ = argv[i]; break;
+			case 'N': normError = argv[i]; break;
+			case 'F': fixedRatio = argv[i]; break;
+			case 'B': fixedBitRate = argv[i]; break;
+			case 'j': nbThreads = atoi(argv[i]); break;
+			case 'm': memory = atoi(argv[i]); break;
+			case 'o': p.outDir = argv[i]; break;
+			default: usage();
+			}
+		}
+	}
+
+	if(isCompression == -1000 || nbInputs == 0 || nbThreads < 1 || memory < 1)
+		usage();
+	if(isCompression == 0 && r1 == 0)
+	{
+		printf("Error: please specify the dimensions of the decompressed data.\n");
+		exit(0);
+	}
+
+	if(SZ_NSCS==SZ_Init(conPath))
+		exit(0);
+	if(errBoundMode != NULL)
+	{
+		if(strcmp(errBoundMode, "ABS")==0)
+			confparams_cpr->errorBoundMode = ABS;
+		else if(strcmp(errBoundMode, "REL")==0||strcmp(errBoundMode, "VR_REL")==0)
+			confparams_cpr->errorBoundMode = REL;
+		else if(strcmp(errBoundMode, "ABS_AND_REL")==0)
+			confparams_cpr->errorBoundMode = ABS_AND_REL;
+		else if(strcmp(errBoundMode, "ABS_OR_REL")==0)
+			confparams_cpr->errorBoundMode = ABS_OR_REL;
+		else if(strcmp(errBoundMode, "PSNR")==0)
+			confparams_cpr->errorBoundMode = PSNR;
+		else if(strcmp(errBoundMode, "PW_REL")==0)
+			confparams_cpr->errorBoundMode = PW_REL;
+		else if(strcmp(errBoundMode, "NORM")==0)
+			confparams_cpr->errorBoundMode = NORM;
+		else if(strcmp(errBoundMode, "FIXED_RATIO")==0)
+			confparams_cpr->errorBoundMode = FIXED_RATIO;
+		else
+		{
+			printf("Error: wrong error bound mode setting by using the option '-M'\n");
+			usage();
+		}
+	}
+	if(absErrorBound != NULL)
+		confparams_cpr->absErrBound = atof(absErrorBound);
+	if(relErrorBound != NULL)
+		confparams_cpr->relBoundRatio = atof(relErrorBound);
+	if(pwrErrorBound != NULL)
+		confparams_cpr->pw_relBoundRatio = atof(pwrErrorBound);
+	if(psnr_ != NULL)
+		confparams_cpr->psnr = atof(psnr_);
+	if(normError != NULL)
+		confparams_cpr->normErr = atof(normError);
+	if(fixedRatio != NULL)
+		confparams_cpr->fixedRatio = atof(fixedRatio);
+	if(fixedBitRate != NULL)
+	{
+		confparams_cpr->fixedRatio = 0;
+		confparams_cpr->fixedBitRate = atof(fixedBitRate);
+	}
+
+	//the dimensions as given to SZ_compress(): r5, r4, r3, r2, r1
+	size_t dims[5] = {r5, r4, r3, r2, r1};
+	memcpy(p.r, dims, sizeof(dims));
+	p.isCompression = isCompression;
+	p.dataType = dataType == 0 ? SZ_FLOAT : SZ_DOUBLE;
+	p.memLimit = (size_t)memory*1024*1024;
+	p.params = confparams_cpr;
+	p.exe = exe_params;
+	pthread_mutex_init(&p.lock, NULL);
+	pthread_cond_init(&p.workReady, NULL);
+	pthread_cond_init(&p.writeReady, NULL);
+	pthread_cond_init(&p.spaceFree, NULL);
+
+	pthread_t* workers = (pthread_t*)malloc(nbThreads*sizeof(pthread_t));
+	pthread_t writer;
+	double start = sz_stats_clock();
+	for(i = 0; i < nbThreads; i++)
+		pthread_create(&workers[i], NULL, batch_run_worker, &p);
+	pthread_create(&writer, NULL, batch_run_writer, &p);
+
+	for(i = 0; i < nbInputs; i++)
+	{
+		struct stat st;
+		if(stat(inputs[i], &st) == 0 && S_ISDIR(st.st_mode))
+			batch_read_directory(&p, inputs[i]);
+		else
+			batch_read(&p, inputs[i]);
+	}
+	pthread_mutex_lock(&p.lock);
+	p.readDone = 1;
+	pthread_cond_broadcast(&p.workReady);
+	pthread_cond_broadcast(&p.writeReady);
+	pthread_mutex_unlock(&p.lock);
+
+	for(i = 0; i < nbThreads; i++)
+		pthread_join(workers[i], NULL);
+	pthread_join(writer, NULL);
+	double wallTime = sz_stats_clock() - start;
+
+	printf("files = %d (failed: %d), threads = %d\n", p.nbRead, p.nbFailed, nbThreads);
+	printf("original size = %zu bytes, compressed size = %zu bytes, compression ratio = %f\n", p.rawBytes, p.cmpBytes,
+		p.cmpBytes == 0 ? 0 : (double)p.rawBytes/p.cmpBytes);
+	printf("%s time = %f seconds (wall), %f seconds (sum over the threads)\n", isCompression ? "compression" : "decompression", wallTime, p.workTime);
+	printf("throughput = %f MB/s\n", p.rawBytes/wallTime/1E6);
+
+	pthread_mutex_destroy(&p.lock);
+	pthread_cond_destroy(&p.workReady);
+	pthread_cond_destroy(&p.writeReady);
+	pthread_cond_destroy(&p.spaceFree);
+	free(workers);
+	free(inputs);
+	SZ_Finalize();
+	return p.nbFailed == 0 ? 0 : 1;
+}
@@ -92,7 +92,7 @@ int main(int argc, char * argv[])
 		for(j=0;j<nbEle;j++)
 			data[j] = (double)data_[j];	
 		cost_start();
-		SZ_compress_ts(SZ_PERIO_TEMPORAL_COMPRESSION, &bytes, &outSize);
+		SZ_compress_ts(SZ_ADAPTIVE_TEMPORAL_COMPRESSION, &bytes, &outSize);
 		cost_end();
 		printf("timecost=%f\n",totalCost);
 		sprintf(outputFilePath, "%s/%s%02d-double.bin.dat.sz2", outputDir, varName, i);
@@ -83,7 +83,7 @@ int main(int argc, char * argv[])
 		exit(0);
     }
    
-    //unsigned char var_ids[2] = {1,2};
+    //unsigned int var_ids[2] = {1,2};
     for(i=1;i<20;i++)
 	{
 		printf("simulation time step %d\n", i);
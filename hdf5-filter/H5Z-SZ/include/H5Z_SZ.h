@@ -57,6 +57,9 @@ static herr_t H5Z_sz_set_local(hid_t dcpl_id, hid_t type_id, hid_t space_id);
 
 void init_dims_chunk(int dim, hsize_t dims[5], hsize_t chunk[5], size_t nbEle, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 
+int H5Z_SZ_Write_Chunks(hid_t dset_id, const void* data, int nbThreads);
+int H5Z_SZ_Read_Chunks(hid_t dset_id, void* data, int nbThreads);
+
 #ifdef __cplusplus
 }
 #endif
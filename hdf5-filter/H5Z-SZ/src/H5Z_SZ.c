@@ -10,6 +10,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <string.h>
+#include <pthread.h>
 #include "H5Z_SZ.h"
 #include "H5PLextern.h"
 
@@ -40,6 +42,8 @@ void cost_end()
 int load_conffile_flag = 0; //0 means 'not yet', 1 means 'already loaded'
 char cfgFile[256] = "sz.config"; 
 
+static void H5Z_SZ_freeContexts();
+
 const H5Z_class2_t H5Z_SZ[1] = {{
 	H5Z_CLASS_T_VERS,              /* H5Z_class_t version */
 	(H5Z_filter_t)H5Z_FILTER_SZ, /* Filter id number */
@@ -119,6 +123,7 @@ sz_params* H5Z_SZ_Init_Default()
 int H5Z_SZ_Finalize()
 {
 	//SZ_Finalize();
+	H5Z_SZ_freeContexts();
 	herr_t ret = H5Zunregister(H5Z_FILTER_SZ);
 	if (ret < 0) return -1;
 	return 0;
@@ -222,6 +227,110 @@ void SZ_metaDataToCdArray(size_t* cd_nelmts, unsigned int **cd_values, int dataT
 	}
 }
 
+/**
+ * Per-dataset filter context, keyed by the cd_values set by H5Z_sz_set_local().
+ * The dimensions/data type are decoded only once per dataset, and the compression parameters are 
+ * snapshotted when the context is created, so that each filter call can run on private copies 
+ * (bound to the calling thread by SZ_bindThreadContext) instead of the global SZ state.
+ * */
+typedef struct H5Z_SZ_Context
+{
+	size_t cd_nelmts;
+	unsigned int cd_values[7];
+	int dimSize;
+	int dataType;
+	size_t r5, r4, r3, r2, r1;
+	size_t nbEle;
+	size_t outSize; //size (in bytes) of a decompressed chunk
+	int hasParams; //1 means cpr/exe have been captured from the global SZ parameters
+	sz_params cpr;
+	sz_exedata exe;
+	struct H5Z_SZ_Context* next;
+} H5Z_SZ_Context;
+
+static H5Z_SZ_Context* H5Z_SZ_contexts = NULL;
+static pthread_mutex_t H5Z_SZ_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static size_t H5Z_SZ_typeSize(int dataType)
+{
+	switch(dataType)
+	{
+	case SZ_FLOAT: 
+		return sizeof(float);
+	case SZ_DOUBLE: 
+		return sizeof(double);
+	case SZ_INT8: 
+	case SZ_UINT8: 
+		return 1;
+	case SZ_INT16: 
+	case SZ_UINT16: 
+		return 2;
+	case SZ_INT32: 
+	case SZ_UINT32: 
+		return 4;
+	case SZ_INT64: 
+	case SZ_UINT64: 
+		return 8;
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Look up (or create) the context of the dataset described by cd_values. 
+ * capture: 0 - leave the compression parameters as they are (decompression does not need them); 
+ * 1 - capture the global parameters if not yet done (initializing SZ if needed); 2 - always recapture them.
+ * */
+static H5Z_SZ_Context* H5Z_SZ_getContext(size_t cd_nelmts, const unsigned int cd_values[], int capture)
+{
+	H5Z_SZ_Context* ctx = NULL;
+	if(cd_nelmts > 7)
+		cd_nelmts = 7;
+	pthread_mutex_lock(&H5Z_SZ_mutex);
+	for(ctx = H5Z_SZ_contexts; ctx != NULL; ctx = ctx->next)
+		if(ctx->cd_nelmts == cd_nelmts && memcmp(ctx->cd_values, cd_values, cd_nelmts*sizeof(unsigned int)) == 0)
+			break;
+	if(ctx == NULL)
+	{
+		ctx = (H5Z_SZ_Context*)malloc(sizeof(H5Z_SZ_Context));
+		memset(ctx, 0, sizeof(H5Z_SZ_Context));
+		ctx->cd_nelmts = cd_nelmts;
+		memcpy(ctx->cd_values, cd_values, cd_nelmts*sizeof(unsigned int));
+		SZ_cdArrayToMetaData(cd_nelmts, cd_values, &ctx->dimSize, &ctx->dataType, &ctx->r5, &ctx->r4, &ctx->r3, &ctx->r2, &ctx->r1);
+		ctx->nbEle = computeDataLength(ctx->r5, ctx->r4, ctx->r3, ctx->r2, ctx->r1);
+		ctx->outSize = ctx->nbEle*H5Z_SZ_typeSize(ctx->dataType);
+		ctx->next = H5Z_SZ_contexts;
+		H5Z_SZ_contexts = ctx;
+	}
+	if(capture == 2 || (capture == 1 && !ctx->hasParams))
+	{
+		if(confparams_cpr == NULL)
+			H5Z_SZ_Init(cfgFile);
+		if(confparams_cpr != NULL)
+		{
+			memcpy(&ctx->cpr, confparams_cpr, sizeof(sz_params));
+			if(exe_params != NULL)
+				memcpy(&ctx->exe, exe_params, sizeof(sz_exedata));
+			ctx->exe.SZ_SIZE_TYPE = sizeof(size_t);
+			ctx->hasParams = 1;
+		}
+	}
+	pthread_mutex_unlock(&H5Z_SZ_mutex);
+	return ctx;
+}
+
+static void H5Z_SZ_freeContexts()
+{
+	pthread_mutex_lock(&H5Z_SZ_mutex);
+	while(H5Z_SZ_contexts != NULL)
+	{
+		H5Z_SZ_Context* next = H5Z_SZ_contexts->next;
+		free(H5Z_SZ_contexts);
+		H5Z_SZ_contexts = next;
+	}
+	pthread_mutex_unlock(&H5Z_SZ_mutex);
+}
+
 static herr_t H5Z_sz_set_local(hid_t dcpl_id, hid_t type_id, hid_t chunk_space_id)
 {
 	//printf("start in H5Z_sz_set_local\n");
@@ -338,6 +447,9 @@ static herr_t H5Z_sz_set_local(hid_t dcpl_id, hid_t type_id, hid_t chunk_space_i
 
 	SZ_metaDataToCdArray(&cd_nelmts, &cd_values, dataType, r5, r4, r3, r2, r1);
 	
+	//(re)capture the current SZ parameters for the chunks of this dataset
+	H5Z_SZ_getContext(cd_nelmts, cd_values, 2);
+	
 	/* Now, update cd_values for the filter */
 	if (0 > H5Pmodify_filter(dcpl_id, H5Z_FILTER_SZ, flags, cd_nelmts, cd_values))
 		H5Z_SZ_PUSH_AND_GOTO(H5E_PLINE, H5E_BADVALUE, 0, "failed to modify cd_values");	
@@ -351,214 +463,408 @@ done:
 
 static size_t H5Z_filter_sz(unsigned int flags, size_t cd_nelmts, const unsigned int cd_values[], size_t nbytes, size_t* buf_size, void** buf)
 {
-	//printf("start in H5Z_filter_sz\n");
-	//H5Z_SZ_Init_Default();
-	
-	size_t r1 = 0, r2 = 0, r3 = 0, r4 = 0, r5 = 0;
-	int dimSize = 0, dataType = 0;
-
 	if(cd_nelmts==0) //this is special data such as string, which should not be treated as values.
 		return nbytes;
 	
-	SZ_cdArrayToMetaData(cd_nelmts, cd_values, &dimSize, &dataType, &r5, &r4, &r3, &r2, &r1);
-	
-/*	int i=0;
-	for(i=0;i<cd_nelmts;i++)
-		printf("cd_values[%d]=%u\n", i, cd_values[i]);
-	printf("dimSize=%d, r1=%u, r2=%u, r3=%u, r4=%u, r5=%u\n", dimSize, r1, r2, r3, r4, r5);*/
-	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1); 
-
-	if(nbEle < 20)
+	H5Z_SZ_Context* ctx = H5Z_SZ_getContext(cd_nelmts, cd_values, !(flags & H5Z_FLAG_REVERSE));
+	if(ctx->nbEle < 20)
 		return nbytes;
-
+	if(ctx->outSize == 0)
+	{
+		printf("Error: unknown data type: %d\n", ctx->dataType);
+		return 0;
+	}
+	
+	//run on private copies of the parameters, so concurrent filter calls do not share any SZ state
+	//(copied under the mutex: H5Z_sz_set_local() may recapture them for another dataset meanwhile)
+	sz_params cpr, dec;
+	sz_exedata exe;
+	pthread_mutex_lock(&H5Z_SZ_mutex);
+	int hasParams = ctx->hasParams;
+	memcpy(&cpr, &ctx->cpr, sizeof(sz_params));
+	memcpy(&exe, &ctx->exe, sizeof(sz_exedata));
+	pthread_mutex_unlock(&H5Z_SZ_mutex);
+	memset(&dec, 0, sizeof(sz_params));
+	sz_thread_context tctx = {.cpr = &cpr, .dec = &dec, .exe = &exe};
+	sz_thread_context* previous = SZ_bindThreadContext(&tctx);
+	
+	size_t retval = 0;
 	if (flags & H5Z_FLAG_REVERSE) 
 	{ 
-		//cost_start();
-		/* decompress data */
-		if(dataType == SZ_FLOAT)//==0
-		{
-			float* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(float);
-		}
-		else if(dataType == SZ_DOUBLE)//==1
-		{
-			double* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(double);			
-		}
-		else if(dataType == SZ_INT8)
-		{
-			char* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(char);
-		}
-		else if(dataType == SZ_UINT8)
+		/* decompress data: SZ allocates exactly one output buffer of the chunk size, which is handed over to HDF5.
+		 * It cannot decompress into *buf, which holds the compressed bytes being read, and the decompressors of SZ
+		 * allocate their output themselves: decompressing into a buffer of the filter would only add a copy. */
+		void* data = SZ_decompress(ctx->dataType, *buf, nbytes, ctx->r5, ctx->r4, ctx->r3, ctx->r2, ctx->r1);
+		if(data != NULL)
 		{
-			unsigned char* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
 			free(*buf);
 			*buf = data;
-			*buf_size = nbEle*sizeof(unsigned char);
+			*buf_size = ctx->outSize;
+			retval = ctx->outSize;
 		}
-		else if(dataType == SZ_INT16)
+	}
+	else
+	{
+		if(!hasParams)
+			printf("Error: SZ parameters are not initialized (H5Z_SZ_Init)\n");
+		else
 		{
-			short* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(short);
+			size_t outSize = 0;
+			unsigned char *bytes = SZ_compress(ctx->dataType, *buf, &outSize, ctx->r5, ctx->r4, ctx->r3, ctx->r2, ctx->r1);
+			if(bytes != NULL)
+			{
+				free(*buf);
+				*buf = bytes;
+				*buf_size = outSize;
+				retval = outSize;
+			}
 		}
-		else if(dataType == SZ_UINT16)
-		{
-			unsigned short* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(unsigned short);
+	}
+	
+	SZ_bindThreadContext(previous);
+	return retval;
+}
+
+/**
+ * Shared state of the parallel chunk driver (H5Z_SZ_Write_Chunks/H5Z_SZ_Read_Chunks).
+ * The calling thread does all the HDF5 I/O in chunk order, while the worker threads run 
+ * H5Z_filter_sz() on the chunks, so that the bytes are exactly those produced by the filter pipeline.
+ * */
+typedef struct H5Z_SZ_ChunkDriver
+{
+	int reverse; //0: compress and write; H5Z_FLAG_REVERSE: read and decompress
+	size_t cd_nelmts;
+	unsigned int cd_values[7];
+	int rank;
+	hsize_t dims[H5S_MAX_RANK];
+	hsize_t chunk[H5S_MAX_RANK];
+	hsize_t nbChunksPerDim[H5S_MAX_RANK];
+	size_t nbChunks;
+	size_t chunkEle;
+	size_t typeSize;
+	unsigned char* data; //the user's array (the whole dataset)
+	void** bufs; //compressed bytes of each chunk
+	size_t* sizes;
+	char* ready; //1 means the worker is done with the chunk (compression only)
+	size_t next; //next chunk to be processed by a worker
+	size_t io; //number of chunks written/read by the calling thread
+	size_t finished; //number of chunks decompressed (decompression only)
+	size_t window; //at most so many chunks are kept in memory ahead of the I/O
+	int error;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+} H5Z_SZ_ChunkDriver;
+
+static void H5Z_SZ_chunkOffset(H5Z_SZ_ChunkDriver* drv, size_t chunkIndex, hsize_t* offset)
+{
+	int d;
+	for(d = drv->rank-1; d >= 0; d--)
+	{
+		offset[d] = (chunkIndex % drv->nbChunksPerDim[d]) * drv->chunk[d];
+		chunkIndex /= drv->nbChunksPerDim[d];
+	}
+}
+
+/**
+ * Copy the chunk at offset between the dataset array and the contiguous chunk buffer, one row 
+ * (fastest dimension) at a time. For edge chunks, the part outside of the dataset is padded with the 
+ * nearest values on gather (to keep the chunk smooth for SZ), and skipped on scatter.
+ * */
+static void H5Z_SZ_copyChunk(H5Z_SZ_ChunkDriver* drv, const hsize_t* offset, unsigned char* chunkBuf, int scatter)
+{
+	int d, last = drv->rank-1;
+	size_t ts = drv->typeSize;
+	size_t rowLen = drv->chunk[last];
+	size_t nbRows = drv->chunkEle/rowLen;
+	size_t valid = offset[last]+rowLen <= drv->dims[last] ? rowLen : drv->dims[last]-offset[last];
+	size_t row, k;
+	for(row = 0; row < nbRows; row++)
+	{
+		//locate the row in the dataset (coordinates are clamped into the dataset)
+		size_t r = row, src = 0, stride = drv->dims[last];
+		int inside = 1;
+		hsize_t coord[H5S_MAX_RANK];
+		for(d = last-1; d >= 0; d--)
+		{
+			coord[d] = offset[d] + r % drv->chunk[d];
+			r /= drv->chunk[d];
+			if(coord[d] >= drv->dims[d])
+			{
+				coord[d] = drv->dims[d]-1;
+				inside = 0;
+			}
 		}
-		else if(dataType == SZ_INT32)
+		for(d = 0; d < last; d++)
+			src = src*drv->dims[d] + coord[d];
+		src = src*stride + offset[last];
+		
+		unsigned char* p = chunkBuf + row*rowLen*ts;
+		unsigned char* q = drv->data + src*ts;
+		if(scatter)
 		{
-			int* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(int);
+			if(inside)
+				memcpy(q, p, valid*ts);
 		}
-		else if(dataType == SZ_UINT32)
+		else
 		{
-			unsigned int* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(unsigned int);
+			memcpy(p, q, valid*ts);
+			for(k = valid; k < rowLen; k++)
+				memcpy(p+k*ts, q+(valid-1)*ts, ts);
 		}
-		else if(dataType == SZ_INT64)
+	}
+}
+
+static void* H5Z_SZ_chunkWorker(void* arg)
+{
+	H5Z_SZ_ChunkDriver* drv = (H5Z_SZ_ChunkDriver*)arg;
+	size_t chunkBytes = drv->chunkEle*drv->typeSize;
+	hsize_t offset[H5S_MAX_RANK];
+	for(;;)
+	{
+		size_t idx;
+		pthread_mutex_lock(&drv->mutex);
+		if(drv->reverse)
+			while(!drv->error && drv->next < drv->nbChunks && drv->next >= drv->io)
+				pthread_cond_wait(&drv->cond, &drv->mutex);
+		else
+			while(!drv->error && drv->next < drv->nbChunks && drv->next >= drv->io + drv->window)
+				pthread_cond_wait(&drv->cond, &drv->mutex);
+		if(drv->error || drv->next >= drv->nbChunks)
 		{
-			long* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(long);
+			pthread_mutex_unlock(&drv->mutex);
+			break;
 		}
-		else if(dataType == SZ_UINT64)
+		idx = drv->next++;
+		pthread_mutex_unlock(&drv->mutex);
+		
+		H5Z_SZ_chunkOffset(drv, idx, offset);
+		void* buf = drv->bufs[idx];
+		size_t bufSize = drv->sizes[idx], outSize = 0;
+		if(drv->reverse)
 		{
-			unsigned long* data = SZ_decompress(dataType, *buf, nbytes, r5, r4, r3, r2, r1);
-										
-			free(*buf);
-			*buf = data;
-			*buf_size = nbEle*sizeof(unsigned long);
+			if(buf == NULL) //the chunk has never been written
+			{
+				buf = calloc(1, chunkBytes);
+				outSize = chunkBytes;
+			}
+			else
+				outSize = H5Z_filter_sz(H5Z_FLAG_REVERSE, drv->cd_nelmts, drv->cd_values, drv->sizes[idx], &bufSize, &buf);
+			if(outSize == chunkBytes)
+				H5Z_SZ_copyChunk(drv, offset, (unsigned char*)buf, 1);
+			free(buf);
+			buf = NULL;
 		}
 		else
 		{
-			printf("Decompression error: unknown data type: %d\n", dataType);
-			exit(0);
+			buf = malloc(chunkBytes);
+			bufSize = chunkBytes;
+			H5Z_SZ_copyChunk(drv, offset, (unsigned char*)buf, 0);
+			outSize = H5Z_filter_sz(0, drv->cd_nelmts, drv->cd_values, chunkBytes, &bufSize, &buf);
 		}
-		//cost_end();
-		//printf("decompression time = %lf, decompression rate = %lf\n", totalCost, 1.0*nbEle*sizeof(float)/totalCost);
+		
+		pthread_mutex_lock(&drv->mutex);
+		if(outSize == 0 || (drv->reverse && outSize != chunkBytes))
+			drv->error = 1;
+		drv->bufs[idx] = buf;
+		drv->sizes[idx] = outSize;
+		drv->ready[idx] = 1;
+		drv->finished++;
+		pthread_cond_broadcast(&drv->cond);
+		pthread_mutex_unlock(&drv->mutex);
 	}
-	else
+	return NULL;
+}
+
+/**
+ * Set up the driver from the dataset: the SZ filter must be the only filter of the (chunked) dataset, 
+ * and the file type must have the native byte order because the chunks bypass the type conversion.
+ * */
+static int H5Z_SZ_initChunkDriver(H5Z_SZ_ChunkDriver* drv, hid_t dset_id, int nbThreads)
+{
+	int d, status = SZ_NSCS;
+	unsigned int flags = 0;
+	hid_t dcpl = -1, space = -1, ftype = -1;
+	memset(drv, 0, sizeof(H5Z_SZ_ChunkDriver));
+	
+	if (0 > (dcpl = H5Dget_create_plist(dset_id)) || 0 > (space = H5Dget_space(dset_id)) || 0 > (ftype = H5Dget_type(dset_id)))
+		goto done;
+	if (H5Pget_layout(dcpl) != H5D_CHUNKED || H5Pget_nfilters(dcpl) != 1)
 	{
-		size_t outSize = 0;
+		printf("Error: the dataset must be chunked with the SZ filter as its only filter\n");
+		goto done;
+	}
+	drv->cd_nelmts = 7;
+	if (0 > H5Pget_filter_by_id(dcpl, H5Z_FILTER_SZ, &flags, &drv->cd_nelmts, drv->cd_values, 0, NULL, NULL))
+		goto done;
+	if (H5Tget_order(ftype) != H5Tget_order(H5T_NATIVE_INT))
+	{
+		printf("Error: the parallel chunk driver requires the native byte order in the file\n");
+		goto done;
+	}
+	drv->typeSize = H5Tget_size(ftype);
+	drv->rank = H5Sget_simple_extent_dims(space, drv->dims, NULL);
+	if (drv->rank <= 0 || drv->rank != H5Pget_chunk(dcpl, drv->rank, drv->chunk))
+		goto done;
 	
-		//printf("r5=%d, r4=%d, r3=%d, r2=%d, r1=%d, dataType=%d\n", r5, r4, r3, r2, r1, dataType);
-		//cost_start();
-		if(dataType == SZ_FLOAT)//==0
-		{
-			float* data = (float*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_DOUBLE)//==1
-		{
-			double* data = (double*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_INT8)
-		{
-			char* data = (char*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_UINT8)
-		{
-			unsigned char* data = (unsigned char*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_INT16)
-		{
-			short* data = (short*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_UINT16)
-		{
-			unsigned short* data = (unsigned short*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_INT32)
-		{
-			int* data = (int*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_UINT32)
-		{
-			unsigned int* data = (unsigned int*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_INT64)
-		{
-			long* data = (long*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
-		}
-		else if(dataType == SZ_UINT64)
+	drv->nbChunks = 1;
+	drv->chunkEle = 1;
+	for(d = 0; d < drv->rank; d++)
+	{
+		drv->nbChunksPerDim[d] = (drv->dims[d] + drv->chunk[d] - 1)/drv->chunk[d];
+		drv->nbChunks *= drv->nbChunksPerDim[d];
+		drv->chunkEle *= drv->chunk[d];
+	}
+	drv->window = 4*nbThreads;
+	drv->bufs = (void**)calloc(drv->nbChunks, sizeof(void*));
+	drv->sizes = (size_t*)calloc(drv->nbChunks, sizeof(size_t));
+	drv->ready = (char*)calloc(drv->nbChunks, sizeof(char));
+	pthread_mutex_init(&drv->mutex, NULL);
+	pthread_cond_init(&drv->cond, NULL);
+	status = SZ_SCES;
+done:
+	if(dcpl >= 0) H5Pclose(dcpl);
+	if(space >= 0) H5Sclose(space);
+	if(ftype >= 0) H5Tclose(ftype);
+	return status;
+}
+
+static void H5Z_SZ_freeChunkDriver(H5Z_SZ_ChunkDriver* drv)
+{
+	size_t i;
+	for(i = 0; i < drv->nbChunks; i++)
+		free(drv->bufs[i]);
+	free(drv->bufs);
+	free(drv->sizes);
+	free(drv->ready);
+	pthread_mutex_destroy(&drv->mutex);
+	pthread_cond_destroy(&drv->cond);
+}
+
+static void H5Z_SZ_setDriverError(H5Z_SZ_ChunkDriver* drv)
+{
+	pthread_mutex_lock(&drv->mutex);
+	drv->error = 1;
+	pthread_cond_broadcast(&drv->cond);
+	pthread_mutex_unlock(&drv->mutex);
+}
+
+/**
+ * Compress the chunks of a dataset (created with the SZ filter) on nbThreads threads, and write them 
+ * with H5Dwrite_chunk. The resulting file is readable by the regular H5Z-SZ filter (H5Dread).
+ * @param data the whole dataset, in the native type and C order
+ * @return SZ_SCES or SZ_NSCS
+ * */
+int H5Z_SZ_Write_Chunks(hid_t dset_id, const void* data, int nbThreads)
+{
+	H5Z_SZ_ChunkDriver drv;
+	hsize_t offset[H5S_MAX_RANK];
+	size_t i;
+	int t;
+	if(nbThreads < 1)
+		nbThreads = 1;
+	if(H5Z_SZ_initChunkDriver(&drv, dset_id, nbThreads) == SZ_NSCS)
+		return SZ_NSCS;
+	drv.reverse = 0;
+	drv.data = (unsigned char*)data;
+	
+	pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t)*nbThreads);
+	for(t = 0; t < nbThreads; t++)
+		pthread_create(&threads[t], NULL, H5Z_SZ_chunkWorker, &drv);
+	
+	for(i = 0; i < drv.nbChunks; i++)
+	{
+		pthread_mutex_lock(&drv.mutex);
+		while(!drv.error && !drv.ready[i])
+			pthread_cond_wait(&drv.cond, &drv.mutex);
+		pthread_mutex_unlock(&drv.mutex);
+		if(drv.error)
+			break;
+		
+		H5Z_SZ_chunkOffset(&drv, i, offset);
+		if (0 > H5Dwrite_chunk(dset_id, H5P_DEFAULT, 0, offset, drv.sizes[i], drv.bufs[i]))
 		{
-			unsigned long* data = (unsigned long*)(*buf);
-			unsigned char *bytes = SZ_compress(dataType, data, &outSize, r5, r4, r3, r2, r1);
-			free(*buf);
-			*buf = bytes;
-			*buf_size = outSize;
+			H5Z_SZ_setDriverError(&drv);
+			break;
 		}
-		else 
-		{
-			printf("Compression error: unknown data type: %d\n", dataType);
-			exit(0);
+		
+		pthread_mutex_lock(&drv.mutex);
+		free(drv.bufs[i]);
+		drv.bufs[i] = NULL;
+		drv.io++;
+		pthread_cond_broadcast(&drv.cond);
+		pthread_mutex_unlock(&drv.mutex);
+	}
+	
+	for(t = 0; t < nbThreads; t++)
+		pthread_join(threads[t], NULL);
+	free(threads);
+	int status = drv.error ? SZ_NSCS : SZ_SCES;
+	H5Z_SZ_freeChunkDriver(&drv);
+	return status;
+}
+
+/**
+ * Read the chunks of an SZ-compressed dataset with H5Dread_chunk, and decompress them on nbThreads threads.
+ * @param data the output array (the whole dataset, in the native type and C order)
+ * @return SZ_SCES or SZ_NSCS
+ * */
+int H5Z_SZ_Read_Chunks(hid_t dset_id, void* data, int nbThreads)
+{
+	H5Z_SZ_ChunkDriver drv;
+	hsize_t offset[H5S_MAX_RANK], chunkBytes;
+	uint32_t filterMask;
+	size_t i;
+	int t;
+	if(nbThreads < 1)
+		nbThreads = 1;
+	if(H5Z_SZ_initChunkDriver(&drv, dset_id, nbThreads) == SZ_NSCS)
+		return SZ_NSCS;
+	drv.reverse = H5Z_FLAG_REVERSE;
+	drv.data = (unsigned char*)data;
+	
+	pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t)*nbThreads);
+	for(t = 0; t < nbThreads; t++)
+		pthread_create(&threads[t], NULL, H5Z_SZ_chunkWorker, &drv);
+	
+	for(i = 0; i < drv.nbChunks; i++)
+	{
+		pthread_mutex_lock(&drv.mutex);
+		while(!drv.error && i >= drv.finished + drv.window)
+			pthread_cond_wait(&drv.cond, &drv.mutex);
+		pthread_mutex_unlock(&drv.mutex);
+		if(drv.error)
+			break;
+		
+		void* buf = NULL;
+		chunkBytes = 0;
+		H5Z_SZ_chunkOffset(&drv, i, offset);
+		//a chunk that has never been written has no storage (and reads as zeros)
+		if (0 <= H5Dget_chunk_storage_size(dset_id, offset, &chunkBytes) && chunkBytes > 0)
+		{
+			buf = malloc(chunkBytes);
+			filterMask = 0;
+			if (0 > H5Dread_chunk(dset_id, H5P_DEFAULT, offset, &filterMask, buf) || filterMask != 0)
+			{
+				free(buf);
+				H5Z_SZ_setDriverError(&drv);
+				break;
+			}
 		}
-		//cost_end();
-		//printf("compression time = %lf, compression rate = %lf\n", totalCost, 1.0*nbEle*sizeof(float)/totalCost);
+		
+		pthread_mutex_lock(&drv.mutex);
+		drv.bufs[i] = buf;
+		drv.sizes[i] = chunkBytes;
+		drv.io++;
+		pthread_cond_broadcast(&drv.cond);
+		pthread_mutex_unlock(&drv.mutex);
 	}
 	
-	//H5Z_SZ_Finalize();
-	return *buf_size;
+	for(t = 0; t < nbThreads; t++)
+		pthread_join(threads[t], NULL);
+	free(threads);
+	int status = drv.error ? SZ_NSCS : SZ_SCES;
+	H5Z_SZ_freeChunkDriver(&drv);
+	return status;
 }
 
 void init_dims_chunk(int dim, hsize_t dims[5], hsize_t chunk[5], size_t nbEle, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
@@ -18,6 +18,15 @@
 #define DATASET "testdata_compressed"
 #define MAX_CHUNK_SIZE 4294967295 //2^32-1
 
+static int nbThreads = 0; //>0: read the chunks directly and decompress them in parallel (--threads N)
+
+static herr_t readDataset(hid_t dset, hid_t memType, void* data)
+{
+	if(nbThreads > 0)
+		return H5Z_SZ_Read_Chunks(dset, data, nbThreads) == SZ_SCES ? 0 : -1;
+	return H5Dread(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+}
+
 int main(int argc, char * argv[])
 {
 	int dimSize = 0;
@@ -36,9 +45,19 @@ int main(int argc, char * argv[])
 	size_t nelmts = 0, dsize;
 	unsigned int values_out[7] = {0,0,0,0,0,0,0}; //at most 7 parameters 
 
+	int i = 0, j = 0;
+	for(i=0;i<argc;i++)
+	{
+		if(strcmp(argv[i], "--threads")==0 && i+1<argc)
+			nbThreads = atoi(argv[++i]);
+		else
+			argv[j++] = argv[i];
+	}
+	argc = j;
+
 	if(argc < 2)
 	{
-		printf("Test case: dszFromHDF5 [hdf5FilePath]\n");
+		printf("Test case: dszFromHDF5 [--threads N] [hdf5FilePath]\n");
 		printf("Example 1: dszFromHDF5 testdata/x86/testfloat_8_8_128.dat.sz.hdf5\n");
 		printf("Example 2: dszFromHDF5 testdata/x86/testint32_8x8x8.dat.sz.hdf5\n");
 		exit(0);
@@ -93,9 +112,9 @@ int main(int argc, char * argv[])
 			printf("data type: float\n");
 			float* data = (float*)malloc(sizeof(float)*nbEle);		
 			if(dorder==H5T_ORDER_LE)		
-				status = H5Dread(dset, H5T_IEEE_F32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+				status = readDataset(dset, H5T_IEEE_F32LE, data);
 			else //H5T_ORDER_BE
-				status = H5Dread(dset, H5T_IEEE_F32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+				status = readDataset(dset, H5T_IEEE_F32BE, data);
 			/*Print the first 20 data values to check the correctness.*/	
 			int i;
 			printf("reconstructed data = ");
@@ -109,9 +128,9 @@ int main(int argc, char * argv[])
 			printf("data type: double\n");
 			double* data = (double*)malloc(sizeof(double)*nbEle);
 			if(dorder==H5T_ORDER_LE)
-				status = H5Dread(dset, H5T_IEEE_F64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+				status = readDataset(dset, H5T_IEEE_F64LE, data);
 			else
-				status = H5Dread(dset, H5T_IEEE_F64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+				status = readDataset(dset, H5T_IEEE_F64BE, data);
 			/*Print the first 10 data values to check the correctness.*/	
 			int i;
 			printf("reconstructed data = ");
@@ -134,9 +153,9 @@ int main(int argc, char * argv[])
 				printf("data type: unsigned char\n");
 				unsigned char* data = (unsigned char*)malloc(sizeof(unsigned char)*nbEle);		
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_U8LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_U8LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_U8BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);		
+					status = readDataset(dset, H5T_STD_U8BE, data);		
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -149,9 +168,9 @@ int main(int argc, char * argv[])
 				printf("data type: unsigned short\n");
 				unsigned short* data = (unsigned short*)malloc(sizeof(unsigned short)*nbEle);		
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_U16LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_U16LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_U16BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);	
+					status = readDataset(dset, H5T_STD_U16BE, data);	
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -164,9 +183,9 @@ int main(int argc, char * argv[])
 				printf("data type: unsigned int\n");
 				unsigned int* data = (unsigned int*)malloc(sizeof(unsigned int)*nbEle);		
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_U32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_U32LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_U32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);		
+					status = readDataset(dset, H5T_STD_U32BE, data);		
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -179,9 +198,9 @@ int main(int argc, char * argv[])
 				printf("data type: unsigned long\n");
 				unsigned long* data = (unsigned long*)malloc(sizeof(unsigned long)*nbEle);		
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_U64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_U64LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_U64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);	
+					status = readDataset(dset, H5T_STD_U64BE, data);	
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -197,9 +216,9 @@ int main(int argc, char * argv[])
 				printf("data type: char\n");
 				char *data = (char*)malloc(sizeof(char)*nbEle);
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_I8LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I8LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_I8BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I8BE, data);
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -212,9 +231,9 @@ int main(int argc, char * argv[])
 				printf("data type: short\n");
 				short *data = (short*)malloc(sizeof(short)*nbEle);
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_I16LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I16LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_I16BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);		
+					status = readDataset(dset, H5T_STD_I16BE, data);		
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -227,9 +246,9 @@ int main(int argc, char * argv[])
 				printf("data type: int\n");
 				int *data = (int*)malloc(sizeof(int)*nbEle);
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_I32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I32LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_I32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);		
+					status = readDataset(dset, H5T_STD_I32BE, data);		
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
@@ -242,9 +261,9 @@ int main(int argc, char * argv[])
 				printf("data type: long\n");
 				long *data = (long*)malloc(sizeof(long)*nbEle);
 				if(dorder==H5T_ORDER_LE)	
-					status = H5Dread(dset, H5T_STD_I64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I64LE, data);
 				else
-					status = H5Dread(dset, H5T_STD_I64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+					status = readDataset(dset, H5T_STD_I64BE, data);
 				int i;
 				printf("reconstructed data = ");
 				for(i=0;i<20;i++)
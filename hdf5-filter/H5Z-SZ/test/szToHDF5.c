@@ -16,6 +16,15 @@
 
 #define DATASET "testdata_compressed"
 
+static int nbThreads = 0; //>0: compress the chunks in parallel and write them directly (--threads N)
+
+static herr_t writeDataset(hid_t dset, hid_t memType, const void* data)
+{
+	if(nbThreads > 0)
+		return H5Z_SZ_Write_Chunks(dset, data, nbThreads) == SZ_SCES ? 0 : -1;
+	return H5Dwrite(dset, memType, H5S_ALL, H5S_ALL, H5P_DEFAULT, data);
+}
+
 int main(int argc, char * argv[])
 {
 	size_t r5=0,r4=0,r3=0,r2=0,r1=0;
@@ -30,9 +39,19 @@ int main(int argc, char * argv[])
 
 	hid_t sid, idsid, cpid, fid;
 
+	int i = 0, j = 0;
+	for(i=0;i<argc;i++)
+	{
+		if(strcmp(argv[i], "--threads")==0 && i+1<argc)
+			nbThreads = atoi(argv[++i]);
+		else
+			argv[j++] = argv[i];
+	}
+	argc = j;
+
 	if(argc < 4)
 	{
-		printf("Test case: szToHDF5 [dataType] [config_file] [srcFilePath] [dimension sizes...]\n");
+		printf("Test case: szToHDF5 [--threads N] [dataType] [config_file] [srcFilePath] [dimension sizes...]\n");
 		printf("Example1 : szToHDF5 -f sz.config testdata/x86/testfloat_8_8_128.dat 8 8 128\n");
 		printf("Example 2: szToHDF5 -i32 sz.config testdata/x86/testint32_8x8x8.dat 8 8 8\n");	
 		exit(0);
@@ -100,7 +119,6 @@ int main(int argc, char * argv[])
 	cd_values[5] = 0;				
 	cd_values[6] = 0;*/
 	
-	int i = 0;
 //	for(i=0;i<cd_nelmts;i++)
 //		printf("cd_values[%d]=%u\n", i, cd_values[i]);
 
@@ -109,6 +127,13 @@ int main(int argc, char * argv[])
 
 	hsize_t dims[5] = {0,0,0,0,0}, chunk[5] = {0,0,0,0,0};
 	init_dims_chunk(dim, dims, chunk, nbEle, r5, r4, r3, r2, r1);
+	if(nbThreads > 0) //split the slowest dimension to get about 4 chunks per thread
+	{
+		hsize_t c = (dims[0]+4*nbThreads-1)/(4*nbThreads);
+		if(c < chunk[0])
+			chunk[0] = c;
+		printf("threads = %d, chunk size along the slowest dimension = %llu\n", nbThreads, (unsigned long long)chunk[0]);
+	}
 
 	/* create HDF5 file */
 	if (0 > (fid = H5Fcreate(outputFilePath, H5F_ACC_TRUNC, H5P_DEFAULT, H5P_DEFAULT))) ERROR(H5Fcreate);
@@ -153,12 +178,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_IEEE_F32LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_IEEE_F32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_IEEE_F32LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_IEEE_F32BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_IEEE_F32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);						
+			if (0 > writeDataset(idsid, H5T_IEEE_F32BE, data)) ERROR(H5Dwrite);						
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);
@@ -175,12 +200,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_IEEE_F64LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_IEEE_F64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_IEEE_F64LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_IEEE_F64BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_IEEE_F64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_IEEE_F64BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);
@@ -197,12 +222,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I8LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I8LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_I8LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I8BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I8BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_I8BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -219,12 +244,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U8LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U8LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_U8LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U8BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U8BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_U8BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -241,12 +266,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I16LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I16LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_I16LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I16BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I16BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_I16BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -263,12 +288,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U16LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U16LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_U16LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U16BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U16BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_U16BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -285,12 +310,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I32LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_I32LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I32BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_I32BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -307,12 +332,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U32LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U32LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_U32LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U32BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U32BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_U32BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -329,12 +354,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I64LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_I64LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_I64BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_I64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_I64BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
@@ -351,12 +376,12 @@ int main(int argc, char * argv[])
 		if(dataEndianType == LITTLE_ENDIAN_DATA)
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U64LE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U64LE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);			
+			if (0 > writeDataset(idsid, H5T_STD_U64LE, data)) ERROR(H5Dwrite);			
 		}
 		else //BIG_ENDIAN_DATA
 		{
 			if (0 > (idsid = H5Dcreate(fid, DATASET, H5T_STD_U64BE, sid, H5P_DEFAULT, cpid, H5P_DEFAULT))) ERROR(H5Dcreate);
-			if (0 > H5Dwrite(idsid, H5T_STD_U64BE, H5S_ALL, H5S_ALL, H5P_DEFAULT, data)) ERROR(H5Dwrite);				
+			if (0 > writeDataset(idsid, H5T_STD_U64BE, data)) ERROR(H5Dwrite);				
 		}
 		free(data);
 		if (0 > H5Dclose(idsid)) ERROR(H5Dclose);		
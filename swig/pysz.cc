@@ -83,6 +83,8 @@ Compressor::Compressor(Config config): app(config.app) {
     ss << "SZ Init Error: " << ret;
     throw std::runtime_error(ss.str());
   }
+  cpr = *confparams_cpr;
+  exe = *exe_params;
 }
 
 Compressor::~Compressor() {
@@ -38,6 +38,8 @@
 #include <vector>
 #include <memory>
 #include <algorithm>
+#include <cstring>
+#include <stdexcept>
 #include "sz.h"
 #include "exafelSZ.h"
 #include "pysz_private.h"
@@ -141,66 +143,153 @@ class Compressor {
   //
   //even though sz supports 5d arrays, they aren't supported well by numpy, omit it for now
   //
+  //Compress returns the compressed bytes, Decompress the values; both throw std::runtime_error when SZ fails
+  //
 
   template<class T>
   std::string Compress1(T* data, size_t r1, void* params=nullptr) {
-    size_t outsize = 0;
-    int status;
-    char* tmp = reinterpret_cast<char*>(SZ_compress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, data, 0, 0, 0, 0, r1, &outsize, &status));
-    return std::string(tmp, outsize);
+    return CompressString(data, 0, 0, 0, 0, r1, params);
   }
   template<class T>
   std::string Compress2(T* data, size_t r1, size_t r2, void* params=nullptr) {
-    int status;
-    size_t outsize = 0;
-    auto tmp = reinterpret_cast<char*>(SZ_compress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, data, 0, 0, 0, r2, r1, &outsize, &status));
-    return std::string(tmp, outsize);
+    return CompressString(data, 0, 0, 0, r2, r1, params);
   }
   template<class T>
   std::string Compress3(T* data, size_t r1, size_t r2, size_t r3, void* params=nullptr) {
-    int status;
-    size_t outsize = 0;
-    auto tmp = reinterpret_cast<char*>(SZ_compress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, data, 0, 0, r3, r2, r1, &outsize, &status));
-    return std::string(tmp, outsize);
+    return CompressString(data, 0, 0, r3, r2, r1, params);
   }
   template<class T>
   std::string Compress4(T* data, size_t r1, size_t r2, size_t r3, size_t r4, void* params=nullptr) {
-    int status;
-    size_t outsize = 0;
-    auto tmp = reinterpret_cast<char*>(SZ_compress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, data, 0, r4, r3, r2, r1, &outsize, &status));
-    return std::string(tmp, outsize);
-
+    return CompressString(data, 0, r4, r3, r2, r1, params);
   }
 
   template<class T>
   std::vector<T> Decompress(std::string data, std::vector<int> r, void* params=nullptr) {
-    T* decompressed = nullptr;
     size_t len = 0;
-    int status;
-    switch(r.size()) {
-      case 1:
-
-        decompressed = (T*)SZ_decompress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, (unsigned char*)(data.c_str()), data.length(), 0,0,0,0,r[0], &status);
-        len = r[0];
-        break;
-      case 2:
-        decompressed = (T*)SZ_decompress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, (unsigned char*)(data.c_str()), data.length(), 0,0,0,r[1],r[0], &status);
-        len = r[0]*r[1];
-        break;
-      case 3:
-        decompressed = (T*)SZ_decompress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, (unsigned char*)(data.c_str()), data.length(), 0,0,r[2],r[1],r[0], &status);
-        len = r[0]*r[1]*r[2];
-        break;
-      case 4:
-        decompressed = (T*)SZ_decompress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, (unsigned char*)(data.c_str()), data.length(), 0,r[3],r[2],r[1],r[0], &status);
-        len = r[0]*r[1]*r[2]*r[3];
-        break;
-      default:
-        printf("%zu dimensional arrays not supported\n", r.size());
+    T* decompressed = static_cast<T*>(DecompressRaw(SZTypeToTypeID<T>::value, reinterpret_cast<const unsigned char*>(data.data()), data.length(), r, &len, params));
+    std::vector<T> values(decompressed, decompressed+len);
+    free(decompressed);
+    return values;
+  }
+
+  //
+  //The Array variants hand over the buffers as they come out of SZ (the caller owns them and releases them with free()),
+  //so that the binding can wrap them in arrays without copying them; DecompressInto writes into an array allocated by
+  //the caller, and throws std::invalid_argument if its length does not match the dimensions
+  //
+
+  template<class T>
+  void CompressArray1(T* data, size_t r1, unsigned char** compressed, size_t* compressed_len, void* params=nullptr) {
+    Compress(data, 0, 0, 0, 0, r1, compressed, compressed_len, params);
+  }
+  template<class T>
+  void CompressArray2(T* data, size_t r1, size_t r2, unsigned char** compressed, size_t* compressed_len, void* params=nullptr) {
+    Compress(data, 0, 0, 0, r2, r1, compressed, compressed_len, params);
+  }
+  template<class T>
+  void CompressArray3(T* data, size_t r1, size_t r2, size_t r3, unsigned char** compressed, size_t* compressed_len, void* params=nullptr) {
+    Compress(data, 0, 0, r3, r2, r1, compressed, compressed_len, params);
+  }
+  template<class T>
+  void CompressArray4(T* data, size_t r1, size_t r2, size_t r3, size_t r4, unsigned char** compressed, size_t* compressed_len, void* params=nullptr) {
+    Compress(data, 0, r4, r3, r2, r1, compressed, compressed_len, params);
+  }
+
+  template<class T>
+  void DecompressArray(const unsigned char* bytes, size_t bytes_len, std::vector<int> r, T** decompressed, size_t* decompressed_len, void* params=nullptr) {
+    *decompressed = static_cast<T*>(DecompressRaw(SZTypeToTypeID<T>::value, bytes, bytes_len, r, decompressed_len, params));
+  }
+
+  template<class T>
+  void DecompressInto(const unsigned char* bytes, size_t bytes_len, std::vector<int> r, T* out, size_t out_len, void* params=nullptr) {
+    size_t len = 0;
+    if(Length(r) != out_len) {
+      throw std::invalid_argument("the output array has " + std::to_string(out_len) + " elements, the dimensions " + std::to_string(Length(r)) + " values");
     }
-    return std::vector<T>(decompressed, decompressed+len);
+    T* decompressed = static_cast<T*>(DecompressRaw(SZTypeToTypeID<T>::value, bytes, bytes_len, r, &len, params));
+    std::copy(decompressed, decompressed+len, out);
+    free(decompressed);
   }
 
   private:
+  /*
+   * Each call runs on private copies of the parameters (bound to the calling thread), so that several threads can
+   * use the compressor at the same time once the binding has released the GIL
+   */
+  class ThreadContext {
+    public:
+    ThreadContext(sz_params const& cpr, sz_exedata const& exe): cpr(cpr), exe(exe), ctx() {
+      memset(&dec, 0, sizeof(dec));
+      ctx.cpr = &this->cpr;
+      ctx.dec = &dec;
+      ctx.exe = &this->exe;
+      previous = SZ_bindThreadContext(&this->ctx);
+    }
+    ~ThreadContext() {
+      SZ_bindThreadContext(previous);
+    }
+    ThreadContext(ThreadContext const&)=delete;
+    ThreadContext& operator=(ThreadContext const&)=delete;
+
+    private:
+    sz_params cpr;
+    sz_params dec;
+    sz_exedata exe;
+    sz_thread_context ctx;
+    sz_thread_context* previous;
+  };
+
+  template<class T>
+  void Compress(T* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, unsigned char** compressed, size_t* compressed_len, void* params) {
+    int status = SZ_NSCS;
+    ThreadContext context(cpr, exe);
+    *compressed_len = 0;
+    *compressed = SZ_compress_customize(app.c_str(), params, SZTypeToTypeID<T>::value, data, r5, r4, r3, r2, r1, compressed_len, &status);
+    if(*compressed == nullptr || status != SZ_SCES) {
+      free(*compressed);
+      *compressed = nullptr;
+      throw std::runtime_error("SZ failed to compress the array");
+    }
+  }
+
+  template<class T>
+  std::string CompressString(T* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, void* params) {
+    unsigned char* compressed = nullptr;
+    size_t compressed_len = 0;
+    Compress(data, r5, r4, r3, r2, r1, &compressed, &compressed_len, params);
+    std::string bytes(reinterpret_cast<char*>(compressed), compressed_len);
+    free(compressed);
+    return bytes;
+  }
+
+  static size_t Length(std::vector<int> const& r) {
+    if(r.size() < 1 || r.size() > 4) {
+      throw std::invalid_argument(std::to_string(r.size()) + " dimensional arrays not supported");
+    }
+    size_t dims[4] = {0,0,0,0};
+    std::copy(r.begin(), r.end(), dims);
+    return computeDataLength(0, dims[3], dims[2], dims[1], dims[0]);
+  }
+
+  void* DecompressRaw(int dataType, const unsigned char* bytes, size_t bytes_len, std::vector<int> const& r, size_t* len, void* params) {
+    void* decompressed = nullptr;
+    int status = SZ_NSCS;
+    size_t dims[4] = {0,0,0,0};
+    *len = Length(r);
+    std::copy(r.begin(), r.end(), dims);
+    {
+      ThreadContext context(cpr, exe);
+      decompressed = SZ_decompress_customize(app.c_str(), params, dataType, const_cast<unsigned char*>(bytes), bytes_len, 0, dims[3], dims[2], dims[1], dims[0], &status);
+    }
+    if(decompressed == nullptr || status != SZ_SCES) {
+      free(decompressed);
+      *len = 0;
+      throw std::runtime_error("SZ failed to decompress the bytes");
+    }
+    return decompressed;
+  }
+
   std::string app;
+  sz_params cpr;
+  sz_exedata exe;
 };
@@ -33,7 +33,7 @@
  * official policies, either expressed or implied, of Robert Underwood.
  */
 
-%module pysz
+%module(threads="1") pysz
 %feature("autodoc", 1);
 
 %{
@@ -43,6 +43,10 @@
 #include "defines.h"
 #include <vector>
 #include <cstdint>
+
+static void pysz_free_capsule(PyObject* capsule) {
+  free(PyCapsule_GetPointer(capsule, NULL));
+}
 %}
 
 %init %{
@@ -51,8 +55,69 @@ import_array();
 
 %include <std_vector.i>
 %include <std_string.i>
+%include <exception.i>
 %include "numpy.i"
 
+//the errors of the compressor are raised as Python exceptions (after the GIL is taken back)
+%exception {
+  try {
+    $action
+  } catch (std::invalid_argument const& e) {
+    SWIG_exception(SWIG_ValueError, e.what());
+  } catch (std::exception const& e) {
+    SWIG_exception(SWIG_RuntimeError, e.what());
+  }
+}
+
+//the SZ calls of the compressor run without the GIL (see Compressor::ThreadContext); the builders
+//and the constructor/destructor of the compressor touch the process-wide state of SZ, so they keep it
+%nothread ConfigBuilder::ConfigBuilder;
+%nothread Compressor::Compressor;
+%nothread Compressor::~Compressor;
+
+//compressed bytes are accepted from any object exporting a contiguous buffer (bytes, bytearray, memoryview,
+//numpy arrays...) without copying them
+%typemap(in) (const unsigned char* bytes, size_t bytes_len) (Py_buffer view) {
+  view.obj = NULL;
+  if (PyObject_GetBuffer($input, &view, PyBUF_SIMPLE) != 0) SWIG_fail;
+  $1 = (unsigned char*) view.buf;
+  $2 = (size_t) view.len;
+}
+%typemap(freearg) (const unsigned char* bytes, size_t bytes_len) {
+  PyBuffer_Release(&view$argnum);
+}
+
+//arrays allocated by SZ are handed over to numpy, which releases them with free()
+%define %sz_argout_array(TYPE, TYPECODE, ARRAY, LEN)
+%typemap(in,numinputs=0) (TYPE** ARRAY, size_t* LEN) (TYPE* data_temp = NULL, size_t len_temp = 0) {
+  $1 = &data_temp;
+  $2 = &len_temp;
+}
+%typemap(argout) (TYPE** ARRAY, size_t* LEN) {
+  if (*$1 == NULL) {
+    PyErr_SetString(PyExc_RuntimeError, "SZ failed");
+    SWIG_fail;
+  }
+  npy_intp dims[1] = { (npy_intp) *$2 };
+  PyObject* obj = PyArray_SimpleNewFromData(1, dims, TYPECODE, (void*)(*$1));
+  if (!obj) SWIG_fail;
+  PyArray_SetBaseObject((PyArrayObject*) obj, PyCapsule_New((void*)(*$1), NULL, pysz_free_capsule));
+  $result = SWIG_Python_AppendOutput($result, obj);
+}
+%enddef
+
+%sz_argout_array(unsigned char, NPY_UINT8, compressed, compressed_len)
+%sz_argout_array(float, NPY_FLOAT32, decompressed, decompressed_len)
+%sz_argout_array(double, NPY_FLOAT64, decompressed, decompressed_len)
+%sz_argout_array(uint8_t, NPY_UINT8, decompressed, decompressed_len)
+%sz_argout_array(int8_t, NPY_INT8, decompressed, decompressed_len)
+%sz_argout_array(uint16_t, NPY_UINT16, decompressed, decompressed_len)
+%sz_argout_array(int16_t, NPY_INT16, decompressed, decompressed_len)
+%sz_argout_array(uint32_t, NPY_UINT32, decompressed, decompressed_len)
+%sz_argout_array(int32_t, NPY_INT32, decompressed, decompressed_len)
+%sz_argout_array(uint64_t, NPY_UINT64, decompressed, decompressed_len)
+%sz_argout_array(int64_t, NPY_INT64, decompressed, decompressed_len)
+
 namespace std {
   %template(vectori8) vector<int8_t>;
   %template(vectori16) vector<int16_t>;
@@ -107,6 +172,18 @@ namespace std {
 %apply (int64_t* INPLACE_ARRAY3, int DIM1, int DIM2, int DIM3 ) {(int64_t* data, size_t r1, size_t r2, size_t r3)}
 %apply (int64_t* INPLACE_ARRAY4, int DIM1, int DIM2, int DIM3, int DIM4 ) {(int64_t* data, size_t r1, size_t r2, size_t r3, size_t r4)}
 
+//the output of DecompressInto (DecompressArray with out=) is written in place
+%apply (float* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(float* out, size_t out_len)}
+%apply (double* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(double* out, size_t out_len)}
+%apply (uint8_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(uint8_t* out, size_t out_len)}
+%apply (int8_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(int8_t* out, size_t out_len)}
+%apply (uint16_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(uint16_t* out, size_t out_len)}
+%apply (int16_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(int16_t* out, size_t out_len)}
+%apply (uint32_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(uint32_t* out, size_t out_len)}
+%apply (int32_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(int32_t* out, size_t out_len)}
+%apply (uint64_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(uint64_t* out, size_t out_len)}
+%apply (int64_t* INPLACE_ARRAY_FLAT, int DIM_FLAT ) {(int64_t* out, size_t out_len)}
+
 
 %include "pysz.h"
 %include "defines.h"
@@ -156,10 +233,46 @@ namespace std {
   %template(CompressInt64_3) Compress3<int64_t>;
   %template(CompressInt64_4) Compress4<int64_t>;
 
-
-
-
-
+  %template(CompressArrayFloat1) CompressArray1<float>;
+  %template(CompressArrayFloat2) CompressArray2<float>;
+  %template(CompressArrayFloat3) CompressArray3<float>;
+  %template(CompressArrayFloat4) CompressArray4<float>;
+  %template(CompressArrayDouble1) CompressArray1<double>;
+  %template(CompressArrayDouble2) CompressArray2<double>;
+  %template(CompressArrayDouble3) CompressArray3<double>;
+  %template(CompressArrayDouble4) CompressArray4<double>;
+  %template(CompressArrayUInt8_1) CompressArray1<uint8_t>;
+  %template(CompressArrayUInt8_2) CompressArray2<uint8_t>;
+  %template(CompressArrayUInt8_3) CompressArray3<uint8_t>;
+  %template(CompressArrayUInt8_4) CompressArray4<uint8_t>;
+  %template(CompressArrayInt8_1) CompressArray1<int8_t>;
+  %template(CompressArrayInt8_2) CompressArray2<int8_t>;
+  %template(CompressArrayInt8_3) CompressArray3<int8_t>;
+  %template(CompressArrayInt8_4) CompressArray4<int8_t>;
+  %template(CompressArrayUInt16_1) CompressArray1<uint16_t>;
+  %template(CompressArrayUInt16_2) CompressArray2<uint16_t>;
+  %template(CompressArrayUInt16_3) CompressArray3<uint16_t>;
+  %template(CompressArrayUInt16_4) CompressArray4<uint16_t>;
+  %template(CompressArrayInt16_1) CompressArray1<int16_t>;
+  %template(CompressArrayInt16_2) CompressArray2<int16_t>;
+  %template(CompressArrayInt16_3) CompressArray3<int16_t>;
+  %template(CompressArrayInt16_4) CompressArray4<int16_t>;
+  %template(CompressArrayUInt32_1) CompressArray1<uint32_t>;
+  %template(CompressArrayUInt32_2) CompressArray2<uint32_t>;
+  %template(CompressArrayUInt32_3) CompressArray3<uint32_t>;
+  %template(CompressArrayUInt32_4) CompressArray4<uint32_t>;
+  %template(CompressArrayInt32_1) CompressArray1<int32_t>;
+  %template(CompressArrayInt32_2) CompressArray2<int32_t>;
+  %template(CompressArrayInt32_3) CompressArray3<int32_t>;
+  %template(CompressArrayInt32_4) CompressArray4<int32_t>;
+  %template(CompressArrayUInt64_1) CompressArray1<uint64_t>;
+  %template(CompressArrayUInt64_2) CompressArray2<uint64_t>;
+  %template(CompressArrayUInt64_3) CompressArray3<uint64_t>;
+  %template(CompressArrayUInt64_4) CompressArray4<uint64_t>;
+  %template(CompressArrayInt64_1) CompressArray1<int64_t>;
+  %template(CompressArrayInt64_2) CompressArray2<int64_t>;
+  %template(CompressArrayInt64_3) CompressArray3<int64_t>;
+  %template(CompressArrayInt64_4) CompressArray4<int64_t>;
 
   %template(DecompressFloat) Decompress<float>;
   %template(DecompressDouble) Decompress<double>;
@@ -172,6 +285,28 @@ namespace std {
   %template(DecompressUInt64) Decompress<uint64_t>;
   %template(DecompressInt64) Decompress<int64_t>;
 
+  %template(DecompressArrayFloat) DecompressArray<float>;
+  %template(DecompressArrayDouble) DecompressArray<double>;
+  %template(DecompressArrayUInt8) DecompressArray<uint8_t>;
+  %template(DecompressArrayInt8) DecompressArray<int8_t>;
+  %template(DecompressArrayUInt16) DecompressArray<uint16_t>;
+  %template(DecompressArrayInt16) DecompressArray<int16_t>;
+  %template(DecompressArrayUInt32) DecompressArray<uint32_t>;
+  %template(DecompressArrayInt32) DecompressArray<int32_t>;
+  %template(DecompressArrayUInt64) DecompressArray<uint64_t>;
+  %template(DecompressArrayInt64) DecompressArray<int64_t>;
+
+  %template(DecompressIntoFloat) DecompressInto<float>;
+  %template(DecompressIntoDouble) DecompressInto<double>;
+  %template(DecompressIntoUInt8) DecompressInto<uint8_t>;
+  %template(DecompressIntoInt8) DecompressInto<int8_t>;
+  %template(DecompressIntoUInt16) DecompressInto<uint16_t>;
+  %template(DecompressIntoInt16) DecompressInto<int16_t>;
+  %template(DecompressIntoUInt32) DecompressInto<uint32_t>;
+  %template(DecompressIntoInt32) DecompressInto<int32_t>;
+  %template(DecompressIntoUInt64) DecompressInto<uint64_t>;
+  %template(DecompressIntoInt64) DecompressInto<int64_t>;
+
   %pythoncode %{
     import numpy
 
@@ -218,6 +353,49 @@ namespace std {
       (4, numpy.dtype('int64')): CompressInt64_4,
     }
 
+    __CompressArray = {
+      (1, numpy.dtype('float64')): CompressArrayDouble1,
+      (2, numpy.dtype('float64')): CompressArrayDouble2,
+      (3, numpy.dtype('float64')): CompressArrayDouble3,
+      (4, numpy.dtype('float64')): CompressArrayDouble4,
+      (1, numpy.dtype('float32')): CompressArrayFloat1,
+      (2, numpy.dtype('float32')): CompressArrayFloat2,
+      (3, numpy.dtype('float32')): CompressArrayFloat3,
+      (4, numpy.dtype('float32')): CompressArrayFloat4,
+      (1, numpy.dtype('uint8')): CompressArrayUInt8_1,
+      (2, numpy.dtype('uint8')): CompressArrayUInt8_2,
+      (3, numpy.dtype('uint8')): CompressArrayUInt8_3,
+      (4, numpy.dtype('uint8')): CompressArrayUInt8_4,
+      (1, numpy.dtype('int8')): CompressArrayInt8_1,
+      (2, numpy.dtype('int8')): CompressArrayInt8_2,
+      (3, numpy.dtype('int8')): CompressArrayInt8_3,
+      (4, numpy.dtype('int8')): CompressArrayInt8_4,
+      (1, numpy.dtype('uint16')): CompressArrayUInt16_1,
+      (2, numpy.dtype('uint16')): CompressArrayUInt16_2,
+      (3, numpy.dtype('uint16')): CompressArrayUInt16_3,
+      (4, numpy.dtype('uint16')): CompressArrayUInt16_4,
+      (1, numpy.dtype('int16')): CompressArrayInt16_1,
+      (2, numpy.dtype('int16')): CompressArrayInt16_2,
+      (3, numpy.dtype('int16')): CompressArrayInt16_3,
+      (4, numpy.dtype('int16')): CompressArrayInt16_4,
+      (1, numpy.dtype('uint32')): CompressArrayUInt32_1,
+      (2, numpy.dtype('uint32')): CompressArrayUInt32_2,
+      (3, numpy.dtype('uint32')): CompressArrayUInt32_3,
+      (4, numpy.dtype('uint32')): CompressArrayUInt32_4,
+      (1, numpy.dtype('int32')): CompressArrayInt32_1,
+      (2, numpy.dtype('int32')): CompressArrayInt32_2,
+      (3, numpy.dtype('int32')): CompressArrayInt32_3,
+      (4, numpy.dtype('int32')): CompressArrayInt32_4,
+      (1, numpy.dtype('uint64')): CompressArrayUInt64_1,
+      (2, numpy.dtype('uint64')): CompressArrayUInt64_2,
+      (3, numpy.dtype('uint64')): CompressArrayUInt64_3,
+      (4, numpy.dtype('uint64')): CompressArrayUInt64_4,
+      (1, numpy.dtype('int64')): CompressArrayInt64_1,
+      (2, numpy.dtype('int64')): CompressArrayInt64_2,
+      (3, numpy.dtype('int64')): CompressArrayInt64_3,
+      (4, numpy.dtype('int64')): CompressArrayInt64_4,
+    }
+
     __Decompress = {
       numpy.dtype('float32'): DecompressFloat,
       numpy.float32: DecompressFloat,
@@ -246,6 +424,47 @@ namespace std {
       numpy.int64: DecompressInt64,
     }
 
+    __DecompressArray = {
+      numpy.dtype('float32'): DecompressArrayFloat,
+      numpy.float32: DecompressArrayFloat,
+
+      numpy.dtype('float64'): DecompressArrayDouble,
+      numpy.float64: DecompressArrayDouble,
+
+      numpy.dtype('uint8'): DecompressArrayUInt8,
+      numpy.uint8: DecompressArrayUInt8,
+      numpy.dtype('int8'): DecompressArrayInt8,
+      numpy.int8: DecompressArrayInt8,
+
+      numpy.dtype('uint16'): DecompressArrayUInt16,
+      numpy.uint16: DecompressArrayUInt16,
+      numpy.dtype('int16'): DecompressArrayInt16,
+      numpy.int16: DecompressArrayInt16,
+
+      numpy.dtype('uint32'): DecompressArrayUInt32,
+      numpy.uint32: DecompressArrayUInt32,
+      numpy.dtype('int32'): DecompressArrayInt32,
+      numpy.int32: DecompressArrayInt32,
+
+      numpy.dtype('uint64'): DecompressArrayUInt64,
+      numpy.uint64: DecompressArrayUInt64,
+      numpy.dtype('int64'): DecompressArrayInt64,
+      numpy.int64: DecompressArrayInt64,
+    }
+
+    __DecompressInto = {
+      numpy.dtype('float32'): DecompressIntoFloat,
+      numpy.dtype('float64'): DecompressIntoDouble,
+      numpy.dtype('uint8'): DecompressIntoUInt8,
+      numpy.dtype('int8'): DecompressIntoInt8,
+      numpy.dtype('uint16'): DecompressIntoUInt16,
+      numpy.dtype('int16'): DecompressIntoInt16,
+      numpy.dtype('uint32'): DecompressIntoUInt32,
+      numpy.dtype('int32'): DecompressIntoInt32,
+      numpy.dtype('uint64'): DecompressIntoUInt64,
+      numpy.dtype('int64'): DecompressIntoInt64,
+    }
+
     def Compress(self, array, userparams=None):
       length = len(array.shape)
       dtype = array.dtype
@@ -256,7 +475,25 @@ namespace std {
         values = self.__Decompress[dtype](self, bytes, list(dims), userparams)
         return self.numpy.reshape(values, dims)
       except KeyError as e:
-        raise TypeError("type {} not supported".format(i.args[0]))
+        raise TypeError("type {} not supported".format(e.args[0]))
+
+    def CompressArray(self, array, userparams=None):
+      """like Compress, but returns the compressed bytes as a uint8 numpy array, without copying them"""
+      length = len(array.shape)
+      dtype = array.dtype
+      return self.__CompressArray[length, dtype](self, array, userparams)
+
+    def DecompressArray(self, bytes, dims, dtype=None, userparams=None, out=None):
+      """like Decompress, but accepts any buffer (bytes, numpy array...) and returns the values without copying
+      them; when out is given, the values are written into it"""
+      try:
+        if out is not None:
+          self.__DecompressInto[out.dtype](self, bytes, list(dims), out, userparams)
+          return out
+        values = self.__DecompressArray[dtype](self, bytes, list(dims), userparams)
+        return values.reshape(dims)
+      except KeyError as e:
+        raise TypeError("type {} not supported".format(e.args[0]))
 
 
       
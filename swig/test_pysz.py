@@ -0,0 +1,58 @@
+#!/usr/bin/env python
+# -*- coding: utf-8 -*-
+
+import unittest
+import numpy as np
+import pysz
+
+ERR_BOUND = 1e-3
+
+
+class TestPysz(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        cls.compressor = pysz.Compressor(pysz.ConfigBuilder().errorBoundMode(pysz.ABS)
+                                         .absErrBound(ERR_BOUND).build())
+        x = np.arange(40*50, dtype=np.float32).reshape(40, 50)
+        cls.data = (np.sin(x*0.01) + np.cos(x*0.003)).astype(np.float32)
+
+    def test_compress_decompress(self):
+        compressed = self.compressor.Compress(self.data)
+        self.assertIsInstance(compressed, bytes)
+        values = self.compressor.Decompress(compressed, [50, 40], np.float32)
+        self.assertEqual(values.shape, (50, 40))
+        self.assertLessEqual(np.max(np.abs(values.ravel() - self.data.ravel())), ERR_BOUND)
+
+    def test_compress_decompress_array(self):
+        compressed = self.compressor.CompressArray(self.data)
+        self.assertEqual(compressed.dtype, np.uint8)
+        self.assertEqual(compressed.tobytes(), self.compressor.Compress(self.data))
+        for buffer in (compressed, compressed.tobytes(), memoryview(compressed)):
+            values = self.compressor.DecompressArray(buffer, [50, 40], np.float32)
+            self.assertEqual(values.dtype, np.float32)
+            self.assertLessEqual(np.max(np.abs(values.ravel() - self.data.ravel())), ERR_BOUND)
+
+    def test_decompress_into(self):
+        compressed = self.compressor.CompressArray(self.data)
+        out = np.zeros(self.data.shape, dtype=np.float32)
+        self.assertIs(self.compressor.DecompressArray(compressed, [50, 40], out=out), out)
+        self.assertLessEqual(np.max(np.abs(out - self.data)), ERR_BOUND)
+
+    def test_decompress_into_wrong_size(self):
+        compressed = self.compressor.CompressArray(self.data)
+        out = np.zeros(10, dtype=np.float32)
+        with self.assertRaises(ValueError):
+            self.compressor.DecompressArray(compressed, [50, 40], out=out)
+        self.assertFalse(out.any())
+
+    def test_unsupported_dimensions(self):
+        compressed = self.compressor.Compress(self.data)
+        with self.assertRaises(ValueError):
+            self.compressor.DecompressArray(compressed, [2, 2, 2, 25, 5], np.float32)
+        with self.assertRaises(ValueError):
+            self.compressor.Decompress(compressed, [2, 2, 2, 25, 5], np.float32)
+
+
+if __name__ == '__main__':
+    unittest.main()
@@ -32,12 +32,15 @@ typedef struct HuffmanTree {
 	node *qqq, *qq; //the root node of the HuffmanTree is qq[1]
 	int n_nodes; //n_nodes is for compression
 	int qend; 
-	unsigned long **code;
+	unsigned long **code; //the code of the state i is code[i][0..1] (left-aligned), or NULL if the state is not in the tree
+	unsigned long *codeTable; //the codes of all the states, 2 words per state: code[i] points to codeTable+2*i
 	unsigned char *cout;
 	int n_inode; //n_inode is for decompression
 	int maxBitCount;
 } HuffmanTree;
 
+struct sz_huffman_dict; //see sz_huffman_dict.h
+
 HuffmanTree* createHuffmanTree(int stateNum);
 HuffmanTree* createDefaultHuffmanTree();
 
@@ -47,6 +50,7 @@ void qinsert(HuffmanTree *huffmanTree, node n);
 node qremove(HuffmanTree *huffmanTree);
 void build_code(HuffmanTree *huffmanTree, node n, int len, unsigned long out1, unsigned long out2);
 void init(HuffmanTree *huffmanTree, int *s, size_t length);
+void init_fromHistogram(HuffmanTree *huffmanTree, size_t *freq, int minState, int maxState);
 void init_static(HuffmanTree *huffmanTree, int *s, size_t length);
 void encode(HuffmanTree *huffmanTree, int *s, size_t length, unsigned char *out, size_t *outSize);
 
@@ -63,9 +67,10 @@ void unpad_tree_uint(HuffmanTree* huffmanTree, unsigned int* L, unsigned int* R,
 node reconstruct_HuffTree_from_bytes_anyStates(HuffmanTree *huffmanTree, unsigned char* bytes, int nodeCount);
 
 void encode_withTree(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize);
+void encode_withInitTree(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize, struct sz_huffman_dict* dict);
 int encode_withTree_MSST19(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize);
-void decode_withTree(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out);
-void decode_withTree_MSST19(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out, int maxBits);
+int decode_withTree(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out);
+int decode_withTree_MSST19(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out, int maxBits);
 void SZ_ReleaseHuffman(HuffmanTree* huffmanTree);
 
 #ifdef __cplusplus
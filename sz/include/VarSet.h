@@ -16,20 +16,26 @@ extern "C" {
 
 #include <stdio.h>
 
+struct sz_huffman_dict;
+
 typedef struct sz_multisteps
 {
 	char compressionType;
 	int predictionMode;
 	int lastSnapshotStep; //the previous snapshot step
 	unsigned int currentStep; //current time step of the execution/simulation
+	double tsHitRatio; //sampled hit ratio of the previous-step prediction (SZ_ADAPTIVE_TEMPORAL_COMPRESSION)
+	double snapshotHitRatio; //sampled hit ratio of the Lorenzo prediction used by the snapshot compression
 	
 	//void* ori_data; //original data pointer, which serve as the key for retrieving hist_data
 	void* hist_data; //historical data in past time steps
+	struct sz_huffman_dict* cmprHuffmanDict; //the Huffman trees that the compressed steps of the variable can refer to
+	struct sz_huffman_dict* decHuffmanDict; //the same trees, rebuilt by the decompressor from the steps it decompressed
 } sz_multisteps;
 
 typedef struct SZ_Variable
 {
-	unsigned char var_id;
+	unsigned int var_id;
 	char* varName;
 	char compressType; //102 means HZ; 101 means SZ 
 	int dataType; //SZ_FLOAT or SZ_DOUBLE
@@ -47,13 +53,21 @@ typedef struct SZ_Variable
 	unsigned char* compressedBytes;
 	size_t compressedSize;
 	struct SZ_Variable* next;
+	struct SZ_Variable* prev;
+	struct SZ_Variable* idHashNext; //next variable in the same bucket of SZ_VarSet::idTable
+	struct SZ_Variable* nameHashNext; //next variable in the same bucket of SZ_VarSet::nameTable
 } SZ_Variable;
 
+/*The variables are kept in a doubly linked list (registration order, used for serialization), 
+ * and are indexed by two chained hash tables (by var_id and by varName) for O(1) lookup.*/
 typedef struct SZ_VarSet
 {
-	unsigned short count;
+	unsigned int count;
 	struct SZ_Variable *header;
 	struct SZ_Variable *lastVar;
+	size_t tableSize; //# buckets of each hash table (always a power of 2)
+	struct SZ_Variable **idTable;
+	struct SZ_Variable **nameTable;
 } SZ_VarSet;
 
 void free_Variable_keepOriginalData(SZ_Variable* v);
@@ -74,8 +88,12 @@ void free_VarSet_vset(SZ_VarSet *vset, int mode);
 void SZ_freeVarSet(int mode);
 
 void free_multisteps(sz_multisteps* multisteps);
-int checkVarID(unsigned char cur_var_id, unsigned char* var_ids, int var_count);
+int checkVarID(unsigned int cur_var_id, unsigned int* var_ids, int var_count);
+void sortVarIDs(unsigned int* var_ids, int var_count);
+int checkSortedVarID(unsigned int cur_var_id, unsigned int* sorted_var_ids, int var_count);
 SZ_Variable* SZ_getVariable(int var_id);
+SZ_Variable* SZ_getVariable_vset(SZ_VarSet* vset, unsigned int var_id);
+SZ_Variable* SZ_searchVar_vset(SZ_VarSet* vset, char* varName);
 
 #ifdef __cplusplus
 }
@@ -33,6 +33,7 @@
 #define ABS_OR_REL 3
 #define PSNR 4
 #define NORM 5
+#define FIXED_RATIO 6 //the error bound is searched for a target compression ratio (see SZ_estimate_errorBound)
 
 #define PW_REL 10
 #define ABS_AND_PW_REL 11
@@ -79,6 +80,12 @@
 #define SZ_FORCE_SNAPSHOT_COMPRESSION 0
 #define SZ_FORCE_TEMPORAL_COMPRESSION 1
 #define SZ_PERIO_TEMPORAL_COMPRESSION 2
+#define SZ_ADAPTIVE_TEMPORAL_COMPRESSION 3 //choose snapshot or temporal per step by the sampled prediction hit ratio
+
+//first byte of a time-step stream (SZ_compress_ts): SZ_TS_FORMAT_FLAG|version. The streams without it (version 0)
+//start with the big-endian time step, whose first byte is below SZ_TS_FORMAT_FLAG
+#define SZ_TS_FORMAT_FLAG 0x80
+#define SZ_TS_FORMAT_VERSION 1
 
 //SUCCESS returning status
 #define SZ_SCES 0  //successful
@@ -102,5 +109,6 @@
 
 #define GZIP_COMPRESSOR 0 //i.e., ZLIB_COMPRSSOR
 #define ZSTD_COMPRESSOR 1
+#define SECTIONED_COMPRESSOR 2 //Zstd or Gzip, section by section (see sz_sections.c)
 
 #endif /* _SZ_DEFINES_H */
@@ -6,6 +6,7 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdlib.h>
+#include "DynamicByteArray.h"
 
 typedef struct exafelSZ_params{
   uint8_t *peaks;
@@ -44,6 +45,29 @@ void* exafelSZ_Decompress(void *_pr,
                          size_t events, size_t panels, size_t rows, size_t cols,
                          size_t compressedSize);
 
+//Streaming compression of the events, batch by batch
+typedef struct exafelSZ_stream{
+  exafelSZ_params *pr;
+  size_t batchEvents; //number of events per compressed batch
+  size_t panels;
+  size_t rows;
+  size_t cols;
+
+  size_t nEvents; //number of events in the current batch
+  DynamicByteArray *peaks; //peaks of the events of the current batch (same layout as exafelSZ_params.peaks)
+  DynamicByteArray *roiData; //ROI pixels (float) of the events of the current batch
+  float *binnedData; //binned events of the current batch: batchEvents x panels x binnedRows x binnedCols
+  uint8_t *roiM; //ROI mask of one event
+  float *roiEvent; //ROI pixels of one event, panel by panel
+  size_t *roiCounts; //number of ROI pixels of every panel of one event
+} exafelSZ_stream;
+
+exafelSZ_stream* exafelSZ_stream_open(exafelSZ_params *pr, size_t batchEvents, size_t panels, size_t rows, size_t cols);
+int exafelSZ_stream_push(exafelSZ_stream *stream, float *eventData, uint8_t *eventPeaks,
+                         unsigned char **compressedBytes, size_t *compressedSize);
+int exafelSZ_stream_flush(exafelSZ_stream *stream, unsigned char **compressedBytes, size_t *compressedSize, size_t *nEvents);
+void exafelSZ_stream_close(exafelSZ_stream *stream);
+
 #ifdef __cplusplus
 }
 #endif
@@ -33,6 +33,7 @@
 #define MAX_PS_SIZE 100
 #define MAX_BLOCK_SIZE 10000
 #define MAX_BUFSIZE 160000  //Should be a multiple of 8
+#define PASTRI_INDEX_CHUNK 64 //Blocks compressed together into one buffer by SZ_pastriCompressBatchIndexed
 #define D_W 0 //Debug switch: Write (input block)
 #define D_R 0 //Debug switch: Read (compressed block)
 #define D_G 0 //Debug switch: General
@@ -121,6 +122,25 @@ void SZ_pastriCheckBatch(pastri_params *p,unsigned char*originalBuf,unsigned cha
 //OUTPUTS: None (Just some on-screen messages)
 //Compares originalBuf with decompressedBuf. Checks whether the absolute error condition is satisfied or not.
 
+int SZ_pastriCompressBatchIndexed(pastri_params *p,unsigned char *originalBuf, unsigned char** compressedBufP,size_t *compressedBytes);
+//INPUTS: p, originalBuf
+//OUTPUTS: compressedBufP, compressedBytes
+//Same as SZ_pastriCompressBatch, but the blocks are compressed in parallel (chunks of PASTRI_INDEX_CHUNK blocks,
+//with OpenMP) and the parameters are followed by a block index: the end offset (uint64_t) of every block in the
+//compressed blocks. The compressed blocks are the same as those of SZ_pastriCompressBatch.
+//Returns 0, or -1 (and *compressedBufP=NULL) if p->dataSize is neither 4 nor 8.
+
+int SZ_pastriDecompressBatchIndexed(unsigned char*compressedBuf, pastri_params *p, unsigned char** decompressedBufP ,size_t *decompressedBytes);
+//INPUTS: compressedBuf (from SZ_pastriCompressBatchIndexed)
+//OUTPUTS: p, decompressedBufP, decompressedBytes
+//Same as SZ_pastriDecompressBatch, with the blocks decompressed in parallel.
+//Returns 0, or -1 (and *decompressedBufP=NULL) if the dataSize of the batch is neither 4 nor 8.
+
+int SZ_pastriDecompressBlock(unsigned char*compressedBuf, int blockIndex, pastri_params *p, unsigned char* blockBuf);
+//INPUTS: compressedBuf (from SZ_pastriCompressBatchIndexed), blockIndex
+//OUTPUTS: p, blockBuf (p->bSize*p->dataSize bytes, allocated by the caller)
+//Decompresses only the block blockIndex. Returns 0, or -1 if blockIndex is out of range or the dataSize is not supported.
+
 /********************************************************************/
 //Other Includes:
 /********************************************************************/
@@ -54,11 +54,22 @@
 #include "pastri.h"
 #include "sz_float_ts.h"
 #include "szd_float_ts.h"
+#include "sz_double_ts.h"
+#include "szd_double_ts.h"
 #include "utility.h"
 #include "CacheTable.h"
 #include "MultiLevelCacheTable.h"
 #include "MultiLevelCacheTableWideInterval.h"
 #include "exafelSZ.h"
+#include "sz_stats.h"
+#include "sz_estimate.h"
+#include "sz_progressive.h"
+#include "sz_lowres.h"
+#include "sz_histogram.h"
+#include "sz_huffman_dict.h"
+#include "sz_zstd_dict.h"
+#include "sz_sections.h"
+#include "sz_unpred.h"
 
 #ifdef _WIN32
 #define PATH_SEPARATOR ';'
@@ -175,6 +186,8 @@ typedef struct sz_params
 	double relBoundRatio; //value range based relative error bound ratio
 	double psnr; //PSNR
 	double normErr;
+	double fixedRatio; //target compression ratio (FIXED_RATIO)
+	double fixedBitRate; //target bits per value (FIXED_RATIO, when fixedRatio is 0)
 	double pw_relBoundRatio; //point-wise relative error bound
 	int segment_size; //only used for 2D/3D data compression with pw_relBoundRatio (deprecated)
 	int pwr_type; //only used for 2D/3D data compression with pw_relBoundRatio
@@ -184,6 +197,7 @@ typedef struct sz_params
 	double dmin, dmax;
 	
 	int snapshotCmprStep; //perform single-snapshot-based compression if time_step == snapshotCmprStep
+	int reuseHuffmanTrees; //1: in SZ_compress_ts, the steps of a variable refer to the Huffman trees of the previous steps since its last snapshot (0 by default)
 	int predictionMode;
 
 	int accelerate_pw_rel_compression;
@@ -191,6 +205,15 @@ typedef struct sz_params
 	
 	int randomAccess;
 	int withRegression;
+	int regressionBlockSize; //edge of the regression blocks (0: 6 in 3D, 16 in 2D; 2 to 40)
+	double regressionCoeffErr; //error bound of the regression coefficients, relative to the error bound (0: 0.025 in 3D, 0.05 in 2D)
+	
+	int autotune; //SZ_TUNE_NONE, SZ_TUNE_MAX_RATIO or SZ_TUNE_MAX_SPEED (see SZ_autotune)
+	double tuneMinThroughput; //compression throughput floor in MB/s for SZ_TUNE_MAX_RATIO (0: none)
+	double tuneMinRatio; //compression ratio floor for SZ_TUNE_MAX_SPEED
+	
+	double losslessMinGain; //the lossless stage is skipped if it saves less than this fraction of its input on samples (0: never skipped)
+	int losslessSections; //1: the lossless stage codes the sections of the SZ bytes separately (see sz_sections.c)
 	
 } sz_params;
 
@@ -228,6 +251,26 @@ typedef struct sz_tsc_metainfo
 
 extern int versionNumber[4];
 
+#if defined(_MSC_VER)
+#define SZ_THREAD_LOCAL __declspec(thread)
+#else
+#define SZ_THREAD_LOCAL __thread
+#endif
+
+/*The compressions and decompressions of a thread that binds its own context (see SZ_bindThreadContext) use 
+ * the parameters of that context, instead of the process-wide confparams_cpr, confparams_dec and exe_params 
+ * set by SZ_Init. This is what allows the batch engine to compress several variables concurrently.*/
+typedef struct sz_thread_context
+{
+	struct sz_params* cpr;
+	struct sz_params* dec;
+	sz_exedata* exe;
+	sz_perf_stats* stats; //optional: where the stage timings of the compressions are recorded (see SZ_get_last_stats)
+	struct sz_huffman_dict* huffmanDict; //optional: the Huffman trees reused by the compressions (see SZ_setHuffmanDict)
+	struct sz_zstd_dict* zstdDict; //optional: the dictionary of the Zstd lossless stage (see SZ_setZstdDict)
+	sz_multisteps* multisteps; //optional: the time-step state of the variable being compressed (batch engine)
+} sz_thread_context;
+
 //-------------------key global variables--------------
 extern int dataEndianType; //*endian type of the data read from disk
 extern int sysEndianType; //*sysEndianType is actually set automatically.
@@ -253,6 +296,8 @@ int SZ_Init(const char *configFilePath);
 
 int SZ_Init_Params(sz_params *params);
 
+void SZ_setDefaultParams(sz_params* params, sz_exedata* exe);
+
 size_t computeDataLength(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 
 int computeDimension(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
@@ -274,6 +319,8 @@ unsigned char *SZ_compress(int dataType, void *data, size_t *outSize, size_t r5,
 unsigned char* SZ_compress_args(int dataType, void *data, size_t *outSize, int errBoundMode, double absErrBound, 
 double relBoundRatio, double pwrBoundRatio, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 
+unsigned char* SZ_compress_args_fixedRatio(int cmprType, int dataType, void *data, size_t *outSize, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+
 int SZ_compress_args2(int dataType, void *data, unsigned char* compressed_bytes, size_t *outSize, 
 int errBoundMode, double absErrBound, double relBoundRatio, double pwrBoundRatio, 
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
@@ -311,13 +358,19 @@ int SZ_deregisterVar_ID(int var_id);
 int SZ_deregisterVar(char* varName);
 int SZ_deregisterAllVars();
 
-int SZ_compress_ts_select_var(int cmprType, unsigned char* var_ids, unsigned char var_count, unsigned char** newByteData, size_t *outSize);
+int SZ_compress_ts_select_var(int cmprType, unsigned int* var_ids, unsigned int var_count, unsigned char** newByteData, size_t *outSize);
 int SZ_compress_ts(int cmprType, unsigned char** newByteData, size_t *outSize);
-void SZ_decompress_ts_select_var(unsigned char* var_ids, unsigned char var_count, unsigned char *bytes, size_t bytesLength);
-void SZ_decompress_ts(unsigned char *bytes, size_t byteLength);
+int SZ_decompress_ts_select_var(unsigned int* var_ids, unsigned int var_count, unsigned char *bytes, size_t bytesLength);
+int SZ_decompress_ts(unsigned char *bytes, size_t byteLength);
 
 void SZ_Finalize();
 
+sz_thread_context* SZ_bindThreadContext(sz_thread_context* ctx);
+sz_params* SZ_getParams_cpr();
+sz_params* SZ_getParams_dec();
+sz_exedata* SZ_getExeParams();
+int SZ_get_last_stats(sz_thread_context* ctx, sz_perf_stats* stats);
+
 void convertSZParamsToBytes(sz_params* params, unsigned char* result);
 void convertBytesToSZParams(unsigned char* bytes, sz_params* params);
 
@@ -0,0 +1,376 @@
+/**
+ *  @file sz.hpp
+ *  @brief Header-only C++ interface of SZ.
+ *
+ *  sz::Compressor<T, N> compresses N-dimensional arrays of T. The typed kernel is selected at compile time,
+ *  and every compressor owns its parameters (bound to the calling thread during each call), so that
+ *  compressors can be used concurrently and do not depend on SZ_Init/SZ_Finalize. They still share two
+ *  process-wide globals of SZ: sysEndianType, the byte order of the host (set once, by the first compressor
+ *  created), and dataEndianType, which the decompressor reads from the header of each stream.
+ *
+ *  Example:
+ *		sz::Compressor<float, 3> compressor;
+ *		compressor.params().errorBoundMode = ABS;
+ *		compressor.params().absErrBound = 1E-4;
+ *		std::vector<unsigned char> bytes = compressor.compress(sz::make_view(data, nz, ny, nx));
+ *		std::vector<float> values = compressor.decompress(sz::make_view(bytes), {nz, ny, nx});
+ *
+ *  (C) 2020 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_HPP
+#define _SZ_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+#include "sz.h"
+
+namespace sz {
+
+enum class status
+{
+	ok = 0,
+	invalid_argument, //the extents are empty, or do not match the output
+	buffer_too_small, //the output buffer is smaller than the compressed data
+	failed //the compression/decompression failed
+};
+
+class error : public std::runtime_error
+{
+public:
+	error(status code, const char* what) : std::runtime_error(what), code(code) {}
+	status code;
+};
+
+/**
+ * Non-owning view of a contiguous buffer.
+ * */
+template<class T>
+class span
+{
+public:
+	span(T* data, std::size_t size) noexcept : data_(data), size_(size) {}
+	template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	span(const span<U>& other) noexcept : data_(other.data()), size_(other.size()) {}
+	template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	span(std::vector<U>& v) noexcept : data_(v.data()), size_(v.size()) {}
+	template<class U, class = typename std::enable_if<std::is_convertible<const U*, T*>::value>::type>
+	span(const std::vector<U>& v) noexcept : data_(v.data()), size_(v.size()) {}
+
+	T* data() const noexcept {return data_;}
+	std::size_t size() const noexcept {return size_;}
+
+private:
+	T* data_;
+	std::size_t size_;
+};
+
+/**
+ * Non-owning view of a row-major N-dimensional array: extent(0) is the slowest dimension,
+ * extent(N-1) the fastest one (r1 in the C interface).
+ * */
+template<class T, std::size_t N>
+class array_view
+{
+public:
+	array_view(T* data, const std::array<std::size_t, N>& extents) noexcept : data_(data), extents_(extents) {}
+	template<class U, class = typename std::enable_if<std::is_convertible<U*, T*>::value>::type>
+	array_view(const array_view<U, N>& other) noexcept : data_(other.data()), extents_(other.extents()) {}
+
+	T* data() const noexcept {return data_;}
+	const std::array<std::size_t, N>& extents() const noexcept {return extents_;}
+	std::size_t extent(std::size_t i) const noexcept {return extents_[i];}
+	std::size_t size() const noexcept
+	{
+		std::size_t n = 1;
+		for(std::size_t i = 0; i < N; i++)
+			n *= extents_[i];
+		return n;
+	}
+
+private:
+	T* data_;
+	std::array<std::size_t, N> extents_;
+};
+
+template<class T, class... Extents>
+array_view<T, sizeof...(Extents)> make_view(T* data, Extents... extents) noexcept
+{
+	return array_view<T, sizeof...(Extents)>(data, {{static_cast<std::size_t>(extents)...}});
+}
+
+template<class T>
+span<T> make_view(std::vector<T>& v) noexcept {return span<T>(v);}
+
+template<class T>
+span<const T> make_view(const std::vector<T>& v) noexcept {return span<const T>(v);}
+
+namespace detail {
+
+/**
+ * The typed kernels of SZ: SZ_compress_args/SZ_decompress dispatch on dataType at runtime,
+ * here the specialization is picked by the compiler.
+ * */
+template<class T>
+struct kernel;
+
+template<>
+struct kernel<float>
+{
+	static constexpr int type = SZ_FLOAT;
+	static int compress(unsigned char** out, float* data, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2, std::size_t r1,
+		std::size_t* outSize, const sz_params& p)
+	{
+		return SZ_compress_args_float(-1, out, data, r5, r4, r3, r2, r1, outSize, p.errorBoundMode, p.absErrBound, p.relBoundRatio, p.pw_relBoundRatio);
+	}
+	static int decompress(float** out, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2, std::size_t r1, unsigned char* bytes, std::size_t n)
+	{
+		return SZ_decompress_args_float(out, r5, r4, r3, r2, r1, bytes, n, 0, NULL);
+	}
+};
+
+template<>
+struct kernel<double>
+{
+	static constexpr int type = SZ_DOUBLE;
+	static int compress(unsigned char** out, double* data, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2, std::size_t r1,
+		std::size_t* outSize, const sz_params& p)
+	{
+		return SZ_compress_args_double(-1, out, data, r5, r4, r3, r2, r1, outSize, p.errorBoundMode, p.absErrBound, p.relBoundRatio, p.pw_relBoundRatio);
+	}
+	static int decompress(double** out, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2, std::size_t r1, unsigned char* bytes, std::size_t n)
+	{
+		return SZ_decompress_args_double(out, r5, r4, r3, r2, r1, bytes, n, 0, NULL);
+	}
+};
+
+#define SZ_HPP_INTEGER_KERNEL(T, ID, NAME)                                                                                    \
+	template<>                                                                                                                \
+	struct kernel<T>                                                                                                          \
+	{                                                                                                                         \
+		static constexpr int type = ID;                                                                                       \
+		static int compress(unsigned char** out, T* data, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2,    \
+			std::size_t r1, std::size_t* outSize, const sz_params& p)                                                         \
+		{                                                                                                                     \
+			return SZ_compress_args_##NAME(out, data, r5, r4, r3, r2, r1, outSize, p.errorBoundMode, p.absErrBound,           \
+				p.relBoundRatio);                                                                                             \
+		}                                                                                                                     \
+		static int decompress(T** out, std::size_t r5, std::size_t r4, std::size_t r3, std::size_t r2, std::size_t r1,      \
+			unsigned char* bytes, std::size_t n)                                                                              \
+		{                                                                                                                     \
+			return SZ_decompress_args_##NAME(out, r5, r4, r3, r2, r1, bytes, n);                                              \
+		}                                                                                                                     \
+	};
+
+SZ_HPP_INTEGER_KERNEL(int8_t, SZ_INT8, int8)
+SZ_HPP_INTEGER_KERNEL(int16_t, SZ_INT16, int16)
+SZ_HPP_INTEGER_KERNEL(int32_t, SZ_INT32, int32)
+SZ_HPP_INTEGER_KERNEL(int64_t, SZ_INT64, int64)
+SZ_HPP_INTEGER_KERNEL(uint8_t, SZ_UINT8, uint8)
+SZ_HPP_INTEGER_KERNEL(uint16_t, SZ_UINT16, uint16)
+SZ_HPP_INTEGER_KERNEL(uint32_t, SZ_UINT32, uint32)
+SZ_HPP_INTEGER_KERNEL(uint64_t, SZ_UINT64, uint64)
+
+#undef SZ_HPP_INTEGER_KERNEL
+
+/**
+ * Sets sysEndianType to the byte order of the host (the same value for every thread).
+ * */
+inline bool detect_host() noexcept
+{
+	int x = 1;
+	sysEndianType = *reinterpret_cast<char*>(&x) == 1 ? LITTLE_ENDIAN_SYSTEM : BIG_ENDIAN_SYSTEM;
+	return true;
+}
+
+/**
+ * Binds private parameters to the calling thread for the lifetime of the object (see SZ_bindThreadContext).
+ * */
+class context_binding
+{
+public:
+	context_binding(sz_params* cpr, sz_params* dec, sz_exedata* exe) noexcept : ctx_()
+	{
+		//the optional fields (stats, dictionaries) stay null
+		ctx_.cpr = cpr;
+		ctx_.dec = dec;
+		ctx_.exe = exe;
+		previous_ = SZ_bindThreadContext(&ctx_);
+	}
+	~context_binding() {SZ_bindThreadContext(previous_);}
+	context_binding(const context_binding&) = delete;
+	context_binding& operator=(const context_binding&) = delete;
+
+private:
+	sz_thread_context ctx_;
+	sz_thread_context* previous_;
+};
+
+struct free_deleter
+{
+	void operator()(void* p) const noexcept {free(p);}
+};
+
+//map the extents (slowest first) to r5..r1 of the C interface
+template<std::size_t N>
+void to_dims(const std::array<std::size_t, N>& extents, std::size_t r[5]) noexcept
+{
+	for(std::size_t i = 0; i < 5; i++)
+		r[i] = 0;
+	for(std::size_t i = 0; i < N; i++)
+		r[5-N+i] = extents[i];
+}
+
+} //namespace detail
+
+template<class T, std::size_t N>
+class Compressor
+{
+	static_assert(N >= 1 && N <= 5, "SZ supports 1 to 5 dimensions");
+
+public:
+	using value_type = T;
+	static constexpr std::size_t rank = N;
+
+	/**
+	 * Default configuration (the one of SZ_Init(NULL)).
+	 * */
+	Compressor() noexcept
+	{
+		SZ_setDefaultParams(&params_, &exe_);
+		static const bool hostDetected = detail::detect_host(); //once (thread-safe), for all the compressors
+		(void)hostDetected;
+	}
+
+	/**
+	 * @param params the parameters, normalized like SZ_Init_Params() does
+	 * */
+	explicit Compressor(const sz_params& params) noexcept : Compressor()
+	{
+		params_ = params;
+		if(params_.losslessCompressor != GZIP_COMPRESSOR && params_.losslessCompressor != ZSTD_COMPRESSOR)
+			params_.losslessCompressor = ZSTD_COMPRESSOR;
+		if(params_.max_quant_intervals > 0)
+			params_.maxRangeRadius = params_.max_quant_intervals/2;
+		exe_.intvCapacity = params_.maxRangeRadius*2;
+		exe_.intvRadius = params_.maxRangeRadius;
+	}
+
+	sz_params& params() noexcept {return params_;}
+	const sz_params& params() const noexcept {return params_;}
+
+	/**
+	 * Upper bound of the compressed size of an array with these extents: SZ falls back to storing the
+	 * values as they are (plus the header), and the lossless stage may add a few bytes on top of that.
+	 * */
+	static std::size_t compress_bound(const std::array<std::size_t, N>& extents) noexcept
+	{
+		std::size_t bytes = sizeof(T);
+		for(std::size_t i = 0; i < N; i++)
+			bytes *= extents[i];
+		return bytes + bytes/128 + 1024;
+	}
+
+	/**
+	 * Compress into a buffer provided by the caller (sized with compress_bound()).
+	 * @param outSize the number of bytes written into out
+	 * */
+	status compress(array_view<const T, N> in, span<unsigned char> out, std::size_t& outSize) const noexcept
+	{
+		std::unique_ptr<unsigned char, detail::free_deleter> bytes;
+		status s = compress_raw(in, bytes, outSize);
+		if(s != status::ok)
+			return s;
+		if(outSize > out.size())
+			return status::buffer_too_small;
+		memcpy(out.data(), bytes.get(), outSize);
+		return status::ok;
+	}
+
+	std::vector<unsigned char> compress(array_view<const T, N> in) const
+	{
+		std::unique_ptr<unsigned char, detail::free_deleter> bytes;
+		std::size_t outSize = 0;
+		status s = compress_raw(in, bytes, outSize);
+		if(s != status::ok)
+			throw error(s, "SZ compression failed");
+		return std::vector<unsigned char>(bytes.get(), bytes.get()+outSize);
+	}
+
+	/**
+	 * Decompress into an array provided by the caller, whose extents must be those of the compressed array.
+	 * */
+	status decompress(span<const unsigned char> in, array_view<T, N> out) const noexcept
+	{
+		std::unique_ptr<T, detail::free_deleter> values;
+		status s = decompress_raw(in, out.extents(), values);
+		if(s == status::ok)
+			memcpy(out.data(), values.get(), out.size()*sizeof(T));
+		return s;
+	}
+
+	std::vector<T> decompress(span<const unsigned char> in, const std::array<std::size_t, N>& extents) const
+	{
+		std::unique_ptr<T, detail::free_deleter> values;
+		status s = decompress_raw(in, extents, values);
+		if(s != status::ok)
+			throw error(s, "SZ decompression failed");
+		return std::vector<T>(values.get(), values.get()+array_view<T, N>(nullptr, extents).size());
+	}
+
+private:
+	status compress_raw(array_view<const T, N> in, std::unique_ptr<unsigned char, detail::free_deleter>& bytes, std::size_t& outSize) const noexcept
+	{
+		std::size_t r[5];
+		detail::to_dims(in.extents(), r);
+		outSize = 0;
+		if(in.size() == 0)
+			return status::invalid_argument;
+
+		//the kernels may adjust the parameters (e.g. the error bound), so each call works on copies
+		sz_params cpr = params_, dec;
+		sz_exedata exe = exe_;
+		memset(&dec, 0, sizeof(dec));
+		cpr.dataType = detail::kernel<T>::type;
+		detail::context_binding binding(&cpr, &dec, &exe);
+
+		unsigned char* out = NULL;
+		int state = detail::kernel<T>::compress(&out, const_cast<T*>(in.data()), r[0], r[1], r[2], r[3], r[4], &outSize, cpr);
+		bytes.reset(out);
+		return state == SZ_SCES && out != NULL ? status::ok : status::failed;
+	}
+
+	status decompress_raw(span<const unsigned char> in, const std::array<std::size_t, N>& extents, std::unique_ptr<T, detail::free_deleter>& values) const noexcept
+	{
+		std::size_t r[5];
+		detail::to_dims(extents, r);
+		if(in.size() == 0 || array_view<T, N>(nullptr, extents).size() == 0)
+			return status::invalid_argument;
+
+		sz_params cpr = params_, dec;
+		sz_exedata exe;
+		memset(&dec, 0, sizeof(dec));
+		memset(&exe, 0, sizeof(exe));
+		exe.SZ_SIZE_TYPE = 8;
+		detail::context_binding binding(&cpr, &dec, &exe);
+
+		T* out = NULL;
+		int state = detail::kernel<T>::decompress(&out, r[0], r[1], r[2], r[3], r[4], const_cast<unsigned char*>(in.data()), in.size());
+		values.reset(out);
+		return state == SZ_SCES && out != NULL ? status::ok : status::failed;
+	}
+
+	sz_params params_;
+	sz_exedata exe_;
+};
+
+} //namespace sz
+
+#endif /* ----- #ifndef _SZ_HPP  ----- */
@@ -19,6 +19,8 @@ unsigned int optimize_intervals_double_1D_ts(double *oriData, size_t dataLength,
 TightDataPointStorageD* SZ_compress_double_1D_MDQ_ts(double *oriData, size_t dataLength, sz_multisteps* multisteps,
 double realPrecision, double valueRangeSize, double medianValue_d);
 
+char SZ_decide_compressionType_double_ts(int cmprType, double *oriData, size_t r1, size_t r2, size_t r3, sz_multisteps* multisteps, double realPrecision);
+
 #ifdef __cplusplus
 }
 #endif
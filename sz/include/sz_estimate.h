@@ -0,0 +1,53 @@
+/**
+ *  @file sz_estimate.h
+ *  @brief Header file for the sz_estimate.c (estimation and autotuning of the compression).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_ESTIMATE_H
+#define _SZ_ESTIMATE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_ESTIMATE_SAMPLE_RATE 0.01 //fraction of the data that is sampled (by blocks)
+#define SZ_ESTIMATE_MIN_BLOCKS 64 //sample at least this many blocks (or all of them)
+#define SZ_FIXED_RATIO_TOLERANCE 0.05 //relative tolerance on the compressed size in the FIXED_RATIO mode
+#define SZ_FIXED_RATIO_MAX_STEPS 8 //estimations in the search of the error bound
+
+//objectives of SZ_autotune (sz_params.autotune)
+#define SZ_TUNE_NONE 0
+#define SZ_TUNE_MAX_RATIO 1 //maximize the compression ratio (above a throughput floor)
+#define SZ_TUNE_MAX_SPEED 2 //maximize the compression throughput (above a ratio floor)
+
+/*Predicted outcome of a compression, see SZ_estimate()*/
+typedef struct sz_estimation
+{
+	double ratio; //compression ratio
+	double bitRate; //bits per value
+	double psnr;
+	double errorBound; //the absolute error bound the compression would use
+	double compressTime; //predicted compression time (seconds)
+	double estimateTime; //time spent in SZ_estimate (seconds)
+	double predictableRate; //fraction of the sampled values within the quantization range
+	double regressionRate; //fraction of the sampled blocks predicted by linear regression
+	double losslessRatio; //gain of the lossless stage on the Huffman codes (1 in SZ_BEST_SPEED mode)
+	unsigned int intervals; //number of quantization intervals
+	size_t sampleCount; //number of sampled values
+} sz_estimation;
+
+struct sz_params;
+
+int SZ_estimate(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, struct sz_params* params, sz_estimation* est);
+int SZ_estimate_errorBound(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, struct sz_params* params, double targetRatio, double* absErrBound, sz_estimation* est);
+int SZ_autotune(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, struct sz_params* params, sz_estimation* est);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_ESTIMATE_H  ----- */
@@ -85,7 +85,7 @@ unsigned char * SZ_compress_float_1D_MDQ_decompression_random_access_with_blocke
 
 TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, float valueRangeSize, float medianValue_f);
 
-char SZ_compress_args_float_NoCkRngeNoGzip_4D(unsigned char** newByteData, float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, float valueRangeSize, float medianValue_f);
+char SZ_compress_args_float_NoCkRngeNoGzip_4D(int cmprType, unsigned char** newByteData, float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, float valueRangeSize, float medianValue_f);
 
 TightDataPointStorageF* SZ_compress_float_1D_MDQ_MSST19(float *oriData, 
 size_t dataLength, double realPrecision, float valueRangeSize, float medianValue_f);
@@ -19,6 +19,8 @@ unsigned int optimize_intervals_float_1D_ts(float *oriData, size_t dataLength, f
 TightDataPointStorageF* SZ_compress_float_1D_MDQ_ts(float *oriData, size_t dataLength, sz_multisteps* multisteps,
 double realPrecision, float valueRangeSize, float medianValue_f);
 
+char SZ_decide_compressionType_float_ts(int cmprType, float *oriData, size_t r1, size_t r2, size_t r3, sz_multisteps* multisteps, double realPrecision);
+
 #ifdef __cplusplus
 }
 #endif
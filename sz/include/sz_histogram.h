@@ -0,0 +1,27 @@
+/**
+ *  @file sz_histogram.h
+ *  @brief Header file for the sz_histogram.c (frequencies of the quantization codes).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_HISTOGRAM_H
+#define _SZ_HISTOGRAM_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_HISTOGRAM_TABLES 4 //interleaved counter tables per thread
+#define SZ_HISTOGRAM_THREAD_MIN_LENGTH 65536 //the smallest number of states counted by one thread
+
+size_t* SZ_histogram(const int* s, size_t length, size_t nbStates, int* minState, int* maxState);
+void SZ_histogram_full(const int* s, size_t length, size_t* freq, size_t nbStates);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_HISTOGRAM_H  ----- */
@@ -0,0 +1,64 @@
+/**
+ *  @file sz_huffman_dict.h
+ *  @brief Header file for the sz_huffman_dict.c (Huffman trees reused across compressions).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_HUFFMAN_DICT_H
+#define _SZ_HUFFMAN_DICT_H
+
+#include <stddef.h>
+#include "Huffman.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_HUFFMAN_DICT_MAX_TREES 16
+
+//flag on the number of intervals of an encoded stream: the tree is not in the stream, but in the dictionary
+#define SZ_HUFFMAN_TREE_REF 0x80000000u
+#define SZ_HUFFMAN_TREE_REF_SIZE 12 //nodeCount, intervals|SZ_HUFFMAN_TREE_REF and the id of the tree
+
+typedef struct sz_huffman_dict_tree
+{
+	unsigned int id; //hash of the serialized tree
+	unsigned int intervals;
+	int nodeCount;
+	unsigned int treeByteSize;
+	unsigned char* treeBytes; //as written by convert_HuffTree_to_bytes_anyStates
+	unsigned char* cout; //code lengths of the 2*intervals states (0: not in the tree), built when first needed by the encoder
+	unsigned long* codeTable;
+	int maxBits;
+	size_t lastUse;
+} sz_huffman_dict_tree;
+
+/*The trees already emitted (or seen by the decompressor), which the next streams can refer to by id*/
+typedef struct sz_huffman_dict
+{
+	double driftThreshold; //a tree is reused while the bits per code lost with it, compared to a new tree, are at most this (0: automatic)
+	int nbTrees;
+	size_t clock; //for the least recently used tree, replaced when the dictionary is full
+	size_t reused, built; //number of streams encoded with a tree of the dictionary, and with a new tree
+	sz_huffman_dict_tree trees[SZ_HUFFMAN_DICT_MAX_TREES];
+} sz_huffman_dict;
+
+sz_huffman_dict* SZ_createHuffmanDict(double driftThreshold);
+void SZ_freeHuffmanDict(sz_huffman_dict* dict);
+sz_huffman_dict* SZ_setHuffmanDict(sz_huffman_dict* dict);
+int SZ_exportHuffmanDict(sz_huffman_dict* dict, unsigned char** bytes, size_t* byteLength);
+sz_huffman_dict* SZ_importHuffmanDict(unsigned char* bytes, size_t byteLength, double driftThreshold);
+
+sz_huffman_dict* sz_huffman_dict_current();
+sz_huffman_dict* sz_huffman_dict_swap(sz_huffman_dict* dict);
+void sz_huffman_dict_reset(sz_huffman_dict* dict);
+sz_huffman_dict_tree* sz_huffman_dict_add(sz_huffman_dict* dict, unsigned int intervals, int nodeCount, unsigned char* treeBytes, unsigned int treeByteSize);
+sz_huffman_dict_tree* sz_huffman_dict_find(sz_huffman_dict* dict, unsigned int id);
+void sz_huffman_dict_encode(sz_huffman_dict* dict, HuffmanTree* huffmanTree, int* s, size_t length, unsigned char** out, size_t* outSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_HUFFMAN_DICT_H  ----- */
@@ -0,0 +1,30 @@
+/**
+ *  @file sz_lowres.h
+ *  @brief Header file for the sz_lowres.c (low-resolution decompression).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_LOWRES_H
+#define _SZ_LOWRES_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//modes of SZ_decompress_lowres
+#define SZ_LOWRES_STRIDED 0 //the values at every stride-th point along each dimension
+#define SZ_LOWRES_AVERAGED 1 //the averages over the boxes of stride points along each dimension
+
+#define SZ_LOWRES_DIM(r, stride) ((r) == 0 ? 0 : ((r) - 1)/(stride) + 1) //a dimension of the low-resolution field
+
+void* SZ_decompress_lowres(int dataType, unsigned char* bytes, size_t byteLength, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1,
+int mode, size_t stride, int* fromCoefficients);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_LOWRES_H  ----- */
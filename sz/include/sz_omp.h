@@ -21,6 +21,11 @@
 extern "C" {
 #endif
 
+double sz_wtime();
+int sz_get_max_threads();
+int sz_get_thread_num();
+void sz_set_num_threads(int nthreads);
+
 unsigned char * SZ_compress_float_1D_MDQ_openmp(float *oriData, size_t r1, double realPrecision, size_t * comp_size);
 unsigned char * SZ_compress_float_2D_MDQ_openmp(float *oriData, size_t r1, size_t r2, double realPrecision, size_t * comp_size);
 unsigned char * SZ_compress_float_3D_MDQ_openmp(float *oriData, size_t r1, size_t r2, size_t r3, float realPrecision, size_t * comp_size);
@@ -38,7 +43,7 @@ void decompressDataSeries_double_2D_openmp(double** data, size_t r1, size_t r2,
 void decompressDataSeries_double_3D_openmp(double** data, size_t r1, size_t r2, size_t r3, unsigned char* comp_data);
 
 //void Huffman_init_openmp(HuffmanTree* huffmanTree, int *s, size_t length, int thread_num);
-void Huffman_init_openmp(HuffmanTree* huffmanTree, int *s, size_t length, int thread_num, size_t * freq);
+void Huffman_init_openmp(HuffmanTree* huffmanTree, int *s, size_t length, int thread_num, size_t * freq); //freq is unused (may be NULL)
 
 #ifdef __cplusplus
 }
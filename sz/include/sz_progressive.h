@@ -0,0 +1,39 @@
+/**
+ *  @file sz_progressive.h
+ *  @brief Header file for the sz_progressive.c (progressive compression by layers of tighter error bounds).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_PROGRESSIVE_H
+#define _SZ_PROGRESSIVE_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_PROGRESSIVE_MAX_LAYERS 16
+#define SZ_PROGRESSIVE_PREAMBLE_SIZE 8 //magic "SZPG", data type, number of layers, 2 reserved bytes
+#define SZ_PROGRESSIVE_HEADER_SIZE(nbLayers) (SZ_PROGRESSIVE_PREAMBLE_SIZE + 16*(nbLayers)) //+ error bound and byte length of each layer
+
+/**
+ * Layout of a progressive stream: the header, then the SZ streams of the layers. Layer 0 is the data
+ * compressed with the first (coarsest) absolute error bound; layer k is the residual of the data after
+ * the layers 0..k-1, compressed with the k-th error bound. The first k layers thus decode to the data
+ * within errBounds[k-1], from a prefix of the stream (see SZ_progressive_info).
+ * */
+unsigned char* SZ_compress_progressive(int dataType, void* data, size_t* outSize, int nbLayers, const double* errBounds,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+int SZ_progressive_info(unsigned char* bytes, size_t byteLength, int* nbLayers, double* errBounds, size_t* layerEnds);
+void* SZ_decompress_progressive(int dataType, unsigned char* bytes, size_t byteLength, int nbLayers,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+int SZ_refine_progressive(int dataType, unsigned char* bytes, size_t byteLength, int fromLayer, int toLayer, void* data,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_PROGRESSIVE_H  ----- */
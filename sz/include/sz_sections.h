@@ -0,0 +1,81 @@
+/**
+ *  @file sz_sections.h
+ *  @brief Header file for the sz_sections.c (sectioned lossless stage, with a table of contents).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_SECTIONS_H
+#define _SZ_SECTIONS_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_SECTIONS_MAX 16
+
+//sections of the SZ bytes
+#define SZ_SECTION_HEADER 0 //version, parameters and sizes
+#define SZ_SECTION_TREE 1 //Huffman tree of the quantization codes
+#define SZ_SECTION_CODES 2 //Huffman codes (with their tree, in the streams that do not separate it)
+#define SZ_SECTION_PWR_BOUNDS 3 //point-wise relative error bounds
+#define SZ_SECTION_LEADNUM 4 //leading numbers of the unpredictable data
+#define SZ_SECTION_EXACTMID 5 //middle bytes of the unpredictable data
+#define SZ_SECTION_RESIDUALMID 6 //residual bits of the unpredictable data
+#define SZ_SECTION_COEFFICIENTS 7 //regression coefficients of the blocks
+#define SZ_SECTION_UNPREDICTABLE 8 //unpredictable data, stored as is
+
+//coding of a section
+#define SZ_SECTION_RAW 0
+#define SZ_SECTION_GZIP 1
+#define SZ_SECTION_ZSTD 2
+
+#define SZ_SECTION_MIN_CODED 64 //smaller sections are stored as is
+#define SZ_SECTION_SMALL 65536 //smaller sections are coded at a high level (at little cost)
+#define SZ_SECTION_SMALL_ZSTD_LEVEL 19
+#define SZ_SECTION_SMALL_GZIP_LEVEL 9
+
+#define SZ_SECTIONS_MAGIC_SIZE 4
+#define SZ_SECTIONS_ENTRY_SIZE 19 //id, codec, level, raw size (8 bytes) and coded size (8 bytes)
+
+typedef struct sz_section_info
+{
+	int id;
+	int codec;
+	int level;
+	size_t rawSize;
+	size_t cmpSize;
+	size_t rawOffset; //in the SZ bytes
+	size_t cmpOffset; //in the sectioned stream
+} sz_section_info;
+
+/*Where the sections begin in the SZ bytes last serialized by this thread*/
+typedef struct sz_sections_layout
+{
+	int recording;
+	const unsigned char* bytes;
+	size_t size;
+	int count;
+	int id[SZ_SECTIONS_MAX];
+	size_t offset[SZ_SECTIONS_MAX];
+} sz_sections_layout;
+
+void sz_sections_begin(const unsigned char* bytes);
+void sz_sections_mark(int id, size_t offset);
+void sz_sections_end(size_t size);
+sz_sections_layout* sz_sections_find(const unsigned char* bytes, size_t size);
+
+int sz_sections_is_sectioned(const unsigned char* bytes, size_t byteLength);
+unsigned long sz_sections_compress(sz_sections_layout* layout, int losslessCompressor, int level, unsigned char* data, unsigned long dataLength, unsigned char** compressBytes);
+unsigned long sz_sections_decompress(unsigned char* bytes, unsigned long byteLength, unsigned char** oriData);
+
+int SZ_getSections(unsigned char* bytes, size_t byteLength, sz_section_info* sections, int maxSections);
+unsigned char* SZ_decompressSection(unsigned char* bytes, size_t byteLength, int id, size_t* sectionSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_SECTIONS_H  ----- */
@@ -44,6 +44,41 @@ typedef struct sz_stats
 
 extern sz_stats sz_stat;
 
+/*The stages of a compression, as reported by SZ_get_last_stats()*/
+#define SZ_STAGE_RANGE_SCAN 0 //value range (and median) of the data
+#define SZ_STAGE_INTERVAL_OPT 1 //estimation of the number of quantization intervals
+#define SZ_STAGE_PREDICT_QUANT 2 //prediction and quantization (whatever is not accounted for by the other stages)
+#define SZ_STAGE_HUFFMAN_BUILD 3 //histogram, Huffman tree and codes
+#define SZ_STAGE_ENCODE 4 //Huffman encoding of the quantization codes
+#define SZ_STAGE_LOSSLESS 5 //final lossless compression (Zstd/Gzip)
+#define SZ_STAGE_SERIALIZE 6 //assembling the compressed stream
+#define SZ_STAGE_NUM 7
+
+typedef struct sz_stage_stats
+{
+	double time; //wall time, in seconds
+	size_t bytesIn;
+	size_t bytesOut;
+	size_t calls;
+} sz_stage_stats;
+
+/*Per-stage timing of the last compression of the calling thread (or of the context it is bound to). 
+ * Unlike sz_stat, it is always recorded: a few clock readings per compression.*/
+typedef struct sz_perf_stats
+{
+	sz_stage_stats stage[SZ_STAGE_NUM];
+	double totalTime;
+	size_t bytesIn; //size of the original data
+	size_t bytesOut; //size of the compressed data
+	int dataType;
+} sz_perf_stats;
+
+double sz_stats_clock();
+sz_perf_stats* sz_stats_current();
+void sz_stats_begin(int dataType, size_t bytesIn);
+void sz_stats_add(int stage, double startTime, size_t bytesIn, size_t bytesOut);
+void sz_stats_end(size_t bytesOut);
+
 
 void writeBlockInfo(int use_mean, size_t blockSize, size_t regressionBlocks, size_t totalBlocks);
 void writeHuffmanInfo(size_t huffmanTreeSize, size_t huffmanCodingSize, size_t totalDataSize, int huffmanNocdeCount);
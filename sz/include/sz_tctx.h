@@ -0,0 +1,37 @@
+/**
+ *  @file sz_tctx.h
+ *  @brief Header file for the sz_tctx.c (parameters of the context bound to the calling thread).
+ *  Internal to the library: sz.h does not include it, so the applications see the process-wide 
+ *  confparams_cpr, confparams_dec, exe_params and multisteps (or use SZ_getParams_cpr etc.).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_TCTX_H
+#define _SZ_TCTX_H
+
+#include "sz.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//the context bound to the calling thread, if any (NULL means using the process-wide parameters)
+extern SZ_THREAD_LOCAL sz_thread_context *sz_tctx;
+
+static inline sz_params** sz_confparams_cpr_ref(void) {return sz_tctx==NULL ? &confparams_cpr : &(sz_tctx->cpr);}
+static inline sz_params** sz_confparams_dec_ref(void) {return sz_tctx==NULL ? &confparams_dec : &(sz_tctx->dec);}
+static inline sz_exedata** sz_exe_params_ref(void) {return sz_tctx==NULL ? &exe_params : &(sz_tctx->exe);}
+static inline sz_multisteps** sz_multisteps_ref(void) {return sz_tctx==NULL || sz_tctx->multisteps==NULL ? &multisteps : &(sz_tctx->multisteps);}
+
+//in the library code, these are the parameters of the bound context (and the process-wide ones otherwise)
+#define confparams_cpr (*sz_confparams_cpr_ref())
+#define confparams_dec (*sz_confparams_dec_ref())
+#define exe_params (*sz_exe_params_ref())
+#define multisteps (*sz_multisteps_ref())
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_TCTX_H  ----- */
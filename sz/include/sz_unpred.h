@@ -0,0 +1,80 @@
+/**
+ *  @file sz_unpred.h
+ *  @brief Header file for the sz_unpred.c (batched coding of the unpredictable data: leading numbers, mid bytes and residual bits).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_UNPRED_H
+#define _SZ_UNPRED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*The unpredictable data of a compression, collected during the prediction and coded at its end*/
+typedef struct sz_unpred_float
+{
+	uint32_t* words; //bits of the unpredictable values minus the median value, in order
+	size_t count;
+	int reqLength;
+	uint32_t mask; //keeps the reqLength leading bits
+	float medianValue;
+} sz_unpred_float;
+
+typedef struct sz_unpred_double
+{
+	uint64_t* words;
+	size_t count;
+	int reqLength;
+	uint64_t mask;
+	double medianValue;
+} sz_unpred_double;
+
+void sz_unpred_init_float(sz_unpred_float* unpred, size_t capacity, int reqLength, float medianValue);
+void sz_unpred_init_double(sz_unpred_double* unpred, size_t capacity, int reqLength, double medianValue);
+
+/**
+ * Add an unpredictable value (at most capacity of them).
+ *
+ * @return the value as decompressed (i.e., truncated to reqLength bits), for the next predictions
+ * */
+static inline float sz_unpred_add_float(sz_unpred_float* unpred, float value)
+{
+	float normValue = value - unpred->medianValue;
+	uint32_t word;
+	memcpy(&word, &normValue, sizeof(word));
+	unpred->words[unpred->count++] = word;
+	word &= unpred->mask;
+	memcpy(&normValue, &word, sizeof(word));
+	return normValue + unpred->medianValue;
+}
+
+static inline double sz_unpred_add_double(sz_unpred_double* unpred, double value)
+{
+	double normValue = value - unpred->medianValue;
+	uint64_t word;
+	memcpy(&word, &normValue, sizeof(word));
+	unpred->words[unpred->count++] = word;
+	word &= unpred->mask;
+	memcpy(&normValue, &word, sizeof(word));
+	return normValue + unpred->medianValue;
+}
+
+size_t sz_unpred_encode_float(sz_unpred_float* unpred, unsigned char** leadNum, unsigned char** midBytes, unsigned char** resiBits);
+size_t sz_unpred_encode_double(sz_unpred_double* unpred, unsigned char** leadNum, unsigned char** midBytes, unsigned char** resiBits);
+
+void sz_unpred_decode_float(const unsigned char* leadNumBytes, const unsigned char* midBytes, size_t midBytesSize,
+const unsigned char* resiBitsBytes, size_t nbEle, int reqLength, float medianValue, float* decData);
+void sz_unpred_decode_double(const unsigned char* leadNumBytes, const unsigned char* midBytes, size_t midBytesSize,
+const unsigned char* resiBitsBytes, size_t nbEle, int reqLength, double medianValue, double* decData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_UNPRED_H  ----- */
@@ -0,0 +1,46 @@
+/**
+ *  @file sz_zstd_dict.h
+ *  @brief Header file for the sz_zstd_dict.c (Zstd dictionaries for the lossless stage).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _SZ_ZSTD_DICT_H
+#define _SZ_ZSTD_DICT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SZ_ZSTD_DICT_CAPACITY 65536 //default size of a trained dictionary, in bytes
+
+struct ZSTD_CDict_s;
+struct ZSTD_DDict_s;
+
+/*A Zstd dictionary, digested once for the compressions and the decompressions of many small fields*/
+typedef struct sz_zstd_dict
+{
+	unsigned char* dictBytes; //the dictionary itself, to be stored once with the fields (see SZ_loadZstdDict)
+	size_t dictSize;
+	unsigned int dictID; //written in the frames compressed with the dictionary
+	int level; //the compression level the dictionary is digested for
+	struct ZSTD_CDict_s* cdict;
+	struct ZSTD_DDict_s* ddict;
+} sz_zstd_dict;
+
+sz_zstd_dict* SZ_trainZstdDict(unsigned char** samples, const size_t* sampleSizes, unsigned int nbSamples, size_t dictCapacity, int level);
+sz_zstd_dict* SZ_loadZstdDict(const unsigned char* dictBytes, size_t dictSize, int level);
+void SZ_freeZstdDict(sz_zstd_dict* dict);
+sz_zstd_dict* SZ_setZstdDict(sz_zstd_dict* dict);
+
+sz_zstd_dict* sz_zstd_dict_current();
+size_t sz_zstd_dict_compress(sz_zstd_dict* dict, unsigned char* dst, size_t dstCapacity, const unsigned char* src, size_t srcSize, int level);
+size_t sz_zstd_dict_decompress(sz_zstd_dict* dict, unsigned char* dst, size_t dstCapacity, const unsigned char* src, size_t srcSize);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _SZ_ZSTD_DICT_H  ----- */
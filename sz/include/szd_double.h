@@ -31,6 +31,8 @@ void getSnapshotData_double_3D(double** data, size_t r1, size_t r2, size_t r3, T
 void getSnapshotData_double_4D(double** data, size_t r1, size_t r2, size_t r3, size_t r4, TightDataPointStorageD* tdps, int errBoundMode, int compressionType, double* hist_data);
 void decompressDataSeries_double_2D_nonblocked_with_blocked_regression(double** data, size_t r1, size_t r2, unsigned char* comp_data, double* hist_data);
 void decompressDataSeries_double_3D_nonblocked_with_blocked_regression(double** data, size_t r1, size_t r2, size_t r3, unsigned char* comp_data, double* hist_data);
+int decompressDataSeries_double_3D_regression_coefficients(double** coeffs, size_t* block_size, size_t r1, size_t r2, size_t r3, unsigned char* comp_data);
+int SZ_decompress_args_regression_coefficients_double(double** coeffs, size_t* blockSize, size_t r3, size_t r2, size_t r1, unsigned char* cmpBytes, size_t cmpSize);
 
 size_t decompressDataSeries_double_3D_RA_block(double * data, double mean, size_t dim_0, size_t dim_1, size_t dim_2, size_t block_dim_0, size_t block_dim_1, size_t block_dim_2, double realPrecision, int * type, double * unpredictable_data);
 
@@ -42,6 +42,8 @@ void decompressDataSeries_float_1D_decompression_given_areas_with_blocked_regres
 void decompressDataSeries_float_2D_nonblocked_with_blocked_regression(float** data, size_t r1, size_t r2, unsigned char* comp_data, float* hist_data);
 void decompressDataSeries_float_2D_decompression_given_areas_with_blocked_regression(float** data, size_t r1, size_t r2, size_t s1, size_t s2, size_t e1, size_t e2, unsigned char* comp_data);
 void decompressDataSeries_float_3D_nonblocked_with_blocked_regression(float** data, size_t r1, size_t r2, size_t r3, unsigned char* comp_data, float* hist_data);
+int decompressDataSeries_float_3D_regression_coefficients(double** coeffs, size_t* block_size, size_t r1, size_t r2, size_t r3, unsigned char* comp_data);
+int SZ_decompress_args_regression_coefficients_float(double** coeffs, size_t* blockSize, size_t r3, size_t r2, size_t r1, unsigned char* cmpBytes, size_t cmpSize);
 void decompressDataSeries_float_3D_random_access_with_blocked_regression(float** data, size_t r1, size_t r2, size_t r3, unsigned char* comp_data);
 void decompressDataSeries_float_3D_decompression_random_access_with_blocked_regression(float** data, size_t r1, size_t r2, size_t r3, unsigned char* comp_data);
 void decompressDataSeries_float_3D_decompression_given_areas_with_blocked_regression(float** data, size_t r1, size_t r2, size_t r3, size_t s1, size_t s2, size_t s3, size_t e1, size_t e2, size_t e3, unsigned char* comp_data);
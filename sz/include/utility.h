@@ -31,8 +31,15 @@ void write_reordered_tofile(SZ_VarSet* curVar, size_t dataLen);
 //sihuan added: write the reordered input to files for further decompression validation
 float calculate_delta_t(size_t size);//sihuan added
 
+struct sz_params;
+
+#define SZ_LOSSLESS_TRIAL_CHUNKS 8 //evenly spaced chunks compressed to decide whether the lossless stage pays off
+#define SZ_LOSSLESS_TRIAL_CHUNK 16384
+#define SZ_LOSSLESS_TRIAL_MIN_LENGTH (8*SZ_LOSSLESS_TRIAL_CHUNKS*SZ_LOSSLESS_TRIAL_CHUNK) //smaller inputs are always compressed
+
 int is_lossless_compressed_data(unsigned char* compressedBytes, size_t cmpSize);
 unsigned long sz_lossless_compress(int losslessCompressor, int level, unsigned char* data, unsigned long dataLength, unsigned char** compressBytes);
+int sz_lossless_skip(struct sz_params* params, unsigned char* data, unsigned long dataLength);
 unsigned long sz_lossless_decompress(int losslessCompressor, unsigned char* compressBytes, unsigned long cmpSize, unsigned char** oriData, unsigned long targetOriSize);
 unsigned long sz_lossless_decompress65536bytes(int losslessCompressor, unsigned char* compressBytes, unsigned long cmpSize, unsigned char** oriData);
 void* detransposeData(void* data, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
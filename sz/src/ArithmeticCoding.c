@@ -68,15 +68,9 @@ void freeAriCoder(AriCoder *ariCoder)
 
 void ari_init(AriCoder *ariCoder, int *s, size_t length)
 {
-	size_t i; //# states is in the range of integer.
 	int index = 0;
 	size_t *freq = (size_t *)malloc(ariCoder->numOfRealStates*sizeof(size_t));
-	memset(freq, 0, ariCoder->numOfRealStates*sizeof(size_t));
-	for(i = 0;i < length;i++) 
-	{
-		index = s[i];
-		freq[index]++;
-	}
+	SZ_histogram_full(s, length, freq, ariCoder->numOfRealStates);
  
 	int counter = 0;
 	size_t _sum = 0, sum = 0, freqDiv = 0;
@@ -9,6 +9,7 @@
  
 #include <stdlib.h>
 #include "sz.h" 	
+#include "sz_tctx.h"
 #include "zlib.h"
 
 inline unsigned short bytesToUInt16_bigEndian(unsigned char* bytes)
@@ -950,6 +951,7 @@ void convertSZParamsToBytes(sz_params* params, unsigned char* result)
    
     //compressor
     result[14] = (unsigned char)params->sol_ID;
+    result[15] = 0; //unused since segment_size was dropped, but written for the streams to be reproducible
     
     //int16ToBytes_bigEndian(&result[14], (short)(params->segment_size));
     
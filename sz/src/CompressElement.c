@@ -20,8 +20,13 @@ char* decompressGroupIDArray(unsigned char* bytes, size_t dataLength)
 {
 	HuffmanTree* huffmanTree = SZ_Reset(); //create a default huffman tree	
 	int* standGroupID = (int*)malloc(dataLength*sizeof(int));
-	decode_withTree(huffmanTree, bytes, dataLength, standGroupID);
+	int treeStatus = decode_withTree(huffmanTree, bytes, dataLength, standGroupID);
 	SZ_ReleaseHuffman(huffmanTree);
+	if(treeStatus != SZ_SCES)
+	{
+		free(standGroupID);
+		return NULL;
+	}
 	
 	char* groupID = (char*)malloc(dataLength*sizeof(char));
 	size_t i = 0;
@@ -24,6 +24,7 @@ HuffmanTree* createHuffmanTree(int stateNum)
 	huffmanTree->pool = (struct node_t*)malloc(huffmanTree->allNodes*2*sizeof(struct node_t));
 	huffmanTree->qqq = (node*)malloc(huffmanTree->allNodes*2*sizeof(node));
 	huffmanTree->code = (unsigned long**)malloc(huffmanTree->stateNum*sizeof(unsigned long*));
+	huffmanTree->codeTable = (unsigned long*)malloc(huffmanTree->stateNum*2*sizeof(unsigned long));
 	huffmanTree->cout = (unsigned char *)malloc(huffmanTree->stateNum*sizeof(unsigned char));
 	
 	memset(huffmanTree->pool, 0, huffmanTree->allNodes*2*sizeof(struct node_t));
@@ -109,7 +110,7 @@ node qremove(HuffmanTree* huffmanTree)
 void build_code(HuffmanTree *huffmanTree, node n, int len, unsigned long out1, unsigned long out2)
 {
 	if (n->t) {
-		huffmanTree->code[n->c] = (unsigned long*)malloc(2*sizeof(unsigned long));
+		huffmanTree->code[n->c] = huffmanTree->codeTable + 2*n->c;
 		if(len<=64)
 		{
 			(huffmanTree->code[n->c])[0] = out1 << (64 - len);
@@ -151,24 +152,30 @@ void build_code(HuffmanTree *huffmanTree, node n, int len, unsigned long out1, u
  * */
 void init(HuffmanTree* huffmanTree, int *s, size_t length)
 {
-	size_t i, index;
-	size_t *freq = (size_t *)malloc(huffmanTree->allNodes*sizeof(size_t));
-	memset(freq, 0, huffmanTree->allNodes*sizeof(size_t));
-	for(i = 0;i < length;i++)
-	{
-		index = s[i];
-		freq[index]++;
-	}
+	double statsStart = sz_stats_clock();
+	int minState = 0, maxState = -1;
+	size_t *freq = SZ_histogram(s, length, huffmanTree->allNodes, &minState, &maxState);
+	init_fromHistogram(huffmanTree, freq, minState, maxState);
+	free(freq);
+	sz_stats_add(SZ_STAGE_HUFFMAN_BUILD, statsStart, length*sizeof(int), 0);
+}
 
-	for (i = 0; i < huffmanTree->allNodes; i++)
-		if (freq[i])
-			qinsert(huffmanTree, new_node(huffmanTree, freq[i], i, 0, 0));
+/**
+ * Build the Huffman tree and the codes from the counts of the states (see SZ_histogram)
+ * @param size_t *freq (input): freq[i] is the count of the state minState+i
+ * */
+void init_fromHistogram(HuffmanTree* huffmanTree, size_t *freq, int minState, int maxState)
+{
+	int i;
+	//only the states in use, in increasing order
+	for (i = minState; i <= maxState; i++)
+		if (freq[i - minState])
+			qinsert(huffmanTree, new_node(huffmanTree, freq[i - minState], i, 0, 0));
 
 	while (huffmanTree->qend > 2)
 		qinsert(huffmanTree, new_node(huffmanTree, 0, 0, qremove(huffmanTree), qremove(huffmanTree)));
 
 	build_code(huffmanTree, huffmanTree->qq[1], 0, 0, 0);
-	free(freq);
 }
 
 void init_static(HuffmanTree* huffmanTree, int *s, size_t length)
@@ -189,109 +196,54 @@ void init_static(HuffmanTree* huffmanTree, int *s, size_t length)
 	free(freq);
 }
  
+/**
+ * Append the len (<=64) leading bits of codeWord (left-aligned, the other bits 0) to the bit buffer, which
+ * holds bitCount (<64) bits from its most significant bit, and write the buffer out when its 64 bits are full.
+ * */
+static inline void putBits(uint64_t *buffer, int *bitCount, unsigned char **p, uint64_t codeWord, int len)
+{
+	*buffer |= codeWord >> *bitCount;
+	*bitCount += len;
+	if(*bitCount >= 64)
+	{
+		longToBytes_bigEndian(*p, *buffer);
+		*p += 8;
+		*bitCount -= 64;
+		*buffer = *bitCount == 0 ? 0 : codeWord << (len - *bitCount);
+	}
+}
+
+/**
+ * Encode the states with the codes of the Huffman tree: the bits are gathered in a 64-bit buffer, written
+ * out one word at a time (big-endian), straight from the flat table of the codes.
+ * */
 void encode(HuffmanTree *huffmanTree, int *s, size_t length, unsigned char *out, size_t *outSize)
 {
-	size_t i = 0;
-	unsigned char bitSize = 0, byteSize, byteSizep;
-	int state;
+	double statsStart = sz_stats_clock();
+	size_t statsOutSize = *outSize;
+	size_t i;
+	const unsigned long *codeTable = huffmanTree->codeTable;
+	const unsigned char *cout = huffmanTree->cout;
 	unsigned char *p = out;
-	int lackBits = 0;
-	//long totalBitSize = 0, maxBitSize = 0, bitSize21 = 0, bitSize32 = 0;
+	uint64_t buffer = 0;
+	int bitCount = 0, k;
 	for (i = 0;i<length;i++) 
 	{
-		state = s[i];
-		bitSize = huffmanTree->cout[state];	
-		
-		//printf("%d %d : %d %u\n",i, state, bitSize, (code[state])[0] >> (64-cout[state])); 
-		//debug: compute the average bitSize and the count that is over 32... 	
-		/*if(bitSize>=21)
-			bitSize21++;
-		if(bitSize>=32)
-			bitSize32++;
-		if(maxBitSize<bitSize)
-			maxBitSize = bitSize;
-		totalBitSize+=bitSize;*/
-
-		if(lackBits==0)
-		{
-			byteSize = bitSize%8==0 ? bitSize/8 : bitSize/8+1; //it's equal to the number of bytes involved (for *outSize)
-			byteSizep = bitSize/8; //it's used to move the pointer p for next data
-			if(byteSize<=8)
-			{
-				longToBytes_bigEndian(p, (huffmanTree->code[state])[0]);
-				p += byteSizep;
-			}
-			else //byteSize>8
-			{
-				longToBytes_bigEndian(p, (huffmanTree->code[state])[0]);
-				p += 8;
-				longToBytes_bigEndian(p, (huffmanTree->code[state])[1]);
-				p += (byteSizep - 8);
-			}
-			*outSize += byteSize;
-			lackBits = bitSize%8==0 ? 0 : 8 - bitSize%8;
-		}
+		int state = s[i];
+		int bitSize = cout[state];
+		if(bitSize <= 64)
+			putBits(&buffer, &bitCount, &p, codeTable[2*state], bitSize);
 		else
 		{
-			*p = (*p) | (unsigned char)((huffmanTree->code[state])[0] >> (64 - lackBits));
-			if(lackBits < bitSize)
-			{
-				p++;
-				//(*outSize)++;
-				long newCode = (huffmanTree->code[state])[0] << lackBits;
-				longToBytes_bigEndian(p, newCode);
-
-				if(bitSize<=64)
-				{
-					bitSize -= lackBits;
-					byteSize = bitSize%8==0 ? bitSize/8 : bitSize/8+1;
-					byteSizep = bitSize/8;
-					p += byteSizep;
-					(*outSize)+=byteSize;
-					lackBits = bitSize%8==0 ? 0 : 8 - bitSize%8;
-				}
-				else //bitSize > 64
-				{
-					byteSizep = 7; //must be 7 bytes, because lackBits!=0
-					p+=byteSizep;
-					(*outSize)+=byteSize;
-
-					bitSize -= 64;
-					if(lackBits < bitSize)
-					{
-						*p = (*p) | (unsigned char)((huffmanTree->code[state])[0] >> (64 - lackBits));
-						p++;
-						//(*outSize)++;
-						newCode = (huffmanTree->code[state])[1] << lackBits;
-						longToBytes_bigEndian(p, newCode);
-						bitSize -= lackBits;
-						byteSize = bitSize%8==0 ? bitSize/8 : bitSize/8+1;
-						byteSizep = bitSize/8;
-						p += byteSizep;
-						(*outSize)+=byteSize;
-						lackBits = bitSize%8==0 ? 0 : 8 - bitSize%8;
-					}
-					else //lackBits >= bitSize
-					{
-						*p = (*p) | (unsigned char)((huffmanTree->code[state])[0] >> (64 - bitSize));
-						lackBits -= bitSize;
-					}
-				}
-			}
-			else //lackBits >= bitSize
-			{
-				lackBits -= bitSize;
-				if(lackBits==0)
-					p++;
-			}
+			putBits(&buffer, &bitCount, &p, codeTable[2*state], 64);
+			putBits(&buffer, &bitCount, &p, codeTable[2*state+1], bitSize - 64);
 		}
 	}
-//	for(i=0;i<stateNum;i++)
-//		if(code[i]!=NULL) free(code[i]);
-	/*printf("max bitsize = %d\n", maxBitSize);
-	printf("bitSize21 ratio = %f\n", ((float)bitSize21)/length);
-	printf("bitSize32 ratio = %f\n", ((float)bitSize32)/length);
-	printf("avg bit size = %f\n", ((float)totalBitSize)/length);*/
+	//the last bits, up to the end of their byte
+	for(k = 0; k < bitCount; k += 8)
+		*(p++) = (unsigned char)(buffer >> (56 - k));
+	*outSize += p - out;
+	sz_stats_add(SZ_STAGE_ENCODE, statsStart, length*sizeof(int), *outSize - statsOutSize);
 }
  
 void decode(unsigned char *s, size_t targetLength, node t, int *out)
@@ -774,17 +726,33 @@ node reconstruct_HuffTree_from_bytes_anyStates(HuffmanTree *huffmanTree, unsigne
 }
 
 void encode_withTree(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize)
+{
+	sz_huffman_dict* dict = sz_huffman_dict_current();
+	if(dict != NULL)
+		sz_huffman_dict_encode(dict, huffmanTree, s, length, out, outSize);
+	else
+	{
+		init(huffmanTree, s, length);
+		encode_withInitTree(huffmanTree, s, length, out, outSize, NULL);
+	}
+}
+
+/**
+ * Store the tree built by init() and encode the states with it (the tree is added to dict, if not NULL)
+ * */
+void encode_withInitTree(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize, sz_huffman_dict* dict)
 {
 	size_t i; 
 	int nodeCount = 0;
 	unsigned char *treeBytes, buffer[4];
 	
-	init(huffmanTree, s, length);
 	for (i = 0; i < huffmanTree->stateNum; i++)
 		if (huffmanTree->code[i]) nodeCount++; 
 	nodeCount = nodeCount*2-1;
 	unsigned int treeByteSize = convert_HuffTree_to_bytes_anyStates(huffmanTree,nodeCount, &treeBytes);
 	//printf("treeByteSize = %d\n", treeByteSize);
+	if(dict != NULL)
+		sz_huffman_dict_add(dict, huffmanTree->stateNum/2, nodeCount, treeBytes, treeByteSize);
 
 	*out = (unsigned char*)malloc(length*sizeof(int)+treeByteSize);
 	intToBytes_bigEndian(buffer, nodeCount);
@@ -800,118 +768,88 @@ void encode_withTree(HuffmanTree* huffmanTree, int *s, size_t length, unsigned c
 
 int encode_withTree_MSST19(HuffmanTree* huffmanTree, int *s, size_t length, unsigned char **out, size_t *outSize)
 {
-	//struct ClockPoint clockPointInit;
-	//TimeDurationStart("init", &clockPointInit);
 	size_t i;
-	int nodeCount = 0;
-	unsigned char *treeBytes, buffer[4];
-
-	init(huffmanTree, s, length);
-
 	int maxBits = 0;
+	encode_withTree(huffmanTree, s, length, out, outSize);
 	for (i = 0; i < huffmanTree->stateNum; i++)
-		if (huffmanTree->code[i]){
-			nodeCount++;
-			if(huffmanTree->cout[i] > maxBits) maxBits = huffmanTree->cout[i];
-		}
-	nodeCount = nodeCount*2-1;
-	//TimeDurationEnd(&clockPointInit);
-	//struct ClockPoint clockPointST;
-	//TimeDurationStart("save tree", &clockPointST);
-	unsigned int treeByteSize = convert_HuffTree_to_bytes_anyStates(huffmanTree,nodeCount, &treeBytes);
-	//printf("treeByteSize = %d\n", treeByteSize);
-
-	*out = (unsigned char*)malloc(length*sizeof(int)+treeByteSize);
-	intToBytes_bigEndian(buffer, nodeCount);
-	memcpy(*out, buffer, 4);
-	intToBytes_bigEndian(buffer, huffmanTree->stateNum/2); //real number of intervals
-	memcpy(*out+4, buffer, 4);
-	memcpy(*out+8, treeBytes, treeByteSize);
-	free(treeBytes);
-	size_t enCodeSize = 0;
-	//TimeDurationEnd(&clockPointST);
-	//struct ClockPoint clockPointEncode;
-	//TimeDurationStart("encode", &clockPointEncode);
-	encode(huffmanTree, s, length, *out+8+treeByteSize, &enCodeSize);
-	*outSize = 8+treeByteSize+enCodeSize;
-	//TimeDurationEnd(&clockPointEncode);
-	//unsigned short state[length];
-	//decode(*out+4+treeByteSize, enCodeSize, qqq[0], state);
-	//printf("dataSeriesLength=%d",length );
+		if (huffmanTree->code[i] && huffmanTree->cout[i] > maxBits)
+			maxBits = huffmanTree->cout[i];
 	return maxBits;
 }
 
 /**
- * @par *out rememmber to allocate targetLength short_type data for it beforehand.
- * 
+ * Rebuild the tree of an encoded stream, stored in the stream or referred to in the dictionary
+ * (SZ_HUFFMAN_TREE_REF). A tree stored in the stream is added to the current dictionary, if any.
+ *
+ * @param encoded set to the beginning of the codes
+ * @return the root of the tree, or NULL if the tree is not in the dictionary
  * */
-void decode_withTree(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out)
+static node reconstruct_HuffTree_withDict(HuffmanTree* huffmanTree, unsigned char *s, unsigned char **encoded)
 {
-	size_t encodeStartIndex;
-	size_t nodeCount = bytesToInt_bigEndian(s);
-	node root = reconstruct_HuffTree_from_bytes_anyStates(huffmanTree,s+8, nodeCount);
-
-	//sdi: Debug
-/*	build_code(root, 0, 0, 0);
-	int i;
-	unsigned long code_1, code_2;
-	for (i = 0; i < stateNum; i++)
-		if (code[i])
+	int nodeCount = bytesToInt_bigEndian(s);
+	unsigned int intervals = (unsigned int)bytesToInt_bigEndian(s+4);
+	sz_huffman_dict* dict = sz_huffman_dict_current();
+	if(intervals & SZ_HUFFMAN_TREE_REF)
+	{
+		unsigned int id = (unsigned int)bytesToInt_bigEndian(s+8);
+		sz_huffman_dict_tree* tree = dict == NULL ? NULL : sz_huffman_dict_find(dict, id);
+		if(tree == NULL || tree->nodeCount != nodeCount)
 		{
-			printf("%d: %lu,%lu ; %u\n", i, (code[i])[0],(code[i])[1], cout[i]);
-			//code_1 = (code[i])[0];
-		}*/
+			printf("Error: the Huffman tree %u of the stream is not in the dictionary\n", id);
+			return NULL;
+		}
+		*encoded = s+SZ_HUFFMAN_TREE_REF_SIZE;
+		return reconstruct_HuffTree_from_bytes_anyStates(huffmanTree, tree->treeBytes, nodeCount);
+	}
 
+	size_t encodeStartIndex;
 	if(nodeCount<=256)
 		encodeStartIndex = 1+3*nodeCount*sizeof(unsigned char)+nodeCount*sizeof(unsigned int);
 	else if(nodeCount<=65536)
 		encodeStartIndex = 1+2*nodeCount*sizeof(unsigned short)+nodeCount*sizeof(unsigned char)+nodeCount*sizeof(unsigned int);
 	else
 		encodeStartIndex = 1+3*nodeCount*sizeof(unsigned int)+nodeCount*sizeof(unsigned char);
-	decode(s+8+encodeStartIndex, targetLength, root, out);
+	if(dict != NULL)
+		sz_huffman_dict_add(dict, intervals, nodeCount, s+8, encodeStartIndex);
+	*encoded = s+8+encodeStartIndex;
+	return reconstruct_HuffTree_from_bytes_anyStates(huffmanTree,s+8, nodeCount);
 }
 
-void decode_withTree_MSST19(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out, int maxBits)
+/**
+ * @par *out rememmber to allocate targetLength short_type data for it beforehand.
+ * 
+ * @return SZ_SCES, or SZ_DERR if the tree that the stream refers to is not in the dictionary (out is then not set)
+ * */
+int decode_withTree(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out)
 {
-	size_t encodeStartIndex;
-	size_t nodeCount = bytesToInt_bigEndian(s);
-	node root = reconstruct_HuffTree_from_bytes_anyStates(huffmanTree,s+8, nodeCount);
-
-	//sdi: Debug
-/*	build_code(root, 0, 0, 0);
-	int i;
-	unsigned long code_1, code_2;
-	for (i = 0; i < stateNum; i++)
-		if (code[i])
-		{
-			printf("%d: %lu,%lu ; %u\n", i, (code[i])[0],(code[i])[1], cout[i]);
-			//code_1 = (code[i])[0];
-		}*/
-
-	if(nodeCount<=256)
-		encodeStartIndex = 1+3*nodeCount*sizeof(unsigned char)+nodeCount*sizeof(unsigned int);
-	else if(nodeCount<=65536)
-		encodeStartIndex = 1+2*nodeCount*sizeof(unsigned short)+nodeCount*sizeof(unsigned char)+nodeCount*sizeof(unsigned int);
-	else
-		encodeStartIndex = 1+3*nodeCount*sizeof(unsigned int)+nodeCount*sizeof(unsigned char);
+	unsigned char *encoded;
+	node root = reconstruct_HuffTree_withDict(huffmanTree, s, &encoded);
+	if(root == NULL)
+		return SZ_DERR;
+	decode(encoded, targetLength, root, out);
+	return SZ_SCES;
+}
 
-	decode_MSST19(s+8+encodeStartIndex, targetLength, root, out, maxBits);
+int decode_withTree_MSST19(HuffmanTree* huffmanTree, unsigned char *s, size_t targetLength, int *out, int maxBits)
+{
+	unsigned char *encoded;
+	node root = reconstruct_HuffTree_withDict(huffmanTree, s, &encoded);
+	if(root == NULL)
+		return SZ_DERR;
+	decode_MSST19(encoded, targetLength, root, out, maxBits);
+	return SZ_SCES;
 }
 
 void SZ_ReleaseHuffman(HuffmanTree* huffmanTree)
 {
-	size_t i;
 	free(huffmanTree->pool);
 	huffmanTree->pool = NULL;
 	free(huffmanTree->qqq);
 	huffmanTree->qqq = NULL;
-	for(i=0;i<huffmanTree->stateNum;i++)
-	{
-		if(huffmanTree->code[i]!=NULL)
-			free(huffmanTree->code[i]);
-	}
 	free(huffmanTree->code);
 	huffmanTree->code = NULL;
+	free(huffmanTree->codeTable);
+	huffmanTree->codeTable = NULL;
 	free(huffmanTree->cout);
 	huffmanTree->cout = NULL;	
 	free(huffmanTree);
@@ -12,6 +12,7 @@
 #include <string.h>
 #include "TightDataPointStorageD.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 //#include "rw.h"
 
@@ -456,21 +457,26 @@ void convertTDPStoBytes_double(TightDataPointStorageD* tdps, unsigned char* byte
 			bytes[k++] = exactMidBytesLength[i];
 	}
 
+	sz_sections_mark(SZ_SECTION_CODES, k);
 	memcpy(&(bytes[k]), tdps->typeArray, tdps->typeArray_size);
 	k += tdps->typeArray_size;
 	if(confparams_cpr->errorBoundMode>=PW_REL)
 	{
+		sz_sections_mark(SZ_SECTION_PWR_BOUNDS, k);
 		memcpy(&(bytes[k]), tdps->pwrErrBoundBytes, tdps->pwrErrBoundBytes_size);
 		k += tdps->pwrErrBoundBytes_size;
 	}
 
+	sz_sections_mark(SZ_SECTION_LEADNUM, k);
 	memcpy(&(bytes[k]), tdps->leadNumArray, tdps->leadNumArray_size);
 	k += tdps->leadNumArray_size;
+	sz_sections_mark(SZ_SECTION_EXACTMID, k);
 	memcpy(&(bytes[k]), tdps->exactMidBytes, tdps->exactMidBytes_size);
 	k += tdps->exactMidBytes_size;
 
 	if(tdps->residualMidBits!=NULL)
 	{
+		sz_sections_mark(SZ_SECTION_RESIDUALMID, k);
 		memcpy(&(bytes[k]), tdps->residualMidBits, tdps->residualMidBits_size);
 		k += tdps->residualMidBits_size;
 	}		
@@ -584,6 +590,7 @@ void convertTDPStoBytes_double_reserve(TightDataPointStorageD* tdps, unsigned ch
 //Convert TightDataPointStorageD to bytes...
 void convertTDPStoFlatBytes_double(TightDataPointStorageD *tdps, unsigned char** bytes, size_t *size) 
 {
+	double statsStart = sz_stats_clock();
 	size_t i, k = 0; 
 	unsigned char dsLengthBytes[8];
 	
@@ -647,7 +654,9 @@ void convertTDPStoFlatBytes_double(TightDataPointStorageD *tdps, unsigned char**
 			
 		*bytes = (unsigned char *)malloc(sizeof(unsigned char)*totalByteLength);
 
+		sz_sections_begin(*bytes);
 		convertTDPStoBytes_double(tdps, *bytes, dsLengthBytes, sameByte);
+		sz_sections_end(totalByteLength);
 		
 		*size = totalByteLength;
 	}
@@ -655,6 +664,7 @@ void convertTDPStoFlatBytes_double(TightDataPointStorageD *tdps, unsigned char**
 	{
 		//TODO
 	}
+	sz_stats_add(SZ_STAGE_SERIALIZE, statsStart, *size, *size);
 }
 
 void convertTDPStoFlatBytes_double_args(TightDataPointStorageD *tdps, unsigned char* bytes, size_t *size) 
@@ -12,6 +12,7 @@
 #include <string.h>
 #include "TightDataPointStorageF.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 //#include "rw.h"
 
@@ -454,21 +455,26 @@ void convertTDPStoBytes_float(TightDataPointStorageF* tdps, unsigned char* bytes
 			bytes[k++] = exactMidBytesLength[i];
 	}
 
+	sz_sections_mark(SZ_SECTION_CODES, k);
 	memcpy(&(bytes[k]), tdps->typeArray, tdps->typeArray_size);
 	k += tdps->typeArray_size;
 	if(confparams_cpr->errorBoundMode>=PW_REL)
 	{
+		sz_sections_mark(SZ_SECTION_PWR_BOUNDS, k);
 		memcpy(&(bytes[k]), tdps->pwrErrBoundBytes, tdps->pwrErrBoundBytes_size);
 		k += tdps->pwrErrBoundBytes_size;
 	}
 
+	sz_sections_mark(SZ_SECTION_LEADNUM, k);
 	memcpy(&(bytes[k]), tdps->leadNumArray, tdps->leadNumArray_size);
 	k += tdps->leadNumArray_size;
+	sz_sections_mark(SZ_SECTION_EXACTMID, k);
 	memcpy(&(bytes[k]), tdps->exactMidBytes, tdps->exactMidBytes_size);
 	k += tdps->exactMidBytes_size;
 
 	if(tdps->residualMidBits!=NULL)
 	{
+		sz_sections_mark(SZ_SECTION_RESIDUALMID, k);
 		memcpy(&(bytes[k]), tdps->residualMidBits, tdps->residualMidBits_size);
 		k += tdps->residualMidBits_size;
 	}	
@@ -585,6 +591,7 @@ void convertTDPStoBytes_float_reserve(TightDataPointStorageF* tdps, unsigned cha
 //convert TightDataPointStorageD to bytes...
 void convertTDPStoFlatBytes_float(TightDataPointStorageF *tdps, unsigned char** bytes, size_t *size)
 {
+	double statsStart = sz_stats_clock();
 	size_t i, k = 0; 
 	unsigned char dsLengthBytes[8];
 	
@@ -648,7 +655,9 @@ void convertTDPStoFlatBytes_float(TightDataPointStorageF *tdps, unsigned char**
 
 		*bytes = (unsigned char *)malloc(sizeof(unsigned char)*totalByteLength);
 
+		sz_sections_begin(*bytes);
 		convertTDPStoBytes_float(tdps, *bytes, dsLengthBytes, sameByte);
+		sz_sections_end(totalByteLength);
 		
 		*size = totalByteLength;
 	}
@@ -656,6 +665,7 @@ void convertTDPStoFlatBytes_float(TightDataPointStorageF *tdps, unsigned char**
 	{
 		//TODO
 	}
+	sz_stats_add(SZ_STAGE_SERIALIZE, statsStart, *size, *size);
 }
 
 void convertTDPStoFlatBytes_float_args(TightDataPointStorageF *tdps, unsigned char* bytes, size_t *size)
@@ -13,6 +13,7 @@
 #include <math.h>
 #include "TightDataPointStorageI.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 //#include "rw.h"
 
@@ -333,6 +334,7 @@ void convertTDPStoBytes_int(TightDataPointStorageI* tdps, unsigned char* bytes,
 //convert TightDataPointStorageI to bytes...
 void convertTDPStoFlatBytes_int(TightDataPointStorageI *tdps, unsigned char** bytes, size_t *size)
 {
+	double statsStart = sz_stats_clock();
 	size_t i, k = 0; 
 	unsigned char dsLengthBytes[8];
 	
@@ -390,6 +392,7 @@ void convertTDPStoFlatBytes_int(TightDataPointStorageI *tdps, unsigned char** by
 		
 		*size = totalByteLength;
 	}
+	sz_stats_add(SZ_STAGE_SERIALIZE, statsStart, *size, *size);
 }
 
 void convertTDPStoFlatBytes_int_args(TightDataPointStorageI *tdps, unsigned char* bytes, size_t *size)
@@ -11,6 +11,7 @@
 #include <stdlib.h>
 #include "DynamicByteArray.h"
 #include "sz.h"
+#include "sz_tctx.h"
 
 //int convertIntArray2ByteArray_fast_8b()
 
@@ -133,7 +134,7 @@ void convertByteArray2IntArray_fast_1b(size_t intArrayLength, unsigned char* byt
  */
 size_t convertIntArray2ByteArray_fast_2b(unsigned char* timeStepType, size_t timeStepTypeLength, unsigned char **result)
 {
-	size_t i, j, byteLength = 0;
+	size_t i, byteLength = 0;
 	if(timeStepTypeLength%4==0)
 		byteLength = timeStepTypeLength*2/8;
 	else
@@ -142,34 +143,28 @@ size_t convertIntArray2ByteArray_fast_2b(unsigned char* timeStepType, size_t tim
 		*result = (unsigned char*)malloc(byteLength*sizeof(unsigned char));
 	else
 		*result = NULL;
-	size_t n = 0;
-	for(i = 0;i<byteLength;i++)
+	unsigned char check = 0;
+	for(i = 0;i<timeStepTypeLength;i++)
+		check |= timeStepType[i];
+	if(check > 3)
+	{
+		for(i = 0;timeStepType[i]<=3;i++);
+		printf("Error: wrong timestep type...: type[%zu]=%d\n", i, timeStepType[i]);
+		exit(0);
+	}
+	//four types per byte, without branches
+	size_t n = timeStepTypeLength/4;
+	for(i = 0;i<n;i++)
+	{
+		unsigned char* t = &timeStepType[4*i];
+		(*result)[i] = (unsigned char)((t[0] << 6) | (t[1] << 4) | (t[2] << 2) | t[3]);
+	}
+	if(n < byteLength)
 	{
 		int tmp = 0;
-		for(j = 0;j<4&&n<timeStepTypeLength;j++)
-		{
-			int type = timeStepType[n];
-			switch(type)
-			{
-			case 0: 
-				
-				break;
-			case 1:
-				tmp = (tmp | (1 << (6-j*2)));
-				break;
-			case 2:
-				tmp = (tmp | (2 << (6-j*2)));
-				break;
-			case 3:
-				tmp = (tmp | (3 << (6-j*2)));
-				break;
-			default:
-				printf("Error: wrong timestep type...: type[%zu]=%d\n", n, type);
-				exit(0);
-			}
-			n++;
-		}
-		(*result)[i] = (unsigned char)tmp;
+		for(i = 4*n;i<timeStepTypeLength;i++)
+			tmp = tmp | (timeStepType[i] << (6-(i-4*n)*2));
+		(*result)[n] = (unsigned char)tmp;
 	}
 	return byteLength;
 }
@@ -370,41 +365,29 @@ inline int getLeftMovingSteps(size_t k, unsigned char resiBitLength)
  */
 size_t convertIntArray2ByteArray_fast_dynamic(unsigned char* timeStepType, unsigned char resiBitLength, size_t nbEle, unsigned char **bytes)
 {
-	size_t i = 0, j = 0, k = 0; 
-	int value;
-	DynamicByteArray* dba;
-	new_DBA(&dba, 1024);
-	int tmp = 0, leftMovSteps = 0;
+	size_t j, k = 0;
+	size_t size = (nbEle*resiBitLength+7)/8;
+	if(size==0)
+	{
+		*bytes = NULL;
+		return 0;
+	}
+	//the bits are accumulated in a word and written byte by byte into the output sized once
+	*bytes = (unsigned char*)malloc(size*sizeof(unsigned char));
+	unsigned int buffer = 0;
+	int bitCount = 0;
 	for(j = 0;j<nbEle;j++)
 	{
-		if(resiBitLength==0)
-			continue;
-		value = timeStepType[i];
-		leftMovSteps = getLeftMovingSteps(k, resiBitLength);
-		if(leftMovSteps < 0)
-		{
-			tmp = tmp | (value >> (-leftMovSteps));
-			addDBA_Data(dba, (unsigned char)tmp);
-			tmp = 0 | (value << (8+leftMovSteps));
-		}
-		else if(leftMovSteps > 0)
+		buffer = (buffer << resiBitLength) | timeStepType[j];
+		bitCount += resiBitLength;
+		if(bitCount >= 8)
 		{
-			tmp = tmp | (value << leftMovSteps);
+			bitCount -= 8;
+			(*bytes)[k++] = (unsigned char)(buffer >> bitCount);
 		}
-		else //==0
-		{
-			tmp = tmp | value;
-			addDBA_Data(dba, (unsigned char)tmp);
-			tmp = 0;
-		}
-		i++;
-		k += resiBitLength;
 	}
-	if(leftMovSteps != 0)
-		addDBA_Data(dba, (unsigned char)tmp);
-	convertDBAtoBytes(dba, bytes);
-	size_t size = dba->size;
-	free_DBA(dba);
+	if(bitCount > 0)
+		(*bytes)[k++] = (unsigned char)(buffer << (8-bitCount));
 	return size;
 }
 
@@ -12,6 +12,7 @@
 #include <string.h>
 #include "VarSet.h"
 #include "sz.h"
+#include "dictionary.h"
 
 void free_Variable_keepOriginalData(SZ_Variable* v)
 {
@@ -52,6 +53,84 @@ void free_Variable_all(SZ_Variable* v)
 	free(v);
 }
 
+#define VARSET_INIT_TABLE_SIZE 64
+
+static inline size_t hashVarID(unsigned int var_id, size_t tableSize)
+{
+	//integer mixing (from MurmurHash3's fmix32), so that consecutive ids are spread over the buckets
+	unsigned int h = var_id;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h & (tableSize - 1);
+}
+
+static inline size_t hashVarName(const char* varName, size_t tableSize)
+{
+	return dictionary_hash(varName) & (tableSize - 1);
+}
+
+static void insertVarIntoTables(SZ_VarSet* vset, SZ_Variable* var)
+{
+	size_t idIndex = hashVarID(var->var_id, vset->tableSize);
+	var->idHashNext = vset->idTable[idIndex];
+	vset->idTable[idIndex] = var;
+	
+	size_t nameIndex = hashVarName(var->varName, vset->tableSize);
+	var->nameHashNext = vset->nameTable[nameIndex];
+	vset->nameTable[nameIndex] = var;
+}
+
+static void removeVarFromTables(SZ_VarSet* vset, SZ_Variable* var)
+{
+	SZ_Variable** pp = &(vset->idTable[hashVarID(var->var_id, vset->tableSize)]);
+	while(*pp != NULL && *pp != var)
+		pp = &((*pp)->idHashNext);
+	if(*pp != NULL)
+		*pp = var->idHashNext;
+
+	pp = &(vset->nameTable[hashVarName(var->varName, vset->tableSize)]);
+	while(*pp != NULL && *pp != var)
+		pp = &((*pp)->nameHashNext);
+	if(*pp != NULL)
+		*pp = var->nameHashNext;
+}
+
+/**
+ * double the number of buckets and redistribute all the variables, 
+ * so that the load factor of the hash tables stays below 1
+ * */
+static void rehashVarSet(SZ_VarSet* vset, size_t newTableSize)
+{
+	free(vset->idTable);
+	free(vset->nameTable);
+	vset->tableSize = newTableSize;
+	vset->idTable = (SZ_Variable**)calloc(newTableSize, sizeof(SZ_Variable*));
+	vset->nameTable = (SZ_Variable**)calloc(newTableSize, sizeof(SZ_Variable*));
+	SZ_Variable* p = vset->header->next;
+	while(p != NULL)
+	{
+		insertVarIntoTables(vset, p);
+		p = p->next;
+	}
+}
+
+/**
+ * unlink the variable from both the linked list and the hash tables
+ * */
+static void detachVar(SZ_VarSet* vset, SZ_Variable* var)
+{
+	removeVarFromTables(vset, var);
+	var->prev->next = var->next;
+	if(var->next != NULL)
+		var->next->prev = var->prev;
+	else //var is the last variable
+		vset->lastVar = var->prev;
+	vset->count --;
+}
+
 void SZ_batchAddVar(int var_id, char* varName, int dataType, void* data, 
 			int errBoundMode, double absErrBound, double relBoundRatio, double pwRelBoundRatio, 
 			size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
@@ -60,14 +139,28 @@ void SZ_batchAddVar(int var_id, char* varName, int dataType, void* data,
 	{
 		sz_varset = (SZ_VarSet*)malloc(sizeof(SZ_VarSet));
 		sz_varset->header = (SZ_Variable*)malloc(sizeof(SZ_Variable));
-		sz_varset->header->next = NULL;
+		memset(sz_varset->header, 0, sizeof(SZ_Variable));
 		sz_varset->lastVar = sz_varset->header;
-		sz_varset->count = 0;		
+		sz_varset->count = 0;
+		sz_varset->tableSize = VARSET_INIT_TABLE_SIZE;
+		sz_varset->idTable = (SZ_Variable**)calloc(VARSET_INIT_TABLE_SIZE, sizeof(SZ_Variable*));
+		sz_varset->nameTable = (SZ_Variable**)calloc(VARSET_INIT_TABLE_SIZE, sizeof(SZ_Variable*));
+	}
+	
+	if(SZ_getVariable_vset(sz_varset, (unsigned int)var_id) != NULL)
+	{
+		printf("Error: var_id %d has already been registered.\n", var_id);
+		return;
+	}
+	if(SZ_searchVar_vset(sz_varset, varName) != NULL)
+	{
+		printf("Error: varName %s has already been registered.\n", varName);
+		return;
 	}
 	
 	SZ_Variable* var = (SZ_Variable*)malloc(sizeof(SZ_Variable));
 	memset(var, 0, sizeof(SZ_Variable));
-	var->var_id = var_id;
+	var->var_id = (unsigned int)var_id;
 	var->varName = (char*)malloc(strlen(varName)+1);
 	memcpy(var->varName, varName, strlen(varName)+1);
 	//var->varName = varName;
@@ -99,10 +192,16 @@ void SZ_batchAddVar(int var_id, char* varName, int dataType, void* data,
 	}
 	var->compressedBytes = NULL;
 	var->next = NULL;
+	var->prev = sz_varset->lastVar;
 	
 	sz_varset->count ++;
 	sz_varset->lastVar->next = var;
 	sz_varset->lastVar = var;
+	
+	if(sz_varset->count > sz_varset->tableSize)
+		rehashVarSet(sz_varset, sz_varset->tableSize*2);
+	else
+		insertVarIntoTables(sz_varset, var);
 }
 
 int SZ_batchDelVar_ID(int var_id)
@@ -119,67 +218,45 @@ int SZ_batchDelVar(char* varName)
 
 int SZ_batchDelVar_ID_vset(SZ_VarSet* vset, int var_id)
 {
-	int delSuccess = SZ_NSCS;
-	SZ_Variable* p = vset->header;
-	SZ_Variable* q = p->next;
-	while(q != NULL)
-	{
-		if(q->var_id == var_id)
-		{
-			p->next = q->next;
-			//free_Variable_all(q);
-			free_Variable_keepOriginalData(q);
-			vset->count --;
-			delSuccess = SZ_SCES;
-			if(q->next==NULL) //means that q is the last variable
-				vset->lastVar = p;			
-			break;
-		}
-			
-		p = p->next;
-		q = q->next;	
-	}
-	
-	return delSuccess;	
+	SZ_Variable* q = SZ_getVariable_vset(vset, (unsigned int)var_id);
+	if(q == NULL)
+		return SZ_NSCS;
+	detachVar(vset, q);
+	//free_Variable_all(q);
+	free_Variable_keepOriginalData(q);
+	return SZ_SCES;
 }
 
 int SZ_batchDelVar_vset(SZ_VarSet* vset, char* varName)
 {
-	int delSuccess = SZ_NSCS;
-	SZ_Variable* p = vset->header;
-	SZ_Variable* q = p->next;
-	while(q != NULL)
-	{
-		int cmpResult = strcmp(q->varName, varName);
-		if(cmpResult==0)
-		{
-			p->next = q->next;
-			//free_Variable_all(q);
-			free_Variable_keepOriginalData(q);
-			vset->count --;
-			delSuccess = SZ_SCES;
-			break;
-		}
-		p = p->next;
-		q = q->next;	
-	}
-	
-	return delSuccess;
+	SZ_Variable* q = SZ_searchVar_vset(vset, varName);
+	if(q == NULL)
+		return SZ_NSCS;
+	detachVar(vset, q);
+	//free_Variable_all(q);
+	free_Variable_keepOriginalData(q);
+	return SZ_SCES;
 }
 
-SZ_Variable* SZ_searchVar(char* varName)
+SZ_Variable* SZ_searchVar_vset(SZ_VarSet* vset, char* varName)
 {
-	SZ_Variable* p = sz_varset->header->next;
+	if(vset==NULL)
+		return NULL;
+	SZ_Variable* p = vset->nameTable[hashVarName(varName, vset->tableSize)];
 	while(p!=NULL)
 	{
-		int checkName = strcmp(p->varName, varName);
-		if(checkName==0)
+		if(strcmp(p->varName, varName)==0)
 			return p;
-		p = p->next;
-	}	
+		p = p->nameHashNext;
+	}
 	return NULL;
 }
 
+SZ_Variable* SZ_searchVar(char* varName)
+{
+	return SZ_searchVar_vset(sz_varset, varName);
+}
+
 void* SZ_getVarData(char* varName, size_t *r5, size_t *r4, size_t *r3, size_t *r2, size_t *r1)
 {
 	SZ_Variable* v = SZ_searchVar(varName);
@@ -219,7 +296,11 @@ void free_VarSet_vset(SZ_VarSet *vset, int mode)
 		else if(mode==SZ_DESTROY_WHOLE_VARSET)
 			free_Variable_all(q);
 	}
-	free(sz_varset->header);
+	free(vset->header);
+	free(vset->idTable);
+	free(vset->nameTable);
+	if(vset==sz_varset)
+		sz_varset = NULL;
 	free(vset);
 }
 
@@ -227,10 +308,12 @@ void free_multisteps(sz_multisteps* multisteps)
 {
 	if(multisteps->hist_data!=NULL)
 		free(multisteps->hist_data);
+	SZ_freeHuffmanDict(multisteps->cmprHuffmanDict);
+	SZ_freeHuffmanDict(multisteps->decHuffmanDict);
 	free(multisteps);
 }
 
-inline int checkVarID(unsigned char cur_var_id, unsigned char* var_ids, int var_count)
+int checkVarID(unsigned int cur_var_id, unsigned int* var_ids, int var_count)
 {
 	int j = 0;
 	for(j=0;j<var_count;j++)
@@ -241,14 +324,40 @@ inline int checkVarID(unsigned char cur_var_id, unsigned char* var_ids, int var_
 	return 0;
 }
 
-SZ_Variable* SZ_getVariable(int var_id)
+static int compareVarID(const void* a, const void* b)
+{
+	unsigned int x = *(const unsigned int*)a, y = *(const unsigned int*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * sort var_ids in place, so that checkSortedVarID() can be used for the membership test
+ * */
+void sortVarIDs(unsigned int* var_ids, int var_count)
+{
+	qsort(var_ids, var_count, sizeof(unsigned int), compareVarID);
+}
+
+int checkSortedVarID(unsigned int cur_var_id, unsigned int* sorted_var_ids, int var_count)
 {
-	SZ_Variable* p = sz_varset->header->next;
+	return bsearch(&cur_var_id, sorted_var_ids, var_count, sizeof(unsigned int), compareVarID) != NULL;
+}
+
+SZ_Variable* SZ_getVariable_vset(SZ_VarSet* vset, unsigned int var_id)
+{
+	if(vset==NULL)
+		return NULL;
+	SZ_Variable* p = vset->idTable[hashVarID(var_id, vset->tableSize)];
 	while(p!=NULL)
 	{
 		if(var_id == p->var_id)
 			return p;
-		p = p->next;
+		p = p->idHashNext;
 	}	
 	return NULL;
+}
+
+SZ_Variable* SZ_getVariable(int var_id)
+{
+	return SZ_getVariable_vset(sz_varset, (unsigned int)var_id);
 } 
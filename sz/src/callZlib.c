@@ -12,6 +12,7 @@
 #include <stdlib.h>
 #include <zlib.h>
 #include <sz.h>
+#include "sz_tctx.h"
 
 #if MAX_MEM_LEVEL >= 8
 #define DEF_MEM_LEVEL 8
@@ -10,6 +10,7 @@
 #include <math.h>
 #include "string.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "iniparser.h"
 #include "Huffman.h"
 #include "pastri.h"
@@ -66,6 +67,69 @@ double computeABSErrBoundFromNORM_ERR(double normErr, size_t nbEle)
 
  
 /*-------------------------------------------------------------------------*/
+/**
+ * Fill params and exe with the default configuration (the one used when no configuration file is given), 
+ * without touching confparams_cpr and exe_params, nor sysEndianType and dataEndianType (set by SZ_ReadConf).
+ * */
+void SZ_setDefaultParams(sz_params* params, sz_exedata* exe)
+{
+	memset(params, 0, sizeof(sz_params));
+	memset(exe, 0, sizeof(sz_exedata));
+	params->plus_bits = 3;
+	params->sol_ID = SZ;
+	params->max_quant_intervals = 65536;
+	params->maxRangeRadius = params->max_quant_intervals/2;
+	
+	exe->intvCapacity = params->maxRangeRadius*2;
+	exe->intvRadius = params->maxRangeRadius;
+
+	params->quantization_intervals = 0;
+	exe->optQuantMode = 1;
+	params->predThreshold = 0.99;
+	params->sampleDistance = 100;
+
+	params->szMode = SZ_BEST_COMPRESSION;
+	params->losslessCompressor = ZSTD_COMPRESSOR; //other option: GZIP_COMPRESSOR;
+	if(params->losslessCompressor==ZSTD_COMPRESSOR)
+		params->gzipMode = 3; //fast mode
+	else
+		params->gzipMode = 1; //high speed mode
+
+	params->errorBoundMode = PSNR;
+	params->psnr = 90;
+	params->absErrBound = 1E-4;
+	params->relBoundRatio = 1E-4;
+	params->fixedRatio = 10;
+	params->fixedBitRate = 0;
+	params->accelerate_pw_rel_compression = 1;
+
+	params->pw_relBoundRatio = 1E-3;
+	params->segment_size = 36;
+
+	params->pwr_type = SZ_PWR_MIN_TYPE;
+
+	params->snapshotCmprStep = 5;
+	params->reuseHuffmanTrees = 0;
+
+	params->withRegression = SZ_WITH_LINEAR_REGRESSION;
+
+	params->randomAccess = 0; //0: no random access , 1: support random access
+
+	params->regressionBlockSize = 0; //0: default block size (6 in 3D, 16 in 2D)
+	params->regressionCoeffErr = 0;
+
+	params->autotune = SZ_TUNE_NONE;
+	params->tuneMinThroughput = 0;
+	params->tuneMinRatio = 10;
+
+	params->losslessMinGain = 0.01;
+	params->losslessSections = 0;
+
+	params->protectValueRange = 0;
+
+	exe->SZ_SIZE_TYPE = sizeof(size_t);
+}
+
 /**
  * 
  * 
@@ -97,44 +161,7 @@ int SZ_ReadConf(const char* sz_cfgFile) {
     if(sz_cfgFile == NULL)
     {
 		dataEndianType = LITTLE_ENDIAN_DATA;
-		confparams_cpr->sol_ID = SZ;
-		confparams_cpr->max_quant_intervals = 65536;
-		confparams_cpr->maxRangeRadius = confparams_cpr->max_quant_intervals/2;
-				
-		exe_params->intvCapacity = confparams_cpr->maxRangeRadius*2;
-		exe_params->intvRadius = confparams_cpr->maxRangeRadius;
-		
-		confparams_cpr->quantization_intervals = 0;
-		exe_params->optQuantMode = 1;
-		confparams_cpr->predThreshold = 0.99;
-		confparams_cpr->sampleDistance = 100;
-		
-		confparams_cpr->szMode = SZ_BEST_COMPRESSION;
-		confparams_cpr->losslessCompressor = ZSTD_COMPRESSOR; //other option: GZIP_COMPRESSOR;
-		if(confparams_cpr->losslessCompressor==ZSTD_COMPRESSOR)
-			confparams_cpr->gzipMode = 3; //fast mode
-		else
-			confparams_cpr->gzipMode = 1; //high speed mode
-		
-		confparams_cpr->errorBoundMode = PSNR;
-		confparams_cpr->psnr = 90;
-		confparams_cpr->absErrBound = 1E-4;
-		confparams_cpr->relBoundRatio = 1E-4;
-		confparams_cpr->accelerate_pw_rel_compression = 1;
-		
-		confparams_cpr->pw_relBoundRatio = 1E-3;
-		confparams_cpr->segment_size = 36;
-		
-		confparams_cpr->pwr_type = SZ_PWR_MIN_TYPE;
-		
-		confparams_cpr->snapshotCmprStep = 5;
-		
-		confparams_cpr->withRegression = SZ_WITH_LINEAR_REGRESSION;
-	
-		confparams_cpr->randomAccess = 0; //0: no random access , 1: support random access
-	
-		confparams_cpr->protectValueRange = 0;
-	
+		SZ_setDefaultParams(confparams_cpr, exe_params);
 		return SZ_SCES;
 	}
     
@@ -305,8 +332,38 @@ int SZ_ReadConf(const char* sz_cfgFile) {
 		
 		confparams_cpr->randomAccess = (int)iniparser_getint(ini, "PARAMETER:randomAccess", 0);
 		
+		confparams_cpr->regressionBlockSize = (int)iniparser_getint(ini, "PARAMETER:regressionBlockSize", 0);
+		confparams_cpr->regressionCoeffErr = iniparser_getdouble(ini, "PARAMETER:regressionCoeffErr", 0);
+		if(confparams_cpr->regressionBlockSize==1 || confparams_cpr->regressionBlockSize<0 || confparams_cpr->regressionBlockSize>40)
+		{
+			printf("[SZ] Error: regressionBlockSize must be 0 (default) or between 2 and 40 (please check sz.config file)\n");
+			iniparser_freedict(ini);
+			return SZ_NSCS;
+		}
+		
+		modeBuf = iniparser_getstring(ini, "PARAMETER:autotune", "NONE");
+		if(strcmp(modeBuf, "NONE")==0)
+			confparams_cpr->autotune = SZ_TUNE_NONE;
+		else if(strcmp(modeBuf, "MAX_RATIO")==0)
+			confparams_cpr->autotune = SZ_TUNE_MAX_RATIO;
+		else if(strcmp(modeBuf, "MAX_SPEED")==0)
+			confparams_cpr->autotune = SZ_TUNE_MAX_SPEED;
+		else
+		{
+			printf("[SZ] Error: Wrong autotune setting (please check sz.config file)\n");
+			iniparser_freedict(ini);
+			return SZ_NSCS;
+		}
+		confparams_cpr->tuneMinThroughput = iniparser_getdouble(ini, "PARAMETER:tuneMinThroughput", 0);
+		confparams_cpr->tuneMinRatio = iniparser_getdouble(ini, "PARAMETER:tuneMinRatio", 10);
+		confparams_cpr->losslessMinGain = iniparser_getdouble(ini, "PARAMETER:losslessMinGain", 0.01);
+		modeBuf = iniparser_getstring(ini, "PARAMETER:losslessSections", "NO");
+		confparams_cpr->losslessSections = strcmp(modeBuf, "YES")==0 || strcmp(modeBuf, "yes")==0;
+		
 		//TODO
 		confparams_cpr->snapshotCmprStep = (int)iniparser_getint(ini, "PARAMETER:snapshotCmprStep", 5);
+		modeBuf = iniparser_getstring(ini, "PARAMETER:reuseHuffmanTrees", "NO");
+		confparams_cpr->reuseHuffmanTrees = strcmp(modeBuf, "YES")==0 || strcmp(modeBuf, "yes")==0;
 				
 		errBoundMode = iniparser_getstring(ini, "PARAMETER:errorBoundMode", NULL);
 		if(errBoundMode==NULL)
@@ -339,6 +396,8 @@ int SZ_ReadConf(const char* sz_cfgFile) {
 			confparams_cpr->errorBoundMode=REL_OR_PW_REL;
 		else if(strcmp(errBoundMode, "NORM")==0||strcmp(errBoundMode, "norm")==0)
 			confparams_cpr->errorBoundMode=NORM;
+		else if(strcmp(errBoundMode, "FIXED_RATIO")==0||strcmp(errBoundMode, "fixed_ratio")==0)
+			confparams_cpr->errorBoundMode=FIXED_RATIO;
 		else
 		{
 			printf("[SZ] Error: Wrong error bound mode (please check sz.config file)\n");
@@ -350,6 +409,8 @@ int SZ_ReadConf(const char* sz_cfgFile) {
 		confparams_cpr->relBoundRatio = (double)iniparser_getdouble(ini, "PARAMETER:relBoundRatio", 0);
 		confparams_cpr->psnr = (double)iniparser_getdouble(ini, "PARAMETER:psnr", 0);
 		confparams_cpr->normErr = (double)iniparser_getdouble(ini, "PARAMETER:normErr", 0);
+		confparams_cpr->fixedRatio = (double)iniparser_getdouble(ini, "PARAMETER:fixedRatio", 0);
+		confparams_cpr->fixedBitRate = (double)iniparser_getdouble(ini, "PARAMETER:fixedBitRate", 0);
 		confparams_cpr->pw_relBoundRatio = (double)iniparser_getdouble(ini, "PARAMETER:pw_relBoundRatio", 0);
 		confparams_cpr->segment_size = (int)iniparser_getint(ini, "PARAMETER:segment_size", 0);
 		confparams_cpr->accelerate_pw_rel_compression = (int)iniparser_getint(ini, "PARAMETER:accelerate_pw_rel_compression", 1);
@@ -12,6 +12,7 @@
 #include <string.h>
 #include <unistd.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
 #include "TightDataPointStorageD.h"
@@ -32,14 +33,17 @@ int computeByteSizePerIntValue(long valueRangeSize)
 
 long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* valueRangeSize)
 {
+	double statsStart = sz_stats_clock();
 	size_t i = 0;
 	long max = 0, min = 0;
+	size_t typeSize = 0;
 
 	if(dataType==SZ_UINT8)
 	{
 		unsigned char* data = (unsigned char*)oriData;
 		unsigned char data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_INT8)
@@ -47,6 +51,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		char* data = (char*)oriData;
 		char data_;
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_UINT16)
@@ -54,6 +59,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		unsigned short* data = (unsigned short*)oriData;
 		unsigned short data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_INT16)
@@ -61,6 +67,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		short* data = (short*)oriData;
 		short data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_UINT32)
@@ -68,6 +75,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		unsigned int* data = (unsigned int*)oriData;
 		unsigned int data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_INT32)
@@ -75,6 +83,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		int* data = (int*)oriData;
 		int data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_UINT64)
@@ -82,6 +91,7 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		unsigned long* data = (unsigned long*)oriData;
 		unsigned long data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 	else if(dataType == SZ_INT64)
@@ -89,15 +99,18 @@ long computeRangeSize_int(void* oriData, int dataType, size_t size, int64_t* val
 		long* data = (long *)oriData;
 		long data_; 
 		min = data[0], max = min;
+		typeSize = sizeof(data_);
 		computeMinMax(data);
 	}
 
 	*valueRangeSize = max - min;
+	sz_stats_add(SZ_STAGE_RANGE_SCAN, statsStart, size*typeSize, 0);
 	return min;	
 }
 
 float computeRangeSize_float(float* oriData, size_t size, float* valueRangeSize, float* medianValue)
 {
+	double statsStart = sz_stats_clock();
 	size_t i = 0;
 	float min = oriData[0];
 	float max = min;
@@ -112,11 +125,13 @@ float computeRangeSize_float(float* oriData, size_t size, float* valueRangeSize,
 
 	*valueRangeSize = max - min;
 	*medianValue = min + *valueRangeSize/2;
+	sz_stats_add(SZ_STAGE_RANGE_SCAN, statsStart, size*sizeof(float), 0);
 	return min;
 }
 
 float computeRangeSize_float_MSST19(float* oriData, size_t size, float* valueRangeSize, float* medianValue, unsigned char * signs, bool* positive, float* nearZero)
 {
+    double statsStart = sz_stats_clock();
     size_t i = 0;
     float min = oriData[0];
     float max = min;
@@ -140,11 +155,13 @@ float computeRangeSize_float_MSST19(float* oriData, size_t size, float* valueRan
 
     *valueRangeSize = max - min;
     *medianValue = min + *valueRangeSize/2;
+    sz_stats_add(SZ_STAGE_RANGE_SCAN, statsStart, size*sizeof(float), 0);
     return min;
 }
 
 double computeRangeSize_double(double* oriData, size_t size, double* valueRangeSize, double* medianValue)
 {
+	double statsStart = sz_stats_clock();
 	size_t i = 0;
 	double min = oriData[0];
 	double max = min;
@@ -159,11 +176,13 @@ double computeRangeSize_double(double* oriData, size_t size, double* valueRangeS
 	
 	*valueRangeSize = max - min;
 	*medianValue = min + *valueRangeSize/2;
+	sz_stats_add(SZ_STAGE_RANGE_SCAN, statsStart, size*sizeof(double), 0);
 	return min;
 }
 
 double computeRangeSize_double_MSST19(double* oriData, size_t size, double* valueRangeSize, double* medianValue, unsigned char * signs, bool* positive, double* nearZero)
 {
+    double statsStart = sz_stats_clock();
     size_t i = 0;
     double min = oriData[0];
     double max = min;
@@ -187,6 +206,7 @@ double computeRangeSize_double_MSST19(double* oriData, size_t size, double* valu
 
     *valueRangeSize = max - min;
     *medianValue = min + *valueRangeSize/2;
+    sz_stats_add(SZ_STAGE_RANGE_SCAN, statsStart, size*sizeof(double), 0);
     return min;
 }
 
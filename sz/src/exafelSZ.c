@@ -79,52 +79,26 @@ static inline size_t calcIdx_2D(int i1, int i0, int size0){
   return i0+size0*i1;
 }
 
-unsigned char * exafelSZ_Compress(void* _pr,
-                       void* _origData,
-                       size_t nEvents, size_t panels, size_t rows, size_t cols,
-                       size_t *compressedSize)
-{
-  float *origData=(float*)_origData;
-  exafelSZ_params *pr=(exafelSZ_params*)_pr;
-  
-  exafelSZ_params_process(pr, panels, rows, cols); 
-  exafelSZ_params_checkDecomp(pr, panels, rows, cols); 
-  
-  uint8_t *roiM=(uint8_t*)malloc(nEvents*panels*rows*cols) ;
-  float *roiData=(float*)malloc(nEvents*panels*rows*cols*sizeof(float)) ;
-  float *binnedData=(float*)malloc(nEvents*panels*pr->binnedRows*pr->binnedCols*sizeof(float)) ;
-  //float *binnedData=(float*)malloc(nEvents*panels*rows*cols*sizeof(float)) ;
-  
-  size_t e,p,r,c,pk,ri,ci,br,bc,roii,bi;
-  
-  //Generate the ROI mask: NOTE: 0 means affirmative in ROI mask! This comes from the python scripts!
-  //First, initialize with calibration panel:
-  for(e=0;e<nEvents;e++){ //Event
-    for(p=0;p<panels;p++){ //Panel
-      for(r=0;r<rows;r++){ //Row
-        for(c=0;c<cols;c++){ //Column
-          roiM[calcIdx_4D(e,p,r,c,panels,rows,cols)]=pr->calibPanel[calcIdx_2D(r,c,cols)];
-        }
-      }
-    }
-  }
+//*********************************************************************************
+//The events are processed panel by panel: every panel of every event is independent once the byte offsets
+//of the peaks of the events are known, so the panels are shared among the threads, each one with a mask
+//buffer of one panel.
+//*********************************************************************************
+
+//Check the peaks of nEvents events (nPeaks(uint64_t), then nPeaks x (panel,row,col)(uint16_t x 3), per event)
+//and compute the byte offset of the peaks of every event. Returns the size of the peaks in bytes.
+static uint64_t exafelSZ_peaksOffsets(const uint8_t *peaks, size_t nEvents, size_t panels, size_t rows, size_t cols, uint64_t *offsets){
   uint64_t peaksBytePos=0; //Position in the peaks buffer
-  //Now process the peaks and generate the mask:
-  uint64_t nPeaksTotal=0;  //Total number of peaks
+  size_t e,pk;
   for(e=0;e<nEvents;e++){ //Event
-    uint64_t nPeaks=*(uint64_t*)(&pr->peaks[peaksBytePos]);
+    offsets[e]=peaksBytePos;
+    uint64_t nPeaks=*(uint64_t*)(&peaks[peaksBytePos]);
     peaksBytePos+=8;
-    //peaksBytePos+=8;//Skip the second one! This is due to the problem in Python.
-
-    nPeaksTotal+=nPeaks;
     for(pk=0;pk<nPeaks;pk++){
-      uint16_t p_=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Panel for the current peak
-      peaksBytePos+=2;
-      uint16_t r_=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Row for the current peak
-      peaksBytePos+=2;
-      uint16_t c_=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Col for the current peak
-      peaksBytePos+=2;
-      
+      uint16_t p_=*(uint16_t*)(&peaks[peaksBytePos]); //Panel for the current peak
+      uint16_t r_=*(uint16_t*)(&peaks[peaksBytePos+2]); //Row for the current peak
+      uint16_t c_=*(uint16_t*)(&peaks[peaksBytePos+4]); //Col for the current peak
+      peaksBytePos+=6;
       if(p_>=panels){
         printf("ERROR: Peak coordinate out of bounds: Panel=%d, Valid range: 0,%d\n",(int)p_,(int)panels-1);
         assert(0);
@@ -137,79 +111,81 @@ unsigned char * exafelSZ_Compress(void* _pr,
         printf("ERROR: Peak coordinate out of bounds: Col=%d, Valid range: 0,%d\n",(int)c_,(int)cols-1);
         assert(0);
       }
-      
-      for(ri=r_-pr->peakRadius;ri<=r_+pr->peakRadius;ri++){  //ri: row index. Just a temporary variable.
-        for(ci=c_-pr->peakRadius;ci<=c_+pr->peakRadius;ci++){  //ci: column index. Just a temporary variable.
-          if(ri<rows && ci<cols){  //Check whether inside bounds or not
-            roiM[calcIdx_4D(e,p_,ri,ci,panels,rows,cols)]=0;
-          }
-        }
-      }
     }
   }
-  
-  //Save ROI:
-  uint64_t roiSavedCount=0;
-  for(e=0;e<nEvents;e++){ //Event
-    for(p=0;p<panels;p++){ //Panel
-      for(r=0;r<rows;r++){ //Row
-        for(c=0;c<cols;c++){ //Column
-          if(!roiM[calcIdx_4D(e,p,r,c,panels,rows,cols)]){
-            roiData[roiSavedCount]=origData[calcIdx_4D(e,p,r,c,panels,rows,cols)];
-            roiSavedCount++;
-          }
-          
-          //AMG: Replace ROI and RONI pixels with avg values!
-          
+  return peaksBytePos;
+}
+
+//Generate the ROI mask of the panel p of an event: NOTE: 0 means affirmative in ROI mask! This comes from the python scripts!
+static void exafelSZ_panelMask(exafelSZ_params *pr, const uint8_t *eventPeaks, size_t p, size_t rows, size_t cols, uint8_t *roiM){
+  size_t pk,ri,ci;
+  //First, initialize with calibration panel:
+  memcpy(roiM,pr->calibPanel,rows*cols);
+  uint64_t nPeaks=*(uint64_t*)eventPeaks;
+  const uint8_t *peak=eventPeaks+8;
+  for(pk=0;pk<nPeaks;pk++,peak+=6){
+    uint16_t p_=*(uint16_t*)peak; //Panel for the current peak
+    uint16_t r_=*(uint16_t*)(peak+2); //Row for the current peak
+    uint16_t c_=*(uint16_t*)(peak+4); //Col for the current peak
+    if(p_!=p)
+      continue;
+    //ri and ci are unsigned: as it always was, nothing is masked for a peak closer than peakRadius to the first
+    //row or column. The decompressor rebuilds the same mask, so this must not change.
+    for(ri=r_-pr->peakRadius;ri<=r_+pr->peakRadius;ri++){  //ri: row index. Just a temporary variable.
+      for(ci=c_-pr->peakRadius;ci<=c_+pr->peakRadius;ci++){  //ci: column index. Just a temporary variable.
+        if(ri<rows && ci<cols){  //Check whether inside bounds or not
+          roiM[calcIdx_2D(ri,ci,cols)]=0;
         }
       }
     }
   }
-  
-  //Binning:
-  for(e=0;e<nEvents;e++){ //Event
-    for(p=0;p<panels;p++){  //Panel
-      for(r=0;r<pr->binnedRows;r++){ //Row of the binnedData
-        for(c=0;c<pr->binnedCols;c++){ //Column of the binnedData
-          float sum=0;
-          int nPts=0;
-          for(br=0;br<pr->binSize;br++) //Bin Row (from origData)
-            for(bc=0;bc<pr->binSize;bc++) //Bin Column (from origData)
-              if(r*pr->binSize+br<rows && c*pr->binSize+bc<cols){
-                // cout<<p<<" "<<r<<" "<<c<<" "<<br<<" "<<bc<<" "<<r*pr->binSize+br<<" "<<c*pr->binSize+bc<<endl;
-                sum+=origData[calcIdx_4D(e,p,r*pr->binSize+br,c*pr->binSize+bc,panels,rows,cols)];
-                nPts++;
-              }
-          // cout<<"p:"<<p<<" r:"<<r<<" c:"<<c<<" nPts:"<<nPts<<endl;
-          binnedData[calcIdx_4D(e,p,r,c,panels,pr->binnedRows,pr->binnedCols)]=sum/nPts;
-        }
-      }
+}
+
+//Save the ROI pixels of a panel into roiData (if not NULL). Returns the number of ROI pixels.
+static size_t exafelSZ_panelROI(const uint8_t *roiM, const float *panel, size_t panelSize, float *roiData){
+  size_t i,count=0;
+  for(i=0;i<panelSize;i++){
+    if(!roiM[i]){
+      if(roiData!=NULL)
+        roiData[count]=panel[i];
+      count++;
     }
   }
+  return count;
+}
 
-  //Additional compression using SZ:    
-  size_t szCompressedSize=0;
-  unsigned char* szComp;
-   
-  switch(pr->szDim){
-    case 1:
-      // szComp=sz_compress_3D(binnedData, 0, 0, nEvents * panels * pr->binnedRows * pr->binnedCols, pr->tolerance, szCompressedSize); //1D
-      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0,0,0, nEvents * panels * pr->binnedRows * pr->binnedCols);
-      break;
-    case 2:
-      // szComp=sz_compress_3D(binnedData, 0, nEvents * panels * pr->binnedRows, pr->binnedCols, pr->tolerance, szCompressedSize); //2D
-      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0,0, nEvents * panels * pr->binnedRows, pr->binnedCols);
-      break;
-    case 3:
-      // szComp=sz_compress_3D(binnedData, nEvents * panels, pr->binnedRows, pr->binnedCols, pr->tolerance, szCompressedSize); //3D
-      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0, nEvents * panels, pr->binnedRows, pr->binnedCols);
-      break;
-    default:
-      printf("ERROR: Wrong szDim : %d It must be 1,2 or 3.\n",(int)pr->szDim);
-      assert(0);
+//Bin a panel: (pr->binSize x pr->binSize) to (1 x 1)
+static void exafelSZ_panelBin(exafelSZ_params *pr, const float *panel, size_t rows, size_t cols, float *binned){
+  size_t r,c,br,bc;
+  for(r=0;r<pr->binnedRows;r++){ //Row of the binnedData
+    for(c=0;c<pr->binnedCols;c++){ //Column of the binnedData
+      float sum=0;
+      int nPts=0;
+      for(br=0;br<pr->binSize;br++) //Bin Row (from origData)
+        for(bc=0;bc<pr->binSize;bc++) //Bin Column (from origData)
+          if(r*pr->binSize+br<rows && c*pr->binSize+bc<cols){
+            sum+=panel[calcIdx_2D(r*pr->binSize+br,c*pr->binSize+bc,cols)];
+            nPts++;
+          }
+      binned[calcIdx_2D(r,c,pr->binnedCols)]=sum/nPts;
+    }
   }
-  
-  /*      
+}
+
+//De-bin a panel
+static void exafelSZ_panelDebin(exafelSZ_params *pr, const float *binned, size_t rows, size_t cols, float *panel){
+  size_t r,c,br,bc;
+  for(r=0;r<pr->binnedRows;r++) //Row of the binnedData
+    for(c=0;c<pr->binnedCols;c++) //Column of the binnedData
+      for(br=0;br<pr->binSize;br++) //Bin Row (from origData)
+        for(bc=0;bc<pr->binSize;bc++) //Bin Column (from origData)
+          if(r*pr->binSize+br<rows && c*pr->binSize+bc<cols)
+            panel[calcIdx_2D(r*pr->binSize+br,c*pr->binSize+bc,cols)]=binned[calcIdx_2D(r,c,pr->binnedCols)];
+}
+
+/*
+  Compress the binned data with SZ and write the compressed buffer of a batch of nEvents events.
+
   Compressed buffer format: (Types are indicated in parenthesis)
     WRITE: nPeaksTotal(uint64_t) (Total number of peaks in this batch)
     for(e=0;e<nEvents;e++){  (e for "event")
@@ -237,93 +213,113 @@ unsigned char * exafelSZ_Compress(void* _pr,
     ROI_data : roiSavedCount x 4 : roiSavedCount x float 
     szCompressedSize : 8 : uint64_t
     szComp : szComp x 1 : szComp x (unsigned char)
-  */
-  (*compressedSize)=8+nEvents*8+nPeaksTotal*(2+2+2)+8+roiSavedCount*4+8+szCompressedSize;
-  //compressedBuffer=new uint8_t[(*compressedSize)];
+*/
+static unsigned char * exafelSZ_pack(exafelSZ_params *pr, size_t nEvents, size_t panels, const uint8_t *peaks, uint64_t peaksBytes,
+                       const float *roiData, uint64_t roiSavedCount, float *binnedData, size_t *compressedSize)
+{
+  uint64_t nPeaksTotal=(peaksBytes-8*nEvents)/6;  //Total number of peaks
+  size_t nBinned=nEvents*panels*pr->binnedRows*pr->binnedCols;
+
+  //Additional compression using SZ:
+  size_t szCompressedSize=0;
+  unsigned char* szComp=NULL;
+  switch(pr->szDim){
+    case 1:
+      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0,0,0, nBinned);
+      break;
+    case 2:
+      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0,0, nEvents * panels * pr->binnedRows, pr->binnedCols);
+      break;
+    case 3:
+      szComp=SZ_compress_args(SZ_FLOAT, binnedData, &szCompressedSize, ABS, pr->tolerance, 0, 0, 0, 0, nEvents * panels, pr->binnedRows, pr->binnedCols);
+      break;
+    default:
+      printf("ERROR: Wrong szDim : %d It must be 1,2 or 3.\n",(int)pr->szDim);
+      assert(0);
+  }
+
+  (*compressedSize)=8+peaksBytes+8+roiSavedCount*4+8+szCompressedSize;
   uint8_t * compressedBuffer=(uint8_t*)malloc(*compressedSize);
-  uint64_t bytePos;
-  
-  bytePos=0;
-  //*(uint64_t*)(&compressedBuffer[bytePos])=nEvents;
-  //bytePos+=8;
+  uint64_t bytePos=0;
   *(uint64_t*)(&compressedBuffer[bytePos])=nPeaksTotal;
   bytePos+=8;
-  // cout<<endl;
-  // cout<<"COMPRESS:"<<endl;
-  // cout<<"nPeaksTotal="<<nPeaksTotal<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("\nCOMPRESS:\n");
-  //printf("nPeaksTotal=%d\n",nPeaksTotal);
-  //printf("bytePos=%d\n",bytePos);
-  
-  peaksBytePos=0;
-  for(e=0;e<nEvents;e++){
-    uint64_t nPeaks=*(uint64_t*)(&pr->peaks[peaksBytePos]);
-    peaksBytePos+=8;
-    //peaksBytePos+=8;//Skip the second one. This is due to the error in Python!
-    
-    *(uint64_t*)(&compressedBuffer[bytePos])=nPeaks;
-    bytePos+=8;
-    for(pk=0;pk<nPeaks;pk++){
-      *(uint16_t*)(&compressedBuffer[bytePos])=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Panel for the current peak
-      bytePos+=2;
-      peaksBytePos+=2;
-      *(uint16_t*)(&compressedBuffer[bytePos])=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Row for the current peak
-      bytePos+=2;
-      peaksBytePos+=2;      
-      *(uint16_t*)(&compressedBuffer[bytePos])=*(uint16_t*)(&pr->peaks[peaksBytePos]); //Column for the current peak
-      bytePos+=2;
-      peaksBytePos+=2;
-    }
-  }
-  // cout<<"peaks"<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("peaks\n");
-  //printf("bytePos=%d\n",bytePos);
-
+  memcpy(&compressedBuffer[bytePos],peaks,peaksBytes);
+  bytePos+=peaksBytes;
   *(uint64_t*)(&compressedBuffer[bytePos])=roiSavedCount;
   bytePos+=8;
-  // cout<<"roiSavedCount="<<roiSavedCount<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  // cout<<"roiData"<<endl;
-  //printf("roiSavedCount=%d\n",roiSavedCount);
-  //printf("bytePos=%d\n",bytePos);
-  //printf("roiData\n");
-  for(roii=0;roii<roiSavedCount;roii++){
-    *(float*)(&compressedBuffer[bytePos])=roiData[roii];
-    // cout<<roiData[roii]<<",";
-    bytePos+=4;
-  }
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("bytePos=%d\n",bytePos);
+  memcpy(&compressedBuffer[bytePos],roiData,roiSavedCount*4);
+  bytePos+=roiSavedCount*4;
   *(uint64_t*)(&compressedBuffer[bytePos])=szCompressedSize;
   bytePos+=8;
-  // cout<<"szCompressedSize="<<szCompressedSize<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("szCompressedSize=%d\n",szCompressedSize);
-  //printf("bytePos=%d\n",bytePos);
-  for(bi=0;bi<szCompressedSize;bi++){  //bi for "byte index"
-    *(unsigned char*)(&compressedBuffer[bytePos])=szComp[bi];
-    bytePos+=1;
-  }
-  // cout<<"szComp"<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("szComp\n");
-  //printf("bytePos=%d\n",bytePos);
-  
+  memcpy(&compressedBuffer[bytePos],szComp,szCompressedSize);
+  bytePos+=szCompressedSize;
+
   if(bytePos!=(*compressedSize)){
-    printf("ERROR: bytePos = %ld != %ld = compressedSize\n",(long)bytePos,(long)compressedSize);
+    printf("ERROR: bytePos = %ld != %ld = compressedSize\n",(long)bytePos,(long)(*compressedSize));
     assert(0);
   }
-  
   free(szComp);
-  free(roiM);
+  return compressedBuffer;
+}
+
+unsigned char * exafelSZ_Compress(void* _pr,
+                       void* _origData,
+                       size_t nEvents, size_t panels, size_t rows, size_t cols,
+                       size_t *compressedSize)
+{
+  float *origData=(float*)_origData;
+  exafelSZ_params *pr=(exafelSZ_params*)_pr;
+  
+  exafelSZ_params_process(pr, panels, rows, cols); 
+  exafelSZ_params_checkDecomp(pr, panels, rows, cols); 
+  
+  size_t nPanels=nEvents*panels, panelSize=rows*cols, binnedSize=pr->binnedRows*pr->binnedCols;
+  uint64_t *peaksOffsets=(uint64_t*)malloc(nEvents*sizeof(uint64_t));
+  uint64_t peaksBytes=exafelSZ_peaksOffsets(pr->peaks, nEvents, panels, rows, cols, peaksOffsets);
+  float *binnedData=(float*)malloc(nPanels*binnedSize*sizeof(float));
+  float **roiPanels=(float**)malloc(nPanels*sizeof(float*)); //ROI pixels of every panel
+  size_t *roiCounts=(size_t*)malloc(nPanels*sizeof(size_t));
+  long long i;
+
+  //Mask, save the ROI and bin every panel of every event:
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint8_t *roiM=(uint8_t*)malloc(panelSize);
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for(i=0;i<(long long)nPanels;i++){
+      const float *panel=origData+i*panelSize;
+      exafelSZ_panelMask(pr, pr->peaks+peaksOffsets[i/panels], i%panels, rows, cols, roiM);
+      roiCounts[i]=exafelSZ_panelROI(roiM, panel, panelSize, NULL);
+      roiPanels[i]=(float*)malloc(roiCounts[i]*sizeof(float)+1);
+      exafelSZ_panelROI(roiM, panel, panelSize, roiPanels[i]);
+      exafelSZ_panelBin(pr, panel, rows, cols, binnedData+i*binnedSize);
+    }
+    free(roiM);
+  }
+
+  //Gather the ROI in the order of the events and panels:
+  uint64_t roiSavedCount=0;
+  for(i=0;i<(long long)nPanels;i++)
+    roiSavedCount+=roiCounts[i];
+  float *roiData=(float*)malloc(roiSavedCount*sizeof(float)+1);
+  roiSavedCount=0;
+  for(i=0;i<(long long)nPanels;i++){
+    memcpy(roiData+roiSavedCount,roiPanels[i],roiCounts[i]*sizeof(float));
+    roiSavedCount+=roiCounts[i];
+    free(roiPanels[i]);
+  }
+
+  unsigned char *compressedBuffer=exafelSZ_pack(pr, nEvents, panels, pr->peaks, peaksBytes, roiData, roiSavedCount, binnedData, compressedSize);
+
+  free(peaksOffsets);
+  free(roiPanels);
+  free(roiCounts);
   free(roiData);
   free(binnedData);
-  // delete [] roiM;
-  // delete [] roiData;
-  // delete [] binnedData;
-  
   return compressedBuffer;
 }
 
@@ -337,12 +333,6 @@ void* exafelSZ_Decompress(void *_pr,
   exafelSZ_params_process(pr, panels, rows, cols); 
   exafelSZ_params_checkDecomp(pr, panels, rows, cols); 
   
-  float *decompressedBuffer=(float*)malloc(nEvents*panels*rows*cols*sizeof(float));
-  
-  uint8_t *roiM=(uint8_t*)malloc(nEvents*panels*rows*cols);
-  size_t e,p,r,c,pk,ri,ci,br,bc;
-  
-  
   /*
   Compressed Data Layout:
   nPeaksTotal : 8 bytes : (1 x uint64_t)
@@ -355,113 +345,23 @@ void* exafelSZ_Decompress(void *_pr,
   uint64_t bytePos=0;
   uint64_t nPeaksTotal=*(uint64_t*)(&compressedBuffer[bytePos]);
   bytePos += 8; 
-  // cout<<endl;
-  // cout<<"DECOMPRESS:"<<endl;
-  // cout<<"nPeaksTotal="<<nPeaksTotal<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("\nDECOMPRESS:\n");
-  //printf("nPeaksTotal=%d\n",nPeaksTotal);
-  //printf("bytePos=%d\n",bytePos);
-  
   uint8_t *peaks=(uint8_t*)(&compressedBuffer[bytePos]);
   bytePos += (8 * nEvents + nPeaksTotal * 3 * 2);
-  // cout<<"peaks"<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("peaks\n");
-  //printf("bytePos=%d\n",bytePos);
-  
   uint64_t roiSavedCount=*(uint64_t*)(&compressedBuffer[bytePos]);
   bytePos+=8;
-  // cout<<"roiSavedCount="<<roiSavedCount<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("roiSavedCount=%d\n",roiSavedCount);
-  //printf("bytePos=%d\n",bytePos);
-  
-  // cout<<"roiData"<<endl;
   float *roiData=(float*)(&compressedBuffer[bytePos]);
   bytePos+=(roiSavedCount*4);
-  // for(uint64_t roii=0;roii<roiSavedCount;roii++){
-    // cout<<roiData[roii]<<",";
-  // }
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("bytePos=%d\n",bytePos);
-  
   uint64_t szCompressedSize=*(uint64_t*)(&compressedBuffer[bytePos]);
   bytePos+=8;
-  // cout<<"szCompressedSize="<<szCompressedSize<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  //printf("szCompressedSize=%d\n",szCompressedSize);
-  //printf("bytePos=%d\n",bytePos);
-  
   unsigned char *szComp=(unsigned char*)(&compressedBuffer[bytePos]);
   bytePos+=szCompressedSize;
-  // cout<<"szComp"<<endl;
-  // cout<<"bytePos="<<bytePos<<endl;
-  // cout<<endl;
-  //printf("szComp\n");
-  //printf("bytePos=%d\n\n",bytePos);
-  
-  //We should have inputs ready by now. Now process them:
-  
-  //Generate the ROI mask: NOTE: 0 means affirmative in ROI mask! This comes from the python scripts!
-  //First, initialize with calibration panel:
-  for(e=0;e<nEvents;e++){ //Event
-    for(p=0;p<panels;p++){ //Panel
-      for(r=0;r<rows;r++){ //Row
-        for(c=0;c<cols;c++){ //Column
-          if(calcIdx_2D(r,c,cols)<0 ||calcIdx_2D(r,c,cols)>=rows*cols){
-            printf("ERROR: calcIdx_2D(r,c,cols) = calcIdx_2D(%d,%d,%d) = %d",(int)r,(int)c,(int)cols,(int)calcIdx_2D(r,c,cols));
-            printf("       is NOT in the correct range: [0,%ld]",(int)rows*cols-1);
-            assert(0);
-          }
-          if(calcIdx_4D(e,p,r,c,panels,rows,cols)<0 ||calcIdx_4D(e,p,r,c,panels,rows,cols)>=nEvents*panels*rows*cols){
-            printf("ERROR: calcIdx_4D(e,p,r,c,panels,rows,cols) = calcIdx_4D(%d,%d,%d,%d,%d,%d,%d) = %d",(int)e,(int)p,(int)r,(int)c,(int)panels,(int)rows,(int)cols,(int)calcIdx_4D(e,p,r,c,panels,rows,cols));
-            assert(0);
-          }
-          roiM[calcIdx_4D(e,p,r,c,panels,rows,cols)]=pr->calibPanel[calcIdx_2D(r,c,cols)];
-        }
-      }
-    }
-  }
-  uint64_t peaksBytePos=0; //Position in the peaks buffer
-  //Now process the peaks and generate the mask:
-  for(e=0;e<nEvents;e++){ //Event
-    uint64_t nPeaks=*(uint64_t*)(&peaks[peaksBytePos]);
-    peaksBytePos+=8;
-    
-    for(pk=0;pk<nPeaks;pk++){
-      uint16_t p_=*(uint16_t*)(&peaks[peaksBytePos]); //Panel for the current peak
-      peaksBytePos+=2;
-      uint16_t r_=*(uint16_t*)(&peaks[peaksBytePos]); //Row for the current peak
-      peaksBytePos+=2;
-      uint16_t c_=*(uint16_t*)(&peaks[peaksBytePos]); //Col for the current peak
-      peaksBytePos+=2;
-      
-      if(p_<0 || p_>=panels){
-        printf("ERROR: Peak coordinate out of bounds: Panel=%d, Valid range: 0,%d\n",(int)p_,(int)panels-1);
-        assert(0);
-      }
-      if(r_<0 || r_>=rows){
-        printf("ERROR: Peak coordinate out of bounds: Row=%d, Valid range: 0,%d\n",(int)r_,(int)rows-1);
-        assert(0);
-      }
-      if(c_<0 || c_>=cols){
-        printf("ERROR: Peak coordinate out of bounds: Col=%d, Valid range: 0,%d\n",(int)c_,(int)cols-1);
-        assert(0);
-      }
-      
-      for(ri=r_-pr->peakRadius;ri<=r_+pr->peakRadius;ri++){  //ri: row index. Just a temporary variable.
-        for(ci=c_-pr->peakRadius;ci<=c_+pr->peakRadius;ci++){  //ci: column index. Just a temporary variable.
-          if(ri>=0 && ri<rows && ci>=0 && ci<cols){  //Check whether inside bounds or not
-            roiM[calcIdx_4D(e,p_,ri,ci,panels,rows,cols)]=0;
-          }
-        }
-      }
-    }
+  if(bytePos>compressedSize){
+    printf("ERROR: the compressed data (%ld bytes) is shorter than its layout (%ld bytes)\n",(long)compressedSize,(long)bytePos);
+    return NULL;
   }
   
   //De-compress using SZ:
-  float* szDecomp;
+  float* szDecomp=NULL;
   size_t _szCompressedSize=szCompressedSize;
   switch(pr->szDim){
     case 1:
@@ -477,43 +377,183 @@ void* exafelSZ_Decompress(void *_pr,
       printf("ERROR: Wrong szDim : %d It must be 1,2 or 3.\n",(int)pr->szDim);
       assert(0);
   }
-  //szDecomp=(void*)malloc(nEvents*panels*rows*cols*sizeof(float));
-  
-  // double max_err = 0;
-  // for(int i=0; i<nEvents * panels * pr->binnedRows * pr->binnedCols; i++){
-    // double err = fabs(szDecomp[i]-binnedData[i]);
-    // if(err > max_err) max_err = err;
-  // }
-  // cout << "Max err = \t\t\t" << max_err << endl;
-  
+  if(szDecomp==NULL)
+    return NULL;
 
-  //De-binning:
-  for(e=0;e<nEvents;e++)//Event
-    for(p=0;p<panels;p++)  //Panel
-      for(r=0;r<pr->binnedRows;r++) //Row of the binnedData
-        for(c=0;c<pr->binnedCols;c++) //Column of the binnedData
-            for(br=0;br<pr->binSize;br++) //Bin Row (from origData)
-              for(bc=0;bc<pr->binSize;bc++) //Bin Column (from origData)
-                if(r*pr->binSize+br<rows && c*pr->binSize+bc<cols){
-                  decompressedBuffer[calcIdx_4D(e,p,r*pr->binSize+br,c*pr->binSize+bc,panels,rows,cols)] = szDecomp[calcIdx_4D(e,p,r,c,panels,pr->binnedRows,pr->binnedCols)];
-                }
-  //Restore ROI:
-  uint64_t current=0;
-  for(e=0;e<nEvents;e++)//Event
-    for(p=0;p<panels;p++)  //Panel
-      for(r=0;r<rows;r++) //Row of the binnedData
-        for(c=0;c<cols;c++) //Column of the binnedData
-          if(!roiM[calcIdx_4D(e,p,r,c,panels,rows,cols)]){
-            decompressedBuffer[calcIdx_4D(e,p,r,c,panels,rows,cols)]=roiData[current];
-            current++;
-          }
-  // delete [] roiM;
-  free(roiM);
+  size_t nPanels=nEvents*panels, panelSize=rows*cols, binnedSize=pr->binnedRows*pr->binnedCols;
+  uint64_t *peaksOffsets=(uint64_t*)malloc(nEvents*sizeof(uint64_t));
+  exafelSZ_peaksOffsets(peaks, nEvents, panels, rows, cols, peaksOffsets);
+  uint64_t *roiOffsets=(uint64_t*)malloc((nPanels+1)*sizeof(uint64_t)); //the ROI pixels of the panel i start at roiData[roiOffsets[i]]
+  float *decompressedBuffer=(float*)malloc(nPanels*panelSize*sizeof(float));
+  long long i;
+
+  //Count the ROI pixels of every panel to find where they start:
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint8_t *roiM=(uint8_t*)malloc(panelSize);
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for(i=0;i<(long long)nPanels;i++){
+      exafelSZ_panelMask(pr, peaks+peaksOffsets[i/panels], i%panels, rows, cols, roiM);
+      roiOffsets[i+1]=exafelSZ_panelROI(roiM, NULL, panelSize, NULL);
+    }
+    free(roiM);
+  }
+  roiOffsets[0]=0;
+  for(i=0;i<(long long)nPanels;i++)
+    roiOffsets[i+1]+=roiOffsets[i];
+  if(roiOffsets[nPanels]!=roiSavedCount){
+    printf("ERROR: the ROI mask has %ld pixels but %ld are saved\n",(long)roiOffsets[nPanels],(long)roiSavedCount);
+    free(peaksOffsets);
+    free(roiOffsets);
+    free(decompressedBuffer);
+    free(szDecomp);
+    return NULL;
+  }
+
+  //De-binning and restore ROI:
+#ifdef _OPENMP
+  #pragma omp parallel
+#endif
+  {
+    uint8_t *roiM=(uint8_t*)malloc(panelSize);
+    size_t j,current;
+#ifdef _OPENMP
+    #pragma omp for schedule(dynamic, 1)
+#endif
+    for(i=0;i<(long long)nPanels;i++){
+      float *panel=decompressedBuffer+i*panelSize;
+      exafelSZ_panelDebin(pr, szDecomp+i*binnedSize, rows, cols, panel);
+      exafelSZ_panelMask(pr, peaks+peaksOffsets[i/panels], i%panels, rows, cols, roiM);
+      current=roiOffsets[i];
+      for(j=0;j<panelSize;j++)
+        if(!roiM[j])
+          panel[j]=roiData[current++];
+    }
+    free(roiM);
+  }
+
+  free(peaksOffsets);
+  free(roiOffsets);
   free(szDecomp);
-  
   return ((void*)decompressedBuffer);
 }
 
+//*********************************************************************************
+//Streaming compression: the events are masked, binned and dropped as they arrive, and every batch of
+//batchEvents events is compressed into the same buffer as exafelSZ_Compress would give for the batch.
+//*********************************************************************************
+
+exafelSZ_stream* exafelSZ_stream_open(exafelSZ_params *pr, size_t batchEvents, size_t panels, size_t rows, size_t cols)
+{
+  if(batchEvents<1){
+    printf("ERROR: batchEvents = %ld must be positive\n",(long)batchEvents);
+    return NULL;
+  }
+  exafelSZ_params_process(pr, panels, rows, cols);
+  exafelSZ_params_checkDecomp(pr, panels, rows, cols);
+  exafelSZ_stream *stream=(exafelSZ_stream*)malloc(sizeof(exafelSZ_stream));
+  stream->pr=pr;
+  stream->batchEvents=batchEvents;
+  stream->panels=panels;
+  stream->rows=rows;
+  stream->cols=cols;
+  stream->nEvents=0;
+  new_DBA(&stream->peaks, 1024);
+  new_DBA(&stream->roiData, 1024);
+  stream->binnedData=(float*)malloc(batchEvents*panels*pr->binnedRows*pr->binnedCols*sizeof(float));
+  stream->roiM=(uint8_t*)malloc(panels*rows*cols);
+  stream->roiEvent=(float*)malloc(panels*rows*cols*sizeof(float));
+  stream->roiCounts=(size_t*)malloc(panels*sizeof(size_t));
+  return stream;
+}
+
+//Compress the events of the current batch and start a new one
+static void exafelSZ_stream_compressBatch(exafelSZ_stream *stream, unsigned char **compressedBytes, size_t *compressedSize)
+{
+  *compressedBytes=exafelSZ_pack(stream->pr, stream->nEvents, stream->panels, stream->peaks->array, stream->peaks->size,
+    (float*)stream->roiData->array, stream->roiData->size/sizeof(float), stream->binnedData, compressedSize);
+  stream->nEvents=0;
+  stream->peaks->size=0;
+  stream->roiData->size=0;
+}
+
+/**
+ * Add an event to the stream: its panels are masked and binned (in parallel) and the event is not kept.
+ *
+ * @param eventData the event (panels x rows x cols)
+ * @param eventPeaks the peaks of the event: nPeaks (uint64_t), then nPeaks x (panel,row,col) (uint16_t x 3)
+ * @param compressedBytes set to the compressed batch (to be freed by the caller) if the event completes
+ * a batch of batchEvents events, else to NULL
+ * @return SZ_SCES
+ * */
+int exafelSZ_stream_push(exafelSZ_stream *stream, float *eventData, uint8_t *eventPeaks,
+                         unsigned char **compressedBytes, size_t *compressedSize)
+{
+  exafelSZ_params *pr=stream->pr;
+  size_t panels=stream->panels, rows=stream->rows, cols=stream->cols, panelSize=rows*cols;
+  size_t binnedSize=pr->binnedRows*pr->binnedCols;
+  float *binnedEvent=stream->binnedData+stream->nEvents*panels*binnedSize;
+  uint64_t peaksOffset;
+  uint64_t peaksBytes=exafelSZ_peaksOffsets(eventPeaks, 1, panels, rows, cols, &peaksOffset);
+  long long p;
+
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for(p=0;p<(long long)panels;p++){
+    uint8_t *roiM=stream->roiM+p*panelSize;
+    const float *panel=eventData+p*panelSize;
+    exafelSZ_panelMask(pr, eventPeaks, p, rows, cols, roiM);
+    stream->roiCounts[p]=exafelSZ_panelROI(roiM, panel, panelSize, stream->roiEvent+p*panelSize);
+    exafelSZ_panelBin(pr, panel, rows, cols, binnedEvent+p*binnedSize);
+  }
+
+  memcpyDBA_Data(stream->peaks, eventPeaks, peaksBytes);
+  for(p=0;p<(long long)panels;p++)
+    memcpyDBA_Data(stream->roiData, (unsigned char*)(stream->roiEvent+p*panelSize), stream->roiCounts[p]*sizeof(float));
+  stream->nEvents++;
+
+  *compressedBytes=NULL;
+  *compressedSize=0;
+  if(stream->nEvents==stream->batchEvents)
+    exafelSZ_stream_compressBatch(stream, compressedBytes, compressedSize);
+  return SZ_SCES;
+}
+
+/**
+ * Compress the events of the incomplete batch, if any.
+ *
+ * @param nEvents set to the number of events of the batch (to be given to exafelSZ_Decompress)
+ * @return SZ_SCES, or SZ_NSCS if there is no event to compress (compressedBytes is set to NULL)
+ * */
+int exafelSZ_stream_flush(exafelSZ_stream *stream, unsigned char **compressedBytes, size_t *compressedSize, size_t *nEvents)
+{
+  *nEvents=stream->nEvents;
+  *compressedBytes=NULL;
+  *compressedSize=0;
+  if(stream->nEvents==0)
+    return SZ_NSCS;
+  exafelSZ_stream_compressBatch(stream, compressedBytes, compressedSize);
+  return SZ_SCES;
+}
+
+void exafelSZ_stream_close(exafelSZ_stream *stream)
+{
+  if(stream==NULL)
+    return;
+  free_DBA(stream->peaks);
+  free_DBA(stream->roiData);
+  free(stream->binnedData);
+  free(stream->roiM);
+  free(stream->roiEvent);
+  free(stream->roiCounts);
+  free(stream);
+}
+
 #ifdef __cplusplus
 }
 #endif
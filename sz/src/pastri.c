@@ -85,3 +85,121 @@ void SZ_pastriCheckBatch(pastri_params *p,unsigned char*originalBuf,unsigned cha
     }
   }
 }
+
+//Upper bound on the bytes written for one block: the uncompressed, non-sparse mode takes at most 2 bytes more
+//than the block, and writeBits_Fast touches up to 8 bytes past the current bit position.
+static size_t pastriMaxBlockBytes(pastri_params *p){
+  return (size_t)p->bSize*p->dataSize+16;
+}
+
+//Only the double (8 bytes) and float (4 bytes) kernels exist
+static int pastriCheckDataSize(pastri_params *p){
+  if(p->dataSize!=8 && p->dataSize!=4){
+    printf("ERROR: Unsupported dataSize %d: Valid sizes: 4,8\n",p->dataSize);
+    return -1;
+  }
+  return 0;
+}
+
+int SZ_pastriCompressBatchIndexed(pastri_params *p,unsigned char *originalBuf, unsigned char** compressedBufP,size_t *compressedBytes){
+  if(pastriCheckDataSize(p)!=0){
+    *compressedBufP=NULL;
+    *compressedBytes=0;
+    return -1;
+  }
+  int numChunks=(p->numBlocks+PASTRI_INDEX_CHUNK-1)/PASTRI_INDEX_CHUNK;
+  size_t blockBytes=(size_t)p->bSize*p->dataSize;
+  size_t maxBlockBytes=pastriMaxBlockBytes(p);
+  unsigned char **chunkBufs=(unsigned char**)malloc(numChunks*sizeof(unsigned char*));
+  uint64_t *blockEnds=(uint64_t*)malloc(p->numBlocks*sizeof(uint64_t)); //first, the bytes of every block
+  int c;
+  
+  //Compress the chunks of blocks into their own zeroed buffers (the bit writers only OR the bits in):
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for(c=0;c<numChunks;c++){
+    int i, first=c*PASTRI_INDEX_CHUNK;
+    int last=first+PASTRI_INDEX_CHUNK<p->numBlocks ? first+PASTRI_INDEX_CHUNK : p->numBlocks;
+    size_t bytePos=0;
+    chunkBufs[c]=(unsigned char*)calloc((last-first)*maxBlockBytes,sizeof(char));
+    for(i=first;i<last;i++){
+      int bytes; //bytes for this block
+      if(p->dataSize==8){
+        pastri_double_Compress(originalBuf + i*blockBytes,p,chunkBufs[c] + bytePos,&bytes);
+      }else{
+        pastri_float_Compress(originalBuf + i*blockBytes,p,chunkBufs[c] + bytePos,&bytes);
+      }
+      blockEnds[i]=bytes;
+      bytePos+=bytes;
+    }
+  }
+  
+  int i;
+  for(i=1;i<p->numBlocks;i++)
+    blockEnds[i]+=blockEnds[i-1];
+  size_t headerBytes=sizeof(pastri_params)+p->numBlocks*sizeof(uint64_t);
+  size_t dataBytes=p->numBlocks>0 ? blockEnds[p->numBlocks-1] : 0;
+  *compressedBytes=headerBytes+dataBytes;
+  *compressedBufP=(unsigned char*)malloc(*compressedBytes);
+  memcpy(*compressedBufP, p, sizeof(pastri_params));
+  memcpy(*compressedBufP+sizeof(pastri_params), blockEnds, p->numBlocks*sizeof(uint64_t));
+  
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, 1)
+#endif
+  for(c=0;c<numChunks;c++){
+    int first=c*PASTRI_INDEX_CHUNK;
+    int last=first+PASTRI_INDEX_CHUNK<p->numBlocks ? first+PASTRI_INDEX_CHUNK : p->numBlocks;
+    uint64_t start=first>0 ? blockEnds[first-1] : 0;
+    memcpy(*compressedBufP+headerBytes+start, chunkBufs[c], blockEnds[last-1]-start);
+    free(chunkBufs[c]);
+  }
+  free(chunkBufs);
+  free(blockEnds);
+  return 0;
+}
+
+//Decompress the block i of an indexed batch into outBuf (p is the header of the batch, with a supported dataSize)
+static void pastriDecompressIndexedBlock(unsigned char*compressedBuf, pastri_params *p, int i, unsigned char *outBuf){
+  uint64_t *blockEnds=(uint64_t*)(compressedBuf+sizeof(pastri_params));
+  unsigned char *blockData=compressedBuf+sizeof(pastri_params)+p->numBlocks*sizeof(uint64_t)+(i>0 ? blockEnds[i-1] : 0);
+  int bytes; //bytes for this block
+  if(p->dataSize==8){
+    pastri_double_Decompress(blockData,p->dataSize,p,outBuf,&bytes);
+  }else{
+    pastri_float_Decompress(blockData,p->dataSize,p,outBuf,&bytes);
+  }
+}
+
+int SZ_pastriDecompressBatchIndexed(unsigned char*compressedBuf, pastri_params *p, unsigned char** decompressedBufP ,size_t *decompressedBytes){
+  memcpy(p, compressedBuf, sizeof(pastri_params));
+  if(pastriCheckDataSize(p)!=0){
+    *decompressedBufP=NULL;
+    *decompressedBytes=0;
+    return -1;
+  }
+  size_t blockBytes=(size_t)p->bSize*p->dataSize;
+  (*decompressedBufP) = (unsigned char*)malloc(p->numBlocks*blockBytes*sizeof(char));
+  int i;
+  
+#ifdef _OPENMP
+  #pragma omp parallel for schedule(dynamic, PASTRI_INDEX_CHUNK)
+#endif
+  for(i=0;i<p->numBlocks;i++)
+    pastriDecompressIndexedBlock(compressedBuf, p, i, (*decompressedBufP) + i*blockBytes);
+  *decompressedBytes=p->numBlocks*blockBytes;
+  return 0;
+}
+
+int SZ_pastriDecompressBlock(unsigned char*compressedBuf, int blockIndex, pastri_params *p, unsigned char* blockBuf){
+  memcpy(p, compressedBuf, sizeof(pastri_params));
+  if(blockIndex<0 || blockIndex>=p->numBlocks){
+    printf("ERROR: Block index %d out of range: Valid range: 0,%d\n",blockIndex,p->numBlocks-1);
+    return -1;
+  }
+  if(pastriCheckDataSize(p)!=0)
+    return -1;
+  pastriDecompressIndexedBlock(compressedBuf, p, blockIndex, blockBuf);
+  return 0;
+}
@@ -24,24 +24,23 @@
 #include "conf.h"
 #include "utility.h"
 #include "exafelSZ.h"
+#include "sz_tctx.h"
 //#include "CurveFillingCompressStorage.h"
 
+//sz.c reads the time-step state of the variables (SZ_Variable::multisteps), and binds it to the tasks of the batch engine explicitly
+#undef multisteps
+
 int versionNumber[4] = {SZ_VER_MAJOR,SZ_VER_MINOR,SZ_VER_BUILD,SZ_VER_REVISION};
 //int SZ_SIZE_TYPE = 8;
 
 int dataEndianType = LITTLE_ENDIAN_DATA; //*endian type of the data read from disk
 int sysEndianType; //*sysEndianType is actually set automatically.
 
-//the confparams should be separate between compression and decopmression, in case of mutual-affection when calling compression/decompression alternatively
-sz_params *confparams_cpr = NULL; //used for compression
-sz_params *confparams_dec = NULL; //used for decompression 
-
-sz_exedata *exe_params = NULL;
+//confparams_cpr, confparams_dec, exe_params and multisteps: see sz_tctx.c
 
 /*following global variables are desgined for time-series based compression*/
 /*sz_varset is not used in the single-snapshot data compression*/
 SZ_VarSet* sz_varset = NULL;
-sz_multisteps *multisteps = NULL;
 sz_tsc_metadata *sz_tsc = NULL;
 
 //only for Pastri compressor
@@ -150,6 +149,104 @@ size_t computeDataLength(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 	return dataLength;
 }
 
+static unsigned char* SZ_compress_args_fixedRatio_pass(int cmprType, int dataType, void *data, size_t *outSize, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, double absErrBound)
+{
+	unsigned char *bytes = NULL;
+	if(dataType==SZ_FLOAT)
+		SZ_compress_args_float(cmprType, &bytes, (float *)data, r5, r4, r3, r2, r1, outSize, ABS, absErrBound, 0, 0);
+	else
+		SZ_compress_args_double(cmprType, &bytes, (double *)data, r5, r4, r3, r2, r1, outSize, ABS, absErrBound, 0, 0);
+	return bytes;
+}
+
+/**
+ * FIXED_RATIO mode of SZ_compress_args() (float and double data): the error bound is searched on samples
+ * for the target ratio (confparams_cpr->fixedRatio, or the bits per value confparams_cpr->fixedBitRate),
+ * then the data are compressed with it as an ABS bound. If the compressed size misses the target by more
+ * than SZ_FIXED_RATIO_TOLERANCE, the search is run again with the target corrected by the error of the
+ * estimation at that bound (even if the search missed its own target) and the data are compressed a second
+ * time: the closer of the two is returned.
+ * 
+ * cmprType (SZ_FORCE_SNAPSHOT_COMPRESSION etc., or -1) is passed on to SZ_compress_args_float/double().
+ * When the compressions have a state (the previous time step in SZ_TEMPORAL_COMPRESSION mode, or a Huffman
+ * tree dictionary), the passes of the search run without the dictionary and do not change the previous step:
+ * the data are compressed once more with the error bound found. The estimations are those of the snapshot
+ * compression, so the steps compressed based on the previous one may miss SZ_FIXED_RATIO_TOLERANCE.
+ * */
+unsigned char* SZ_compress_args_fixedRatio(int cmprType, int dataType, void *data, size_t *outSize, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t typeSize = dataType==SZ_FLOAT ? sizeof(float) : sizeof(double);
+	size_t histSize = computeDataLength(r5,r4,r3,r2,r1)*typeSize;
+	double oriSize = (double)histSize;
+	double targetRatio = confparams_cpr->fixedRatio > 0 ? confparams_cpr->fixedRatio : 
+		(confparams_cpr->fixedBitRate > 0 ? typeSize*8/confparams_cpr->fixedBitRate : 0);
+	if(targetRatio <= 0)
+	{
+		printf("Error: the FIXED_RATIO mode needs a positive fixedRatio or fixedBitRate\n");
+		return NULL;
+	}
+	double targetSize = oriSize/targetRatio, correction = 1, absErrBound, bestErrBound = 0, userAbsErrBound = confparams_cpr->absErrBound;
+	unsigned char *bytes = NULL, *best = NULL;
+	size_t bestSize = 0;
+	sz_estimation est;
+	int pass;
+
+	sz_huffman_dict* dict = sz_huffman_dict_current();
+	sz_multisteps *steps = *sz_multisteps_ref(), savedSteps;
+	void* savedHist = NULL;
+	int stateful = dict != NULL;
+#ifdef HAVE_TIMECMPR
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION && steps != NULL && steps->hist_data != NULL)
+	{
+		savedHist = malloc(histSize);
+		memcpy(savedHist, steps->hist_data, histSize);
+		memcpy(&savedSteps, steps, sizeof(sz_multisteps));
+		stateful = 1;
+	}
+#endif
+	if(stateful)
+		sz_huffman_dict_swap(NULL);
+
+	for(pass = 0; pass < 2; pass++)
+	{
+		if(SZ_estimate_errorBound(dataType, data, r5, r4, r3, r2, r1, confparams_cpr, targetRatio*correction, &absErrBound, &est)!=SZ_SCES)
+			break;
+		bytes = SZ_compress_args_fixedRatio_pass(cmprType, dataType, data, outSize, r5, r4, r3, r2, r1, absErrBound);
+		if(savedHist != NULL)
+		{
+			memcpy(steps->hist_data, savedHist, histSize);
+			memcpy(steps, &savedSteps, sizeof(sz_multisteps));
+		}
+		if(best==NULL || fabs(*outSize - targetSize) < fabs(bestSize - targetSize))
+		{
+			free(best);
+			best = bytes;
+			bestSize = *outSize;
+			bestErrBound = absErrBound;
+		}
+		else
+			free(bytes);
+		if(fabs(bestSize - targetSize) <= SZ_FIXED_RATIO_TOLERANCE*targetSize)
+			break;
+		correction *= est.ratio*(*outSize)/oriSize; //estimated/actual ratio at this error bound
+	}
+	if(stateful)
+	{
+		sz_huffman_dict_swap(dict);
+		if(best != NULL)
+		{
+			free(best);
+			best = SZ_compress_args_fixedRatio_pass(cmprType, dataType, data, &bestSize, r5, r4, r3, r2, r1, bestErrBound);
+		}
+		free(savedHist);
+	}
+	//the compressors switch to ABS: keep the mode for the next compressions
+	confparams_cpr->errorBoundMode = FIXED_RATIO;
+	confparams_cpr->absErrBound = userAbsErrBound;
+	*outSize = bestSize;
+	return best;
+}
+
 /*-------------------------------------------------------------------------*/
 /**
     @brief      Perform Compression 
@@ -178,21 +275,34 @@ double relBoundRatio, double pwrBoundRatio, size_t r5, size_t r4, size_t r3, siz
 	}
 	
 	confparams_cpr->dataType = dataType;
-	if(dataType==SZ_FLOAT)
+	if((dataType==SZ_FLOAT || dataType==SZ_DOUBLE) && errBoundMode==FIXED_RATIO)
+		return SZ_compress_args_fixedRatio(-1, dataType, data, outSize, r5, r4, r3, r2, r1);
+	else if(dataType==SZ_FLOAT || dataType==SZ_DOUBLE)
 	{
 		unsigned char *newByteData = NULL;
+		sz_params userParams;
+		//autotune mode: compress with the settings tuned for this field and this error bound, then restore the user's ones
+		int tuned = confparams_cpr->autotune!=SZ_TUNE_NONE && errBoundMode<PW_REL && r5==0;
+		if(tuned)
+		{
+			memcpy(&userParams, confparams_cpr, sizeof(sz_params));
+			confparams_cpr->errorBoundMode = errBoundMode;
+			confparams_cpr->absErrBound = absErrBound;
+			confparams_cpr->relBoundRatio = relBoundRatio;
+			tuned = SZ_autotune(dataType, data, r5, r4, r3, r2, r1, confparams_cpr, NULL)==SZ_SCES;
+			if(!tuned)
+				memcpy(confparams_cpr, &userParams, sizeof(sz_params));
+		}
 		
-		SZ_compress_args_float(-1, &newByteData, (float *)data, r5, r4, r3, r2, r1, 
-		outSize, errBoundMode, absErrBound, relBoundRatio, pwrBoundRatio);
-		
-		return newByteData;
-	}
-	else if(dataType==SZ_DOUBLE)
-	{
-		unsigned char *newByteData;
-		SZ_compress_args_double(-1, &newByteData, (double *)data, r5, r4, r3, r2, r1, 
-		outSize, errBoundMode, absErrBound, relBoundRatio, pwrBoundRatio);
+		if(dataType==SZ_FLOAT)
+			SZ_compress_args_float(-1, &newByteData, (float *)data, r5, r4, r3, r2, r1, 
+			outSize, errBoundMode, absErrBound, relBoundRatio, pwrBoundRatio);
+		else
+			SZ_compress_args_double(-1, &newByteData, (double *)data, r5, r4, r3, r2, r1, 
+			outSize, errBoundMode, absErrBound, relBoundRatio, pwrBoundRatio);
 		
+		if(tuned)
+			memcpy(confparams_cpr, &userParams, sizeof(sz_params));
 		return newByteData;
 	}
 	else if(dataType==SZ_INT64)
@@ -362,61 +472,61 @@ void *SZ_decompress(int dataType, unsigned char *bytes, size_t byteLength, size_
 	
 	if(dataType == SZ_FLOAT)
 	{
-		float *newFloatData;
+		float *newFloatData = NULL;
 		SZ_decompress_args_float(&newFloatData, r5, r4, r3, r2, r1, bytes, byteLength, 0, NULL);
 		return newFloatData;	
 	}
 	else if(dataType == SZ_DOUBLE)
 	{
-		double *newDoubleData;
+		double *newDoubleData = NULL;
 		SZ_decompress_args_double(&newDoubleData, r5, r4, r3, r2, r1, bytes, byteLength, 0, NULL);
 		return newDoubleData;	
 	}
 	else if(dataType == SZ_INT8)
 	{
-		int8_t *newInt8Data;
+		int8_t *newInt8Data = NULL;
 		SZ_decompress_args_int8(&newInt8Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newInt8Data;
 	}
 	else if(dataType == SZ_INT16)
 	{
-		int16_t *newInt16Data;
+		int16_t *newInt16Data = NULL;
 		SZ_decompress_args_int16(&newInt16Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newInt16Data;
 	}
 	else if(dataType == SZ_INT32)
 	{
-		int32_t *newInt32Data;
+		int32_t *newInt32Data = NULL;
 		SZ_decompress_args_int32(&newInt32Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newInt32Data;
 	}
 	else if(dataType == SZ_INT64)
 	{
-		int64_t *newInt64Data;
+		int64_t *newInt64Data = NULL;
 		SZ_decompress_args_int64(&newInt64Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newInt64Data;
 	}
 	else if(dataType == SZ_UINT8)
 	{
-		uint8_t *newUInt8Data;
+		uint8_t *newUInt8Data = NULL;
 		SZ_decompress_args_uint8(&newUInt8Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newUInt8Data;
 	}
 	else if(dataType == SZ_UINT16)
 	{
-		uint16_t *newUInt16Data;
+		uint16_t *newUInt16Data = NULL;
 		SZ_decompress_args_uint16(&newUInt16Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newUInt16Data;
 	}
 	else if(dataType == SZ_UINT32)
 	{
-		uint32_t *newUInt32Data;
+		uint32_t *newUInt32Data = NULL;
 		SZ_decompress_args_uint32(&newUInt32Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newUInt32Data;
 	}
 	else if(dataType == SZ_UINT64)
 	{
-		uint64_t *newUInt64Data;
+		uint64_t *newUInt64Data = NULL;
 		SZ_decompress_args_uint64(&newUInt64Data, r5, r4, r3, r2, r1, bytes, byteLength);
 		return newUInt64Data;
 	}
@@ -723,6 +833,11 @@ void SZ_printMetadata(sz_metadata* metadata)
 		printf("errBoundMode:                   \t PSNR\n");
 		printf("psnr:                           \t %f\n", params->psnr);
 		break;
+	case FIXED_RATIO:
+		printf("errBoundMode:                   \t FIXED_RATIO\n");
+		printf("fixedRatio:                     \t %f\n", params->fixedRatio);
+		printf("fixedBitRate:                   \t %f\n", params->fixedBitRate);
+		break;
 	case PW_REL:
 		printf("errBoundMode:                   \t PW_REL\n");
 		break;
@@ -839,235 +954,255 @@ int SZ_deregisterVar(char* varName)
 	return state;
 }
 
+/**
+ * deregister all the variables (their data buffers belong to the application and are kept)
+ * */
+int SZ_deregisterAllVars()
+{
+	SZ_freeVarSet(SZ_MAINTAIN_VAR_DATA);
+	return SZ_SCES;
+}
+
 #ifdef HAVE_TIMECMPR
+
+static size_t getVarByteSize(SZ_Variable* v)
+{
+	size_t dataLen = computeDataLength(v->r5, v->r4, v->r3, v->r2, v->r1);
+	return v->dataType==SZ_FLOAT ? dataLen*sizeof(float) : dataLen*sizeof(double);
+}
+
+static int compareVarByteSize(const void* a, const void* b)
+{
+	size_t x = getVarByteSize(*(SZ_Variable* const*)a), y = getVarByteSize(*(SZ_Variable* const*)b);
+	return (x < y) - (x > y); //descending order
+}
+
 /**
- * process multiple variables
+ * compress one variable of the batch with the task's private copies of the parameters,
+ * so that it can run concurrently with the other variables
  * */
-int SZ_compress_ts_select_var(int cmprType, unsigned char* var_ids, unsigned char var_count, unsigned char** newByteData, size_t *outSize)
+static void compress_ts_var(int cmprType, SZ_Variable* v, sz_params* base_cpr, sz_exedata* base_exe)
 {
-	confparams_cpr->szMode = SZ_TEMPORAL_COMPRESSION;
-	confparams_cpr->predictionMode = SZ_PREVIOUS_VALUE_ESTIMATE;
+	sz_params cpr;
+	sz_exedata exe;
+	memcpy(&cpr, base_cpr, sizeof(sz_params));
+	memcpy(&exe, base_exe, sizeof(sz_exedata));
+	cpr.dataType = v->dataType; //as in SZ_compress_args, for the meta data of the stream
+	if(cpr.reuseHuffmanTrees && v->multisteps->cmprHuffmanDict==NULL)
+		v->multisteps->cmprHuffmanDict = SZ_createHuffmanDict(0);
+	//the multisteps of the variable are used in the following compression, and its Huffman trees are reused across the steps if enabled
+	sz_thread_context ctx = {.cpr = &cpr, .dec = confparams_dec, .exe = &exe, .multisteps = v->multisteps};
+	if(cpr.reuseHuffmanTrees)
+		ctx.huffmanDict = v->multisteps->cmprHuffmanDict;
+	sz_thread_context* previous = SZ_bindThreadContext(&ctx);
 	
-	SZ_VarSet* vset = sz_varset;
-	int i = 0, j = 0, totalSize = 0;	
+	if(v->compressedBytes!=NULL)
+		free(v->compressedBytes);
+	v->compressedBytes = NULL;
+	v->compressedSize = 0;
 
-	SZ_Variable* vp[256];
-
-	SZ_Variable* v = vset->header->next;	
-	for(i = 0;i<vset->count;i++)
+	if(v->dataType==SZ_FLOAT)
 	{
-		int found = checkVarID(v->var_id, var_ids, var_count);
-		if (found)
-		{
-			multisteps = v->multisteps;
-			if(v->dataType==SZ_FLOAT)
-			{
-				SZ_compress_args_float(cmprType, &(v->compressedBytes), (float*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
-			}
-			else if(v->dataType==SZ_DOUBLE)
-			{
-				SZ_compress_args_double(cmprType, &(v->compressedBytes), (double*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
-			}
-		
-			totalSize += v->compressedSize;
-			v->compressType = multisteps->compressionType;
-			vp[j] = v;
-			j++;
-		}
-		v = v->next;
+		SZ_compress_args_float(cmprType, &(v->compressedBytes), (float*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
 	}
-	
-	*outSize = sizeof(int) + sizeof(unsigned short) + totalSize + var_count*(3*sizeof(unsigned char)+sizeof(size_t));
-	*newByteData = (unsigned char*)malloc(*outSize); 
-	unsigned char* p = *newByteData;
-
-	intToBytes_bigEndian(p, sz_tsc->currentStep);
-	p+=4;
-	shortToBytes(p, var_count);
-	p+=2;
-
-	for(i=0;i<var_count;i++)
+	else if(v->dataType==SZ_DOUBLE)
 	{
-		v = vp[i];
-		*p = v->var_id; //1 byte
-		p++;
-		*p = (unsigned char)v->compressType; //1 byte
-		p++;
-		*p = (unsigned char)v->dataType; //1 byte
-		p++;
-		sizeToBytes(p, v->compressedSize); //size_t
-		p += sizeof(size_t);							
-		memcpy(p, v->compressedBytes, v->compressedSize); //outSize_[i]
-		p += v->compressedSize;
+		SZ_compress_args_double(cmprType, &(v->compressedBytes), (double*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
 	}
-
-	sz_tsc->currentStep ++;	
+	v->compressType = v->multisteps->compressionType;
 	
-	return SZ_SCES;	
+	SZ_bindThreadContext(previous);
 }
 
 /**
- * process all variables
+ * The batch engine: compress the variables concurrently (largest first, for load balance), 
+ * and then assemble the output stream:
+ * SZ_TS_FORMAT_FLAG|SZ_TS_FORMAT_VERSION (1 byte) + current step (4 bytes) + # variables (4 bytes) + 
+ * table of contents {var_id (4 bytes) + compressType + dataType + compressedSize (size_t)} per variable + 
+ * the compressed bytes of the variables, in the order of the table
+ * With confparams_cpr->reuseHuffmanTrees, each variable has its own Huffman tree dictionary (sz_multisteps::cmprHuffmanDict):
+ * its stream can refer to the trees of its previous steps since its last snapshot instead of storing a tree.
  * */
-int SZ_compress_ts(int cmprType, unsigned char** newByteData, size_t *outSize)
+static int compress_ts_vars(int cmprType, SZ_Variable** vars, unsigned int var_count, unsigned char** newByteData, size_t *outSize)
 {
 	confparams_cpr->szMode = SZ_TEMPORAL_COMPRESSION;
 	confparams_cpr->predictionMode = SZ_PREVIOUS_VALUE_ESTIMATE;
 	
-	SZ_VarSet* vset = sz_varset;
+	sz_params* base_cpr = confparams_cpr;
+	sz_exedata* base_exe = exe_params;
+	int i = 0;
 	
-	//char *metadata_str = (char*)malloc(vset->count*256);
-	//memset(metadata_str, 0, vset->count*256);
-	//sprintf(metadata_str, "step %d", sz_tsc->currentStep);
+	SZ_Variable** order = (SZ_Variable**)malloc(sizeof(SZ_Variable*)*var_count);
+	memcpy(order, vars, sizeof(SZ_Variable*)*var_count);
+	qsort(order, var_count, sizeof(SZ_Variable*), compareVarByteSize);
 	
-	int i = 0, totalSize = 0;
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 1)
+#endif
+	for(i=0;i<(int)var_count;i++)
+		compress_ts_var(cmprType, order[i], base_cpr, base_exe);
+	free(order);
 	
-	SZ_Variable* v = vset->header->next;	
-	for(i=0;i<vset->count;i++)
+	size_t entrySize = sizeof(int)+2*sizeof(unsigned char)+sizeof(size_t);
+	size_t tocSize = 1 + 2*sizeof(int) + var_count*entrySize;
+	size_t* offsets = (size_t*)malloc(sizeof(size_t)*var_count);
+	size_t totalSize = tocSize;
+	for(i=0;i<(int)var_count;i++)
 	{
-		multisteps = v->multisteps; //assign the v's multisteps to the global variable 'multisteps', which will be used in the following compression.
-
-		if(v->dataType==SZ_FLOAT)
-		{
-			SZ_compress_args_float(cmprType, &(v->compressedBytes), (float*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
-		}
-		else if(v->dataType==SZ_DOUBLE)
-		{
-			SZ_compress_args_double(cmprType, &(v->compressedBytes), (double*)v->data, v->r5, v->r4, v->r3, v->r2, v->r1, &(v->compressedSize), v->errBoundMode, v->absErrBound, v->relBoundRatio, v->pwRelBoundRatio);
-		}
-		//sprintf(metadata_str, "%s:%d,%d,%zu", metadata_str, i, multisteps->lastSnapshotStep, outSize_[i]);
-		
-		totalSize += v->compressedSize;
-		v->compressType = multisteps->compressionType;
-		v = v->next;
+		offsets[i] = totalSize;
+		totalSize += vars[i]->compressedSize;
 	}
 	
-	//sprintf(metadata_str, "%s\n", metadata_str);
-	//fputs(metadata_str, sz_tsc->metadata_file);
-	//free(metadata_str);
-	
-	//sizeof(int)==current time step; 2*sizeof(char)+sizeof(size_t)=={compressionType + datatype + compression_data_size}; 
-	//sizeof(char)==# variables
-	*outSize = sizeof(int) + sizeof(unsigned short) + totalSize + vset->count*(3*sizeof(unsigned char)+sizeof(size_t));
-	*newByteData = (unsigned char*)malloc(*outSize); 
+	*outSize = totalSize;
+	*newByteData = (unsigned char*)malloc(totalSize);
 	unsigned char* p = *newByteData;
-
+	*(p++) = SZ_TS_FORMAT_FLAG|SZ_TS_FORMAT_VERSION;
 	intToBytes_bigEndian(p, sz_tsc->currentStep);
 	p+=4;
-	shortToBytes(p, vset->count);
-	p+=2;
-	
-	v = vset->header->next;
-
-	for(i=0;i<vset->count;i++)
+	intToBytes_bigEndian(p, var_count);
+	p+=4;
+	for(i=0;i<(int)var_count;i++)
 	{
-		*p = v->var_id; //1 byte
-		p++;
+		SZ_Variable* v = vars[i];
+		intToBytes_bigEndian(p, v->var_id); //4 bytes
+		p+=4;
 		*p = (unsigned char)v->compressType; //1 byte
 		p++;
 		*p = (unsigned char)v->dataType; //1 byte
 		p++;
 		sizeToBytes(p, v->compressedSize); //size_t
 		p += sizeof(size_t);
-		
-		memcpy(p, v->compressedBytes, v->compressedSize); //outSize_[i]
-		p += v->compressedSize;
-		v = v->next;
 	}
-
-	sz_tsc->currentStep ++;	
-	//free(outSize_);
 	
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 1)
+#endif
+	for(i=0;i<(int)var_count;i++)
+		memcpy(*newByteData + offsets[i], vars[i]->compressedBytes, vars[i]->compressedSize);
+	
+	free(offsets);
+	sz_tsc->currentStep ++;
 	return SZ_SCES;
 }
 
-void SZ_decompress_ts(unsigned char *bytes, size_t bytesLength)
+/**
+ * process multiple variables
+ * */
+int SZ_compress_ts_select_var(int cmprType, unsigned int* var_ids, unsigned int var_count, unsigned char** newByteData, size_t *outSize)
 {
-	if(confparams_dec==NULL)
-		confparams_dec = (sz_params*)malloc(sizeof(sz_params));
-	memset(confparams_dec, 0, sizeof(sz_params));
-	confparams_dec->szMode = SZ_TEMPORAL_COMPRESSION;
-	confparams_dec->predictionMode = SZ_PREVIOUS_VALUE_ESTIMATE;
+	unsigned int i = 0, j = 0;
+	SZ_Variable** vars = (SZ_Variable**)malloc(sizeof(SZ_Variable*)*var_count);
+	for(i = 0;i<var_count;i++)
+	{
+		SZ_Variable* v = SZ_getVariable(var_ids[i]);
+		if (v != NULL) //unregistered ids are skipped
+			vars[j++] = v;
+	}
 	
-	if(exe_params==NULL)
-		exe_params = (sz_exedata*)malloc(sizeof(sz_exedata));
-	memset(exe_params, 0, sizeof(sz_exedata));
+	int status = compress_ts_vars(cmprType, vars, j, newByteData, outSize);
+	free(vars);
+	return status;	
+}
+
+/**
+ * process all variables
+ * */
+int SZ_compress_ts(int cmprType, unsigned char** newByteData, size_t *outSize)
+{
+	SZ_VarSet* vset = sz_varset;
+	unsigned int i = 0;
+	SZ_Variable** vars = (SZ_Variable**)malloc(sizeof(SZ_Variable*)*vset->count);
+	SZ_Variable* v = vset->header->next;
+	for(i=0;i<vset->count;i++)
+	{
+		vars[i] = v;
+		v = v->next;
+	}
 	
-	int x = 1;
-	char *y = (char*)&x;
-	if(*y==1)
-		sysEndianType = LITTLE_ENDIAN_SYSTEM;
-	else //=0
-		sysEndianType = BIG_ENDIAN_SYSTEM;
+	int status = compress_ts_vars(cmprType, vars, vset->count, newByteData, outSize);
+	free(vars);
+	return status;
+}
+
+typedef struct sz_ts_dec_task
+{
+	SZ_Variable* var;
+	unsigned char compressionType;
+	unsigned char dataType;
+	unsigned char* cmpBytes;
+	size_t cmpSize;
+} sz_ts_dec_task;
+
+static int compareDecTaskSize(const void* a, const void* b)
+{
+	size_t x = ((const sz_ts_dec_task*)a)->cmpSize, y = ((const sz_ts_dec_task*)b)->cmpSize;
+	return (x < y) - (x > y); //descending order
+}
+
+/**
+ * decompress one variable of the batch; on failure, its data and its history (for the next step) are unchanged
+ * 
+ * @return SZ_SCES or the error code of the decompression
+ * */
+static int decompress_ts_var(sz_ts_dec_task* task)
+{
+	sz_params dec;
+	sz_exedata exe;
+	memset(&dec, 0, sizeof(sz_params));
+	memset(&exe, 0, sizeof(sz_exedata));
+	dec.szMode = SZ_TEMPORAL_COMPRESSION;
+	dec.predictionMode = SZ_PREVIOUS_VALUE_ESTIMATE;
+	SZ_Variable* p = task->var;
+	sz_multisteps* ms = p->multisteps;
+	if(ms->decHuffmanDict==NULL)
+		ms->decHuffmanDict = SZ_createHuffmanDict(0);
+	if(task->compressionType == 0) //like the compressor: a snapshot refers to no tree of the previous steps
+		sz_huffman_dict_reset(ms->decHuffmanDict);
+	sz_thread_context ctx = {.cpr = confparams_cpr, .dec = &dec, .exe = &exe, .huffmanDict = ms->decHuffmanDict};
+	sz_thread_context* previous = SZ_bindThreadContext(&ctx);
 	
-	int i = 0;
-	size_t r5 = 0, r4 = 0, r3 = 0, r2 = 0, r1 = 0;
-	unsigned char* q = bytes;
-	sz_tsc->currentStep = bytesToInt_bigEndian(q); 
-	q += 4;
-	unsigned short nbVars = (unsigned short)bytesToShort(q);
-	q += 2;
+	size_t dataLen = computeDataLength(p->r5, p->r4, p->r3, p->r2, p->r1);
+	int status = SZ_SCES;
 	
 	float *newFloatData = NULL;
-	double *newDoubleData = NULL;	
-	
-	for(i=0;i<nbVars;i++)
+	double *newDoubleData = NULL;
+	switch(task->dataType)
 	{
-		unsigned char var_id = *(q++);
-		SZ_Variable* p = SZ_getVariable(var_id);
-		sz_multisteps* multisteps = p->multisteps;
-		multisteps->compressionType = *(q++);
-		unsigned char dataType = *(q++);
-		size_t cmpSize = bytesToSize(q);
-		q += sizeof(size_t);
-		
-		if(p==NULL)
-			q += cmpSize;
-		else
-		{
-			sz_multisteps* multisteps = p->multisteps;
-			r5 = p->r5;
-			r4 = p->r4;
-			r3 = p->r3;
-			r2 = p->r2;
-			r1 = p->r1;
-			size_t dataLen = computeDataLength(r5, r4, r3, r2, r1);				
-			
-			unsigned char* cmpBytes = q;			
-			switch(dataType)
-			{
-			case SZ_FLOAT:
-					SZ_decompress_args_float(&newFloatData, r5, r4, r3, r2, r1, cmpBytes, cmpSize, multisteps->compressionType, multisteps->hist_data);
-					memcpy(p->data, newFloatData, dataLen*sizeof(float));
-					free(newFloatData);
-					break;
-			case SZ_DOUBLE:
-					SZ_decompress_args_double(&newDoubleData, r5, r4, r3, r2, r1, cmpBytes, cmpSize, multisteps->compressionType, multisteps->hist_data);
-					memcpy(p->data, newDoubleData, dataLen*sizeof(double));
-					free(newDoubleData);
-					break;
-			default:
-					printf("Error: data type cannot be the types other than SZ_FLOAT or SZ_DOUBLE\n");
-					return;	
-			}
-			
-			q += cmpSize;			
-		}
-	}	
+	case SZ_FLOAT:
+			status = SZ_decompress_args_float(&newFloatData, p->r5, p->r4, p->r3, p->r2, p->r1, task->cmpBytes, task->cmpSize, task->compressionType, ms->hist_data);
+			if(status == SZ_SCES && newFloatData == NULL)
+				status = SZ_DERR;
+			if(status != SZ_SCES)
+				break;
+			memcpy(p->data, newFloatData, dataLen*sizeof(float));
+			free(ms->hist_data);
+			ms->hist_data = newFloatData; //the reconstructed data become the history of the next step (no extra copy)
+			ms->compressionType = task->compressionType;
+			break;
+	case SZ_DOUBLE:
+			status = SZ_decompress_args_double(&newDoubleData, p->r5, p->r4, p->r3, p->r2, p->r1, task->cmpBytes, task->cmpSize, task->compressionType, ms->hist_data);
+			if(status == SZ_SCES && newDoubleData == NULL)
+				status = SZ_DERR;
+			if(status != SZ_SCES)
+				break;
+			memcpy(p->data, newDoubleData, dataLen*sizeof(double));
+			free(ms->hist_data);
+			ms->hist_data = newDoubleData; //the reconstructed data become the history of the next step (no extra copy)
+			ms->compressionType = task->compressionType;
+			break;
+	default:
+			printf("Error: data type cannot be the types other than SZ_FLOAT or SZ_DOUBLE\n");
+			status = SZ_DERR;
+	}
+	
+	SZ_bindThreadContext(previous);
+	return status;
 }
 
-void SZ_decompress_ts_select_var(unsigned char* var_ids, unsigned char var_count, unsigned char *bytes, size_t bytesLength)
+static int SZ_decompress_ts_vars(unsigned int* sorted_var_ids, unsigned int var_count, unsigned char *bytes, size_t bytesLength)
 {
-	if(confparams_dec==NULL)
-		confparams_dec = (sz_params*)malloc(sizeof(sz_params));
-	memset(confparams_dec, 0, sizeof(sz_params));
-	confparams_dec->szMode = SZ_TEMPORAL_COMPRESSION;
-	confparams_dec->predictionMode = SZ_PREVIOUS_VALUE_ESTIMATE;
-	
-	if(exe_params==NULL)
-		exe_params = (sz_exedata*)malloc(sizeof(sz_exedata));
-	memset(exe_params, 0, sizeof(sz_exedata));
-	
+	//the tasks bind their own decompression and execution parameters (decompress_ts_var): the process-wide ones,
+	//which the next compression uses, are kept
 	int x = 1;
 	char *y = (char*)&x;
 	if(*y==1)
@@ -1075,61 +1210,139 @@ void SZ_decompress_ts_select_var(unsigned char* var_ids, unsigned char var_count
 	else //=0
 		sysEndianType = BIG_ENDIAN_SYSTEM;
 	
-	int i = 0;
-	size_t r5 = 0, r4 = 0, r3 = 0, r2 = 0, r1 = 0;
+	int i = 0, status = SZ_SCES, version = 0;
 	unsigned char* q = bytes;
+	unsigned char* end = bytes + bytesLength;
+	if(bytesLength > 0 && (bytes[0] & SZ_TS_FORMAT_FLAG))
+	{
+		version = bytes[0] & ~SZ_TS_FORMAT_FLAG;
+		q++;
+	}
+	if(version > SZ_TS_FORMAT_VERSION)
+	{
+		printf("Error: version %d of the time-step stream is not supported\n", version);
+		return SZ_NSCS;
+	}
+	//version 0: 1-byte var_ids and a 2-byte (native-endian) number of variables, with the compressed bytes of each variable after its entry
+	size_t entrySize = (version==0 ? 1 : sizeof(int)) + 2*sizeof(unsigned char) + sizeof(size_t);
+	if(end - q < (version==0 ? 6 : 8))
+	{
+		printf("Error: the time-step stream is truncated\n");
+		return SZ_NSCS;
+	}
 	sz_tsc->currentStep = bytesToInt_bigEndian(q); 
 	q += 4;
-	unsigned short nbVars = (unsigned short)bytesToShort(q);
-	q += 2;
-	
-	float *newFloatData = NULL;
-	double *newDoubleData = NULL;	
+	unsigned int nbVars;
+	if(version==0)
+	{
+		nbVars = (unsigned short)bytesToShort(q);
+		q += 2;
+	}
+	else
+	{
+		nbVars = (unsigned int)bytesToInt_bigEndian(q);
+		q += 4;
+	}
+	if(version > 0 && (size_t)(end - q) < nbVars*entrySize)
+	{
+		printf("Error: the time-step stream is truncated\n");
+		return SZ_NSCS;
+	}
 	
-	for(i=0;i<nbVars;i++)
+	//read the table of contents (or the entries of version 0) and locate the compressed bytes of each variable
+	sz_ts_dec_task* tasks = (sz_ts_dec_task*)malloc(sizeof(sz_ts_dec_task)*nbVars);
+	unsigned char* cmpBytes = q + (version==0 ? 0 : nbVars*entrySize);
+	int taskCount = 0;
+	for(i=0;i<(int)nbVars;i++)
 	{
-		unsigned char var_id = *(q++);
-		int selected = checkVarID(var_id, var_ids, var_count);
+		if(version==0 && (size_t)(end - q) < entrySize)
+		{
+			status = SZ_NSCS;
+			break;
+		}
+		unsigned int var_id;
+		if(version==0)
+			var_id = *(q++);
+		else
+		{
+			var_id = (unsigned int)bytesToInt_bigEndian(q);
+			q += 4;
+		}
 		SZ_Variable* p = SZ_getVariable(var_id);
-		sz_multisteps* multisteps = p->multisteps;
-		multisteps->compressionType = *(q++);
+		unsigned char compressionType = *(q++);
 		unsigned char dataType = *(q++);
 		size_t cmpSize = bytesToSize(q);
 		q += sizeof(size_t);
+		if(version==0)
+			cmpBytes = q;
+		if((size_t)(end - cmpBytes) < cmpSize)
+		{
+			status = SZ_NSCS;
+			break;
+		}
 		
-		if(p==NULL || selected == 0) //p==NULL means the variable was not registered during compression ; selected==0 means that the variable is not selected
-			q += cmpSize;
-		else // p!=NULL && selected == 1
+		//p==NULL means the variable was not registered during compression ; otherwise the variable may be not selected
+		if(p!=NULL && (sorted_var_ids==NULL || checkSortedVarID(var_id, sorted_var_ids, var_count)))
 		{
-			sz_multisteps* multisteps = p->multisteps;
-			r5 = p->r5;
-			r4 = p->r4;
-			r3 = p->r3;
-			r2 = p->r2;
-			r1 = p->r1;
-			size_t dataLen = computeDataLength(r5, r4, r3, r2, r1);				
-			
-			unsigned char* cmpBytes = q;			
-			switch(dataType)
-			{
-			case SZ_FLOAT:
-					SZ_decompress_args_float(&newFloatData, r5, r4, r3, r2, r1, cmpBytes, cmpSize, multisteps->compressionType, multisteps->hist_data);
-					memcpy(p->data, newFloatData, dataLen*sizeof(float));
-					free(newFloatData);
-					break;
-			case SZ_DOUBLE:
-					SZ_decompress_args_double(&newDoubleData, r5, r4, r3, r2, r1, cmpBytes, cmpSize, multisteps->compressionType, multisteps->hist_data);
-					memcpy(p->data, newDoubleData, dataLen*sizeof(double));
-					free(newDoubleData);
-					break;
-			default:
-					printf("Error: data type cannot be the types other than SZ_FLOAT or SZ_DOUBLE\n");
-					return;	
-			}
-			
-			q += cmpSize;			
+			sz_ts_dec_task* task = &tasks[taskCount++];
+			task->var = p;
+			task->compressionType = compressionType;
+			task->dataType = dataType;
+			task->cmpBytes = cmpBytes;
+			task->cmpSize = cmpSize;
 		}
-	}	
+		cmpBytes += cmpSize;
+		if(version==0)
+			q = cmpBytes;
+	}
+	if(status != SZ_SCES)
+	{
+		printf("Error: the time-step stream is truncated\n");
+		free(tasks);
+		return status;
+	}
+	qsort(tasks, taskCount, sizeof(sz_ts_dec_task), compareDecTaskSize);
+	
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic, 1)
+#endif
+	for(i=0;i<taskCount;i++)
+	{
+		int taskStatus = decompress_ts_var(&tasks[i]);
+		if(taskStatus != SZ_SCES)
+		{
+#ifdef _OPENMP
+			#pragma omp critical(sz_ts_status)
+#endif
+			status = taskStatus;
+		}
+	}
+	
+	free(tasks);
+	return status;
+}
+
+/**
+ * The steps are to be decompressed in the order of their compression, as the streams of a variable refer to
+ * the data of its previous step, and with reuseHuffmanTrees to the Huffman trees (sz_multisteps::decHuffmanDict)
+ * of its previous steps since its last snapshot. A snapshot decompresses on its own.
+ * The streams written before the format version byte (SZ_TS_FORMAT_VERSION) are read too.
+ * 
+ * @return SZ_SCES, or the error code of a variable that failed to decompress (its data and history are then unchanged)
+ * */
+int SZ_decompress_ts(unsigned char *bytes, size_t bytesLength)
+{
+	return SZ_decompress_ts_vars(NULL, 0, bytes, bytesLength);
+}
+
+int SZ_decompress_ts_select_var(unsigned int* var_ids, unsigned int var_count, unsigned char *bytes, size_t bytesLength)
+{
+	unsigned int* sorted_var_ids = (unsigned int*)malloc(sizeof(unsigned int)*var_count);
+	memcpy(sorted_var_ids, var_ids, sizeof(unsigned int)*var_count);
+	sortVarIDs(sorted_var_ids, var_count);
+	int status = SZ_decompress_ts_vars(sorted_var_ids, var_count, bytes, bytesLength);
+	free(sorted_var_ids);
+	return status;
 }
 #endif
 
@@ -1221,8 +1434,15 @@ unsigned char* SZ_compress_customize(const char* cmprName, void* userPara, int d
     {
 		void* transData = transposeData(data, dataType, r5, r4, r3, r2, r1);
 		sz_maybe_init_with_user_params(userPara, confparams_cpr);
+		if(transData == NULL)
+		{
+			*status = SZ_NSCS;
+			return NULL;
+		}
 		size_t n = computeDataLength(r5, r4, r3, r2, r1);
 		result = SZ_compress(dataType, transData, outSize, 0, 0, 0, 0, n);
+		free(transData);
+		*status = SZ_SCES;
 	}
     else if(strcmp(cmprName, "ExaFEL")==0){
     	assert(dataType==SZ_FLOAT);
@@ -1266,7 +1486,14 @@ void* SZ_decompress_customize(const char* cmprName, void* userPara, int dataType
     {
 		size_t n = computeDataLength(r5, r4, r3, r2, r1);
 		void* tmpData = SZ_decompress(dataType, bytes, byteLength, 0, 0, 0, 0, n);
+		if(tmpData == NULL)
+		{
+			*status = SZ_NSCS;
+			return NULL;
+		}
 		result = detransposeData(tmpData, dataType, r5, r4, r3, r2, r1);
+		free(tmpData);
+		*status = result == NULL ? SZ_NSCS : SZ_SCES;
 	}
   	else if(strcmp(cmprName, "ExaFEL")==0){
     	assert(dataType==SZ_FLOAT);
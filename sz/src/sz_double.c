@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -58,6 +59,7 @@ inline short computeReqLength_double_MSST19(double realPrecision)
 
 unsigned int optimize_intervals_double_1D(double *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	double pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -96,11 +98,13 @@ unsigned int optimize_intervals_double_1D(double *oriData, size_t dataLength, do
 
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_2D(double *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j, index;
 	size_t radiusIndex;
 	double pred_value = 0, pred_err;
@@ -142,11 +146,13 @@ unsigned int optimize_intervals_double_2D(double *oriData, size_t r1, size_t r2,
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_3D(double *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j,k, index;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -195,11 +201,13 @@ unsigned int optimize_intervals_double_3D(double *oriData, size_t r1, size_t r2,
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_4D(double *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision)
 {
+	double statsStart = sz_stats_clock();
 	size_t i,j,k,l, index;
 	size_t radiusIndex;
 	size_t r234=r2*r3*r4;
@@ -250,6 +258,7 @@ unsigned int optimize_intervals_double_4D(double *oriData, size_t r1, size_t r2,
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
@@ -280,47 +289,29 @@ size_t dataLength, double realPrecision, double valueRangeSize, double medianVal
 		
 	double* spaceFillingValue = oriData; //
 	
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-	
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
+	sz_unpred_double unpred;
+	sz_unpred_init_double(&unpred, dataLength, reqLength, medianValue);
+	double unpredData;
 	
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
-
-	unsigned char preDataBytes[8];
-	longToBytes_bigEndian(preDataBytes, 0);
-	
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 	double last3CmprsData[3] = {0};
 
-	DoubleValueCompressElement *vce = (DoubleValueCompressElement*)malloc(sizeof(DoubleValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));			
-				
 	//add the first data	
 	type[0] = 0;
-	compressSingleDoubleValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,8);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	listAdd_double(last3CmprsData, vce->data);
+	unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[0]);
+	listAdd_double(last3CmprsData, unpredData);
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[0] = vce->data;
+		decData[0] = unpredData;
 #endif		
 		
 	//add the second data
 	type[1] = 0;
-	compressSingleDoubleValue(vce, spaceFillingValue[1], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,8);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	listAdd_double(last3CmprsData, vce->data);
+	unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[1]);
+	listAdd_double(last3CmprsData, unpredData);
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[1] = vce->data;
+		decData[1] = unpredData;
 #endif
 	int state;
 	double checkRadius;
@@ -361,29 +352,28 @@ size_t dataLength, double realPrecision, double valueRangeSize, double medianVal
 		
 		//unpredictable data processing
 		type[i] = 0;		
-		compressSingleDoubleValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,8);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
+		unpredData = sz_unpred_add_double(&unpred, curData);
 							
-		//listAdd_double(last3CmprsData, vce->data);
-		pred = vce->data;
+		//listAdd_double(last3CmprsData, unpredData);
+		pred = unpredData;
 		
 #ifdef HAVE_TIMECMPR
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-			decData[i] = vce->data;
+			decData[i] = unpredData;
 #endif	
 		
 	}//end of for
 		
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_double(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 	
 	TightDataPointStorageD* tdps;
 			
 	new_TightDataPointStorageD(&tdps, dataLength, exactDataNum, 
-			type, exactMidByteArray->array, exactMidByteArray->size,  
-			exactLeadNumArray->array,  
-			resiBitArray->array, resiBitArray->size, 
+			type, exactMidBytes, exactMidBytes_size,  
+			exactLeadNum,  
+			resiBits, exactDataNum, 
 			resiBitsLength, 
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 	
@@ -391,12 +381,9 @@ size_t dataLength, double realPrecision, double valueRangeSize, double medianVal
 //			exactDataNum, expSegmentsInBytes_size, exactMidByteArray->size);
 	
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);
-	free(vce);
-	free(lce);	
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);	
 	
 	return tdps;	
 }
@@ -433,6 +420,11 @@ void SZ_compress_args_double_StoreOriData(double* oriData, size_t dataLength, un
 		for(i=0;i<dataLength;i++,p+=doubleSize)
 			doubleToBytes(p, oriData[i]);
 	}
+#ifdef HAVE_TIMECMPR
+	//the decompressor will take the original data as the history of the next step
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+		memcpy(multisteps->hist_data, oriData, dataLength*sizeof(double));
+#endif
 	*outSize = totalByteLength;
 }
 
@@ -445,33 +437,11 @@ size_t dataLength, double realPrecision, size_t *outSize, double valueRangeSize,
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
-		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{	
-				tdps = SZ_compress_double_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_d);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}					
-		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			tdps = SZ_compress_double_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_d);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
+		compressionType = SZ_decide_compressionType_double_ts(cmprType, oriData, 1, 1, dataLength, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
 			tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-			compressionType = 1; //time-series based compression 			
-		}
-
+		else //snapshot-based compression
+			tdps = SZ_compress_double_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_d);
 	}
 	else
 #endif
@@ -526,36 +496,21 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 		
 	double* spaceFillingValue = oriData; //
 	
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-	
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-	
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
+	sz_unpred_double unpred;
+	sz_unpred_init_double(&unpred, dataLength, reqLength, medianValue);
+	double unpredData;
 	
 	type[0] = 0;
 	
-	unsigned char preDataBytes[8];
-	longToBytes_bigEndian(preDataBytes, 0);
-	
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	DoubleValueCompressElement *vce = (DoubleValueCompressElement*)malloc(sizeof(DoubleValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-			
 	/* Process Row-0 data 0*/
 	type[0] = 0;
-	compressSingleDoubleValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,8);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	P1[0] = vce->data;
+	unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[0]);
+	P1[0] = unpredData;
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[0] = vce->data;
+		decData[0] = unpredData;
 #endif	
 
 	/* Process Row-0 data 1*/
@@ -573,11 +528,8 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 	else
 	{
 		type[1] = 0;
-		compressSingleDoubleValue(vce, spaceFillingValue[1], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,8);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[1] = vce->data;
+		unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[1]);
+		P1[1] = unpredData;
 	}
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -601,11 +553,8 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[j] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[j], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[j] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[j]);
+			P1[j] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -633,11 +582,8 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[index] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P0[0] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+			P0[0] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -663,11 +609,8 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[j] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P0[j] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -684,14 +627,16 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 	if(r2!=1)	
 		free(P0);
 	free(P1);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_double(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 	
 	TightDataPointStorageD* tdps;
 			
 	new_TightDataPointStorageD(&tdps, dataLength, exactDataNum, 
-			type, exactMidByteArray->array, exactMidByteArray->size,  
-			exactLeadNumArray->array,  
-			resiBitArray->array, resiBitArray->size, 
+			type, exactMidBytes, exactMidBytes_size,  
+			exactLeadNum,  
+			resiBits, exactDataNum, 
 			resiBitsLength, 
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
@@ -708,15 +653,12 @@ TightDataPointStorageD* SZ_compress_double_2D_MDQ(double *oriData, size_t r1, si
 //			exactDataNum, expSegmentsInBytes_size, exactMidByteArray->size);
 	
 //	for(i = 3800;i<3844;i++)
-//		printf("exactLeadNumArray->array[%d]=%d\n",i,exactLeadNumArray->array[i]);
+//		printf("exactLeadNum[%d]=%d\n",i,exactLeadNum[i]);
 	
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);	
-	free(vce);
-	free(lce);	
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 	
 	return tdps;
 }
@@ -734,32 +676,11 @@ char SZ_compress_args_double_NoCkRngeNoGzip_2D(int cmprType, unsigned char** new
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
-		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{	
-				tdps = SZ_compress_double_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_d);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}					
-		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			tdps = SZ_compress_double_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_d);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
+		compressionType = SZ_decide_compressionType_double_ts(cmprType, oriData, 1, r1, r2, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
 			tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-			compressionType = 1; //time-series based compression 			
-		}
+		else //snapshot-based compression
+			tdps = SZ_compress_double_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_d);
 	}
 	else
 #endif
@@ -814,35 +735,20 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 
 	double* spaceFillingValue = oriData; //
 
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
+	sz_unpred_double unpred;
+	sz_unpred_init_double(&unpred, dataLength, reqLength, medianValue);
+	double unpredData;
 
 	type[0] = 0;
 
-	unsigned char preDataBytes[8];
-	longToBytes_bigEndian(preDataBytes, 0);
-
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	DoubleValueCompressElement *vce = (DoubleValueCompressElement*)malloc(sizeof(DoubleValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-
 
 	///////////////////////////	Process layer-0 ///////////////////////////
 	/* Process Row-0 data 0*/
 	type[0] = 0;
-	compressSingleDoubleValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,8);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	P1[0] = vce->data;
+	unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[0]);
+	P1[0] = unpredData;
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 			decData[0] = P1[0];
@@ -863,11 +769,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 	else
 	{
 		type[1] = 0;
-		compressSingleDoubleValue(vce, spaceFillingValue[1], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,8);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[1] = vce->data;
+		unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[1]);
+		P1[1] = unpredData;
 	}
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -891,11 +794,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[j] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[j], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[j] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[j]);
+			P1[j] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -923,11 +823,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[index] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[index] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+			P1[index] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -953,11 +850,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P1[index] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -987,11 +881,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[index] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P0[0] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+			P0[0] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1017,11 +908,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[j] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P0[j] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1050,11 +938,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[index2D] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P0[index2D] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1081,11 +966,8 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 				else
 				{
 					type[index] = 0;
-					compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,8);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+					P0[index2D] = unpredData;
 				}
 #ifdef HAVE_TIMECMPR	
 				if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1102,14 +984,16 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 	if(r23!=1)
 		free(P0);
 	free(P1);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_double(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 
 	TightDataPointStorageD* tdps;
 
 	new_TightDataPointStorageD(&tdps, dataLength, exactDataNum,
-			type, exactMidByteArray->array, exactMidByteArray->size,
-			exactLeadNumArray->array,
-			resiBitArray->array, resiBitArray->size,
+			type, exactMidBytes, exactMidBytes_size,
+			exactLeadNum,
+			resiBits, exactDataNum,
 			resiBitsLength, 
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
@@ -1117,15 +1001,12 @@ TightDataPointStorageD* SZ_compress_double_3D_MDQ(double *oriData, size_t r1, si
 //			exactDataNum, expSegmentsInBytes_size, exactMidByteArray->size);
 
 //	for(i = 3800;i<3844;i++)
-//		printf("exactLeadNumArray->array[%d]=%d\n",i,exactLeadNumArray->array[i]);
+//		printf("exactLeadNum[%d]=%d\n",i,exactLeadNum[i]);
 
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);
-	free(vce);
-	free(lce);	
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);	
 	
 	return tdps;	
 }
@@ -1139,38 +1020,17 @@ char SZ_compress_args_double_NoCkRngeNoGzip_3D(int cmprType, unsigned char** new
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
+		compressionType = SZ_decide_compressionType_double_ts(cmprType, oriData, r1, r2, r3, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
+			tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
+		else if(confparams_cpr->withRegression == SZ_NO_REGRESSION) //snapshot-based compression
+			tdps = SZ_compress_double_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_d);
+		else //snapshot-based compression with the blocked regression (SZ 2.1), which also records its reconstruction in hist_data
 		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{	
-				if(confparams_cpr->withRegression == SZ_NO_REGRESSION)	
-					tdps = SZ_compress_double_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_d);
-				else
-					*newByteData = SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}
+			*newByteData = SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
+			if(*outSize>3 + MetaDataByteLength_double + exe_params->SZ_SIZE_TYPE + 1 + sizeof(double)*dataLength)
+				SZ_compress_args_double_StoreOriData(oriData, dataLength, newByteData, outSize);
 		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			if(confparams_cpr->withRegression == SZ_NO_REGRESSION)	
-				tdps = SZ_compress_double_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_d);
-			else
-				*newByteData = SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
-			tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
-			compressionType = 1; //time-series based compression 			
-		}		
 	}
 	else
 #endif
@@ -1189,6 +1049,12 @@ char SZ_compress_args_double_NoCkRngeNoGzip_3D(int cmprType, unsigned char** new
 
 TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, double valueRangeSize, double medianValue_d)
 {
+#ifdef HAVE_TIMECMPR
+	double* decData = NULL;
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+		decData = (double*)(multisteps->hist_data);
+#endif
+
 	double recip_realPrecision = 1/realPrecision;
 	unsigned int quantization_intervals;
 	if(exe_params->optQuantMode==1)
@@ -1222,24 +1088,12 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 
 	double* spaceFillingValue = oriData; //
 
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
-
-	unsigned char preDataBytes[8];
-	longToBytes_bigEndian(preDataBytes, 0);
+	sz_unpred_double unpred;
+	sz_unpred_init_double(&unpred, dataLength, reqLength, medianValue);
+	double unpredData;
 
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	DoubleValueCompressElement *vce = (DoubleValueCompressElement*)malloc(sizeof(DoubleValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-
 
 	size_t l;
 	for (l = 0; l < r1; l++)
@@ -1251,11 +1105,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 		size_t index2D = 0;
 
 		type[index] = 0;
-		compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,8);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[index2D] = vce->data;
+		unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+		P1[index2D] = unpredData;
 
 		/* Process Row-0 data 1*/
 		index = l*r234+1;
@@ -1275,11 +1126,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 		else
 		{
 			type[index] = 0;
-			compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,8);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[index2D] = vce->data;
+			unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+			P1[index2D] = unpredData;
 		}
 
 		/* Process Row-0 data 2 --> data r4-1 */
@@ -1302,11 +1150,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index2D] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P1[index2D] = unpredData;
 			}
 		}
 
@@ -1331,11 +1176,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index2D] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P1[index2D] = unpredData;
 			}
 
 			/* Process row-i data 1 --> data r4-1*/
@@ -1359,16 +1201,18 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 				else
 				{
 					type[index] = 0;
-					compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,8);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P1[index2D] = vce->data;
+					unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+					P1[index2D] = unpredData;
 				}
 			}
 		}
 
 
+#ifdef HAVE_TIMECMPR
+		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+			memcpy(decData+l*r234, P1, r34*sizeof(double));
+#endif
+
 		///////////////////////////	Process layer-1 --> layer-r2-1 ///////////////////////////
 
 		for (k = 1; k < r2; k++)
@@ -1391,11 +1235,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 			else
 			{
 				type[index] = 0;
-				compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,8);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[index2D] = vce->data;
+				unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+				P0[index2D] = unpredData;
 			}
 
 
@@ -1419,11 +1260,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 				else
 				{
 					type[index] = 0;
-					compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,8);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+					P0[index2D] = unpredData;
 				}
 			}
 
@@ -1448,11 +1286,8 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 				else
 				{
 					type[index] = 0;
-					compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,8);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+					P0[index2D] = unpredData;
 				}
 
 				/* Process Row-i data 1 --> data r4-1 */
@@ -1476,15 +1311,17 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 					else
 					{
 						type[index] = 0;
-						compressSingleDoubleValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-						updateLossyCompElement_Double(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-						memcpy(preDataBytes,vce->curBytes,8);
-						addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-						P0[index2D] = vce->data;
+						unpredData = sz_unpred_add_double(&unpred, spaceFillingValue[index]);
+						P0[index2D] = unpredData;
 					}
 				}
 			}
 
+#ifdef HAVE_TIMECMPR
+			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+				memcpy(decData+l*r234+k*r34, P0, r34*sizeof(double));
+#endif
+
 			double *Pt;
 			Pt = P1;
 			P1 = P0;
@@ -1494,41 +1331,60 @@ TightDataPointStorageD* SZ_compress_double_4D_MDQ(double *oriData, size_t r1, si
 
 	free(P0);
 	free(P1);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_double(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 
 	TightDataPointStorageD* tdps;
 
 	new_TightDataPointStorageD(&tdps, dataLength, exactDataNum,
-			type, exactMidByteArray->array, exactMidByteArray->size,
-			exactLeadNumArray->array,
-			resiBitArray->array, resiBitArray->size,
+			type, exactMidBytes, exactMidBytes_size,
+			exactLeadNum,
+			resiBits, exactDataNum,
 			resiBitsLength,
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);
-	free(vce);
-	free(lce);
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 
 	return tdps;
 }
 
 
-char SZ_compress_args_double_NoCkRngeNoGzip_4D(unsigned char** newByteData, double *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, double valueRangeSize, double medianValue_d)
+char SZ_compress_args_double_NoCkRngeNoGzip_4D(int cmprType, unsigned char** newByteData, double *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, double valueRangeSize, double medianValue_d)
 {
-	TightDataPointStorageD* tdps = SZ_compress_double_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_d);
-
-	convertTDPStoFlatBytes_double(tdps, newByteData, outSize);
-
 	size_t dataLength = r1*r2*r3*r4;
-	if(*outSize>3 + MetaDataByteLength_double + exe_params->SZ_SIZE_TYPE + 1 + sizeof(double)*dataLength)
-		SZ_compress_args_double_StoreOriData(oriData, dataLength, newByteData, outSize);
+	char compressionType = 0;
+	TightDataPointStorageD* tdps = NULL;
+#ifdef HAVE_TIMECMPR
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+	{
+		compressionType = SZ_decide_compressionType_double_ts(cmprType, oriData, r1*r2, r3, r4, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
+			tdps = SZ_compress_double_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_d);
+		else if(confparams_cpr->withRegression == SZ_NO_REGRESSION) //snapshot-based compression
+			tdps = SZ_compress_double_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_d);
+		else //snapshot-based compression with the blocked regression (SZ 2.1), which also records its reconstruction in hist_data
+		{
+			*newByteData = SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1*r2, r3, r4, realPrecision, outSize);
+			if(*outSize>3 + MetaDataByteLength_double + exe_params->SZ_SIZE_TYPE + 1 + sizeof(double)*dataLength)
+				SZ_compress_args_double_StoreOriData(oriData, dataLength, newByteData, outSize);
+		}
+	}
+	else
+#endif
+		tdps = SZ_compress_double_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_d);
 
-	free_TightDataPointStorageD(tdps);
-	return 0;
+	if(tdps!=NULL)
+	{
+		convertTDPStoFlatBytes_double(tdps, newByteData, outSize);
+		if(*outSize>3 + MetaDataByteLength_double + exe_params->SZ_SIZE_TYPE + 1 + sizeof(double)*dataLength)
+			SZ_compress_args_double_StoreOriData(oriData, dataLength, newByteData, outSize);
+		free_TightDataPointStorageD(tdps);
+	}
+	return compressionType;
 }
 
 /*MSST19*/
@@ -2447,6 +2303,16 @@ void SZ_compress_args_double_withinRange(unsigned char** newByteData, double *or
 	//*newByteData = (unsigned char*)malloc(sizeof(unsigned char)*16); //for floating-point data (1+3+4+4)
 	//memcpy(*newByteData, tmpByteData, 16);
 	*outSize = tmpOutSize;//12==3+1+8(double_size)+MetaDataByteLength_double
+#ifdef HAVE_TIMECMPR
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+	{
+		size_t i;
+		double* hist_data = (double*)(multisteps->hist_data);
+		for(i=0;i<dataLength;i++)
+			hist_data[i] = value;
+		multisteps->compressionType = 0;
+	}
+#endif
 	free_TightDataPointStorageD(tdps);	
 }
 
@@ -2507,6 +2373,11 @@ int SZ_compress_args_double(int cmprType, unsigned char** newByteData, double *o
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, size_t *outSize, 
 int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRatio)
 {
+	if(errBoundMode==FIXED_RATIO) //the error bound is searched for the target ratio first, see SZ_compress_args_fixedRatio()
+	{
+		*newByteData = SZ_compress_args_fixedRatio(cmprType, SZ_DOUBLE, oriData, outSize, r5, r4, r3, r2, r1);
+		return *newByteData==NULL ? SZ_NSCS : SZ_SCES;
+	}
 	confparams_cpr->errorBoundMode = errBoundMode;
 	if(errBoundMode==PW_REL)
 	{
@@ -2515,10 +2386,12 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 		
 	int status = SZ_SCES;
 	size_t dataLength = computeDataLength(r5,r4,r3,r2,r1);
+	sz_stats_begin(SZ_DOUBLE, dataLength*sizeof(double));
 	
 	if(dataLength <= MIN_NUM_OF_ELEMENTS)
 	{
 		*newByteData = SZ_skip_compress_double(oriData, dataLength, outSize);
+		sz_stats_end(*outSize);
 		return status;
 	}
 	
@@ -2662,12 +2535,12 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 			else
 #ifdef HAVE_TIMECMPR
 				if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)			
-					multisteps->compressionType = SZ_compress_args_double_NoCkRngeNoGzip_4D(&tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
+					multisteps->compressionType = SZ_compress_args_double_NoCkRngeNoGzip_4D(cmprType, &tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
 				else
 #endif	
 				{
 					if(confparams_cpr->withRegression == SZ_NO_REGRESSION)
-						SZ_compress_args_double_NoCkRngeNoGzip_4D(&tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
+						SZ_compress_args_double_NoCkRngeNoGzip_4D(cmprType, &tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
 					else 
 					{
 						tmpByteData = SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(oriData, r4*r3, r2, r1, realPrecision, &tmpOutSize);								
@@ -2684,7 +2557,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 		}
 				
 		//Call Gzip to do the further compression.
-		if(confparams_cpr->szMode==SZ_BEST_SPEED)
+		if(confparams_cpr->szMode==SZ_BEST_SPEED || sz_lossless_skip(confparams_cpr, tmpByteData, tmpOutSize))
 		{
 			*outSize = tmpOutSize;
 			*newByteData = tmpByteData;			
@@ -2701,6 +2574,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 		}
 	}
 
+	sz_stats_end(*outSize);
 	return status;
 }
 
@@ -2892,6 +2766,7 @@ size_t r4, size_t r3, size_t r2, size_t r1, size_t s4, size_t s3, size_t s2, siz
 
 unsigned int optimize_intervals_double_1D_subblock(double *oriData, double realPrecision, size_t r1, size_t s1, size_t e1)
 {
+	double statsStart = sz_stats_clock();
 	size_t dataLength = e1 - s1 + 1;
 	oriData = oriData + s1;
 
@@ -2933,11 +2808,13 @@ unsigned int optimize_intervals_double_1D_subblock(double *oriData, double realP
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_2D_subblock(double *oriData, double realPrecision, size_t r1, size_t r2, size_t s1, size_t s2, size_t e1, size_t e2)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 
@@ -2981,11 +2858,13 @@ unsigned int optimize_intervals_double_2D_subblock(double *oriData, double realP
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_3D_subblock(double *oriData, double realPrecision, size_t r1, size_t r2, size_t r3, size_t s1, size_t s2, size_t s3, size_t e1, size_t e2, size_t e3)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 	size_t R3 = e3 - s3 + 1;
@@ -3038,12 +2917,14 @@ unsigned int optimize_intervals_double_3D_subblock(double *oriData, double realP
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_4D_subblock(double *oriData, double realPrecision,
 size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, size_t s4, size_t e1, size_t e2, size_t e3, size_t e4)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 	size_t R3 = e3 - s3 + 1;
@@ -3101,6 +2982,7 @@ size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, siz
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
@@ -4123,6 +4005,7 @@ size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, siz
 
 unsigned int optimize_intervals_double_1D_opt_MSST19(double *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	double pred_value = 0;
 	double pred_err;
@@ -4168,11 +4051,13 @@ unsigned int optimize_intervals_double_1D_opt_MSST19(double *oriData, size_t dat
 		powerOf2 = 64;
 	
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_2D_opt_MSST19(double *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	double pred_value = 0, pred_err;
@@ -4228,11 +4113,13 @@ unsigned int optimize_intervals_double_2D_opt_MSST19(double *oriData, size_t r1,
 		powerOf2 = 64;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_3D_opt_MSST19(double *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -4293,9 +4180,11 @@ unsigned int optimize_intervals_double_3D_opt_MSST19(double *oriData, size_t r1,
 	if(powerOf2<64)
 		powerOf2 = 64;
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 unsigned int optimize_intervals_double_3D_opt(double *oriData, size_t r1, size_t r2, size_t r3, double realPrecision){	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -4351,6 +4240,7 @@ unsigned int optimize_intervals_double_3D_opt(double *oriData, size_t r1, size_t
 	if(powerOf2<32)
 		powerOf2 = 32;
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
@@ -4652,6 +4542,7 @@ size_t SZ_compress_double_3D_MDQ_RA_block(double * block_ori_data, double * mean
 
 unsigned int optimize_intervals_double_2D_opt(double *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	double pred_value = 0, pred_err;
@@ -4702,11 +4593,13 @@ unsigned int optimize_intervals_double_2D_opt(double *oriData, size_t r1, size_t
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_1D_opt(double *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	double pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -4744,12 +4637,14 @@ unsigned int optimize_intervals_double_1D_opt(double *oriData, size_t dataLength
 		powerOf2 = 32;
 	
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
 /*The above code is for sz 1.4.13; the following code is for sz 2.0*/
 unsigned int optimize_intervals_double_2D_with_freq_and_dense_pos(double *oriData, size_t r1, size_t r2, double realPrecision, double * dense_pos, double * max_freq, double * mean_freq)
 {	
+	double statsStart = sz_stats_clock();
 	double mean = 0.0;
 	size_t len = r1 * r2;
 	size_t mean_distance = (int) (sqrt(len));
@@ -4854,11 +4749,13 @@ unsigned int optimize_intervals_double_2D_with_freq_and_dense_pos(double *oriDat
 
 	free(freq_intervals);
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, 0, 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_double_3D_with_freq_and_dense_pos(double *oriData, size_t r1, size_t r2, size_t r3, double realPrecision, double * dense_pos, double * max_freq, double * mean_freq)
 {	
+	double statsStart = sz_stats_clock();
 	double mean = 0.0;
 	size_t len = r1 * r2 * r3;
 	size_t mean_distance = (int) (sqrt(len));
@@ -4983,6 +4880,7 @@ unsigned int optimize_intervals_double_3D_with_freq_and_dense_pos(double *oriDat
 
 	free(freq_intervals);
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, 0, 0);
 	return powerOf2;
 }
 
@@ -5007,7 +4905,7 @@ unsigned char * SZ_compress_double_2D_MDQ_nonblocked_with_blocked_regression(dou
 
 	// calculate block dims
 	size_t num_x, num_y;
-	size_t block_size = 16;
+	size_t block_size = confparams_cpr->regressionBlockSize > 0 ? confparams_cpr->regressionBlockSize : 16;
 
 	SZ_COMPUTE_2D_NUMBER_OF_BLOCKS(r1, num_x, block_size);
 	SZ_COMPUTE_2D_NUMBER_OF_BLOCKS(r2, num_y, block_size);
@@ -5079,7 +4977,7 @@ unsigned char * SZ_compress_double_2D_MDQ_nonblocked_with_blocked_regression(dou
 
 	//Compress coefficient arrays
 	double precision_a, precision_b, precision_c;
-	double rel_param_err = 0.15/3;
+	double rel_param_err = confparams_cpr->regressionCoeffErr > 0 ? confparams_cpr->regressionCoeffErr : 0.15/3;
 	precision_a = rel_param_err * realPrecision / late_blockcount_x;
 	precision_b = rel_param_err * realPrecision / late_blockcount_y;
 	precision_c = rel_param_err * realPrecision;
@@ -5765,6 +5663,7 @@ unsigned char * SZ_compress_double_2D_MDQ_nonblocked_with_blocked_regression(dou
 	unsigned int meta_data_offset = 3 + 1 + MetaDataByteLength_double;
 	// total size 										metadata		  # elements   real precision		intervals	nodeCount		huffman 	 	block index 						unpredicatable count						mean 					 	unpred size 				elements
 	unsigned char * result = (unsigned char *) calloc(meta_data_offset + exe_params->SZ_SIZE_TYPE + sizeof(double) + sizeof(int) + sizeof(int) + 5*treeByteSize + 3*num_blocks*sizeof(int) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(double) + total_unpred * sizeof(double) + num_elements * sizeof(int), 1);
+	sz_sections_begin(result);
 	unsigned char * result_pos = result;
 	initRandomAccessBytes(result_pos);
 	result_pos += meta_data_offset;
@@ -5782,10 +5681,12 @@ unsigned char * SZ_compress_double_2D_MDQ_nonblocked_with_blocked_regression(dou
 	result_pos += sizeof(int);
 	intToBytes_bigEndian(result_pos, nodeCount);
 	result_pos += sizeof(int);
+	sz_sections_mark(SZ_SECTION_TREE, result_pos - result);
 	memcpy(result_pos, treeBytes, treeByteSize);
 	result_pos += treeByteSize;
 	free(treeBytes);
 
+	sz_sections_mark(SZ_SECTION_COEFFICIENTS, result_pos - result);
 	memcpy(result_pos, &use_mean, sizeof(unsigned char));
 	result_pos += sizeof(unsigned char);
 	memcpy(result_pos, &mean, sizeof(double));
@@ -5833,15 +5734,18 @@ unsigned char * SZ_compress_double_2D_MDQ_nonblocked_with_blocked_regression(dou
 	free(coeff_unpredictable_data);
 
 	//record the number of unpredictable data and also store them
+	sz_sections_mark(SZ_SECTION_UNPREDICTABLE, result_pos - result);
 	memcpy(result_pos, &total_unpred, sizeof(size_t));
 	result_pos += sizeof(size_t);
 	memcpy(result_pos, result_unpredictable_data, total_unpred * sizeof(double));
 	result_pos += total_unpred * sizeof(double);
 	size_t typeArray_size = 0;
+	sz_sections_mark(SZ_SECTION_CODES, result_pos - result);
 	encode(huffmanTree, result_type, num_elements, result_pos, &typeArray_size);
 	result_pos += typeArray_size;
 
 	size_t totalEncodeSize = result_pos - result;
+	sz_sections_end(totalEncodeSize);
 	free(indicator);
 	free(result_unpredictable_data);
 	free(result_type);
@@ -5875,7 +5779,7 @@ unsigned char * SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(dou
 
 	// calculate block dims
 	size_t num_x, num_y, num_z;
-	size_t block_size = 6;
+	size_t block_size = confparams_cpr->regressionBlockSize > 0 ? confparams_cpr->regressionBlockSize : 6;
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r1, num_x, block_size);
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r2, num_y, block_size);
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r3, num_z, block_size);
@@ -5967,7 +5871,7 @@ unsigned char * SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(dou
 	
 	//Compress coefficient arrays
 	double precision_a, precision_b, precision_c, precision_d;
-	double rel_param_err = 0.025;
+	double rel_param_err = confparams_cpr->regressionCoeffErr > 0 ? confparams_cpr->regressionCoeffErr : 0.025;
 	precision_a = rel_param_err * realPrecision / late_blockcount_x;
 	precision_b = rel_param_err * realPrecision / late_blockcount_y;
 	precision_c = rel_param_err * realPrecision / late_blockcount_z;
@@ -6725,6 +6629,7 @@ unsigned char * SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(dou
 	unsigned int meta_data_offset = 3 + 1 + MetaDataByteLength_double;
 	// total size 										metadata		  # elements     real precision		intervals	nodeCount		huffman 	 	block index 						unpredicatable count						mean 					 	unpred size 				elements
 	unsigned char * result = (unsigned char *) calloc(meta_data_offset + exe_params->SZ_SIZE_TYPE + sizeof(double) + sizeof(int) + sizeof(int) + 5*treeByteSize + 4*num_blocks*sizeof(int)+ num_blocks * sizeof(unsigned short) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(double) + total_unpred * sizeof(double) + num_elements * sizeof(int), 1);
+	sz_sections_begin(result);
 	unsigned char * result_pos = result;
 	initRandomAccessBytes(result_pos);
 	
@@ -6743,10 +6648,12 @@ unsigned char * SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(dou
 	result_pos += sizeof(int);
 	intToBytes_bigEndian(result_pos, nodeCount);
 	result_pos += sizeof(int);
+	sz_sections_mark(SZ_SECTION_TREE, result_pos - result);
 	memcpy(result_pos, treeBytes, treeByteSize);
 	result_pos += treeByteSize;
 	free(treeBytes);
 
+	sz_sections_mark(SZ_SECTION_COEFFICIENTS, result_pos - result);
 	memcpy(result_pos, &use_mean, sizeof(unsigned char));
 	result_pos += sizeof(unsigned char);
 	memcpy(result_pos, &mean, sizeof(double));
@@ -6793,14 +6700,17 @@ unsigned char * SZ_compress_double_3D_MDQ_nonblocked_with_blocked_regression(dou
 	free(coeff_unpredictable_data);
 	
 	//record the number of unpredictable data and also store them
+	sz_sections_mark(SZ_SECTION_UNPREDICTABLE, result_pos - result);
 	memcpy(result_pos, &total_unpred, sizeof(size_t));
 	result_pos += sizeof(size_t);
 	memcpy(result_pos, result_unpredictable_data, total_unpred * sizeof(double));
 	result_pos += total_unpred * sizeof(double);
 	size_t typeArray_size = 0;
+	sz_sections_mark(SZ_SECTION_CODES, result_pos - result);
 	encode(huffmanTree, result_type, num_elements, result_pos, &typeArray_size);
 	result_pos += typeArray_size;
 	size_t totalEncodeSize = result_pos - result;
+	sz_sections_end(totalEncodeSize);
 	free(indicator);
 	free(result_unpredictable_data);
 	free(result_type);
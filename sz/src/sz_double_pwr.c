@@ -15,6 +15,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -104,6 +105,7 @@ void compute_segment_precisions_double_1D(double *oriData, size_t dataLength, do
 
 unsigned int optimize_intervals_double_1D_pwr(double *oriData, size_t dataLength, double* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, j = 0;
 	double realPrecision = pwrErrBound[j++];	
 	unsigned long radiusIndex;
@@ -145,6 +147,7 @@ unsigned int optimize_intervals_double_1D_pwr(double *oriData, size_t dataLength
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
@@ -281,6 +284,7 @@ size_t r1, size_t r2, size_t R2, size_t edgeSize, unsigned char* pwrErrBoundByte
 
 unsigned int optimize_intervals_double_2D_pwr(double *oriData, size_t r1, size_t r2, size_t R2, size_t edgeSize, double* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0,j = 0, index, I=0, J=0;
 	double realPrecision = pwrErrBound[0];	
 	unsigned long radiusIndex;
@@ -334,6 +338,7 @@ unsigned int optimize_intervals_double_2D_pwr(double *oriData, size_t r1, size_t
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
@@ -471,6 +476,7 @@ size_t r1, size_t r2, size_t r3, size_t R2, size_t R3, size_t edgeSize, unsigned
 
 unsigned int optimize_intervals_double_3D_pwr(double *oriData, size_t r1, size_t r2, size_t r3, size_t R2, size_t R3, size_t edgeSize, double* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j,k, ir,jr,index, I = 0,J=0,K=0;
 	double realPrecision = pwrErrBound[0];		
 	unsigned long radiusIndex;
@@ -534,6 +540,7 @@ unsigned int optimize_intervals_double_3D_pwr(double *oriData, size_t r1, size_t
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(double), 0);
 	return powerOf2;
 }
 
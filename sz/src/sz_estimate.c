@@ -0,0 +1,900 @@
+/**
+ *  @file sz_estimate.c
+ *  @brief Sampling-based estimation of the compression ratio, PSNR and compression time.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <limits.h>
+#include <float.h>
+#include <stdint.h>
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_estimate.h"
+
+#define SZ_EST_UNPREDICTABLE INT_MIN
+#define SZ_EST_RUN 4 //the blocks are sampled by runs of consecutive ones (the regression coefficients are predicted from the previous block)
+#define SZ_EST_COEFF_CAPACITY 65536 //quantization intervals of the regression coefficients, as in the compressors
+
+//the block sizes of the compressors (blocked regression in 2D/3D), by dimension
+static const size_t sz_est_block_size[4] = {0, 256, 16, 6};
+
+static double sz_est_value(int dataType, const void* data, size_t index)
+{
+	if(dataType == SZ_FLOAT)
+		return ((const float*)data)[index];
+	return ((const double*)data)[index];
+}
+
+static void sz_est_range(int dataType, const void* data, size_t nbEle, double* min, double* max)
+{
+	size_t i;
+	if(dataType == SZ_FLOAT)
+	{
+		const float* d = (const float*)data;
+		float mn = d[0], mx = d[0];
+		for(i = 1; i < nbEle; i++)
+		{
+			if(d[i] < mn)
+				mn = d[i];
+			else if(d[i] > mx)
+				mx = d[i];
+		}
+		*min = mn;
+		*max = mx;
+	}
+	else
+	{
+		const double* d = (const double*)data;
+		double mn = d[0], mx = d[0];
+		for(i = 1; i < nbEle; i++)
+		{
+			if(d[i] < mn)
+				mn = d[i];
+			else if(d[i] > mx)
+				mx = d[i];
+		}
+		*min = mn;
+		*max = mx;
+	}
+}
+
+/*Deterministic pseudo-random value in [-1, 1)*/
+static double sz_est_noise(size_t index)
+{
+	uint64_t x = index*0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30))*0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27))*0x94D049BB133111EBULL;
+	x ^= x >> 31;
+	return (double)(x >> 11)/(1ULL << 52) - 1;
+}
+
+/**
+ * Index of the s-th sampled block: runs of SZ_EST_RUN consecutive blocks with a regular stride (of runs)
+ * and a deterministic jitter, so that the samples do not align with the data.
+ * */
+static size_t sz_est_sample_block(size_t s, size_t stride, size_t totalBlocks)
+{
+	size_t run = s / SZ_EST_RUN, id = s;
+	if(stride > SZ_EST_RUN)
+		id = run*stride + (run*2654435761u) % (stride - SZ_EST_RUN + 1) + s % SZ_EST_RUN;
+	return id < totalBlocks ? id : totalBlocks - 1;
+}
+
+static int sz_est_compare_int(const void* a, const void* b)
+{
+	int x = *(const int*)a, y = *(const int*)b;
+	return (x > y) - (x < y);
+}
+
+/**
+ * Huffman bits per code (at least one, none for a single code) of n sampled codes out of total ones, and the number of distinct
+ * codes among the total ones. When most sampled codes are distinct the sample is too small for their
+ * frequencies: the codes are assumed about normally distributed, over the range of the sampled ones.
+ * */
+static double sz_est_code_bits(int* codes, size_t n, double total, double* distinctTotal)
+{
+	size_t i, run = 1, distinct = 0, count = 0;
+	double bits = 0, sum = 0, sum2 = 0;
+	qsort(codes, n, sizeof(int), sz_est_compare_int);
+	for(i = 1; i <= n; i++)
+	{
+		if(i < n && codes[i] == codes[i-1])
+		{
+			run++;
+			continue;
+		}
+		bits += run*log2((double)n/run);
+		distinct++;
+		run = 1;
+	}
+	bits /= n;
+	*distinctTotal = distinct;
+	for(i = 0; i < n; i++)
+		if(codes[i] != SZ_EST_UNPREDICTABLE)
+		{
+			sum += codes[i];
+			sum2 += (double)codes[i]*codes[i];
+			count++;
+		}
+	if(distinct > n/2 && count > 1)
+	{
+		double var = (sum2 - sum*sum/count)/(count - 1);
+		double normalBits = var > 0 ? log2(sqrt(2*M_PI*M_E*var)) : 0;
+		int first = codes[0] == SZ_EST_UNPREDICTABLE ? codes[n-count] : codes[0];
+		if(normalBits > bits)
+			bits = normalBits;
+		*distinctTotal = (double)codes[n-1] - first + 1;
+		if(*distinctTotal < distinct)
+			*distinctTotal = distinct;
+	}
+	if(*distinctTotal > total)
+		*distinctTotal = total;
+	return distinct == 1 ? 0 : (bits > 1 ? bits : 1);
+}
+
+/*Size of a serialized Huffman tree of the given number of leaves, see convert_HuffTree_to_bytes_anyStates()*/
+static double sz_est_tree_size(size_t leaves)
+{
+	size_t nodeCount = leaves > 0 ? 2*leaves - 1 : 1;
+	return nodeCount <= 256 ? 1+7.0*nodeCount : (nodeCount <= 65536 ? 1+9.0*nodeCount : 1+13.0*nodeCount);
+}
+
+/**
+ * Load a block of the (3D-folded) data with a one-value halo in front of it (zero outside of the data).
+ * The compressors predict from decompressed values, whose errors are about uniform within the bound,
+ * so the halo gets such an error. ori receives the original values of the block and e its extent.
+ * */
+static void sz_est_load_block(int dataType, const void* data, const size_t dims[3], size_t id, const size_t nbBlk[3], const size_t blk[3],
+	double realPrecision, double* buf, double* ori, size_t e[3])
+{
+	size_t b[3], st[3], i, j, k, l0, l1;
+	int d;
+	b[2] = id % nbBlk[2];
+	b[1] = (id / nbBlk[2]) % nbBlk[1];
+	b[0] = id / (nbBlk[2]*nbBlk[1]);
+	for(d = 0; d < 3; d++)
+	{
+		st[d] = b[d]*blk[d];
+		e[d] = dims[d] - st[d] < blk[d] ? dims[d] - st[d] : blk[d];
+	}
+	l1 = e[2]+1;
+	l0 = (e[1]+1)*(e[2]+1);
+	for(i = 0; i <= e[0]; i++)
+		for(j = 0; j <= e[1]; j++)
+			for(k = 0; k <= e[2]; k++)
+			{
+				double v = 0;
+				if((i > 0 || st[0] > 0) && (j > 0 || st[1] > 0) && (k > 0 || st[2] > 0))
+				{
+					size_t index = ((st[0]+i-1)*dims[1] + st[1]+j-1)*dims[2] + st[2]+k-1;
+					v = sz_est_value(dataType, data, index);
+					if(i > 0 && j > 0 && k > 0)
+						ori[((i-1)*e[1] + j-1)*e[2] + k-1] = v;
+					else
+						v += realPrecision*sz_est_noise(index);
+				}
+				buf[i*l0 + j*l1 + k] = v;
+			}
+}
+
+/**
+ * Least-squares fit of a*i+b*j+c*k+d over a full e0*e1*e2 block (the coordinates are independent,
+ * so each slope is fitted on its own), as the blocked regression of the compressors does.
+ * */
+static void sz_est_regression(const double* v, const size_t e[3], double coeff[4])
+{
+	size_t i, j, k, idx = 0;
+	double mean = 0, sum[3] = {0, 0, 0}, center[3], var[3];
+	size_t n = e[0]*e[1]*e[2];
+	int d;
+	for(d = 0; d < 3; d++)
+	{
+		center[d] = (e[d] - 1)/2.0;
+		var[d] = (double)(e[d]*e[d] - 1)/12.0*n; //sum of (x-center)^2 over the block
+	}
+	for(i = 0; i < e[0]; i++)
+		for(j = 0; j < e[1]; j++)
+			for(k = 0; k < e[2]; k++, idx++)
+			{
+				mean += v[idx];
+				sum[0] += (i - center[0])*v[idx];
+				sum[1] += (j - center[1])*v[idx];
+				sum[2] += (k - center[2])*v[idx];
+			}
+	mean /= n;
+	coeff[3] = mean;
+	for(d = 0; d < 3; d++)
+	{
+		coeff[d] = var[d] > 0 ? sum[d]/var[d] : 0;
+		coeff[3] -= coeff[d]*center[d];
+	}
+}
+
+/**
+ * Number of quantization intervals the compressors choose for the data (optimize_intervals_*() with the
+ * parameters in confparams_cpr) and, for the 3D ones with regression, whether the values close to the
+ * densest one (densePos) are flushed to their mean.
+ * */
+static unsigned int sz_est_intervals(int dataType, void* data, int nbDim, size_t r4, size_t r3, size_t r2, size_t r1, int withRegression,
+	double realPrecision, double* densePos, int* useMean)
+{
+	unsigned int intervals;
+	*useMean = 0;
+	if(dataType == SZ_FLOAT)
+	{
+		float* d = (float*)data;
+		float pos = 0, correctFreq = -1, flushFreq = 0;
+		if(nbDim == 1)
+			intervals = optimize_intervals_float_1D_opt(d, r1, realPrecision);
+		else if(nbDim == 2)
+			intervals = withRegression ? optimize_intervals_float_2D_with_freq_and_dense_pos(d, r2, r1, realPrecision, &pos, &correctFreq, &flushFreq)
+				: optimize_intervals_float_2D_opt(d, r2, r1, realPrecision);
+		else if(withRegression)
+		{
+			intervals = optimize_intervals_float_3D_with_freq_and_dense_pos(d, nbDim == 4 ? r4*r3 : r3, r2, r1, realPrecision, &pos, &correctFreq, &flushFreq);
+			*useMean = flushFreq > 0.5 || flushFreq > correctFreq;
+		}
+		else
+			intervals = nbDim == 3 ? optimize_intervals_float_3D_opt(d, r3, r2, r1, realPrecision) : optimize_intervals_float_4D(d, r4, r3, r2, r1, realPrecision);
+		*densePos = pos;
+	}
+	else
+	{
+		double* d = (double*)data;
+		double pos = 0, correctFreq = -1, flushFreq = 0;
+		if(nbDim == 1)
+			intervals = optimize_intervals_double_1D_opt(d, r1, realPrecision);
+		else if(nbDim == 2)
+			intervals = withRegression ? optimize_intervals_double_2D_with_freq_and_dense_pos(d, r2, r1, realPrecision, &pos, &correctFreq, &flushFreq)
+				: optimize_intervals_double_2D_opt(d, r2, r1, realPrecision);
+		else if(withRegression)
+		{
+			intervals = optimize_intervals_double_3D_with_freq_and_dense_pos(d, nbDim == 4 ? r4*r3 : r3, r2, r1, realPrecision, &pos, &correctFreq, &flushFreq);
+			*useMean = flushFreq > 0.5 || flushFreq > correctFreq;
+		}
+		else
+			intervals = nbDim == 3 ? optimize_intervals_double_3D_opt(d, r3, r2, r1, realPrecision) : optimize_intervals_double_4D(d, r4, r3, r2, r1, realPrecision);
+		*densePos = pos;
+	}
+	return intervals;
+}
+
+static int sz_est_check(int dataType, void* data, size_t r5, sz_params* params, void* est, const char* caller)
+{
+	if(data == NULL || est == NULL || params == NULL)
+	{
+		printf("Error: %s() needs the data, the parameters (or SZ_Init) and the output\n", caller);
+		return SZ_NSCS;
+	}
+	if(dataType != SZ_FLOAT && dataType != SZ_DOUBLE)
+	{
+		printf("Error: %s() supports only SZ_FLOAT and SZ_DOUBLE\n", caller);
+		return SZ_NSCS;
+	}
+	if(params->errorBoundMode >= PW_REL)
+	{
+		printf("Error: %s() does not support point-wise relative error bounds\n", caller);
+		return SZ_NSCS;
+	}
+	if(r5 > 0)
+	{
+		printf("Error: doesn't support 5 dimensions for now.\n");
+		return SZ_NSCS;
+	}
+	return SZ_SCES;
+}
+
+/**
+ * SZ_estimate() once the value range is known (rangeTime: time spent computing it). The lossless stage
+ * is evaluated for each of the nbVariants variants of params (szMode, losslessCompressor and gzipMode),
+ * whose estimations are written in est[0..nbVariants-1].
+ * */
+static int sz_est_run(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, sz_params* params,
+	double min, double max, double rangeTime, const sz_params* variants, int nbVariants, sz_estimation* est)
+{
+	double startTime = sz_stats_clock() - rangeTime;
+	int v;
+	memset(est, 0, nbVariants*sizeof(sz_estimation));
+	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1);
+	size_t typeSize = dataType == SZ_FLOAT ? sizeof(float) : sizeof(double);
+	double oriSize = (double)nbEle*typeSize;
+	size_t headerSize = 3 + 1 + (dataType == SZ_FLOAT ? MetaDataByteLength : MetaDataByteLength_double) + 4*exe_params->SZ_SIZE_TYPE + 4 + 4 + 1 + 8;
+	if(nbEle <= MIN_NUM_OF_ELEMENTS)
+	{
+		est->ratio = oriSize/(oriSize + headerSize);
+		est->bitRate = typeSize*8;
+		est->psnr = INFINITY;
+		est->estimateTime = sz_stats_clock() - startTime;
+		for(v = 1; v < nbVariants; v++) //no lossless stage
+			est[v] = est[0];
+		return SZ_SCES;
+	}
+
+	//the error bound derived from the global range, exactly as in the compressors
+	double valueRange = max - min;
+	double realPrecision;
+	int status = SZ_SCES;
+	if(params->errorBoundMode == PSNR)
+		realPrecision = computeABSErrBoundFromPSNR(params->psnr, (double)params->predThreshold, valueRange);
+	else if(params->errorBoundMode == NORM)
+		realPrecision = computeABSErrBoundFromNORM_ERR(params->normErr, nbEle);
+	else
+		realPrecision = getRealPrecision_double(valueRange, params->errorBoundMode, params->absErrBound, params->relBoundRatio, &status);
+	if(status != SZ_SCES || realPrecision <= 0)
+		return SZ_NSCS;
+	est->errorBound = realPrecision;
+	if(valueRange <= realPrecision) //stored as a single value
+	{
+		est->ratio = oriSize/(headerSize + typeSize);
+		est->bitRate = 8.0*(headerSize + typeSize)/nbEle;
+		est->psnr = valueRange == 0 ? INFINITY : 20*log10(valueRange) - 10*log10(valueRange*valueRange/12);
+		est->compressTime = rangeTime;
+		est->estimateTime = sz_stats_clock() - startTime;
+		for(v = 1; v < nbVariants; v++) //no lossless stage
+			est[v] = est[0];
+		return SZ_SCES;
+	}
+
+	//the 4D data are compressed as 3D ones (r4*r3 x r2 x r1); 1D/2D are 3D ones with unit dimensions
+	int nbDim = computeDimension(r5, r4, r3, r2, r1);
+	size_t dims[3] = {1, 1, r1}, blk[3], nbBlk[3];
+	int d;
+	if(nbDim >= 2)
+		dims[1] = r2;
+	if(nbDim == 3)
+		dims[0] = r3;
+	else if(nbDim == 4)
+		dims[0] = r4*r3;
+	int dim3 = nbDim > 3 ? 3 : nbDim;
+	int withRegression = params->withRegression != SZ_NO_REGRESSION && dim3 >= 2;
+	size_t totalBlocks = 1, edge = sz_est_block_size[dim3];
+	if(withRegression && params->regressionBlockSize > 0)
+		edge = params->regressionBlockSize;
+	for(d = 0; d < 3; d++)
+	{
+		blk[d] = dims[d] == 1 ? 1 : (dims[d] < edge ? dims[d] : edge);
+		nbBlk[d] = (dims[d] + blk[d] - 1)/blk[d];
+		totalBlocks *= nbBlk[d];
+	}
+	size_t blockVolume = blk[0]*blk[1]*blk[2];
+	size_t targetBlocks = (size_t)(SZ_ESTIMATE_SAMPLE_RATE*nbEle/blockVolume);
+	if(targetBlocks < SZ_ESTIMATE_MIN_BLOCKS)
+		targetBlocks = SZ_ESTIMATE_MIN_BLOCKS;
+	size_t stride = targetBlocks >= totalBlocks ? 1 : SZ_EST_RUN*totalBlocks/targetBlocks; //per run
+	size_t nbSamples = stride <= SZ_EST_RUN ? totalBlocks : (totalBlocks + stride - 1)/stride*SZ_EST_RUN;
+
+	int* quant = (int*)malloc(nbSamples*blockVolume*sizeof(int));
+	double* err = (double*)malloc(nbSamples*blockVolume*sizeof(double));
+	double* buf = (double*)malloc((blk[0]+1)*(blk[1]+1)*(blk[2]+1)*sizeof(double));
+	double* ori = (double*)malloc(blockVolume*sizeof(double));
+	size_t s, ns = 0, regBlocks = 0, maxRadius = params->maxRangeRadius;
+
+	//number of intervals from the same samples as the compressors, which also decide whether the 3D compressors
+	//with regression flush the values close to the densest one (e.g., the zeros of sparse data) to their mean
+	sz_perf_stats savedStats;
+	memcpy(&savedStats, sz_stats_current(), sizeof(sz_perf_stats)); //the compressor functions record into the stats of the last compression
+	double intervalStart = sz_stats_clock(), densePos = 0, mean = 0;
+	unsigned int intervals = exe_params->intvCapacity;
+	int useMean = 0;
+	if(exe_params->optQuantMode == 1)
+	{
+		sz_params* userParams = confparams_cpr;
+		confparams_cpr = params;
+		intervals = sz_est_intervals(dataType, data, nbDim, r4, r3, r2, r1, withRegression, realPrecision, &densePos, &useMean);
+		confparams_cpr = userParams;
+	}
+	if(useMean)
+	{
+		size_t i, count = 0, step = params->sampleDistance > 0 ? params->sampleDistance : 100;
+		for(i = 0; i < nbEle; i += step)
+		{
+			double value = sz_est_value(dataType, data, i);
+			if(fabs(value - densePos) < realPrecision)
+			{
+				mean += value;
+				count++;
+			}
+		}
+		if(count > 0)
+			mean /= count;
+	}
+	double intervalTime = sz_stats_clock() - intervalStart;
+
+	//the regression coefficients are quantized against the ones of the previous regression block
+	double relParamErr = params->regressionCoeffErr > 0 ? params->regressionCoeffErr : (dim3 == 2 ? 0.05 : 0.025);
+	double precision[4], lastCoeff[4];
+	int* coeffCodes[4];
+	size_t coeffCount = 0, coeffUnpred[4] = {0, 0, 0, 0};
+	int lastValid = 0;
+	for(d = 0; d < 4; d++)
+	{
+		precision[d] = relParamErr*realPrecision/(d < 3 ? blk[d] : 1);
+		coeffCodes[d] = withRegression ? (int*)malloc(nbSamples*sizeof(int)) : NULL;
+	}
+
+	double pqStart = sz_stats_clock();
+	for(s = 0; s < nbSamples; s++)
+	{
+		size_t i, j, k, e[3], l1, l0;
+		sz_est_load_block(dataType, data, dims, sz_est_sample_block(s, stride, totalBlocks), nbBlk, blk, realPrecision, buf, ori, e);
+		l1 = e[2]+1;
+		l0 = (e[1]+1)*(e[2]+1);
+		if(s % SZ_EST_RUN == 0)
+			lastValid = 0;
+
+		int useRegression = 0;
+		double coeff[4];
+		if(withRegression && e[0]*e[1]*e[2] > 1)
+		{
+			double lorenzoErr = 0, regErr = 0, noise = realPrecision*(dim3 == 2 ? 0.81 : 1.22); //as in the compressors
+			sz_est_regression(ori, e, coeff);
+			for(i = 1; i <= e[0]; i++)
+				for(j = 1; j <= e[1]; j++)
+					for(k = 1; k <= e[2]; k++)
+					{
+						double* p = buf + i*l0 + j*l1 + k;
+						double pred = p[-1] + p[-l1] + p[-l0] - p[-l1-1] - p[-l0-1] - p[-l0-l1] + p[-l0-l1-1];
+						lorenzoErr += useMean && fabs(*p - mean) < fabs(*p - pred) + noise ? fabs(*p - mean) : fabs(*p - pred) + noise;
+						regErr += fabs(*p - (coeff[0]*(i-1) + coeff[1]*(j-1) + coeff[2]*(k-1) + coeff[3]));
+					}
+			useRegression = regErr < lorenzoErr;
+			regBlocks += useRegression;
+		}
+		if(useRegression)
+		{
+			for(d = 0; d <= dim3; d++)
+			{
+				int c = d < dim3 ? d + 3 - dim3 : 3; //slopes of the non-degenerate dimensions and the intercept
+				if(!lastValid)
+				{
+					lastCoeff[c] = coeff[c]; //the previous block is not sampled
+					continue;
+				}
+				double diff = coeff[c] - lastCoeff[c], itvNum = fabs(diff)/precision[c] + 1;
+				int q = diff < 0 ? -(int)(itvNum/2) : (int)(itvNum/2);
+				if(itvNum < SZ_EST_COEFF_CAPACITY && fabs(coeff[c] - (lastCoeff[c] + 2*q*precision[c])) <= precision[c])
+				{
+					coeffCodes[d][coeffCount] = q;
+					lastCoeff[c] += 2*q*precision[c];
+				}
+				else
+				{
+					coeffCodes[d][coeffCount] = SZ_EST_UNPREDICTABLE;
+					coeffUnpred[d]++;
+					lastCoeff[c] = coeff[c];
+				}
+			}
+			coeffCount += lastValid;
+			lastValid = 1;
+		}
+
+		//prediction on the decompressed values and linear-scaling quantization
+		for(i = 1; i <= e[0]; i++)
+			for(j = 1; j <= e[1]; j++)
+				for(k = 1; k <= e[2]; k++)
+				{
+					double* p = buf + i*l0 + j*l1 + k;
+					double pred;
+					if(useMean && !useRegression && fabs(*p - mean) <= realPrecision)
+					{
+						quant[ns] = 0;
+						err[ns++] = *p - mean;
+						*p = mean;
+						continue;
+					}
+					if(useRegression)
+						pred = coeff[0]*(i-1) + coeff[1]*(j-1) + coeff[2]*(k-1) + coeff[3];
+					else
+						pred = p[-1] + p[-l1] + p[-l0] - p[-l1-1] - p[-l0-1] - p[-l0-l1] + p[-l0-l1-1];
+					double diff = *p - pred;
+					double itvNum = fabs(diff)/realPrecision + 1;
+					if(itvNum < 2.0*maxRadius)
+					{
+						int q = diff < 0 ? -(int)(itvNum/2) : (int)(itvNum/2);
+						double dec = pred + 2*q*realPrecision;
+						if(fabs(*p - dec) <= realPrecision)
+						{
+							quant[ns] = q;
+							err[ns++] = *p - dec;
+							*p = dec;
+							continue;
+						}
+					}
+					quant[ns] = SZ_EST_UNPREDICTABLE;
+					err[ns++] = 0;
+				}
+	}
+	free(buf);
+	free(ori);
+	double pqTime = sz_stats_clock() - pqStart;
+
+	int radius = intervals/2;
+
+	//quantization codes (0: unpredictable) and their error contribution
+	size_t i, unpredictable = 0;
+	double sqErr = 0;
+	for(i = 0; i < ns; i++)
+	{
+		if(quant[i] != SZ_EST_UNPREDICTABLE && abs(quant[i]) < radius)
+		{
+			sqErr += err[i]*err[i];
+			quant[i] += radius;
+		}
+		else
+		{
+			unpredictable++;
+			if(!withRegression) //the regression compressors store them exactly
+				sqErr += realPrecision*realPrecision/3; //truncated mantissa: about uniform within the bound
+			quant[i] = 0;
+		}
+	}
+	free(err);
+
+	//Huffman code lengths on the samples
+	double huffStart = sz_stats_clock();
+	HuffmanTree* huffmanTree = createHuffmanTree(intervals*2);
+	init(huffmanTree, quant, ns);
+	double treeTime = sz_stats_clock() - huffStart; //mostly depends on the number of intervals: not scaled
+	double huffBits = 0;
+	size_t nodeCount = 0;
+	for(i = 0; i < huffmanTree->stateNum; i++)
+		if(huffmanTree->code[i])
+			nodeCount++;
+	for(i = 0; i < ns; i++)
+		huffBits += huffmanTree->cout[quant[i]]; //no bits for a single code, as encode()
+	unsigned char* huffBytes = (unsigned char*)malloc(ns*2*sizeof(unsigned long) + 16);
+	size_t huffSize = 0;
+	memset(huffBytes, 0, ns*2*sizeof(unsigned long) + 16);
+	huffStart = sz_stats_clock();
+	encode(huffmanTree, quant, ns, huffBytes, &huffSize);
+	double huffTime = sz_stats_clock() - huffStart;
+	SZ_ReleaseHuffman(huffmanTree);
+	free(quant);
+
+	double treeSize = sz_est_tree_size(nodeCount);
+	int reqLength;
+	if(dataType == SZ_FLOAT)
+	{
+		float medianValue = min + valueRange/2;
+		computeReqLength_float(realPrecision, getExponent_float(valueRange/2), &reqLength, &medianValue);
+	}
+	else
+	{
+		double medianValue = min + valueRange/2;
+		computeReqLength_double(realPrecision, getExponent_double(valueRange/2), &reqLength, &medianValue);
+	}
+	double scale = (double)nbEle/ns;
+	double codeBytes = huffBits*scale/8 + treeSize;
+	double unpredBytes = unpredictable*scale*(withRegression ? typeSize : (reqLength + 2)/8.0); //raw, or mid bytes and leading-zero count
+	if(withRegression)
+	{
+		//block flags, then each coefficient with its own Huffman tree and its unpredictable values (raw)
+		double regTotal = (double)regBlocks/nbSamples*totalBlocks;
+		codeBytes += totalBlocks/8.0;
+		for(d = 0; d <= dim3 && regBlocks > 0; d++)
+		{
+			double distinctTotal;
+			if(coeffCount == 0) //no pair of consecutive sampled regression blocks
+			{
+				unpredBytes += regTotal*typeSize;
+				continue;
+			}
+			double bits = sz_est_code_bits(coeffCodes[d], coeffCount, regTotal, &distinctTotal);
+			codeBytes += 28 + bits*regTotal/8 + sz_est_tree_size((size_t)distinctTotal);
+			unpredBytes += (double)coeffUnpred[d]/coeffCount*regTotal*typeSize;
+		}
+	}
+	for(d = 0; d < 4; d++)
+		free(coeffCodes[d]);
+	double mse = sqErr/ns;
+
+	//the lossless stage of each variant on the same codes, then the per-sample costs scaled to the whole data
+	for(v = 0; v < nbVariants; v++)
+	{
+		double losslessRatio = 1, losslessTime = 0;
+		if(variants[v].szMode != SZ_BEST_SPEED && huffSize > 0)
+		{
+			unsigned char* cmpBytes = NULL;
+			double losslessStart = sz_stats_clock();
+			unsigned long cmpSize = sz_lossless_compress(variants[v].losslessCompressor, variants[v].gzipMode, huffBytes, huffSize, &cmpBytes);
+			losslessTime = sz_stats_clock() - losslessStart;
+			if(cmpSize > 0 && cmpSize < huffSize)
+				losslessRatio = (double)huffSize/cmpSize;
+			free(cmpBytes);
+		}
+		double size = headerSize + codeBytes/losslessRatio + unpredBytes;
+		if(size > oriSize + headerSize) //the compressors store the original data then
+			size = oriSize + headerSize;
+
+		est[v].ratio = oriSize/size;
+		est[v].bitRate = 8*size/nbEle;
+		est[v].psnr = mse == 0 ? INFINITY : 20*log10(valueRange) - 10*log10(mse);
+		est[v].errorBound = realPrecision;
+		est[v].predictableRate = 1 - (double)unpredictable/ns;
+		est[v].regressionRate = withRegression ? (double)regBlocks/nbSamples : 0;
+		est[v].losslessRatio = losslessRatio;
+		est[v].intervals = intervals;
+		est[v].sampleCount = ns;
+		est[v].compressTime = rangeTime + intervalTime + treeTime + (pqTime + huffTime)*scale + (huffSize > 0 ? losslessTime*codeBytes/huffSize : 0);
+		est[v].estimateTime = sz_stats_clock() - startTime;
+	}
+	free(huffBytes);
+	memcpy(sz_stats_current(), &savedStats, sizeof(sz_perf_stats));
+	return SZ_SCES;
+}
+
+/**
+ * Estimate the compression of the data with the given parameters without compressing it:
+ * blocks of about SZ_ESTIMATE_SAMPLE_RATE of the data are predicted and quantized like the
+ * compressors do (Lorenzo, or the better of Lorenzo and linear regression when withRegression is set),
+ * then the Huffman code lengths of the sampled quantization codes are computed and the lossless
+ * stage is run on their Huffman encoding. The measured per-value costs are scaled to the whole data.
+ *
+ * @param dataType SZ_FLOAT or SZ_DOUBLE
+ * @param params the parameters to evaluate (NULL: the current ones, see confparams_cpr)
+ * @param est (output) the estimation
+ *
+ * @return SZ_SCES, or SZ_NSCS if the data type, dimensions or error-bound mode are not supported
+ * */
+int SZ_estimate(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, sz_params* params, sz_estimation* est)
+{
+	double startTime = sz_stats_clock();
+	if(params == NULL)
+		params = confparams_cpr;
+	if(sz_est_check(dataType, data, r5, params, est, "SZ_estimate") != SZ_SCES)
+		return SZ_NSCS;
+	double min, max;
+	sz_est_range(dataType, data, computeDataLength(r5, r4, r3, r2, r1), &min, &max);
+	return sz_est_run(dataType, data, r5, r4, r3, r2, r1, params, min, max, sz_stats_clock() - startTime, params, 1, est);
+}
+
+/**
+ * Search the absolute error bound for which the compression ratio of the data is targetRatio, on the
+ * estimations of SZ_estimate (the value range is computed once and the same blocks are sampled at
+ * each step). The number of bits per value decreases by about one when the error bound doubles, so
+ * the search is a secant one on the bit rate against log2 of the error bound, kept within the bracket
+ * of the target and falling back to a bisection; it stops once the estimated compressed size is within
+ * SZ_FIXED_RATIO_TOLERANCE of the target, or after SZ_FIXED_RATIO_MAX_STEPS estimations.
+ *
+ * @param params the other parameters of the compression (NULL: confparams_cpr), the error-bound mode is ignored
+ * @param targetRatio the target compression ratio
+ * @param absErrBound (output) the error bound: the largest one whose estimated ratio does not exceed
+ * the target if none is within the tolerance (so that the compressed size stays below the target)
+ * @param est (output, can be NULL) the estimation with this error bound
+ *
+ * @return SZ_SCES, or SZ_NSCS if the data type, dimensions or the target are not supported
+ * */
+int SZ_estimate_errorBound(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, sz_params* params,
+	double targetRatio, double* absErrBound, sz_estimation* est)
+{
+	double startTime = sz_stats_clock();
+	sz_params cur;
+	if(params == NULL)
+		params = confparams_cpr;
+	if(absErrBound == NULL || !(targetRatio > 0))
+	{
+		printf("Error: SZ_estimate_errorBound() needs a positive target ratio and an output error bound\n");
+		return SZ_NSCS;
+	}
+	memcpy(&cur, params, sizeof(sz_params));
+	cur.errorBoundMode = ABS;
+	if(sz_est_check(dataType, data, r5, &cur, absErrBound, "SZ_estimate_errorBound") != SZ_SCES)
+		return SZ_NSCS;
+	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1);
+	double min, max;
+	sz_est_range(dataType, data, nbEle, &min, &max);
+	double rangeTime = sz_stats_clock() - startTime;
+	double valueRange = max - min;
+	double typeBits = dataType == SZ_FLOAT ? 32 : 64, targetBits = typeBits/targetRatio;
+	if(valueRange == 0)
+		valueRange = fabs(max) > 0 ? fabs(max) : 1;
+
+	//x = log2(error bound/value range), bracketed by lo (above the target bit rate) and hi (below it)
+	double x = log2(1E-4), lo = log2(DBL_EPSILON), hi = 1, prevX = 0, prevBits = 0;
+	int step, hasLo = 0, hasHi = 0;
+	sz_estimation e, hiEst, bestEst;
+	double bestX = x, bestDist = INFINITY;
+	for(step = 0; step < SZ_FIXED_RATIO_MAX_STEPS; step++)
+	{
+		cur.absErrBound = valueRange*pow(2, x);
+		if(sz_est_run(dataType, data, r5, r4, r3, r2, r1, &cur, min, max, rangeTime, &cur, 1, &e) != SZ_SCES)
+			return SZ_NSCS;
+		double dist = fabs(e.bitRate/targetBits - 1);
+		if(dist < bestDist)
+		{
+			bestDist = dist;
+			bestX = x;
+			memcpy(&bestEst, &e, sizeof(sz_estimation));
+		}
+		if(dist <= SZ_FIXED_RATIO_TOLERANCE)
+			break;
+		if(e.bitRate > targetBits)
+		{
+			lo = x;
+			hasLo = 1;
+		}
+		else
+		{
+			hi = x;
+			hasHi = 1;
+			memcpy(&hiEst, &e, sizeof(sz_estimation));
+		}
+		double next;
+		if(step == 0)
+			next = x + (e.bitRate - targetBits); //about one bit per doubling of the error bound
+		else if(e.bitRate != prevBits)
+			next = x + (e.bitRate - targetBits)*(x - prevX)/(prevBits - e.bitRate);
+		else
+			next = (lo + hi)/2;
+		if(fabs(next - x) > 8) //at most a factor of 256 at once (the bit rate is not linear at the ends)
+			next = next > x ? x + 8 : x - 8;
+		if(hasLo && hasHi && (next <= lo || next >= hi))
+			next = (lo + hi)/2;
+		else if(next < lo || next > hi)
+			next = next < lo ? (x + lo)/2 : (x + hi)/2;
+		if(fabs(next - x) < 1E-6 || (hasLo && hasHi && hi - lo < 0.02))
+			break;
+		prevX = x;
+		prevBits = e.bitRate;
+		x = next;
+	}
+	if(bestDist > SZ_FIXED_RATIO_TOLERANCE && hasHi) //missed: stay below the target size
+	{
+		bestX = hi;
+		memcpy(&bestEst, &hiEst, sizeof(sz_estimation));
+	}
+	*absErrBound = valueRange*pow(2, bestX);
+	if(est != NULL)
+	{
+		memcpy(est, &bestEst, sizeof(sz_estimation));
+		est->estimateTime = sz_stats_clock() - startTime;
+	}
+	return SZ_SCES;
+}
+
+typedef struct sz_tune_candidate
+{
+	sz_params params;
+	sz_estimation est;
+	int feasible;
+} sz_tune_candidate;
+
+static void sz_tune_score(sz_tune_candidate* c, double oriSize)
+{
+	double throughput = oriSize/c->est.compressTime/1E6;
+	if(c->params.autotune == SZ_TUNE_MAX_SPEED)
+		c->feasible = c->est.ratio >= c->params.tuneMinRatio;
+	else
+		c->feasible = c->params.tuneMinThroughput <= 0 || throughput >= c->params.tuneMinThroughput;
+}
+
+/*Whether a is a better choice than b: the feasible candidates first, then the objective (or the constraint if none is feasible)*/
+static int sz_tune_better(const sz_tune_candidate* a, const sz_tune_candidate* b)
+{
+	if(a->feasible != b->feasible)
+		return a->feasible;
+	//the predicted times are noisy: within 10%, the higher ratio wins (and within 1% of ratio, the faster)
+	int ratioFirst = a->params.autotune == SZ_TUNE_MAX_SPEED ? !a->feasible : a->feasible;
+	if(ratioFirst)
+		return a->est.ratio > b->est.ratio*1.01 || (a->est.ratio > b->est.ratio*0.99 && a->est.compressTime < b->est.compressTime);
+	return a->est.compressTime < b->est.compressTime*0.9 || (a->est.compressTime < b->est.compressTime*1.1 && a->est.ratio > b->est.ratio);
+}
+
+/**
+ * Choose the compression settings of a field by a quick sampled search (see SZ_estimate), one group
+ * of settings after the other: the predictor (Lorenzo or blocked linear regression, and the size of
+ * the regression blocks), the quantization (predThreshold, which decides the number of intervals)
+ * and the lossless stage (none, or Zstd at a few levels). The error bound is never changed, so
+ * predThreshold is kept in the PSNR mode where it is part of the error bound.
+ *
+ * The objective is given by params->autotune: SZ_TUNE_MAX_RATIO maximizes the compression ratio while
+ * the predicted throughput stays above params->tuneMinThroughput (MB/s, 0: no limit), SZ_TUNE_MAX_SPEED
+ * maximizes the predicted throughput while the ratio stays above params->tuneMinRatio. When no setting
+ * meets the constraint, the one closest to it is chosen.
+ *
+ * All these settings are self-described by the compressed stream (block size, intervals, coefficient
+ * precisions and the lossless format), so the decompression needs no tuning information.
+ *
+ * @param dataType SZ_FLOAT or SZ_DOUBLE
+ * @param params (input/output) the parameters (with the error bound) to tune, NULL: confparams_cpr
+ * @param est (output, can be NULL) the estimation of the chosen setting
+ *
+ * @return SZ_SCES, or SZ_NSCS if the data type, dimensions or error-bound mode are not supported
+ * */
+int SZ_autotune(int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, sz_params* params, sz_estimation* est)
+{
+	double startTime = sz_stats_clock();
+	sz_estimation bestEst;
+	if(params == NULL)
+		params = confparams_cpr;
+	if(est == NULL)
+		est = &bestEst;
+	if(sz_est_check(dataType, data, r5, params, est, "SZ_autotune") != SZ_SCES)
+		return SZ_NSCS;
+	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1);
+	double oriSize = (double)nbEle*(dataType == SZ_FLOAT ? sizeof(float) : sizeof(double));
+	double min, max;
+	sz_est_range(dataType, data, nbEle, &min, &max);
+	double rangeTime = sz_stats_clock() - startTime;
+
+	int nbDim = computeDimension(r5, r4, r3, r2, r1);
+	static const int blockSizes2D[4] = {8, 12, 16, 24};
+	static const int blockSizes3D[4] = {4, 6, 8, 10};
+	static const float thresholds[3] = {0.95, 0.99, 0.999};
+	static const int zstdLevels[4] = {1, 3, 9, 19};
+	const int* blockSizes = nbDim == 2 ? blockSizes2D : blockSizes3D;
+	sz_tune_candidate best, cur;
+	int i;
+
+	memcpy(&best.params, params, sizeof(sz_params));
+	if(best.params.autotune == SZ_TUNE_NONE)
+		best.params.autotune = SZ_TUNE_MAX_RATIO;
+	if(sz_est_run(dataType, data, r5, r4, r3, r2, r1, &best.params, min, max, rangeTime, &best.params, 1, &best.est) != SZ_SCES)
+		return SZ_NSCS;
+	sz_tune_score(&best, oriSize);
+
+	//the predictor: no regression, then the block sizes (there is no regression for 1D data)
+	for(i = 0; nbDim >= 2 && i < 5; i++)
+	{
+		memcpy(&cur.params, &best.params, sizeof(sz_params));
+		cur.params.withRegression = i == 0 ? SZ_NO_REGRESSION : SZ_WITH_LINEAR_REGRESSION;
+		cur.params.regressionBlockSize = i == 0 ? best.params.regressionBlockSize : blockSizes[i-1];
+		if(sz_est_run(dataType, data, r5, r4, r3, r2, r1, &cur.params, min, max, rangeTime, &cur.params, 1, &cur.est) != SZ_SCES)
+			continue;
+		sz_tune_score(&cur, oriSize);
+		if(sz_tune_better(&cur, &best))
+			memcpy(&best, &cur, sizeof(sz_tune_candidate));
+	}
+
+	//the quantization, unless the number of intervals is fixed or predThreshold is part of the error bound
+	for(i = 0; best.params.errorBoundMode != PSNR && exe_params->optQuantMode == 1 && i < 3; i++)
+	{
+		memcpy(&cur.params, &best.params, sizeof(sz_params));
+		cur.params.predThreshold = thresholds[i];
+		if(sz_est_run(dataType, data, r5, r4, r3, r2, r1, &cur.params, min, max, rangeTime, &cur.params, 1, &cur.est) != SZ_SCES)
+			continue;
+		sz_tune_score(&cur, oriSize);
+		if(sz_tune_better(&cur, &best))
+			memcpy(&best, &cur, sizeof(sz_tune_candidate));
+	}
+
+	//the lossless stage: none, then the Zstd levels, all on the same sampled codes
+	sz_params variants[5];
+	sz_estimation ests[5];
+	for(i = 0; i < 5; i++)
+	{
+		memcpy(&variants[i], &best.params, sizeof(sz_params));
+		variants[i].szMode = i == 0 ? SZ_BEST_SPEED : SZ_BEST_COMPRESSION;
+		if(i > 0)
+		{
+			variants[i].losslessCompressor = ZSTD_COMPRESSOR;
+			variants[i].gzipMode = zstdLevels[i-1];
+		}
+	}
+	if(sz_est_run(dataType, data, r5, r4, r3, r2, r1, &best.params, min, max, rangeTime, variants, 5, ests) == SZ_SCES)
+	{
+		for(i = 0; i < 5; i++)
+		{
+			memcpy(&cur.params, &variants[i], sizeof(sz_params));
+			memcpy(&cur.est, &ests[i], sizeof(sz_estimation));
+			sz_tune_score(&cur, oriSize);
+			if(sz_tune_better(&cur, &best))
+				memcpy(&best, &cur, sizeof(sz_tune_candidate));
+		}
+	}
+
+	params->withRegression = best.params.withRegression;
+	params->regressionBlockSize = best.params.regressionBlockSize;
+	params->predThreshold = best.params.predThreshold;
+	params->szMode = best.params.szMode;
+	params->losslessCompressor = best.params.losslessCompressor;
+	params->gzipMode = best.params.gzipMode;
+	memcpy(est, &best.est, sizeof(sz_estimation));
+	est->estimateTime = sz_stats_clock() - startTime;
+	return SZ_SCES;
+}
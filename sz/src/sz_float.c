@@ -15,6 +15,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -59,6 +60,7 @@ inline short computeReqLength_float_MSST19(double realPrecision)
 
 unsigned int optimize_intervals_float_1D(float *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	float pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -97,11 +99,13 @@ unsigned int optimize_intervals_float_1D(float *oriData, size_t dataLength, doub
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_2D(float *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j, index;
 	size_t radiusIndex;
 	float pred_value = 0, pred_err;
@@ -188,11 +192,13 @@ unsigned int optimize_intervals_float_2D(float *oriData, size_t r1, size_t r2, d
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_3D(float *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j,k, index;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -287,12 +293,14 @@ unsigned int optimize_intervals_float_3D(float *oriData, size_t r1, size_t r2, s
 
 	free(intervals);
 	//printf("targetCount=%d, sum=%d, totalSampleSize=%d, ratio=%f, accIntervals=%d, powerOf2=%d\n", targetCount, sum, totalSampleSize, (double)sum/(double)totalSampleSize, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 
 unsigned int optimize_intervals_float_4D(float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision)
 {
+	double statsStart = sz_stats_clock();
 	size_t i,j,k,l, index;
 	size_t radiusIndex;
 	size_t r234=r2*r3*r4;
@@ -343,6 +351,7 @@ unsigned int optimize_intervals_float_4D(float *oriData, size_t r1, size_t r2, s
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -373,47 +382,29 @@ size_t dataLength, float realPrecision, float valueRangeSize, float medianValue_
 		
 	float* spaceFillingValue = oriData; //
 	
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-	
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-	
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
-	
-	unsigned char preDataBytes[4];
-	intToBytes_bigEndian(preDataBytes, 0);
+	sz_unpred_float unpred;
+	sz_unpred_init_float(&unpred, dataLength, reqLength, medianValue);
+	float unpredData;
 	
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 	float last3CmprsData[3] = {0};
 
-	FloatValueCompressElement *vce = (FloatValueCompressElement*)malloc(sizeof(FloatValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-				
 	//add the first data	
 	type[0] = 0;
-	compressSingleFloatValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,4);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	listAdd_float(last3CmprsData, vce->data);
+	unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[0]);
+	listAdd_float(last3CmprsData, unpredData);
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[0] = vce->data;
+		decData[0] = unpredData;
 #endif		
 		
 	//add the second data
 	type[1] = 0;
-	compressSingleFloatValue(vce, spaceFillingValue[1], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,4);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	listAdd_float(last3CmprsData, vce->data);
+	unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[1]);
+	listAdd_float(last3CmprsData, unpredData);
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[1] = vce->data;
+		decData[1] = unpredData;
 #endif
 	int state;
 	float checkRadius;
@@ -449,16 +440,13 @@ size_t dataLength, float realPrecision, float valueRangeSize, float medianValue_
 			if(fabs(curData-pred)>realPrecision)
 			{	
 				type[i] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);		
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				//listAdd_float(last3CmprsData, vce->data);	
-				pred = vce->data;
+				//listAdd_float(last3CmprsData, unpredData);	
+				pred = unpredData;
 #ifdef HAVE_TIMECMPR					
 				if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-					decData[i] = vce->data;
+					decData[i] = unpredData;
 #endif					
 			}
 			else
@@ -474,30 +462,29 @@ size_t dataLength, float realPrecision, float valueRangeSize, float medianValue_
 		
 		//unpredictable data processing		
 		type[i] = 0;		
-		compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,4);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
+		unpredData = sz_unpred_add_float(&unpred, curData);
 
-		//listAdd_float(last3CmprsData, vce->data);
-		pred = vce->data;
+		//listAdd_float(last3CmprsData, unpredData);
+		pred = unpredData;
 #ifdef HAVE_TIMECMPR
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-			decData[i] = vce->data;
+			decData[i] = unpredData;
 #endif	
 		
 	}//end of for
 		
 //	char* expSegmentsInBytes;
 //	int expSegmentsInBytes_size = convertESCToBytes(esc, &expSegmentsInBytes);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_float(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 	
 	TightDataPointStorageF* tdps;
 			
 	new_TightDataPointStorageF(&tdps, dataLength, exactDataNum, 
-			type, exactMidByteArray->array, exactMidByteArray->size,  
-			exactLeadNumArray->array,  
-			resiBitArray->array, resiBitArray->size, 
+			type, exactMidBytes, exactMidBytes_size,  
+			exactLeadNum,  
+			resiBits, exactDataNum, 
 			resiBitsLength,
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
@@ -508,12 +495,9 @@ size_t dataLength, float realPrecision, float valueRangeSize, float medianValue_
 	printf("opt_quantizations=%d, exactDataNum=%zu, sum=%d\n",quantization_intervals, exactDataNum, sum);
 */	
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);	
-	free(vce);
-	free(lce);	
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 	
 	return tdps;
 }
@@ -550,6 +534,11 @@ void SZ_compress_args_float_StoreOriData(float* oriData, size_t dataLength, unsi
 		for(i=0;i<dataLength;i++,p+=floatSize)
 			floatToBytes(p, oriData[i]);
 	}	
+#ifdef HAVE_TIMECMPR
+	//the decompressor will take the original data as the history of the next step
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+		memcpy(multisteps->hist_data, oriData, dataLength*sizeof(float));
+#endif
 	*outSize = totalByteLength;
 }
 
@@ -562,32 +551,11 @@ size_t dataLength, double realPrecision, size_t *outSize, float valueRangeSize,
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
-		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{	
-				tdps = SZ_compress_float_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_f);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}
-		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			tdps = SZ_compress_float_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_f);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
+		compressionType = SZ_decide_compressionType_float_ts(cmprType, oriData, 1, 1, dataLength, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
 			tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-			compressionType = 1; //time-series based compression 			
-		}		
+		else //snapshot-based compression
+			tdps = SZ_compress_float_1D_MDQ(oriData, dataLength, realPrecision, valueRangeSize, medianValue_f);
 	}
 	else
 #endif
@@ -641,35 +609,21 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 		
 	float* spaceFillingValue = oriData; //
 
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-	
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-	
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
+	sz_unpred_float unpred;
+	sz_unpred_init_float(&unpred, dataLength, reqLength, medianValue);
+	float unpredData;
 	
 	type[0] = 0;
-	unsigned char preDataBytes[4];
-	intToBytes_bigEndian(preDataBytes, 0);
 	
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	FloatValueCompressElement *vce = (FloatValueCompressElement*)malloc(sizeof(FloatValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-			
 	/* Process Row-0 data 0*/
 	type[0] = 0;
-	compressSingleFloatValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,4);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	P1[0] = vce->data;
+	unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[0]);
+	P1[0] = unpredData;
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
-		decData[0] = vce->data;
+		decData[0] = unpredData;
 #endif	
 
 	float curData;
@@ -691,22 +645,16 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 		if(fabs(spaceFillingValue[1]-P1[1])>realPrecision)
 		{	
 			type[1] = 0;			
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+			unpredData = sz_unpred_add_float(&unpred, curData);
 			
-			P1[1] = vce->data;
+			P1[1] = unpredData;
 		}		
 	}
 	else
 	{
 		type[1] = 0;
-		compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,4);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[1] = vce->data;
+		unpredData = sz_unpred_add_float(&unpred, curData);
+		P1[1] = unpredData;
 	}
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -732,22 +680,16 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 			if(fabs(curData-P1[j])>realPrecision)
 			{	
 				type[j] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				P1[j] = vce->data;	
+				P1[j] = unpredData;	
 			}
 		}
 		else
 		{
 			type[j] = 0;
-			compressSingleFloatValue(vce,curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[j] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, curData);
+			P1[j] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -777,22 +719,16 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 			if(fabs(curData-P0[0])>realPrecision)
 			{	
 				type[index] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				P0[0] = vce->data;	
+				P0[0] = unpredData;	
 			}
 		}
 		else
 		{
 			type[index] = 0;
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P0[0] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, curData);
+			P0[0] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -820,22 +756,16 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 				if(fabs(curData-P0[j])>realPrecision)
 				{	
 					type[index] = 0;					
-					compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+					unpredData = sz_unpred_add_float(&unpred, curData);
 					
-					P0[j] = vce->data;	
+					P0[j] = unpredData;	
 				}			
 			}
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[j] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, curData);
+				P0[j] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -852,14 +782,16 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 	if(r2!=1)
 		free(P0);
 	free(P1);			
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_float(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 	
 	TightDataPointStorageF* tdps;
 			
 	new_TightDataPointStorageF(&tdps, dataLength, exactDataNum, 
-			type, exactMidByteArray->array, exactMidByteArray->size,  
-			exactLeadNumArray->array,  
-			resiBitArray->array, resiBitArray->size, 
+			type, exactMidBytes, exactMidBytes_size,  
+			exactLeadNum,  
+			resiBits, exactDataNum, 
 			resiBitsLength, 
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
@@ -867,15 +799,12 @@ TightDataPointStorageF* SZ_compress_float_2D_MDQ(float *oriData, size_t r1, size
 //			exactDataNum, expSegmentsInBytes_size, exactMidByteArray->size);
 	
 //	for(i = 3800;i<3844;i++)
-//		printf("exactLeadNumArray->array[%d]=%d\n",i,exactLeadNumArray->array[i]);
+//		printf("exactLeadNum[%d]=%d\n",i,exactLeadNum[i]);
 	
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);
-	free(vce);
-	free(lce);
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 	
 	return tdps;	
 }
@@ -894,32 +823,11 @@ char SZ_compress_args_float_NoCkRngeNoGzip_2D(int cmprType, unsigned char** newB
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
-		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{	
-				tdps = SZ_compress_float_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_f);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}					
-		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			tdps = SZ_compress_float_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_f);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
+		compressionType = SZ_decide_compressionType_float_ts(cmprType, oriData, 1, r1, r2, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
 			tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-			compressionType = 1; //time-series based compression 			
-		}
+		else //snapshot-based compression
+			tdps = SZ_compress_float_2D_MDQ(oriData, r1, r2, realPrecision, valueRangeSize, medianValue_f);
 	}
 	else
 #endif
@@ -971,33 +879,18 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 
 	float* spaceFillingValue = oriData; //
 
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
+	sz_unpred_float unpred;
+	sz_unpred_init_float(&unpred, dataLength, reqLength, medianValue);
+	float unpredData;
 
-	unsigned char preDataBytes[4];
-	intToBytes_bigEndian(preDataBytes, 0);
-	
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	FloatValueCompressElement *vce = (FloatValueCompressElement*)malloc(sizeof(FloatValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-
 
 	///////////////////////////	Process layer-0 ///////////////////////////
 	/* Process Row-0 data 0*/
 	type[0] = 0;
-	compressSingleFloatValue(vce, spaceFillingValue[0], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-	updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-	memcpy(preDataBytes,vce->curBytes,4);
-	addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-	P1[0] = vce->data;
+	unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[0]);
+	P1[0] = unpredData;
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 			decData[0] = P1[0];
@@ -1022,22 +915,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 		if(fabs(curData-P1[1])>realPrecision)
 		{	
 			type[1] = 0;			
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+			unpredData = sz_unpred_add_float(&unpred, curData);
 			
-			P1[1] = vce->data;	
+			P1[1] = unpredData;	
 		}				
 	}
 	else
 	{
 		type[1] = 0;
-		compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,4);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[1] = vce->data;
+		unpredData = sz_unpred_add_float(&unpred, curData);
+		P1[1] = unpredData;
 	}
 #ifdef HAVE_TIMECMPR	
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1063,22 +950,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 			if(fabs(curData-P1[j])>realPrecision)
 			{	
 				type[j] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				P1[j] = vce->data;	
+				P1[j] = unpredData;	
 			}			
 		}
 		else
 		{
 			type[j] = 0;
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[j] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, curData);
+			P1[j] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1108,22 +989,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 			if(fabs(curData-P1[index])>realPrecision)
 			{	
 				type[index] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				P1[index] = vce->data;	
+				P1[index] = unpredData;	
 			}			
 		}
 		else
 		{
 			type[index] = 0;
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[index] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, curData);
+			P1[index] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1151,22 +1026,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 				if(fabs(curData-P1[index])>realPrecision)
 				{	
 					type[index] = 0;					
-					compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+					unpredData = sz_unpred_add_float(&unpred, curData);
 					
-					P1[index] = vce->data;	
+					P1[index] = unpredData;	
 				}				
 			}
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, curData);
+				P1[index] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1198,22 +1067,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 			if(fabs(curData-P0[0])>realPrecision)
 			{	
 				type[index] = 0;				
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+				unpredData = sz_unpred_add_float(&unpred, curData);
 				
-				P0[0] = vce->data;	
+				P0[0] = unpredData;	
 			}			
 		}
 		else
 		{
 			type[index] = 0;
-			compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P0[0] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, curData);
+			P0[0] = unpredData;
 		}
 #ifdef HAVE_TIMECMPR	
 		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1240,22 +1103,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 				if(fabs(curData-P0[j])>realPrecision)
 				{	
 					type[index] = 0;					
-					compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+					unpredData = sz_unpred_add_float(&unpred, curData);
 					
-					P0[j] = vce->data;	
+					P0[j] = unpredData;	
 				}
 			}
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[j] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, curData);
+				P0[j] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1285,22 +1142,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 				if(fabs(curData-P0[index2D])>realPrecision)
 				{	
 					type[index] = 0;					
-					compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+					unpredData = sz_unpred_add_float(&unpred, curData);
 					
-					P0[index2D] = vce->data;	
+					P0[index2D] = unpredData;	
 				}				
 			}
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[index2D] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, curData);
+				P0[index2D] = unpredData;
 			}
 #ifdef HAVE_TIMECMPR	
 			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1331,22 +1182,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 					if(fabs(curData-P0[index2D])>realPrecision)
 					{	
 						type[index] = 0;						
-						compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-						updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-						memcpy(preDataBytes,vce->curBytes,4);
-						addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);	
+						unpredData = sz_unpred_add_float(&unpred, curData);
 						
-						P0[index2D] = vce->data;	
+						P0[index2D] = unpredData;	
 					}					
 				}
 				else
 				{
 					type[index] = 0;
-					compressSingleFloatValue(vce, curData, realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_float(&unpred, curData);
+					P0[index2D] = unpredData;
 				}
 #ifdef HAVE_TIMECMPR	
 				if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
@@ -1363,14 +1208,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 	if(r23!=1)
 		free(P0);
 	free(P1);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_float(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 
 	TightDataPointStorageF* tdps;
 
 	new_TightDataPointStorageF(&tdps, dataLength, exactDataNum,
-			type, exactMidByteArray->array, exactMidByteArray->size,
-			exactLeadNumArray->array,
-			resiBitArray->array, resiBitArray->size,
+			type, exactMidBytes, exactMidBytes_size,
+			exactLeadNum,
+			resiBits, exactDataNum,
 			resiBitsLength, 
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
@@ -1385,19 +1232,16 @@ TightDataPointStorageF* SZ_compress_float_3D_MDQ(float *oriData, size_t r1, size
 //			exactDataNum, expSegmentsInBytes_size, exactMidByteArray->size);
 
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);	
-	free(vce);
-	free(lce);
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 	
 	return tdps;	
 }
 
 /**
  * 
- * @cmprType compressionType (SZ_FORCE_SNAPSHOT_COMPRESSION, SZ_FORCE_TEMPORAL_COMPRESSION or SZ_PEORI_TEMPORAL_COMPRESSION)
+ * @cmprType compressionType (SZ_FORCE_SNAPSHOT_COMPRESSION, SZ_FORCE_TEMPORAL_COMPRESSION, SZ_PEORI_TEMPORAL_COMPRESSION or SZ_ADAPTIVE_TEMPORAL_COMPRESSION)
  * 
  * */
 char SZ_compress_args_float_NoCkRngeNoGzip_3D(int cmprType, unsigned char** newByteData, float *oriData, size_t r1, size_t r2, size_t r3, double realPrecision, size_t *outSize, float valueRangeSize, float medianValue_f)
@@ -1409,37 +1253,16 @@ char SZ_compress_args_float_NoCkRngeNoGzip_3D(int cmprType, unsigned char** newB
 #ifdef HAVE_TIMECMPR
 	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
 	{
-		int timestep = sz_tsc->currentStep;
-		if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
-		{
-			if(timestep % confparams_cpr->snapshotCmprStep != 0)
-			{
-				tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-				compressionType = 1; //time-series based compression 
-			}
-			else
-			{
-				if(confparams_cpr->withRegression == SZ_NO_REGRESSION)	
-					tdps = SZ_compress_float_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_f);
-				else
-					*newByteData = SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
-				compressionType = 0; //snapshot-based compression
-				multisteps->lastSnapshotStep = timestep;
-			}					
-		}
-		else if(cmprType == SZ_FORCE_SNAPSHOT_COMPRESSION)
-		{
-			if(confparams_cpr->withRegression == SZ_NO_REGRESSION)	
-				tdps = SZ_compress_float_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_f);
-			else
-				*newByteData = SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
-			compressionType = 0; //snapshot-based compression
-			multisteps->lastSnapshotStep = timestep;			
-		}
-		else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
-		{
+		compressionType = SZ_decide_compressionType_float_ts(cmprType, oriData, r1, r2, r3, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
 			tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
-			compressionType = 1; //time-series based compression 			
+		else if(confparams_cpr->withRegression == SZ_NO_REGRESSION) //snapshot-based compression
+			tdps = SZ_compress_float_3D_MDQ(oriData, r1, r2, r3, realPrecision, valueRangeSize, medianValue_f);
+		else //snapshot-based compression with the blocked regression (SZ 2.1), which also records its reconstruction in hist_data
+		{
+			*newByteData = SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1, r2, r3, realPrecision, outSize);
+			if(*outSize>3 + MetaDataByteLength + exe_params->SZ_SIZE_TYPE + 1 + sizeof(float)*dataLength)
+				SZ_compress_args_float_StoreOriData(oriData, dataLength, newByteData, outSize);
 		}
 	}
 	else
@@ -1459,6 +1282,12 @@ char SZ_compress_args_float_NoCkRngeNoGzip_3D(int cmprType, unsigned char** newB
 
 TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, float valueRangeSize, float medianValue_f)
 {	
+#ifdef HAVE_TIMECMPR
+	float* decData = NULL;
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+		decData = (float*)(multisteps->hist_data);
+#endif
+
 	unsigned int quantization_intervals;
 	if(exe_params->optQuantMode==1)
 	{
@@ -1491,24 +1320,12 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 
 	float* spaceFillingValue = oriData; //
 
-	DynamicIntArray *exactLeadNumArray;
-	new_DIA(&exactLeadNumArray, DynArrayInitLen);
-
-	DynamicByteArray *exactMidByteArray;
-	new_DBA(&exactMidByteArray, DynArrayInitLen);
-
-	DynamicIntArray *resiBitArray;
-	new_DIA(&resiBitArray, DynArrayInitLen);
+	sz_unpred_float unpred;
+	sz_unpred_init_float(&unpred, dataLength, reqLength, medianValue);
+	float unpredData;
 
-	unsigned char preDataBytes[4];
-	intToBytes_bigEndian(preDataBytes, 0);
-
-	int reqBytesLength = reqLength/8;
 	int resiBitsLength = reqLength%8;
 
-	FloatValueCompressElement *vce = (FloatValueCompressElement*)malloc(sizeof(FloatValueCompressElement));
-	LossyCompressionElement *lce = (LossyCompressionElement*)malloc(sizeof(LossyCompressionElement));
-
 
 	size_t l;
 	for (l = 0; l < r1; l++)
@@ -1520,11 +1337,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 		size_t index2D = 0;
 
 		type[index] = 0;
-		compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-		updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-		memcpy(preDataBytes,vce->curBytes,4);
-		addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-		P1[index2D] = vce->data;
+		unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+		P1[index2D] = unpredData;
 
 		/* Process Row-0 data 1*/
 		index = l*r234+1;
@@ -1544,11 +1358,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 		else
 		{
 			type[index] = 0;
-			compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-			updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-			memcpy(preDataBytes,vce->curBytes,4);
-			addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-			P1[index2D] = vce->data;
+			unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+			P1[index2D] = unpredData;
 		}
 
 		/* Process Row-0 data 2 --> data r4-1 */
@@ -1571,11 +1382,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index2D] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+				P1[index2D] = unpredData;
 			}
 		}
 
@@ -1600,11 +1408,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P1[index2D] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+				P1[index2D] = unpredData;
 			}
 
 			/* Process row-i data 1 --> data r4-1*/
@@ -1628,16 +1433,18 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 				else
 				{
 					type[index] = 0;
-					compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P1[index2D] = vce->data;
+					unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+					P1[index2D] = unpredData;
 				}
 			}
 		}
 
 
+#ifdef HAVE_TIMECMPR
+		if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+			memcpy(decData+l*r234, P1, r34*sizeof(float));
+#endif
+
 		///////////////////////////	Process layer-1 --> layer-r2-1 ///////////////////////////
 
 		for (k = 1; k < r2; k++)
@@ -1660,11 +1467,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 			else
 			{
 				type[index] = 0;
-				compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-				updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-				memcpy(preDataBytes,vce->curBytes,4);
-				addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-				P0[index2D] = vce->data;
+				unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+				P0[index2D] = unpredData;
 			}
 
 			/* Process Row-0 data 1 --> data r4-1 */
@@ -1687,11 +1491,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 				else
 				{
 					type[index] = 0;
-					compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+					P0[index2D] = unpredData;
 				}
 			}
 
@@ -1716,11 +1517,8 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 				else
 				{
 					type[index] = 0;
-					compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-					updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-					memcpy(preDataBytes,vce->curBytes,4);
-					addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-					P0[index2D] = vce->data;
+					unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+					P0[index2D] = unpredData;
 				}
 
 				/* Process Row-i data 1 --> data r4-1 */
@@ -1744,15 +1542,17 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 					else
 					{
 						type[index] = 0;
-						compressSingleFloatValue(vce, spaceFillingValue[index], realPrecision, medianValue, reqLength, reqBytesLength, resiBitsLength);
-						updateLossyCompElement_Float(vce->curBytes, preDataBytes, reqBytesLength, resiBitsLength, lce);
-						memcpy(preDataBytes,vce->curBytes,4);
-						addExactData(exactMidByteArray, exactLeadNumArray, resiBitArray, lce);
-						P0[index2D] = vce->data;
+						unpredData = sz_unpred_add_float(&unpred, spaceFillingValue[index]);
+						P0[index2D] = unpredData;
 					}
 				}
 			}
 
+#ifdef HAVE_TIMECMPR
+			if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+				memcpy(decData+l*r234+k*r34, P0, r34*sizeof(float));
+#endif
+
 			float *Pt;
 			Pt = P1;
 			P1 = P0;
@@ -1762,41 +1562,59 @@ TightDataPointStorageF* SZ_compress_float_4D_MDQ(float *oriData, size_t r1, size
 
 	free(P0);
 	free(P1);
-	size_t exactDataNum = exactLeadNumArray->size;
+	unsigned char *exactLeadNum, *exactMidBytes, *resiBits;
+	size_t exactMidBytes_size = sz_unpred_encode_float(&unpred, &exactLeadNum, &exactMidBytes, &resiBits);
+	size_t exactDataNum = unpred.count;
 
 	TightDataPointStorageF* tdps;
 
 	new_TightDataPointStorageF(&tdps, dataLength, exactDataNum,
-			type, exactMidByteArray->array, exactMidByteArray->size,
-			exactLeadNumArray->array,
-			resiBitArray->array, resiBitArray->size,
+			type, exactMidBytes, exactMidBytes_size,
+			exactLeadNum,
+			resiBits, exactDataNum,
 			resiBitsLength,
 			realPrecision, medianValue, (char)reqLength, quantization_intervals, NULL, 0, 0);
 
 	//free memory
-	free_DIA(exactLeadNumArray);
-	free_DIA(resiBitArray);
+	free(exactLeadNum);
+	free(resiBits);
 	free(type);
-	free(vce);
-	free(lce);
-	free(exactMidByteArray); //exactMidByteArray->array has been released in free_TightDataPointStorageF(tdps);
 
 	return tdps;
 }
 
-char SZ_compress_args_float_NoCkRngeNoGzip_4D(unsigned char** newByteData, float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, float valueRangeSize, float medianValue_f)
+char SZ_compress_args_float_NoCkRngeNoGzip_4D(int cmprType, unsigned char** newByteData, float *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision, size_t *outSize, float valueRangeSize, float medianValue_f)
 {
-	TightDataPointStorageF* tdps = SZ_compress_float_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_f);
-
-	convertTDPStoFlatBytes_float(tdps, newByteData, outSize);
-
-	int dataLength = r1*r2*r3*r4;
-	if(*outSize>3 + MetaDataByteLength + exe_params->SZ_SIZE_TYPE + 1 + sizeof(float)*dataLength)
-		SZ_compress_args_float_StoreOriData(oriData, dataLength, newByteData, outSize);
+	size_t dataLength = r1*r2*r3*r4;
+	char compressionType = 0;
+	TightDataPointStorageF* tdps = NULL;
+#ifdef HAVE_TIMECMPR
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+	{
+		compressionType = SZ_decide_compressionType_float_ts(cmprType, oriData, r1*r2, r3, r4, multisteps, realPrecision);
+		if(compressionType == 1) //time-series based compression
+			tdps = SZ_compress_float_1D_MDQ_ts(oriData, dataLength, multisteps, realPrecision, valueRangeSize, medianValue_f);
+		else if(confparams_cpr->withRegression == SZ_NO_REGRESSION) //snapshot-based compression
+			tdps = SZ_compress_float_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_f);
+		else //snapshot-based compression with the blocked regression (SZ 2.1), which also records its reconstruction in hist_data
+		{
+			*newByteData = SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(oriData, r1*r2, r3, r4, realPrecision, outSize);
+			if(*outSize>3 + MetaDataByteLength + exe_params->SZ_SIZE_TYPE + 1 + sizeof(float)*dataLength)
+				SZ_compress_args_float_StoreOriData(oriData, dataLength, newByteData, outSize);
+		}
+	}
+	else
+#endif
+		tdps = SZ_compress_float_4D_MDQ(oriData, r1, r2, r3, r4, realPrecision, valueRangeSize, medianValue_f);
 
-	free_TightDataPointStorageF(tdps);
-	
-	return 0;
+	if(tdps!=NULL)
+	{
+		convertTDPStoFlatBytes_float(tdps, newByteData, outSize);
+		if(*outSize>3 + MetaDataByteLength + exe_params->SZ_SIZE_TYPE + 1 + sizeof(float)*dataLength)
+			SZ_compress_args_float_StoreOriData(oriData, dataLength, newByteData, outSize);
+		free_TightDataPointStorageF(tdps);
+	}
+	return compressionType;
 }
 
 /*MSST19*/
@@ -2720,6 +2538,16 @@ void SZ_compress_args_float_withinRange(unsigned char** newByteData, float *oriD
 	//*newByteData = (unsigned char*)malloc(sizeof(unsigned char)*12); //for floating-point data (1+3+4+4)
 	//memcpy(*newByteData, tmpByteData, 12);
 	*outSize = tmpOutSize; //8+SZ_SIZE_TYPE; //8==3+1+4(float_size)
+#ifdef HAVE_TIMECMPR
+	if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)
+	{
+		size_t i;
+		float* hist_data = (float*)(multisteps->hist_data);
+		for(i=0;i<dataLength;i++)
+			hist_data[i] = value;
+		multisteps->compressionType = 0;
+	}
+#endif
 	free_TightDataPointStorageF(tdps);	
 }
 
@@ -2783,6 +2611,11 @@ int SZ_compress_args_float(int cmprType, unsigned char** newByteData, float *ori
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, size_t *outSize, 
 int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRatio)
 {
+	if(errBoundMode==FIXED_RATIO) //the error bound is searched for the target ratio first, see SZ_compress_args_fixedRatio()
+	{
+		*newByteData = SZ_compress_args_fixedRatio(cmprType, SZ_FLOAT, oriData, outSize, r5, r4, r3, r2, r1);
+		return *newByteData==NULL ? SZ_NSCS : SZ_SCES;
+	}
 	confparams_cpr->errorBoundMode = errBoundMode;
 	if(errBoundMode==PW_REL)
 	{
@@ -2790,10 +2623,12 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 	}
 	int status = SZ_SCES;
 	size_t dataLength = computeDataLength(r5,r4,r3,r2,r1);
+	sz_stats_begin(SZ_FLOAT, dataLength*sizeof(float));
 	
 	if(dataLength <= MIN_NUM_OF_ELEMENTS)
 	{
 		*newByteData = SZ_skip_compress_float(oriData, dataLength, outSize);
+		sz_stats_end(*outSize);
 		return status;
 	}
 	
@@ -2963,12 +2798,12 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 			else
 #ifdef HAVE_TIMECMPR
 				if(confparams_cpr->szMode == SZ_TEMPORAL_COMPRESSION)				
-					multisteps->compressionType = SZ_compress_args_float_NoCkRngeNoGzip_4D(&tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
+					multisteps->compressionType = SZ_compress_args_float_NoCkRngeNoGzip_4D(cmprType, &tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
 				else
 #endif
 				{
 					if(confparams_cpr->withRegression == SZ_NO_REGRESSION)
-						SZ_compress_args_float_NoCkRngeNoGzip_4D(&tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
+						SZ_compress_args_float_NoCkRngeNoGzip_4D(cmprType, &tmpByteData, oriData, r4, r3, r2, r1, realPrecision, &tmpOutSize, valueRangeSize, medianValue);
 					else 
 					{
 						tmpByteData = SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(oriData, r4*r3, r2, r1, realPrecision, &tmpOutSize); //SZ 2.1 4D
@@ -2983,7 +2818,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 			status = SZ_DERR; //dimension error
 		}
 		//Call Zstd or Gzip to do the further compression.
-		if(confparams_cpr->szMode==SZ_BEST_SPEED)
+		if(confparams_cpr->szMode==SZ_BEST_SPEED || sz_lossless_skip(confparams_cpr, tmpByteData, tmpOutSize))
 		{
 			*outSize = tmpOutSize;
 			*newByteData = tmpByteData;
@@ -3000,6 +2835,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio, double pwRelBoundRa
 		}
 	}
 	
+	sz_stats_end(*outSize);
 	return status;
 }
 
@@ -3191,6 +3027,7 @@ size_t r4, size_t r3, size_t r2, size_t r1, size_t s4, size_t s3, size_t s2, siz
 
 unsigned int optimize_intervals_float_1D_subblock(float *oriData, double realPrecision, size_t r1, size_t s1, size_t e1)
 {
+	double statsStart = sz_stats_clock();
 	size_t dataLength = e1 - s1 + 1;
 	oriData = oriData + s1;
 
@@ -3233,11 +3070,13 @@ unsigned int optimize_intervals_float_1D_subblock(float *oriData, double realPre
 
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_2D_subblock(float *oriData, double realPrecision, size_t r1, size_t r2, size_t s1, size_t s2, size_t e1, size_t e2)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 
@@ -3282,11 +3121,13 @@ unsigned int optimize_intervals_float_2D_subblock(float *oriData, double realPre
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_3D_subblock(float *oriData, double realPrecision, size_t r1, size_t r2, size_t r3, size_t s1, size_t s2, size_t s3, size_t e1, size_t e2, size_t e3)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 	size_t R3 = e3 - s3 + 1;
@@ -3337,12 +3178,14 @@ unsigned int optimize_intervals_float_3D_subblock(float *oriData, double realPre
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_4D_subblock(float *oriData, double realPrecision,
 size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, size_t s4, size_t e1, size_t e2, size_t e3, size_t e4)
 {
+	double statsStart = sz_stats_clock();
 	size_t R1 = e1 - s1 + 1;
 	size_t R2 = e2 - s2 + 1;
 	size_t R3 = e3 - s3 + 1;
@@ -3399,6 +3242,7 @@ size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, siz
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -4424,6 +4268,7 @@ size_t r1, size_t r2, size_t r3, size_t r4, size_t s1, size_t s2, size_t s3, siz
 
 unsigned int optimize_intervals_float_1D_opt_MSST19(float *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	float pred_value = 0;
 	double pred_err;
@@ -4469,11 +4314,13 @@ unsigned int optimize_intervals_float_1D_opt_MSST19(float *oriData, size_t dataL
 		powerOf2 = 32;
 	
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_2D_opt_MSST19(float *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	float pred_value = 0, pred_err;
@@ -4529,11 +4376,13 @@ unsigned int optimize_intervals_float_2D_opt_MSST19(float *oriData, size_t r1, s
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_3D_opt_MSST19(float *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -4594,12 +4443,14 @@ unsigned int optimize_intervals_float_3D_opt_MSST19(float *oriData, size_t r1, s
 	if(powerOf2<32)
 		powerOf2 = 32;
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 
 unsigned int optimize_intervals_float_3D_opt(float *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -4655,6 +4506,7 @@ unsigned int optimize_intervals_float_3D_opt(float *oriData, size_t r1, size_t r
 	if(powerOf2<32)
 		powerOf2 = 32;
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -4971,6 +4823,7 @@ size_t SZ_compress_float_3D_MDQ_RA_block(float * block_ori_data, float * mean, s
 
 unsigned int optimize_intervals_float_2D_opt(float *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i;
 	size_t radiusIndex;
 	float pred_value = 0, pred_err;
@@ -5021,11 +4874,13 @@ unsigned int optimize_intervals_float_2D_opt(float *oriData, size_t r1, size_t r
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_float_1D_opt(float *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	float pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -5063,6 +4918,7 @@ unsigned int optimize_intervals_float_1D_opt(float *oriData, size_t dataLength,
 		powerOf2 = 32;
 	
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -5361,6 +5217,7 @@ static unsigned int optimize_intervals_float_1D_with_freq_and_dense_pos(float *o
 
 unsigned int optimize_intervals_float_2D_with_freq_and_dense_pos(float *oriData, size_t r1, size_t r2, double realPrecision, float * dense_pos, float * max_freq, float * mean_freq)
 {	
+	double statsStart = sz_stats_clock();
 	float mean = 0.0;
 	size_t len = r1 * r2;
 	size_t mean_distance = (int) (sqrt(len));
@@ -5465,6 +5322,7 @@ unsigned int optimize_intervals_float_2D_with_freq_and_dense_pos(float *oriData,
 
 	free(freq_intervals);
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, 0, 0);
 	return powerOf2;
 }
 
@@ -5491,7 +5349,7 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 
 	// calculate block dims
 	size_t num_x, num_y;
-	size_t block_size = 16;
+	size_t block_size = confparams_cpr->regressionBlockSize > 0 ? confparams_cpr->regressionBlockSize : 16;
 
 	SZ_COMPUTE_2D_NUMBER_OF_BLOCKS(r1, num_x, block_size);
 	SZ_COMPUTE_2D_NUMBER_OF_BLOCKS(r2, num_y, block_size);
@@ -5563,7 +5421,7 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 
 	//Compress coefficient arrays
 	float precision_a, precision_b, precision_c;
-	float rel_param_err = 0.15/3;
+	float rel_param_err = confparams_cpr->regressionCoeffErr > 0 ? confparams_cpr->regressionCoeffErr : 0.15/3;
 	precision_a = rel_param_err * realPrecision / late_blockcount_x;
 	precision_b = rel_param_err * realPrecision / late_blockcount_y;
 	precision_c = rel_param_err * realPrecision;
@@ -6253,6 +6111,7 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 	unsigned int meta_data_offset = 3 + 1 + MetaDataByteLength;
 	// total size 										metadata		  # elements   real precision		intervals	nodeCount		huffman 	 	block index 						unpredicatable count						mean 					 	unpred size 				elements
 	unsigned char * result = (unsigned char *) calloc(meta_data_offset + exe_params->SZ_SIZE_TYPE + sizeof(float) + sizeof(int) + sizeof(int) + 5*treeByteSize + 3*num_blocks*sizeof(int) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(float) + total_unpred * sizeof(float) + num_elements * sizeof(int), 1);
+	sz_sections_begin(result);
 	unsigned char * result_pos = result;
 	initRandomAccessBytes(result_pos);
 	result_pos += meta_data_offset;
@@ -6270,10 +6129,12 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 	result_pos += sizeof(int);
 	intToBytes_bigEndian(result_pos, nodeCount);
 	result_pos += sizeof(int);
+	sz_sections_mark(SZ_SECTION_TREE, result_pos - result);
 	memcpy(result_pos, treeBytes, treeByteSize);
 	result_pos += treeByteSize;
 	free(treeBytes);
 
+	sz_sections_mark(SZ_SECTION_COEFFICIENTS, result_pos - result);
 	memcpy(result_pos, &use_mean, sizeof(unsigned char));
 	result_pos += sizeof(unsigned char);
 	memcpy(result_pos, &mean, sizeof(float));
@@ -6321,11 +6182,13 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 	free(coeff_unpredictable_data);
 
 	//record the number of unpredictable data and also store them
+	sz_sections_mark(SZ_SECTION_UNPREDICTABLE, result_pos - result);
 	memcpy(result_pos, &total_unpred, sizeof(size_t));
 	result_pos += sizeof(size_t);
 	memcpy(result_pos, result_unpredictable_data, total_unpred * sizeof(float));
 	result_pos += total_unpred * sizeof(float);
 	size_t typeArray_size = 0;
+	sz_sections_mark(SZ_SECTION_CODES, result_pos - result);
 	encode(huffmanTree, result_type, num_elements, result_pos, &typeArray_size);
 	result_pos += typeArray_size;
 	
@@ -6336,6 +6199,7 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 #endif	
 
 	size_t totalEncodeSize = result_pos - result;
+	sz_sections_end(totalEncodeSize);
 	free(indicator);
 	free(result_unpredictable_data);
 	free(result_type);
@@ -6351,6 +6215,7 @@ unsigned char * SZ_compress_float_2D_MDQ_nonblocked_with_blocked_regression(floa
 
 unsigned int optimize_intervals_float_3D_with_freq_and_dense_pos(float *oriData, size_t r1, size_t r2, size_t r3, double realPrecision, float * dense_pos, float * max_freq, float * mean_freq)
 {	
+	double statsStart = sz_stats_clock();
 	float mean = 0.0;
 	size_t len = r1 * r2 * r3;
 	size_t mean_distance = (int) (sqrt(len));
@@ -6475,6 +6340,7 @@ unsigned int optimize_intervals_float_3D_with_freq_and_dense_pos(float *oriData,
 
 	free(freq_intervals);
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, 0, 0);
 	return powerOf2;
 }
 
@@ -6498,7 +6364,7 @@ unsigned char * SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(floa
 
 	// calculate block dims
 	size_t num_x, num_y, num_z;
-	size_t block_size = 6;
+	size_t block_size = confparams_cpr->regressionBlockSize > 0 ? confparams_cpr->regressionBlockSize : 6;
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r1, num_x, block_size);
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r2, num_y, block_size);
 	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r3, num_z, block_size);
@@ -6590,7 +6456,7 @@ unsigned char * SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(floa
 	
 	//Compress coefficient arrays
 	float precision_a, precision_b, precision_c, precision_d;
-	float rel_param_err = 0.025;
+	float rel_param_err = confparams_cpr->regressionCoeffErr > 0 ? confparams_cpr->regressionCoeffErr : 0.025;
 	precision_a = rel_param_err * realPrecision / late_blockcount_x;
 	precision_b = rel_param_err * realPrecision / late_blockcount_y;
 	precision_c = rel_param_err * realPrecision / late_blockcount_z;
@@ -7344,6 +7210,7 @@ unsigned char * SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(floa
 	unsigned int meta_data_offset = 3 + 1 + MetaDataByteLength;
 	// total size 										metadata		  # elements     real precision		intervals	nodeCount		huffman 	 	block index 						unpredicatable count						mean 					 	unpred size 				elements
 	unsigned char * result = (unsigned char *) calloc(meta_data_offset + exe_params->SZ_SIZE_TYPE + sizeof(float) + sizeof(int) + sizeof(int) + 5*treeByteSize + 4*num_blocks*sizeof(int) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(unsigned short) + num_blocks * sizeof(float) + total_unpred * sizeof(float) + num_elements * sizeof(int), 1);
+	sz_sections_begin(result);
 	unsigned char * result_pos = result;
 	initRandomAccessBytes(result_pos);
 	
@@ -7362,10 +7229,12 @@ unsigned char * SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(floa
 	result_pos += sizeof(int);
 	intToBytes_bigEndian(result_pos, nodeCount);
 	result_pos += sizeof(int);
+	sz_sections_mark(SZ_SECTION_TREE, result_pos - result);
 	memcpy(result_pos, treeBytes, treeByteSize);
 	result_pos += treeByteSize;
 	free(treeBytes);
 
+	sz_sections_mark(SZ_SECTION_COEFFICIENTS, result_pos - result);
 	memcpy(result_pos, &use_mean, sizeof(unsigned char));
 	result_pos += sizeof(unsigned char);
 	memcpy(result_pos, &mean, sizeof(float));
@@ -7415,14 +7284,17 @@ unsigned char * SZ_compress_float_3D_MDQ_nonblocked_with_blocked_regression(floa
 	free(coeff_unpredictable_data);
 	
 	//record the number of unpredictable data and also store them
+	sz_sections_mark(SZ_SECTION_UNPREDICTABLE, result_pos - result);
 	memcpy(result_pos, &total_unpred, sizeof(size_t));
 	result_pos += sizeof(size_t);
 	memcpy(result_pos, result_unpredictable_data, total_unpred * sizeof(float));
 	result_pos += total_unpred * sizeof(float);
 	size_t typeArray_size = 0;
+	sz_sections_mark(SZ_SECTION_CODES, result_pos - result);
 	encode(huffmanTree, result_type, num_elements, result_pos, &typeArray_size);
 	result_pos += typeArray_size;
 	size_t totalEncodeSize = result_pos - result;
+	sz_sections_end(totalEncodeSize);
 	free(indicator);
 	free(result_unpredictable_data);
 	free(result_type);
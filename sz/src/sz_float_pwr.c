@@ -15,6 +15,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -105,6 +106,7 @@ void compute_segment_precisions_float_1D(float *oriData, size_t dataLength, floa
 
 unsigned int optimize_intervals_float_1D_pwr(float *oriData, size_t dataLength, float* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, j = 0;
 	float realPrecision = pwrErrBound[j++];	
 	unsigned long radiusIndex;
@@ -147,6 +149,7 @@ unsigned int optimize_intervals_float_1D_pwr(float *oriData, size_t dataLength,
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -283,6 +286,7 @@ size_t r1, size_t r2, size_t R2, size_t edgeSize, unsigned char* pwrErrBoundByte
 
 unsigned int optimize_intervals_float_2D_pwr(float *oriData, size_t r1, size_t r2, size_t R2, size_t edgeSize, float* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0,j = 0, index, I=0, J=0;
 	float realPrecision = pwrErrBound[0];	
 	unsigned long radiusIndex;
@@ -336,6 +340,7 @@ unsigned int optimize_intervals_float_2D_pwr(float *oriData, size_t r1, size_t r
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -475,6 +480,7 @@ size_t r1, size_t r2, size_t r3, size_t R2, size_t R3, size_t edgeSize, unsigned
 
 unsigned int optimize_intervals_float_3D_pwr(float *oriData, size_t r1, size_t r2, size_t r3, size_t R2, size_t R3, size_t edgeSize, float* pwrErrBound)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j,k, ir,jr,index, I = 0,J=0,K=0;
 	float realPrecision = pwrErrBound[0];		
 	unsigned long radiusIndex;
@@ -538,6 +544,7 @@ unsigned int optimize_intervals_float_3D_pwr(float *oriData, size_t r1, size_t r
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
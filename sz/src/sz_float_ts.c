@@ -14,6 +14,8 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
+#undef multisteps //the time-step state is passed to the functions below explicitly
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -24,6 +26,7 @@
 
 unsigned int optimize_intervals_float_1D_ts(float *oriData, size_t dataLength, float* preData, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	float pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -60,6 +63,7 @@ unsigned int optimize_intervals_float_1D_ts(float *oriData, size_t dataLength, f
 		powerOf2 = 32;
 	
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(float), 0);
 	return powerOf2;
 }
 
@@ -204,4 +208,65 @@ double realPrecision, float valueRangeSize, float medianValue_f)
 	return tdps;
 }
 
+/**
+ * Decide whether the current step is compressed as a snapshot (0) or based on the previous step (1).
+ * The data is viewed as r1*r2*r3 (r3 is the fastest dimension), e.g., 1D data is passed as 1*1*n.
+ * For SZ_ADAPTIVE_TEMPORAL_COMPRESSION, the previous-step prediction and the Lorenzo prediction 
+ * (used by the snapshot compression) are evaluated on the sampled points, and the one with the 
+ * higher hit ratio (prediction error <= realPrecision) wins.
+ * */
+char SZ_decide_compressionType_float_ts(int cmprType, float *oriData, size_t r1, size_t r2, size_t r3, sz_multisteps* multisteps, double realPrecision)
+{
+	char compressionType = 0;
+	int timestep = sz_tsc->currentStep;
+	if(cmprType == SZ_PERIO_TEMPORAL_COMPRESSION)
+		compressionType = (timestep % confparams_cpr->snapshotCmprStep != 0);
+	else if(cmprType == SZ_FORCE_TEMPORAL_COMPRESSION)
+		compressionType = 1;
+	else if(cmprType == SZ_ADAPTIVE_TEMPORAL_COMPRESSION)
+	{
+		float* preStepData = (float*)(multisteps->hist_data);
+		size_t r23 = r2*r3, dataLength = r1*r23;
+		size_t index, sampleCount = 0, tsHits = 0, snapshotHits = 0;
+		double tsErr = 0, snapshotErr = 0, pred, err;
+		int mask, s;
+		for(index=1;index<dataLength;index+=confparams_cpr->sampleDistance)
+		{
+			//Lorenzo prediction over the dimensions in which the point has a preceding neighbor
+			mask = (index%r3>0) | ((index%r23>=r3)<<1) | ((index>=r23)<<2);
+			pred = 0;
+			for(s=1;s<8;s++)
+			{
+				if((s&mask)!=s)
+					continue;
+				size_t offset = (s&1) + ((s>>1)&1)*r3 + ((s>>2)&1)*r23;
+				int sign = ((s&1)+((s>>1)&1)+((s>>2)&1))%2==1 ? 1 : -1;
+				pred += sign*oriData[index-offset];
+			}
+			err = fabs(pred - oriData[index]);
+			snapshotErr += err;
+			if(err <= realPrecision)
+				snapshotHits++;
+
+			err = fabs(preStepData[index] - oriData[index]);
+			tsErr += err;
+			if(err <= realPrecision)
+				tsHits++;
+			sampleCount++;
+		}
+		if(sampleCount > 0)
+		{
+			multisteps->tsHitRatio = (double)tsHits/sampleCount;
+			multisteps->snapshotHitRatio = (double)snapshotHits/sampleCount;
+			compressionType = tsHits > snapshotHits || (tsHits == snapshotHits && tsErr < snapshotErr);
+		}
+	}
 
+	if(compressionType == 0)
+	{
+		multisteps->lastSnapshotStep = timestep;
+		//a snapshot decompresses on its own: neither it nor the next steps refer to the Huffman trees of the steps before it
+		sz_huffman_dict_reset(sz_huffman_dict_current());
+	}
+	return compressionType;
+}
@@ -0,0 +1,140 @@
+/**
+ *  @file sz_histogram.c
+ *  @brief Frequencies of the quantization codes, shared by the entropy coders (Huffman and arithmetic coding).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#include "sz_histogram.h"
+
+//states counted per round, so that the 32-bit counters of a table never overflow
+#define SZ_HISTOGRAM_ROUND ((size_t)1 << 31)
+//counters between two tables (one cache line)
+#define SZ_HISTOGRAM_PADDING 16
+
+static int histogram_threads(size_t length)
+{
+#ifdef _OPENMP
+	size_t nbThreads = length/SZ_HISTOGRAM_THREAD_MIN_LENGTH;
+	if(nbThreads > (size_t)omp_get_max_threads())
+		nbThreads = omp_get_max_threads();
+	return nbThreads < 1 ? 1 : (int)nbThreads;
+#else
+	return 1;
+#endif
+}
+
+/**
+ * Count the states into SZ_HISTOGRAM_TABLES tables of counters, in turn: runs of the same state update
+ * different counters, instead of waiting on the store to one counter.
+ * */
+static void histogram_count(const int* s, size_t length, uint32_t* tables, size_t tableStride)
+{
+	uint32_t *t0 = tables, *t1 = tables + tableStride, *t2 = tables + 2*tableStride, *t3 = tables + 3*tableStride;
+	size_t i;
+	for(i = 0; i + 4 <= length; i += 4)
+	{
+		t0[s[i]]++;
+		t1[s[i+1]]++;
+		t2[s[i+2]]++;
+		t3[s[i+3]]++;
+	}
+	for(; i < length; i++)
+		t0[s[i]]++;
+}
+
+/*Keep only the counts of the states in use: freq[0] becomes the count of the smallest state*/
+static size_t* histogram_trim(size_t* freq, size_t nbStates, int* minState, int* maxState)
+{
+	size_t lo = 0, hi = nbStates - 1;
+	while(freq[lo] == 0)
+		lo++;
+	while(freq[hi] == 0)
+		hi--;
+	if(lo > 0)
+		memmove(freq, freq + lo, (hi - lo + 1)*sizeof(size_t));
+	*minState = (int)lo;
+	*maxState = (int)hi;
+	return freq;
+}
+
+/**
+ * Count the occurrences of the states s[0..length-1], all in [0, nbStates). Every thread counts a slice
+ * into its own tables, which are then summed in parallel over the states.
+ *
+ * @param minState set to the smallest state
+ * @param maxState set to the largest state
+ * @return the counts of the states minState..maxState (freq[i] is the count of the state minState+i),
+ * or NULL if length is 0
+ * */
+size_t* SZ_histogram(const int* s, size_t length, size_t nbStates, int* minState, int* maxState)
+{
+	long long i;
+	if(length == 0)
+		return NULL;
+	size_t* freq = (size_t*)malloc(nbStates*sizeof(size_t));
+	memset(freq, 0, nbStates*sizeof(size_t));
+	if(length < SZ_HISTOGRAM_TABLES*nbStates)
+	{
+		//too short to pay for clearing and summing the tables
+		for(i = 0; i < (long long)length; i++)
+			freq[s[i]]++;
+		return histogram_trim(freq, nbStates, minState, maxState);
+	}
+
+	int nbThreads = histogram_threads(length);
+	//the tables are a little apart, so that the same state in two tables does not map to the same cache set
+	size_t tableStride = nbStates + SZ_HISTOGRAM_PADDING;
+	size_t tableSize = SZ_HISTOGRAM_TABLES*tableStride;
+	uint32_t* tables = (uint32_t*)malloc(nbThreads*tableSize*sizeof(uint32_t));
+	size_t start;
+	for(start = 0; start < length; start += SZ_HISTOGRAM_ROUND)
+	{
+		size_t roundLength = length - start < SZ_HISTOGRAM_ROUND ? length - start : SZ_HISTOGRAM_ROUND;
+		size_t slice = (roundLength - 1)/nbThreads + 1;
+		memset(tables, 0, nbThreads*tableSize*sizeof(uint32_t));
+#ifdef _OPENMP
+		#pragma omp parallel for num_threads(nbThreads) schedule(static, 1)
+#endif
+		for(i = 0; i < nbThreads; i++)
+		{
+			size_t first = i*slice;
+			if(first < roundLength)
+				histogram_count(s + start + first, roundLength - first < slice ? roundLength - first : slice,
+					tables + i*tableSize, tableStride);
+		}
+#ifdef _OPENMP
+		#pragma omp parallel for if(nbStates*nbThreads >= SZ_HISTOGRAM_THREAD_MIN_LENGTH)
+#endif
+		for(i = 0; i < (long long)nbStates; i++)
+		{
+			size_t t, sum = 0;
+			for(t = 0; t < (size_t)nbThreads*SZ_HISTOGRAM_TABLES; t++)
+				sum += tables[t*tableStride + i];
+			freq[i] += sum;
+		}
+	}
+	free(tables);
+	return histogram_trim(freq, nbStates, minState, maxState);
+}
+
+/**
+ * Count the occurrences of the states s[0..length-1], all in [0, nbStates), into freq[0..nbStates-1].
+ * */
+void SZ_histogram_full(const int* s, size_t length, size_t* freq, size_t nbStates)
+{
+	int minState, maxState;
+	memset(freq, 0, nbStates*sizeof(size_t));
+	size_t* counts = SZ_histogram(s, length, nbStates, &minState, &maxState);
+	if(counts == NULL)
+		return;
+	memcpy(freq + minState, counts, ((size_t)(maxState - minState) + 1)*sizeof(size_t));
+	free(counts);
+}
@@ -0,0 +1,350 @@
+/**
+ *  @file sz_huffman_dict.c
+ *  @brief Huffman trees reused across compressions (time steps, variables): a stream whose codes are distributed
+ *  like those of a tree already emitted refers to that tree by id, instead of building and storing a new one.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_huffman_dict.h"
+
+static const unsigned char sz_huffman_dict_magic[4] = {'S', 'Z', 'H', 'D'};
+
+//the dictionary of the threads that are not bound to a context (see SZ_setHuffmanDict)
+static sz_huffman_dict* sz_huffman_dict_global = NULL;
+
+/*FNV-1a hash of the serialized tree: the compressor and the decompressor get the same id without exchanging it*/
+static unsigned int sz_huffman_dict_hash(unsigned int intervals, int nodeCount, const unsigned char* treeBytes, unsigned int treeByteSize)
+{
+	unsigned int h = 2166136261u, i;
+	unsigned char header[8];
+	intToBytes_bigEndian(header, intervals);
+	intToBytes_bigEndian(header+4, (unsigned int)nodeCount);
+	for(i = 0; i < 8; i++)
+		h = (h ^ header[i])*16777619u;
+	for(i = 0; i < treeByteSize; i++)
+		h = (h ^ treeBytes[i])*16777619u;
+	return h;
+}
+
+static void sz_huffman_dict_release_tree(sz_huffman_dict_tree* tree)
+{
+	free(tree->treeBytes);
+	free(tree->cout);
+	free(tree->codeTable);
+	memset(tree, 0, sizeof(sz_huffman_dict_tree));
+}
+
+/**
+ * @param driftThreshold largest number of bits per code lost by encoding a stream with a tree of the dictionary
+ * rather than with a new tree for this tree to be reused, or 0 for a threshold that depends on the stream: the tree is reused
+ * as long as the bits lost with it cost less than storing a new tree
+ * */
+sz_huffman_dict* SZ_createHuffmanDict(double driftThreshold)
+{
+	sz_huffman_dict* dict = (sz_huffman_dict*)malloc(sizeof(sz_huffman_dict));
+	memset(dict, 0, sizeof(sz_huffman_dict));
+	dict->driftThreshold = driftThreshold > 0 ? driftThreshold : 0;
+	return dict;
+}
+
+void SZ_freeHuffmanDict(sz_huffman_dict* dict)
+{
+	if(dict == NULL)
+		return;
+	if(sz_huffman_dict_global == dict)
+		sz_huffman_dict_global = NULL;
+	sz_huffman_dict_reset(dict);
+	free(dict);
+}
+
+/*Remove the trees of the dictionary (NULL: nothing to do)*/
+void sz_huffman_dict_reset(sz_huffman_dict* dict)
+{
+	int i;
+	if(dict == NULL)
+		return;
+	for(i = 0; i < dict->nbTrees; i++)
+		sz_huffman_dict_release_tree(&dict->trees[i]);
+	dict->nbTrees = 0;
+}
+
+/**
+ * Use the dictionary in the compressions and decompressions of the threads that are not bound to a context
+ * (NULL: every stream has its own tree, as without a dictionary). A thread bound to a context uses the
+ * dictionary of its context (sz_thread_context.huffmanDict), so that concurrent compressions do not share one.
+ *
+ * The decompressor needs the trees that the streams refer to: either decompress the streams in the order of
+ * their compression, with a dictionary of its own (the trees stored in the streams are added to it in the same
+ * way), or import the dictionary exported by the compressor (SZ_exportHuffmanDict), stored once per file or batch.
+ *
+ * @return the previous dictionary
+ * */
+sz_huffman_dict* SZ_setHuffmanDict(sz_huffman_dict* dict)
+{
+	sz_huffman_dict* previous = sz_huffman_dict_global;
+	sz_huffman_dict_global = dict;
+	return previous;
+}
+
+sz_huffman_dict* sz_huffman_dict_current()
+{
+	if(sz_tctx != NULL)
+		return sz_tctx->huffmanDict;
+	return sz_huffman_dict_global;
+}
+
+/*Set the dictionary of the bound thread context (or the process-wide one), and return the previous one*/
+sz_huffman_dict* sz_huffman_dict_swap(sz_huffman_dict* dict)
+{
+	sz_huffman_dict* previous = sz_huffman_dict_current();
+	if(sz_tctx != NULL)
+		sz_tctx->huffmanDict = dict;
+	else
+		sz_huffman_dict_global = dict;
+	return previous;
+}
+
+/**
+ * Add a tree to the dictionary (or mark it as used, if it is already in it). When the dictionary is full,
+ * the least recently used tree is replaced.
+ *
+ * @return the tree in the dictionary, or NULL if another tree has the same id
+ * */
+sz_huffman_dict_tree* sz_huffman_dict_add(sz_huffman_dict* dict, unsigned int intervals, int nodeCount, unsigned char* treeBytes, unsigned int treeByteSize)
+{
+	int i, victim = 0;
+	unsigned int id = sz_huffman_dict_hash(intervals, nodeCount, treeBytes, treeByteSize);
+	sz_huffman_dict_tree* tree = sz_huffman_dict_find(dict, id);
+	if(tree != NULL)
+	{
+		if(tree->intervals != intervals || tree->nodeCount != nodeCount || tree->treeByteSize != treeByteSize
+			|| memcmp(tree->treeBytes, treeBytes, treeByteSize) != 0)
+			return NULL;
+		return tree;
+	}
+	if(dict->nbTrees < SZ_HUFFMAN_DICT_MAX_TREES)
+		victim = dict->nbTrees++;
+	else
+	{
+		for(i = 1; i < dict->nbTrees; i++)
+			if(dict->trees[i].lastUse < dict->trees[victim].lastUse)
+				victim = i;
+		sz_huffman_dict_release_tree(&dict->trees[victim]);
+	}
+	tree = &dict->trees[victim];
+	tree->id = id;
+	tree->intervals = intervals;
+	tree->nodeCount = nodeCount;
+	tree->treeByteSize = treeByteSize;
+	tree->treeBytes = (unsigned char*)malloc(treeByteSize);
+	memcpy(tree->treeBytes, treeBytes, treeByteSize);
+	tree->lastUse = ++dict->clock;
+	return tree;
+}
+
+/*The tree with this id (marked as used), or NULL*/
+sz_huffman_dict_tree* sz_huffman_dict_find(sz_huffman_dict* dict, unsigned int id)
+{
+	int i;
+	for(i = 0; i < dict->nbTrees; i++)
+		if(dict->trees[i].id == id)
+		{
+			dict->trees[i].lastUse = ++dict->clock;
+			return &dict->trees[i];
+		}
+	return NULL;
+}
+
+/*The codes of a tree of the dictionary, from its serialized form, when the encoder first needs them*/
+static void sz_huffman_dict_build_codes(sz_huffman_dict_tree* tree)
+{
+	unsigned int i, stateNum = 2*tree->intervals;
+	HuffmanTree* huffmanTree = createHuffmanTree(stateNum);
+	node root = reconstruct_HuffTree_from_bytes_anyStates(huffmanTree, tree->treeBytes, tree->nodeCount);
+	build_code(huffmanTree, root, 0, 0, 0);
+	tree->cout = (unsigned char*)malloc(stateNum*sizeof(unsigned char));
+	tree->codeTable = (unsigned long*)malloc(2*stateNum*sizeof(unsigned long));
+	memcpy(tree->codeTable, huffmanTree->codeTable, 2*stateNum*sizeof(unsigned long));
+	tree->maxBits = 0;
+	for(i = 0; i < stateNum; i++)
+	{
+		//a tree of one state has a code of 0 bits: mark its state with a length of 1 (the encoder writes 0 bits for it anyway)
+		tree->cout[i] = huffmanTree->code[i] == NULL ? 0 : (huffmanTree->cout[i] == 0 ? 1 : huffmanTree->cout[i]);
+		if(huffmanTree->cout[i] > tree->maxBits)
+			tree->maxBits = huffmanTree->cout[i];
+	}
+	SZ_ReleaseHuffman(huffmanTree);
+}
+
+/*Size of a tree serialized by convert_HuffTree_to_bytes_anyStates()*/
+static unsigned int sz_huffman_dict_tree_size(int nodeCount)
+{
+	return nodeCount <= 256 ? 1+7*nodeCount : (nodeCount <= 65536 ? 1+9*nodeCount : 1+13*nodeCount);
+}
+
+/**
+ * Bits per code of the codes (the counts of the states minState..maxState) encoded with the code lengths
+ * of a tree, or -1 if a state is not in the tree.
+ * */
+static double sz_huffman_dict_bits(sz_huffman_dict_tree* tree, const size_t* freq, int minState, int maxState, size_t length)
+{
+	int i;
+	double bits = 0;
+	if((unsigned int)maxState >= 2*tree->intervals)
+		return -1;
+	if(tree->cout == NULL)
+		sz_huffman_dict_build_codes(tree);
+	for(i = minState; i <= maxState; i++)
+	{
+		size_t f = freq[i - minState];
+		if(f == 0)
+			continue;
+		if(tree->cout[i] == 0)
+			return -1;
+		bits += (double)f/length*(tree->nodeCount == 1 ? 0 : tree->cout[i]);
+	}
+	return bits;
+}
+
+/**
+ * Encode the states like encode_withTree(), with the tree of the dictionary that codes them in the fewest bits
+ * if it is worth it: the stream then refers to the tree (SZ_HUFFMAN_TREE_REF). Otherwise the tree of the states
+ * (the one encode_withTree() builds) is stored in the stream, and added to the dictionary.
+ *
+ * A tree of the dictionary is worth it when the bits per code lost with it, compared to the new tree, are at
+ * most the threshold of the dictionary, or (automatic threshold) when the codes with it cost fewer bits than
+ * the codes with the new tree plus the new tree itself. The loss is not measured against the entropy: a Huffman
+ * code spends at least one bit per code, and the trees built by SZ are not always optimal.
+ * */
+void sz_huffman_dict_encode(sz_huffman_dict* dict, HuffmanTree* huffmanTree, int* s, size_t length, unsigned char** out, size_t* outSize)
+{
+	double statsStart = sz_stats_clock();
+	int i, minState = 0, maxState = -1, best = -1, leaves = 0;
+	double bestBits = 0, newTreeBits = 0;
+	size_t* freq = SZ_histogram(s, length, huffmanTree->allNodes, &minState, &maxState);
+	if(freq == NULL)
+		init(huffmanTree, s, length);
+	else
+	{
+		//the new tree is built first, as the reference of the trees of the dictionary
+		init_fromHistogram(huffmanTree, freq, minState, maxState);
+		for(i = minState; i <= maxState; i++)
+		{
+			newTreeBits += (double)freq[i - minState]*huffmanTree->cout[i];
+			leaves += freq[i - minState] > 0;
+		}
+		newTreeBits /= length;
+	}
+	//bits of the new tree in the stream, beyond those of a reference to a tree of the dictionary
+	double newTreeCost = 8.0*((double)sz_huffman_dict_tree_size(2*leaves - 1) + 8 - SZ_HUFFMAN_TREE_REF_SIZE)/length;
+	for(i = 0; freq != NULL && i < dict->nbTrees; i++)
+	{
+		sz_huffman_dict_tree* tree = &dict->trees[i];
+		if(2*tree->intervals != huffmanTree->stateNum)
+			continue;
+		double bits = sz_huffman_dict_bits(tree, freq, minState, maxState, length);
+		if(bits < 0 || (best >= 0 && bits >= bestBits))
+			continue;
+		if(dict->driftThreshold > 0 ? bits - newTreeBits <= dict->driftThreshold : bits - newTreeBits < newTreeCost)
+		{
+			best = i;
+			bestBits = bits;
+		}
+	}
+	if(best < 0)
+	{
+		free(freq);
+		sz_stats_add(SZ_STAGE_HUFFMAN_BUILD, statsStart, length*sizeof(int), 0);
+		encode_withInitTree(huffmanTree, s, length, out, outSize, dict);
+		dict->built++;
+		return;
+	}
+	free(freq);
+
+	sz_huffman_dict_tree* tree = &dict->trees[best];
+	tree->lastUse = ++dict->clock;
+	memcpy(huffmanTree->codeTable, tree->codeTable, 2*huffmanTree->stateNum*sizeof(unsigned long));
+	for(i = 0; i < (int)huffmanTree->stateNum; i++)
+	{
+		huffmanTree->cout[i] = tree->nodeCount == 1 ? 0 : tree->cout[i];
+		huffmanTree->code[i] = tree->cout[i] == 0 ? NULL : huffmanTree->codeTable + 2*i;
+	}
+	sz_stats_add(SZ_STAGE_HUFFMAN_BUILD, statsStart, length*sizeof(int), 0);
+
+	*out = (unsigned char*)malloc(length*sizeof(int) + SZ_HUFFMAN_TREE_REF_SIZE);
+	intToBytes_bigEndian(*out, (unsigned int)tree->nodeCount);
+	intToBytes_bigEndian(*out+4, tree->intervals | SZ_HUFFMAN_TREE_REF);
+	intToBytes_bigEndian(*out+8, tree->id);
+	size_t enCodeSize = 0;
+	encode(huffmanTree, s, length, *out+SZ_HUFFMAN_TREE_REF_SIZE, &enCodeSize);
+	*outSize = SZ_HUFFMAN_TREE_REF_SIZE + enCodeSize;
+	dict->reused++;
+}
+
+/**
+ * Serialize the trees of the dictionary, to be stored once for the streams that refer to them.
+ *
+ * @return SZ_SCES, or SZ_NSCS if dict is NULL
+ * */
+int SZ_exportHuffmanDict(sz_huffman_dict* dict, unsigned char** bytes, size_t* byteLength)
+{
+	int i;
+	if(dict == NULL)
+		return SZ_NSCS;
+	size_t size = 8;
+	for(i = 0; i < dict->nbTrees; i++)
+		size += 12 + dict->trees[i].treeByteSize;
+	unsigned char* p = *bytes = (unsigned char*)malloc(size);
+	memcpy(p, sz_huffman_dict_magic, 4);
+	intToBytes_bigEndian(p+4, (unsigned int)dict->nbTrees);
+	p += 8;
+	for(i = 0; i < dict->nbTrees; i++)
+	{
+		sz_huffman_dict_tree* tree = &dict->trees[i];
+		intToBytes_bigEndian(p, tree->intervals);
+		intToBytes_bigEndian(p+4, (unsigned int)tree->nodeCount);
+		intToBytes_bigEndian(p+8, tree->treeByteSize);
+		memcpy(p+12, tree->treeBytes, tree->treeByteSize);
+		p += 12 + tree->treeByteSize;
+	}
+	*byteLength = size;
+	return SZ_SCES;
+}
+
+/**
+ * Read a dictionary exported by SZ_exportHuffmanDict.
+ *
+ * @return the dictionary (to be freed by SZ_freeHuffmanDict), or NULL if the bytes are not a dictionary
+ * */
+sz_huffman_dict* SZ_importHuffmanDict(unsigned char* bytes, size_t byteLength, double driftThreshold)
+{
+	int i, nbTrees;
+	if(byteLength < 8 || memcmp(bytes, sz_huffman_dict_magic, 4) != 0)
+	{
+		printf("Error: not a Huffman tree dictionary\n");
+		return NULL;
+	}
+	nbTrees = bytesToInt_bigEndian(bytes+4);
+	sz_huffman_dict* dict = SZ_createHuffmanDict(driftThreshold);
+	size_t pos = 8;
+	for(i = 0; i < nbTrees; i++)
+	{
+		if(pos + 12 > byteLength || pos + 12 + (unsigned int)bytesToInt_bigEndian(bytes+pos+8) > byteLength)
+		{
+			printf("Error: the Huffman tree dictionary is truncated\n");
+			SZ_freeHuffmanDict(dict);
+			return NULL;
+		}
+		unsigned int treeByteSize = (unsigned int)bytesToInt_bigEndian(bytes+pos+8);
+		sz_huffman_dict_add(dict, (unsigned int)bytesToInt_bigEndian(bytes+pos), bytesToInt_bigEndian(bytes+pos+4), bytes+pos+12, treeByteSize);
+		pos += 12 + treeByteSize;
+	}
+	return dict;
+}
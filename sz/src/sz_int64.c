@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <math.h>
 #include "sz.h"
+#include "sz_tctx.h"
 #include "CompressElement.h"
 #include "DynamicByteArray.h"
 #include "DynamicIntArray.h"
@@ -25,6 +26,7 @@
 
 unsigned int optimize_intervals_int64_1D(int64_t *oriData, size_t dataLength, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i = 0, radiusIndex;
 	int64_t pred_value = 0, pred_err;
 	size_t *intervals = (size_t*)malloc(confparams_cpr->maxRangeRadius*sizeof(size_t));
@@ -63,11 +65,13 @@ unsigned int optimize_intervals_int64_1D(int64_t *oriData, size_t dataLength, do
 	
 	free(intervals);
 	//printf("accIntervals=%d, powerOf2=%d\n", accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(int64_t), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_int64_2D(int64_t *oriData, size_t r1, size_t r2, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j, index;
 	size_t radiusIndex;
 	int64_t pred_value = 0, pred_err;
@@ -109,11 +113,13 @@ unsigned int optimize_intervals_int64_2D(int64_t *oriData, size_t r1, size_t r2,
 
 	free(intervals);
 	//printf("confparams_cpr->maxRangeRadius = %d, accIntervals=%d, powerOf2=%d\n", confparams_cpr->maxRangeRadius, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(int64_t), 0);
 	return powerOf2;
 }
 
 unsigned int optimize_intervals_int64_3D(int64_t *oriData, size_t r1, size_t r2, size_t r3, double realPrecision)
 {	
+	double statsStart = sz_stats_clock();
 	size_t i,j,k, index;
 	size_t radiusIndex;
 	size_t r23=r2*r3;
@@ -163,12 +169,14 @@ unsigned int optimize_intervals_int64_3D(int64_t *oriData, size_t r1, size_t r2,
 	
 	free(intervals);
 	//printf("targetCount=%d, sum=%d, totalSampleSize=%d, ratio=%f, accIntervals=%d, powerOf2=%d\n", targetCount, sum, totalSampleSize, (double)sum/(double)totalSampleSize, accIntervals, powerOf2);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(int64_t), 0);
 	return powerOf2;
 }
 
 
 unsigned int optimize_intervals_int64_4D(int64_t *oriData, size_t r1, size_t r2, size_t r3, size_t r4, double realPrecision)
 {
+	double statsStart = sz_stats_clock();
 	size_t i,j,k,l, index;
 	size_t radiusIndex;
 	size_t r234=r2*r3*r4;
@@ -219,6 +227,7 @@ unsigned int optimize_intervals_int64_4D(int64_t *oriData, size_t r1, size_t r2,
 		powerOf2 = 32;
 
 	free(intervals);
+	sz_stats_add(SZ_STAGE_INTERVAL_OPT, statsStart, totalSampleSize*sizeof(int64_t), 0);
 	return powerOf2;
 }
 
@@ -1201,6 +1210,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio)
 	}
 	int status = SZ_SCES;
 	size_t dataLength = computeDataLength(r5,r4,r3,r2,r1);
+	sz_stats_begin(SZ_INT64, dataLength*sizeof(int64_t));
 	int64_t valueRangeSize = 0;
 
 	int64_t minValue = (int64_t)computeRangeSize_int(oriData, SZ_INT64, dataLength, &valueRangeSize);
@@ -1248,7 +1258,7 @@ int errBoundMode, double absErr_Bound, double relBoundRatio)
 			status = SZ_DERR; //dimension error
 		}
 		//Call Gzip to do the further compression.
-		if(confparams_cpr->szMode==SZ_BEST_SPEED)
+		if(confparams_cpr->szMode==SZ_BEST_SPEED || sz_lossless_skip(confparams_cpr, tmpByteData, tmpOutSize))
 		{
 			*outSize = tmpOutSize;
 			*newByteData = tmpByteData;
@@ -1265,5 +1275,6 @@ int errBoundMode, double absErr_Bound, double relBoundRatio)
 		}
 	}
 	
+	sz_stats_end(*outSize);
 	return status;
 }
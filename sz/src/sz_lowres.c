@@ -0,0 +1,207 @@
+/**
+ *  @file sz_lowres.c
+ *  @brief Low-resolution (strided or block-averaged) decompression. The 3D fields compressed by blocked linear
+ *  regression are reconstructed from the regression coefficients of the blocks, without decoding the residuals.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_lowres.h"
+
+/*A piece of a low-resolution cell along one dimension, within one block of the regression*/
+typedef struct sz_lowres_segment
+{
+	size_t block; //index of the block along the dimension
+	double center; //center of the piece, relative to the origin of the block
+	size_t length;
+} sz_lowres_segment;
+
+static double sz_lowres_value(int dataType, const void* data, size_t index)
+{
+	if(dataType == SZ_FLOAT)
+		return ((const float*)data)[index];
+	return ((const double*)data)[index];
+}
+
+static void sz_lowres_store(int dataType, void* data, size_t index, double value)
+{
+	if(dataType == SZ_FLOAT)
+		((float*)data)[index] = (float)value;
+	else
+		((double*)data)[index] = value;
+}
+
+/**
+ * Split the cells of the low-resolution field along one dimension of n points into pieces within the blocks
+ * of the regression (as split by SZ_COMPUTE_3D_NUMBER_OF_BLOCKS and SZ_COMPUTE_BLOCKCOUNT).
+ *
+ * @param first the pieces of the cell c are segs[first[c]] to segs[first[c+1]-1]
+ * @return the number of blocks along the dimension
+ * */
+static size_t sz_lowres_segments(size_t n, size_t blockSize, int mode, size_t stride, sz_lowres_segment** segs, size_t** first)
+{
+	size_t nbBlocks, split, early, late, c, x;
+	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(n, nbBlocks, blockSize);
+	SZ_COMPUTE_BLOCKCOUNT(n, nbBlocks, split, early, late);
+	size_t nbCells = SZ_LOWRES_DIM(n, stride), count = 0;
+	*segs = (sz_lowres_segment*)malloc((nbCells + nbBlocks)*sizeof(sz_lowres_segment));
+	*first = (size_t*)malloc((nbCells + 1)*sizeof(size_t));
+	for(c = 0; c < nbCells; c++)
+	{
+		size_t start = c*stride;
+		size_t end = mode == SZ_LOWRES_STRIDED ? start + 1 : (start + stride < n ? start + stride : n);
+		(*first)[c] = count;
+		for(x = start; x < end; count++)
+		{
+			size_t b = x < split*early ? x/early : split + (x - split*early)/late;
+			size_t origin = b < split ? b*early : b*late + split;
+			size_t blockEnd = origin + (b < split ? early : late);
+			size_t pieceEnd = end < blockEnd ? end : blockEnd;
+			(*segs)[count].block = b;
+			(*segs)[count].center = (x + pieceEnd - 1)/2.0 - origin;
+			(*segs)[count].length = pieceEnd - x;
+			x = pieceEnd;
+		}
+	}
+	(*first)[nbCells] = count;
+	return nbBlocks;
+}
+
+/**
+ * Evaluate the regression of the blocks (the prediction c0*i + c1*j + c2*k + c3 in a block) on the low-resolution
+ * grid: at the sampled points, or averaged over the cells. The regression is linear in a block, so its
+ * average over a piece of a cell is its value at the center of the piece.
+ * */
+static void sz_lowres_from_coefficients(int dataType, const double* coeffs, size_t blockSize, size_t r3, size_t r2, size_t r1,
+int mode, size_t stride, void* out)
+{
+	sz_lowres_segment *sx, *sy, *sz;
+	size_t *fx, *fy, *fz;
+	size_t a, b, c, p, q, s, index = 0;
+	sz_lowres_segments(r3, blockSize, mode, stride, &sx, &fx);
+	size_t numY = sz_lowres_segments(r2, blockSize, mode, stride, &sy, &fy);
+	size_t numZ = sz_lowres_segments(r1, blockSize, mode, stride, &sz, &fz);
+	size_t m3 = SZ_LOWRES_DIM(r3, stride), m2 = SZ_LOWRES_DIM(r2, stride), m1 = SZ_LOWRES_DIM(r1, stride);
+	for(a = 0; a < m3; a++)
+		for(b = 0; b < m2; b++)
+			for(c = 0; c < m1; c++)
+			{
+				double sum = 0;
+				size_t volume = 0;
+				for(p = fx[a]; p < fx[a+1]; p++)
+					for(q = fy[b]; q < fy[b+1]; q++)
+						for(s = fz[c]; s < fz[c+1]; s++)
+						{
+							const double* cf = coeffs + 4*((sx[p].block*numY + sy[q].block)*numZ + sz[s].block);
+							size_t length = sx[p].length*sy[q].length*sz[s].length;
+							sum += length*(cf[0]*sx[p].center + cf[1]*sy[q].center + cf[2]*sz[s].center + cf[3]);
+							volume += length;
+						}
+				sz_lowres_store(dataType, out, index++, sum/volume);
+			}
+	free(sx);
+	free(sy);
+	free(sz);
+	free(fx);
+	free(fy);
+	free(fz);
+}
+
+/*Sample or average the fully decompressed data (n3 x n2 x n1, n1 the fastest)*/
+static void sz_lowres_reduce(int dataType, const void* data, size_t n3, size_t n2, size_t n1, int mode, size_t stride, void* out)
+{
+	size_t a, b, c, i, j, k, index = 0;
+	size_t m3 = SZ_LOWRES_DIM(n3, stride), m2 = SZ_LOWRES_DIM(n2, stride), m1 = SZ_LOWRES_DIM(n1, stride);
+	size_t box = mode == SZ_LOWRES_STRIDED ? 1 : stride;
+	for(a = 0; a < m3; a++)
+		for(b = 0; b < m2; b++)
+			for(c = 0; c < m1; c++)
+			{
+				size_t e3 = a*stride + box < n3 ? a*stride + box : n3;
+				size_t e2 = b*stride + box < n2 ? b*stride + box : n2;
+				size_t e1 = c*stride + box < n1 ? c*stride + box : n1;
+				double sum = 0;
+				for(i = a*stride; i < e3; i++)
+					for(j = b*stride; j < e2; j++)
+						for(k = c*stride; k < e1; k++)
+							sum += sz_lowres_value(dataType, data, (i*n2 + j)*n1 + k);
+				sz_lowres_store(dataType, out, index++, sum/((e3 - a*stride)*(e2 - b*stride)*(e1 - c*stride)));
+			}
+}
+
+/**
+ * Decompress a 1D to 3D field at a lower resolution: SZ_LOWRES_DIM(ri, stride) points along each dimension,
+ * sampled every stride points (SZ_LOWRES_STRIDED) or averaged over boxes of stride points (SZ_LOWRES_AVERAGED).
+ *
+ * A 3D field whose blocks were all predicted by linear regression is reconstructed from the regression
+ * coefficients alone, which skips the decoding of the residuals and the full-size buffers: the values are
+ * the predictions of the regression, off the data by the error of the fit (the residuals), not by the error
+ * bound. The other fields are fully decompressed and then reduced, within the error bound.
+ *
+ * @param fromCoefficients set to 1 if the field was reconstructed from the regression coefficients (may be NULL)
+ * @return the low-resolution field, or NULL if any errors
+ * */
+void* SZ_decompress_lowres(int dataType, unsigned char* bytes, size_t byteLength, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1,
+int mode, size_t stride, int* fromCoefficients)
+{
+	if(dataType != SZ_FLOAT && dataType != SZ_DOUBLE)
+	{
+		printf("Error: the low-resolution decompression supports only SZ_FLOAT and SZ_DOUBLE\n");
+		return NULL;
+	}
+	if(r5 != 0 || r4 != 0 || r1 == 0 || stride < 1 || (mode != SZ_LOWRES_STRIDED && mode != SZ_LOWRES_AVERAGED))
+	{
+		printf("Error: the low-resolution decompression needs 1D to 3D data, a stride and a mode\n");
+		return NULL;
+	}
+	size_t typeSize = dataType == SZ_FLOAT ? sizeof(float) : sizeof(double);
+	size_t n3 = r3 == 0 ? 1 : r3, n2 = r2 == 0 ? 1 : r2;
+	void* out = malloc(SZ_LOWRES_DIM(n3, stride)*SZ_LOWRES_DIM(n2, stride)*SZ_LOWRES_DIM(r1, stride)*typeSize);
+	if(fromCoefficients != NULL)
+		*fromCoefficients = 0;
+
+	if(r3 != 0)
+	{
+		if(confparams_dec==NULL)
+			confparams_dec = (sz_params*)malloc(sizeof(sz_params));
+		memset(confparams_dec, 0, sizeof(sz_params));
+		if(exe_params==NULL)
+			exe_params = (sz_exedata*)malloc(sizeof(sz_exedata));
+		memset(exe_params, 0, sizeof(sz_exedata));
+		exe_params->SZ_SIZE_TYPE = 8;
+		int x = 1;
+		char *y = (char*)&x;
+		sysEndianType = *y==1 ? LITTLE_ENDIAN_SYSTEM : BIG_ENDIAN_SYSTEM;
+
+		double* coeffs = NULL;
+		size_t blockSize = 0;
+		int status;
+		if(dataType == SZ_FLOAT)
+			status = SZ_decompress_args_regression_coefficients_float(&coeffs, &blockSize, r3, r2, r1, bytes, byteLength);
+		else
+			status = SZ_decompress_args_regression_coefficients_double(&coeffs, &blockSize, r3, r2, r1, bytes, byteLength);
+		if(status == SZ_SCES)
+		{
+			sz_lowres_from_coefficients(dataType, coeffs, blockSize, r3, r2, r1, mode, stride, out);
+			free(coeffs);
+			if(fromCoefficients != NULL)
+				*fromCoefficients = 1;
+			return out;
+		}
+	}
+
+	void* data = SZ_decompress(dataType, bytes, byteLength, 0, 0, r3, r2, r1);
+	if(data == NULL)
+	{
+		free(out);
+		return NULL;
+	}
+	sz_lowres_reduce(dataType, data, n3, n2, r1, mode, stride, out);
+	free(data);
+	return out;
+}
@@ -8,6 +8,7 @@
  */
 
 #include "sz_omp.h"
+#include "sz_tctx.h"
 #include <math.h>
 #include <time.h>
 
@@ -135,8 +136,6 @@ unsigned char * SZ_compress_float_3D_MDQ_openmp(float *oriData, size_t r1, size_
 	size_t * unpred_offset = (size_t *) malloc(num_blocks * sizeof(size_t));
 	unsigned char * encoding_buffer = (unsigned char *) malloc(max_num_block_elements * sizeof(int) * num_blocks);
 	size_t * block_offset = (size_t *) malloc(num_blocks * sizeof(size_t));
-	size_t *freq = (size_t *)malloc(thread_num*quantization_intervals*4*sizeof(size_t));
-	memset(freq, 0, thread_num*quantization_intervals*4*sizeof(size_t));
 	
 	size_t stateNum = quantization_intervals*2;
 	HuffmanTree* huffmanTree = createHuffmanTree(stateNum);	
@@ -183,7 +182,7 @@ unsigned char * SZ_compress_float_3D_MDQ_openmp(float *oriData, size_t r1, size_
 	// huffman encode
 
 	size_t nodeCount = 0;
-	Huffman_init_openmp(huffmanTree, result_type, num_elements, thread_num, freq);
+	Huffman_init_openmp(huffmanTree, result_type, num_elements, thread_num, NULL);
 	elapsed_time += sz_wtime();
 	printf("Build Huffman: %.4f\n", elapsed_time);
 	elapsed_time = -sz_wtime();
@@ -300,7 +299,6 @@ unsigned char * SZ_compress_float_3D_MDQ_openmp(float *oriData, size_t r1, size_
 	size_t totalEncodeSize = 0;
 	totalEncodeSize = result_pos - result;
 	// printf("Total size %ld\n", totalEncodeSize);
-	free(freq);
 	free(buffer0);
 	free(buffer1);
 	free(treeBytes);
@@ -602,8 +600,6 @@ unsigned char * SZ_compress_double_3D_MDQ_openmp(double *oriData, size_t r1, siz
 	size_t * unpred_offset = (size_t *) malloc(num_blocks * sizeof(size_t));
 	unsigned char * encoding_buffer = (unsigned char *) malloc(max_num_block_elements * sizeof(int) * num_blocks);
 	size_t * block_offset = (size_t *) malloc(num_blocks * sizeof(size_t));
-	size_t *freq = (size_t *)malloc(thread_num*quantization_intervals*4*sizeof(size_t));
-	memset(freq, 0, thread_num*quantization_intervals*4*sizeof(size_t));
 	
 	size_t stateNum = quantization_intervals*2;
 	HuffmanTree* huffmanTree = createHuffmanTree(stateNum);	
@@ -647,7 +643,7 @@ unsigned char * SZ_compress_double_3D_MDQ_openmp(double *oriData, size_t r1, siz
 	// huffman encode
 
 	size_t nodeCount = 0;
-	Huffman_init_openmp(huffmanTree, result_type, num_elements, thread_num, freq);
+	Huffman_init_openmp(huffmanTree, result_type, num_elements, thread_num, NULL);
 	elapsed_time += sz_wtime();
 	printf("Build Huffman: %.4f\n", elapsed_time);
 	elapsed_time = -sz_wtime();
@@ -758,7 +754,6 @@ unsigned char * SZ_compress_double_3D_MDQ_openmp(double *oriData, size_t r1, siz
 	size_t totalEncodeSize = 0;
 	totalEncodeSize = result_pos - result;
 	// printf("Total size %ld\n", totalEncodeSize);
-	free(freq);
 	free(buffer0);
 	free(buffer1);
 	free(treeBytes);
@@ -940,46 +935,9 @@ void decompressDataSeries_double_3D_openmp(double** data, size_t r1, size_t r2,
 	SZ_ReleaseHuffman(huffmanTree);
 }
 
+//The frequencies are counted in parallel by the shared histogram (SZ_histogram): thread_num and freq are no longer used.
 void Huffman_init_openmp(HuffmanTree* huffmanTree, int *s, size_t length, int thread_num, size_t * freq){
-
-	size_t i;
-	// size_t *freq = (size_t *)malloc(thread_num*huffmanTree->allNodes*sizeof(size_t));
-	// memset(freq, 0, thread_num*huffmanTree->allNodes*sizeof(size_t));
-	size_t block_size = (length - 1)/ thread_num + 1;
-	size_t block_residue = length - (thread_num - 1) * block_size;
-	#pragma omp parallel for
-	for(int t=0; t<thread_num; t++){
-		int id = sz_get_thread_num();
-		int * s_pos = s + id * block_size;
-		size_t * freq_pos = freq + id * huffmanTree->allNodes;
-		if(id < thread_num - 1){
-			for(size_t i=0; i<block_size; i++){
-				freq_pos[s_pos[i]] ++;
-			}
-		}
-		else{
-			for(size_t i=0; i<block_residue; i++){
-				freq_pos[s_pos[i]] ++;
-			}
-		}
-	}
-	size_t * freq_pos = freq + huffmanTree->allNodes;
-	for(int t=1; t<thread_num; t++){
-		for(i = 0; i<huffmanTree->allNodes; i++){
-			freq[i] += freq_pos[i];
-		}
-		freq_pos += huffmanTree->allNodes;
-	}
-
-	for (i = 0; i < huffmanTree->allNodes; i++)
-		if (freq[i]) 
-			qinsert(huffmanTree, new_node(huffmanTree, freq[i], i, 0, 0));
- 
-	while (huffmanTree->qend > 2) 
-		qinsert(huffmanTree, new_node(huffmanTree, 0, 0, qremove(huffmanTree), qremove(huffmanTree)));
- 
-	build_code(huffmanTree, huffmanTree->qq[1], 0, 0, 0);
-	// free(freq);
+	init(huffmanTree, s, length);
 }
 
 
@@ -0,0 +1,291 @@
+/**
+ *  @file sz_progressive.c
+ *  @brief Progressive compression: a stream of layers compressed with successively tighter error bounds,
+ *  where a prefix of the stream decodes to a coarse version of the data and the next layers refine it.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_progressive.h"
+
+static const unsigned char sz_progressive_magic[4] = {'S', 'Z', 'P', 'G'};
+
+/*The error bounds are stored big-endian, like the lengths of the layers*/
+static void sz_progressive_bound_to_bytes(unsigned char* b, double errBound)
+{
+	unsigned long bits = 0;
+	memcpy(&bits, &errBound, sizeof(double));
+	longToBytes_bigEndian(b, bits);
+}
+
+static double sz_progressive_bytes_to_bound(unsigned char* b)
+{
+	long bits = bytesToLong_bigEndian(b);
+	double errBound;
+	memcpy(&errBound, &bits, sizeof(double));
+	return errBound;
+}
+
+static size_t sz_progressive_type_size(int dataType)
+{
+	return dataType == SZ_FLOAT ? sizeof(float) : sizeof(double);
+}
+
+/*residual = data - recon, in the precision of the data*/
+static void sz_progressive_residual(int dataType, const void* data, const void* recon, void* residual, size_t nbEle)
+{
+	size_t i;
+	if(dataType == SZ_FLOAT)
+	{
+		const float *d = (const float*)data, *r = (const float*)recon;
+		float* res = (float*)residual;
+		for(i = 0; i < nbEle; i++)
+			res[i] = d[i] - r[i];
+	}
+	else
+	{
+		const double *d = (const double*)data, *r = (const double*)recon;
+		double* res = (double*)residual;
+		for(i = 0; i < nbEle; i++)
+			res[i] = d[i] - r[i];
+	}
+}
+
+/*max |value| times the machine epsilon of the data type: the bound on the rounding of the refinements*/
+static double sz_progressive_rounding(int dataType, const void* data, size_t nbEle)
+{
+	size_t i;
+	double maxAbs = 0;
+	if(dataType == SZ_FLOAT)
+	{
+		const float* d = (const float*)data;
+		for(i = 0; i < nbEle; i++)
+			if(fabs(d[i]) > maxAbs)
+				maxAbs = fabs(d[i]);
+		return maxAbs*FLT_EPSILON;
+	}
+	const double* d = (const double*)data;
+	for(i = 0; i < nbEle; i++)
+		if(fabs(d[i]) > maxAbs)
+			maxAbs = fabs(d[i]);
+	return maxAbs*DBL_EPSILON;
+}
+
+/*recon += layer: the compressor and the decompressor refine the data with the same operations*/
+static void sz_progressive_add(int dataType, void* recon, const void* layer, size_t nbEle)
+{
+	size_t i;
+	if(dataType == SZ_FLOAT)
+	{
+		float* r = (float*)recon;
+		const float* l = (const float*)layer;
+		for(i = 0; i < nbEle; i++)
+			r[i] += l[i];
+	}
+	else
+	{
+		double* r = (double*)recon;
+		const double* l = (const double*)layer;
+		for(i = 0; i < nbEle; i++)
+			r[i] += l[i];
+	}
+}
+
+/**
+ * Compress the data into nbLayers layers with the absolute error bounds errBounds[0] > errBounds[1] > ...
+ * The other settings (predictor, quantization, lossless stage) are those of confparams_cpr, for every layer.
+ *
+ * @return the progressive stream, or NULL if any errors
+ * */
+unsigned char* SZ_compress_progressive(int dataType, void* data, size_t* outSize, int nbLayers, const double* errBounds,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int k;
+	if(dataType != SZ_FLOAT && dataType != SZ_DOUBLE)
+	{
+		printf("Error: the progressive compression supports only SZ_FLOAT and SZ_DOUBLE\n");
+		return NULL;
+	}
+	if(nbLayers < 1 || nbLayers > SZ_PROGRESSIVE_MAX_LAYERS)
+	{
+		printf("Error: the number of layers must be between 1 and %d\n", SZ_PROGRESSIVE_MAX_LAYERS);
+		return NULL;
+	}
+	for(k = 0; k < nbLayers; k++)
+		if(errBounds[k] <= 0 || (k > 0 && errBounds[k] >= errBounds[k-1]))
+		{
+			printf("Error: the error bounds of the layers must be positive and decreasing\n");
+			return NULL;
+		}
+	if(confparams_cpr == NULL)
+		SZ_Init(NULL);
+
+	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1);
+	size_t typeSize = sz_progressive_type_size(dataType);
+	unsigned char* layers[SZ_PROGRESSIVE_MAX_LAYERS];
+	size_t layerSizes[SZ_PROGRESSIVE_MAX_LAYERS];
+	size_t totalSize = SZ_PROGRESSIVE_HEADER_SIZE(nbLayers);
+	void* recon = NULL;
+	void* residual = nbLayers > 1 ? malloc(nbEle*typeSize) : NULL;
+	int errorBoundMode = confparams_cpr->errorBoundMode;
+	double absErrBound = confparams_cpr->absErrBound;
+	double rounding = nbLayers > 1 ? sz_progressive_rounding(dataType, data, nbEle) : 0;
+	sz_exedata exe;
+
+	for(k = 0; k < nbLayers; k++)
+	{
+		void* input = data;
+		double errBound = errBounds[k];
+		if(k > 0)
+		{
+			//the residual and the refinement are rounded to the data type: keep room for it in the bound
+			sz_progressive_residual(dataType, data, recon, residual, nbEle);
+			input = residual;
+			errBound = errBound - rounding > errBound/2 ? errBound - rounding : errBound/2;
+		}
+		layers[k] = SZ_compress_args(dataType, input, &layerSizes[k], ABS, errBound, 0, 0, r5, r4, r3, r2, r1);
+		if(layers[k] == NULL)
+			break;
+		totalSize += layerSizes[k];
+		if(k == nbLayers-1)
+			continue;
+
+		//the next layer is the residual of the data as the decompressor sees them
+		memcpy(&exe, exe_params, sizeof(sz_exedata)); //SZ_decompress() resets the execution parameters
+		void* decLayer = SZ_decompress(dataType, layers[k], layerSizes[k], r5, r4, r3, r2, r1);
+		memcpy(exe_params, &exe, sizeof(sz_exedata));
+		if(recon == NULL)
+			recon = decLayer;
+		else
+		{
+			sz_progressive_add(dataType, recon, decLayer, nbEle);
+			free(decLayer);
+		}
+	}
+	confparams_cpr->errorBoundMode = errorBoundMode;
+	confparams_cpr->absErrBound = absErrBound;
+	free(recon);
+	free(residual);
+
+	unsigned char* bytes = NULL;
+	if(k == nbLayers)
+	{
+		bytes = (unsigned char*)malloc(totalSize);
+		memcpy(bytes, sz_progressive_magic, 4);
+		bytes[4] = (unsigned char)dataType;
+		bytes[5] = (unsigned char)nbLayers;
+		bytes[6] = bytes[7] = 0;
+		unsigned char* p = bytes + SZ_PROGRESSIVE_HEADER_SIZE(nbLayers);
+		for(k = 0; k < nbLayers; k++)
+		{
+			sz_progressive_bound_to_bytes(bytes + SZ_PROGRESSIVE_PREAMBLE_SIZE + 16*k, errBounds[k]);
+			longToBytes_bigEndian(bytes + SZ_PROGRESSIVE_PREAMBLE_SIZE + 16*k + 8, layerSizes[k]);
+			memcpy(p, layers[k], layerSizes[k]);
+			p += layerSizes[k];
+		}
+		*outSize = totalSize;
+	}
+	else
+		k++; //the failed layer is NULL
+	while(k > 0)
+		free(layers[--k]);
+	return bytes;
+}
+
+/**
+ * Read the header of a progressive stream. Only the first SZ_PROGRESSIVE_PREAMBLE_SIZE bytes are needed to get
+ * the number of layers, then SZ_PROGRESSIVE_HEADER_SIZE(nbLayers) bytes for the rest of the header.
+ *
+ * @param errBounds the error bounds of the layers (SZ_PROGRESSIVE_MAX_LAYERS values; may be NULL)
+ * @param layerEnds layerEnds[k] is the number of bytes needed to decode the layers 0..k (may be NULL)
+ * @return SZ_SCES, or SZ_NSCS if the bytes are not (the beginning of) a progressive stream
+ * */
+int SZ_progressive_info(unsigned char* bytes, size_t byteLength, int* nbLayers, double* errBounds, size_t* layerEnds)
+{
+	int k;
+	if(byteLength < SZ_PROGRESSIVE_PREAMBLE_SIZE || memcmp(bytes, sz_progressive_magic, 4) != 0)
+		return SZ_NSCS;
+	*nbLayers = bytes[5];
+	if(*nbLayers < 1 || *nbLayers > SZ_PROGRESSIVE_MAX_LAYERS || byteLength < SZ_PROGRESSIVE_HEADER_SIZE(*nbLayers))
+		return SZ_NSCS;
+	size_t end = SZ_PROGRESSIVE_HEADER_SIZE(*nbLayers);
+	for(k = 0; k < *nbLayers; k++)
+	{
+		end += (size_t)bytesToLong_bigEndian(bytes + SZ_PROGRESSIVE_PREAMBLE_SIZE + 16*k + 8);
+		if(errBounds != NULL)
+			errBounds[k] = sz_progressive_bytes_to_bound(bytes + SZ_PROGRESSIVE_PREAMBLE_SIZE + 16*k);
+		if(layerEnds != NULL)
+			layerEnds[k] = end;
+	}
+	return SZ_SCES;
+}
+
+/**
+ * Add the layers fromLayer..toLayer-1 of a progressive stream to the data decoded from its first fromLayer
+ * layers (data is not read when fromLayer is 0: it is overwritten by layer 0). The bytes may be only
+ * the prefix of the stream that holds these layers.
+ *
+ * @return SZ_SCES, or SZ_NSCS if the layers are not in the bytes
+ * */
+int SZ_refine_progressive(int dataType, unsigned char* bytes, size_t byteLength, int fromLayer, int toLayer, void* data,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int k, nbLayers;
+	size_t layerEnds[SZ_PROGRESSIVE_MAX_LAYERS];
+	if(SZ_progressive_info(bytes, byteLength, &nbLayers, NULL, layerEnds) != SZ_SCES || bytes[4] != dataType)
+	{
+		printf("Error: not a progressive stream of this data type\n");
+		return SZ_NSCS;
+	}
+	if(fromLayer < 0 || toLayer > nbLayers || fromLayer >= toLayer || layerEnds[toLayer-1] > byteLength)
+	{
+		printf("Error: the layers %d to %d are not in the progressive stream\n", fromLayer, toLayer-1);
+		return SZ_NSCS;
+	}
+	size_t nbEle = computeDataLength(r5, r4, r3, r2, r1);
+	for(k = fromLayer; k < toLayer; k++)
+	{
+		size_t start = k == 0 ? SZ_PROGRESSIVE_HEADER_SIZE(nbLayers) : layerEnds[k-1];
+		void* decLayer = SZ_decompress(dataType, bytes + start, layerEnds[k] - start, r5, r4, r3, r2, r1);
+		if(decLayer == NULL)
+			return SZ_NSCS;
+		if(k == 0)
+			memcpy(data, decLayer, nbEle*sz_progressive_type_size(dataType));
+		else
+			sz_progressive_add(dataType, data, decLayer, nbEle);
+		free(decLayer);
+	}
+	return SZ_SCES;
+}
+
+/**
+ * Decode the first nbLayers layers of a progressive stream (all of them if nbLayers is 0).
+ *
+ * @return the data, within the error bound of the last decoded layer, or NULL if any errors
+ * */
+void* SZ_decompress_progressive(int dataType, unsigned char* bytes, size_t byteLength, int nbLayers,
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int totalLayers;
+	if(dataType != SZ_FLOAT && dataType != SZ_DOUBLE)
+	{
+		printf("Error: the progressive compression supports only SZ_FLOAT and SZ_DOUBLE\n");
+		return NULL;
+	}
+	if(nbLayers == 0 && SZ_progressive_info(bytes, byteLength, &totalLayers, NULL, NULL) == SZ_SCES)
+		nbLayers = totalLayers;
+	void* data = malloc(computeDataLength(r5, r4, r3, r2, r1)*sz_progressive_type_size(dataType));
+	if(SZ_refine_progressive(dataType, bytes, byteLength, 0, nbLayers, data, r5, r4, r3, r2, r1) != SZ_SCES)
+	{
+		free(data);
+		return NULL;
+	}
+	return data;
+}
@@ -0,0 +1,292 @@
+/**
+ *  @file sz_sections.c
+ *  @brief Sectioned lossless stage: the sections of the SZ bytes (Huffman tree and codes, unpredictable data,
+ *  regression coefficients, ...) have very different statistics, so they are coded separately, each with
+ *  its own codec and level, behind a table of contents. The sections are coded and decoded in parallel,
+ *  and each of them can be decoded alone.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <zlib.h>
+#include "zstd.h"
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_sections.h"
+
+/*
+ * Layout of a sectioned stream (the sizes are big-endian):
+ * magic (4 bytes) | number of sections (1 byte) | table of contents (SZ_SECTIONS_ENTRY_SIZE bytes per section) | coded sections
+ * The decoded sections, in the order of the table, are the SZ bytes.
+ */
+static const unsigned char sz_sections_magic[SZ_SECTIONS_MAGIC_SIZE] = {'S', 'Z', 'S', 'C'};
+
+static SZ_THREAD_LOCAL sz_sections_layout sz_tls_sections_layout;
+
+/**
+ * Start recording the layout of the SZ bytes being serialized by this thread (only if the lossless
+ * stage is sectioned, see sz_params.losslessSections). The first section is SZ_SECTION_HEADER.
+ * */
+void sz_sections_begin(const unsigned char* bytes)
+{
+	sz_sections_layout* layout = &sz_tls_sections_layout;
+	layout->recording = confparams_cpr->losslessSections;
+	layout->bytes = bytes;
+	layout->size = 0;
+	layout->count = 1;
+	layout->id[0] = SZ_SECTION_HEADER;
+	layout->offset[0] = 0;
+}
+
+/*A new section begins at the offset (the empty sections are dropped)*/
+void sz_sections_mark(int id, size_t offset)
+{
+	sz_sections_layout* layout = &sz_tls_sections_layout;
+	if(!layout->recording)
+		return;
+	if(offset == layout->offset[layout->count-1])
+		layout->id[layout->count-1] = id;
+	else if(layout->count < SZ_SECTIONS_MAX)
+	{
+		layout->id[layout->count] = id;
+		layout->offset[layout->count++] = offset;
+	}
+}
+
+void sz_sections_end(size_t size)
+{
+	sz_sections_layout* layout = &sz_tls_sections_layout;
+	if(!layout->recording)
+		return;
+	layout->size = size;
+	if(layout->count > 1 && layout->offset[layout->count-1] == size)
+		layout->count--;
+	layout->recording = 0;
+}
+
+/**
+ * The layout of the SZ bytes last serialized by this thread, if they are these ones. A layout that
+ * would not fit the bytes (e.g., recorded for other bytes at the same address) still splits them
+ * at valid offsets, so the sectioned stream decodes to the same bytes in any case.
+ * */
+sz_sections_layout* sz_sections_find(const unsigned char* bytes, size_t size)
+{
+	sz_sections_layout* layout = &sz_tls_sections_layout;
+	if(!confparams_cpr->losslessSections || layout->recording || layout->bytes != bytes || layout->size != size || size == 0)
+		return NULL;
+	return layout;
+}
+
+int sz_sections_is_sectioned(const unsigned char* bytes, size_t byteLength)
+{
+	return byteLength > SZ_SECTIONS_MAGIC_SIZE && memcmp(bytes, sz_sections_magic, SZ_SECTIONS_MAGIC_SIZE) == 0;
+}
+
+/*Code a section: as is, unless the codec saves at least minGain of it*/
+static unsigned char* sz_sections_code(int losslessCompressor, int level, double minGain, sz_zstd_dict* dict,
+unsigned char* data, size_t rawSize, sz_section_info* info)
+{
+	unsigned char* coded = NULL;
+	size_t cmpSize = 0;
+	info->codec = SZ_SECTION_RAW;
+	info->level = 0;
+	info->cmpSize = rawSize;
+	if(rawSize < SZ_SECTION_MIN_CODED)
+		return NULL;
+	if(losslessCompressor == GZIP_COMPRESSOR)
+	{
+		if(rawSize < SZ_SECTION_SMALL && level < SZ_SECTION_SMALL_GZIP_LEVEL)
+			level = SZ_SECTION_SMALL_GZIP_LEVEL;
+		cmpSize = zlib_compress5(data, rawSize, &coded, level);
+	}
+	else
+	{
+		if(rawSize < SZ_SECTION_SMALL && level < SZ_SECTION_SMALL_ZSTD_LEVEL && dict == NULL)
+			level = SZ_SECTION_SMALL_ZSTD_LEVEL;
+		size_t bound = ZSTD_compressBound(rawSize);
+		coded = (unsigned char*)malloc(bound);
+		if(dict != NULL)
+			cmpSize = sz_zstd_dict_compress(dict, coded, bound, data, rawSize, level);
+		else
+		{
+			cmpSize = ZSTD_compress(coded, bound, data, rawSize, level);
+			if(ZSTD_isError(cmpSize))
+				cmpSize = 0;
+		}
+	}
+	if(cmpSize == 0 || cmpSize >= rawSize*(1 - minGain))
+	{
+		free(coded);
+		return NULL;
+	}
+	info->codec = losslessCompressor == GZIP_COMPRESSOR ? SZ_SECTION_GZIP : SZ_SECTION_ZSTD;
+	info->level = level;
+	info->cmpSize = cmpSize;
+	return coded;
+}
+
+/**
+ * Code the SZ bytes section by section, with the codec of the lossless stage (Zstd or Gzip). The
+ * sections are coded in parallel; a section that the codec does not reduce by losslessMinGain is stored as is.
+ *
+ * @return the size of the sectioned stream
+ * */
+unsigned long sz_sections_compress(sz_sections_layout* layout, int losslessCompressor, int level, unsigned char* data, unsigned long dataLength, unsigned char** compressBytes)
+{
+	int i, count = layout->count;
+	double minGain = confparams_cpr->losslessMinGain; //the parameters and the dictionary are thread-local
+	sz_zstd_dict* dict = sz_zstd_dict_current();
+	sz_section_info info[SZ_SECTIONS_MAX];
+	unsigned char* coded[SZ_SECTIONS_MAX];
+	for(i = 0; i < count; i++)
+	{
+		info[i].id = layout->id[i];
+		info[i].rawOffset = layout->offset[i];
+		info[i].rawSize = (i + 1 < count ? layout->offset[i+1] : dataLength) - layout->offset[i];
+	}
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic)
+#endif
+	for(i = 0; i < count; i++)
+		coded[i] = sz_sections_code(losslessCompressor, level, minGain, dict, data + info[i].rawOffset, info[i].rawSize, &info[i]);
+
+	size_t k = SZ_SECTIONS_MAGIC_SIZE + 1 + count*SZ_SECTIONS_ENTRY_SIZE, totalSize = k;
+	for(i = 0; i < count; i++)
+		totalSize += info[i].cmpSize;
+	*compressBytes = (unsigned char*)malloc(totalSize);
+	unsigned char* p = *compressBytes;
+	memcpy(p, sz_sections_magic, SZ_SECTIONS_MAGIC_SIZE);
+	p[SZ_SECTIONS_MAGIC_SIZE] = (unsigned char)count;
+	p += SZ_SECTIONS_MAGIC_SIZE + 1;
+	for(i = 0; i < count; i++, p += SZ_SECTIONS_ENTRY_SIZE)
+	{
+		p[0] = (unsigned char)info[i].id;
+		p[1] = (unsigned char)info[i].codec;
+		p[2] = (unsigned char)(signed char)info[i].level;
+		longToBytes_bigEndian(p + 3, info[i].rawSize);
+		longToBytes_bigEndian(p + 11, info[i].cmpSize);
+		if(coded[i] != NULL)
+		{
+			memcpy(*compressBytes + k, coded[i], info[i].cmpSize);
+			free(coded[i]);
+		}
+		else
+			memcpy(*compressBytes + k, data + info[i].rawOffset, info[i].rawSize);
+		k += info[i].cmpSize;
+	}
+	return totalSize;
+}
+
+/**
+ * Read the table of contents of a sectioned stream.
+ *
+ * @return the number of sections (at most maxSections are described), or -1 if the stream is not valid
+ * */
+int SZ_getSections(unsigned char* bytes, size_t byteLength, sz_section_info* sections, int maxSections)
+{
+	int i, count;
+	if(!sz_sections_is_sectioned(bytes, byteLength))
+		return -1;
+	count = bytes[SZ_SECTIONS_MAGIC_SIZE];
+	size_t cmpOffset = SZ_SECTIONS_MAGIC_SIZE + 1 + count*SZ_SECTIONS_ENTRY_SIZE, rawOffset = 0;
+	if(count == 0 || count > SZ_SECTIONS_MAX || cmpOffset > byteLength)
+		return -1;
+	unsigned char* p = bytes + SZ_SECTIONS_MAGIC_SIZE + 1;
+	for(i = 0; i < count; i++, p += SZ_SECTIONS_ENTRY_SIZE)
+	{
+		sz_section_info info;
+		info.id = p[0];
+		info.codec = p[1];
+		info.level = (signed char)p[2];
+		info.rawSize = (size_t)bytesToLong_bigEndian(p + 3);
+		info.cmpSize = (size_t)bytesToLong_bigEndian(p + 11);
+		info.rawOffset = rawOffset;
+		info.cmpOffset = cmpOffset;
+		if(info.codec > SZ_SECTION_ZSTD || info.cmpSize > byteLength - cmpOffset || (info.codec == SZ_SECTION_RAW && info.cmpSize != info.rawSize))
+			return -1;
+		rawOffset += info.rawSize;
+		cmpOffset += info.cmpSize;
+		if(i < maxSections)
+			sections[i] = info;
+	}
+	return count;
+}
+
+/*Decode a section into dst (info->rawSize bytes)*/
+static int sz_sections_decode(unsigned char* bytes, const sz_section_info* info, sz_zstd_dict* dict, unsigned char* dst)
+{
+	unsigned char* src = bytes + info->cmpOffset;
+	if(info->codec == SZ_SECTION_RAW)
+	{
+		memcpy(dst, src, info->rawSize);
+		return 1;
+	}
+	if(info->codec == SZ_SECTION_GZIP)
+	{
+		uLongf outSize = info->rawSize;
+		return uncompress(dst, &outSize, src, info->cmpSize) == Z_OK && outSize == info->rawSize;
+	}
+	size_t outSize = dict != NULL ? sz_zstd_dict_decompress(dict, dst, info->rawSize, src, info->cmpSize)
+		: ZSTD_decompress(dst, info->rawSize, src, info->cmpSize);
+	return !ZSTD_isError(outSize) && outSize == info->rawSize;
+}
+
+/**
+ * Decode a sectioned stream into the SZ bytes, the sections in parallel.
+ *
+ * @return the size of the SZ bytes, or 0 if any errors (*oriData is then NULL)
+ * */
+unsigned long sz_sections_decompress(unsigned char* bytes, unsigned long byteLength, unsigned char** oriData)
+{
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	int i, ok = 1, count = SZ_getSections(bytes, byteLength, sections, SZ_SECTIONS_MAX);
+	sz_zstd_dict* dict = sz_zstd_dict_current();
+	*oriData = NULL;
+	if(count <= 0)
+	{
+		printf("Error: wrong table of contents in the sectioned stream\n");
+		return 0;
+	}
+	size_t totalSize = sections[count-1].rawOffset + sections[count-1].rawSize;
+	*oriData = (unsigned char*)malloc(totalSize);
+#ifdef _OPENMP
+	#pragma omp parallel for schedule(dynamic) reduction(&&:ok)
+#endif
+	for(i = 0; i < count; i++)
+		ok = sz_sections_decode(bytes, &sections[i], dict, *oriData + sections[i].rawOffset) && ok;
+	if(!ok)
+	{
+		printf("Error: failed to decode the sectioned stream\n");
+		free(*oriData);
+		*oriData = NULL;
+		return 0;
+	}
+	return totalSize;
+}
+
+/**
+ * Decode one section of a sectioned stream (e.g., SZ_SECTION_CODES), without the others.
+ *
+ * @return the section (to be freed by the caller), or NULL if the stream has no such section
+ * */
+unsigned char* SZ_decompressSection(unsigned char* bytes, size_t byteLength, int id, size_t* sectionSize)
+{
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	int i, count = SZ_getSections(bytes, byteLength, sections, SZ_SECTIONS_MAX);
+	for(i = 0; i < count; i++)
+		if(sections[i].id == id)
+		{
+			unsigned char* section = (unsigned char*)malloc(sections[i].rawSize > 0 ? sections[i].rawSize : 1);
+			if(!sz_sections_decode(bytes, &sections[i], sz_zstd_dict_current(), section))
+			{
+				free(section);
+				return NULL;
+			}
+			*sectionSize = sections[i].rawSize;
+			return section;
+		}
+	return NULL;
+}
@@ -1,7 +1,16 @@
-#include <sz_stats.h>
+#include <string.h>
+#include <time.h>
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <sz.h>
+#include "sz_tctx.h"
 
 sz_stats sz_stat;
 
+//the stats of the threads that are not bound to a context with its own stats
+static SZ_THREAD_LOCAL sz_perf_stats sz_tls_perf_stats;
+
 void writeBlockInfo(int use_mean, size_t blockSize, size_t regressionBlocks, size_t totalBlocks)
 {
 	sz_stat.use_mean = use_mean;
@@ -58,3 +67,77 @@ void printSZStats()
 	printf("unpredictCount             %zu\n", sz_stat.unpredictCount);
 	printf("unpredictPercent           %f\n", sz_stat.unpredictPercent);
 }
+
+double sz_stats_clock()
+{
+#ifdef _WIN32
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return (double)count.QuadPart/frequency.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec*1E-9;
+#endif
+}
+
+sz_perf_stats* sz_stats_current()
+{
+	if(sz_tctx != NULL && sz_tctx->stats != NULL)
+		return sz_tctx->stats;
+	return &sz_tls_perf_stats;
+}
+
+/**
+ * Start recording a compression: the stats of the previous one are cleared.
+ * */
+void sz_stats_begin(int dataType, size_t bytesIn)
+{
+	sz_perf_stats* stats = sz_stats_current();
+	memset(stats, 0, sizeof(sz_perf_stats));
+	stats->dataType = dataType;
+	stats->bytesIn = bytesIn;
+	stats->totalTime = sz_stats_clock(); //start time, until sz_stats_end()
+}
+
+void sz_stats_add(int stage, double startTime, size_t bytesIn, size_t bytesOut)
+{
+	sz_stage_stats* s = &(sz_stats_current()->stage[stage]);
+	s->time += sz_stats_clock() - startTime;
+	s->bytesIn += bytesIn;
+	s->bytesOut += bytesOut;
+	s->calls++;
+}
+
+/**
+ * Finish recording a compression: the time that is not covered by the instrumented stages is 
+ * attributed to prediction/quantization, which is interleaved with them in the compressors.
+ * */
+void sz_stats_end(size_t bytesOut)
+{
+	int i;
+	sz_perf_stats* stats = sz_stats_current();
+	double others = 0;
+	stats->totalTime = sz_stats_clock() - stats->totalTime;
+	stats->bytesOut = bytesOut;
+	for(i = 0; i < SZ_STAGE_NUM; i++)
+		if(i != SZ_STAGE_PREDICT_QUANT)
+			others += stats->stage[i].time;
+	sz_stage_stats* p = &(stats->stage[SZ_STAGE_PREDICT_QUANT]);
+	p->time = stats->totalTime > others ? stats->totalTime - others : 0;
+	p->bytesIn = stats->bytesIn;
+	p->bytesOut = stats->stage[SZ_STAGE_HUFFMAN_BUILD].bytesIn; //the quantization codes
+	p->calls = 1;
+}
+
+int SZ_get_last_stats(sz_thread_context* ctx, sz_perf_stats* stats)
+{
+	if(stats == NULL)
+		return SZ_NSCS;
+	if(ctx != NULL && ctx->stats != NULL)
+		memcpy(stats, ctx->stats, sizeof(sz_perf_stats));
+	else
+		memcpy(stats, &sz_tls_perf_stats, sizeof(sz_perf_stats));
+	return SZ_SCES;
+}
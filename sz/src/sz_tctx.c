@@ -0,0 +1,52 @@
+/**
+ *  @file sz_tctx.c
+ *  @brief The process-wide parameters, and the context that a thread can bind instead (SZ_bindThreadContext).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include "sz.h"
+
+//the confparams should be separate between compression and decopmression, in case of mutual-affection when calling compression/decompression alternatively
+sz_params *confparams_cpr = NULL; //used for compression
+sz_params *confparams_dec = NULL; //used for decompression 
+
+sz_exedata *exe_params = NULL;
+
+/*following global variable is desgined for time-series based compression*/
+sz_multisteps *multisteps = NULL;
+
+SZ_THREAD_LOCAL sz_thread_context *sz_tctx = NULL;
+
+/**
+ * Bind a context to the calling thread: the library then uses the parameters (and the optional fields) of ctx 
+ * instead of the process-wide ones, until the previous context is bound again. 
+ * 
+ * @param ctx the context (NULL: the process-wide parameters)
+ * @return the previous context of the thread
+ * */
+sz_thread_context* SZ_bindThreadContext(sz_thread_context* ctx)
+{
+	sz_thread_context* previous = sz_tctx;
+	sz_tctx = ctx;
+	return previous;
+}
+
+/*The compression parameters used by the calling thread: those of its context, or the process-wide confparams_cpr*/
+sz_params* SZ_getParams_cpr()
+{
+	return sz_tctx==NULL ? confparams_cpr : sz_tctx->cpr;
+}
+
+/*The decompression parameters used by the calling thread: those of its context, or the process-wide confparams_dec*/
+sz_params* SZ_getParams_dec()
+{
+	return sz_tctx==NULL ? confparams_dec : sz_tctx->dec;
+}
+
+/*The execution parameters used by the calling thread: those of its context, or the process-wide exe_params*/
+sz_exedata* SZ_getExeParams()
+{
+	return sz_tctx==NULL ? exe_params : sz_tctx->exe;
+}
@@ -0,0 +1,216 @@
+/**
+ *  @file sz_unpred.c
+ *  @brief Batched coding of the unpredictable data. The prediction loops only collect the unpredictable values
+ *  (see sz_unpred_add_float); their leading numbers, mid bytes and residual bits are computed at the end in a
+ *  few passes over a flat array, into buffers sized once, instead of element by element through the dynamic arrays.
+ *  The decoder rebuilds all the unpredictable values in one pass, word by word, before the prediction loop.
+ *  The bytes are the same as those of compressSingleFloatValue, updateLossyCompElement_Float and addExactData.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "sz_unpred.h"
+
+void sz_unpred_init_float(sz_unpred_float* unpred, size_t capacity, int reqLength, float medianValue)
+{
+	int ignBytesLength = 32 - reqLength;
+	if(ignBytesLength<0)
+		ignBytesLength = 0;
+	//the pages of the array are only touched by the unpredictable values
+	unpred->words = (uint32_t*)malloc((capacity > 0 ? capacity : 1)*sizeof(uint32_t));
+	unpred->count = 0;
+	unpred->reqLength = reqLength;
+	unpred->mask = ignBytesLength >= 32 ? 0 : 0xFFFFFFFFu << ignBytesLength;
+	unpred->medianValue = medianValue;
+}
+
+void sz_unpred_init_double(sz_unpred_double* unpred, size_t capacity, int reqLength, double medianValue)
+{
+	int ignBytesLength = 64 - reqLength;
+	if(ignBytesLength<0)
+		ignBytesLength = 0;
+	unpred->words = (uint64_t*)malloc((capacity > 0 ? capacity : 1)*sizeof(uint64_t));
+	unpred->count = 0;
+	unpred->reqLength = reqLength;
+	unpred->mask = ignBytesLength >= 64 ? 0 : 0xFFFFFFFFFFFFFFFFull << ignBytesLength;
+	unpred->medianValue = medianValue;
+}
+
+/*The number of identical leading bytes of two values, at most 3 (see compIdenticalLeadingBytesCount_float), from their XOR*/
+#define SZ_UNPRED_LEAD_FLOAT(x) (((x) < 0x1000000u) + ((x) < 0x10000u) + ((x) < 0x100u))
+#define SZ_UNPRED_LEAD_DOUBLE(x) (((x) < 0x100000000000000ull) + ((x) < 0x1000000000000ull) + ((x) < 0x10000000000ull))
+
+/**
+ * Code the unpredictable values: their leading numbers and residual bits (one per value, as in the
+ * exactLeadNumArray and the resiBitArray of the dynamic arrays), and their mid bytes. The collected
+ * values are released.
+ *
+ * @return the number of mid bytes
+ * */
+size_t sz_unpred_encode_float(sz_unpred_float* unpred, unsigned char** leadNum, unsigned char** midBytes, unsigned char** resiBits)
+{
+	size_t i, k = 0, n = unpred->count;
+	int j, reqBytesLength = unpred->reqLength/8, resiBitsLength = unpred->reqLength%8;
+	const uint32_t* words = unpred->words;
+	unsigned char* lead = (unsigned char*)malloc(n > 0 ? n : 1);
+	unsigned char* resi = (unsigned char*)malloc(n > 0 ? n : 1);
+	unsigned char* mid = (unsigned char*)malloc(n*reqBytesLength > 0 ? n*reqBytesLength : 1);
+
+	//without branches nor dependencies between the elements, so that the compiler vectorizes it
+	int resiShift = 32 - 8*reqBytesLength - resiBitsLength;
+	uint32_t resiMask = (1u << resiBitsLength) - 1;
+	if(n > 0)
+	{
+		lead[0] = SZ_UNPRED_LEAD_FLOAT(words[0]);
+		resi[0] = (unsigned char)((words[0] >> resiShift) & resiMask);
+	}
+	for(i = 1; i < n; i++)
+	{
+		uint32_t x = words[i] ^ words[i-1];
+		lead[i] = SZ_UNPRED_LEAD_FLOAT(x);
+		resi[i] = (unsigned char)((words[i] >> resiShift) & resiMask);
+	}
+
+	for(i = 0; i < n; i++)
+		for(j = lead[i]; j < reqBytesLength; j++)
+			mid[k++] = (unsigned char)(words[i] >> (24 - 8*j));
+
+	free(unpred->words);
+	unpred->words = NULL;
+	*leadNum = lead;
+	*resiBits = resi;
+	*midBytes = mid;
+	return k;
+}
+
+size_t sz_unpred_encode_double(sz_unpred_double* unpred, unsigned char** leadNum, unsigned char** midBytes, unsigned char** resiBits)
+{
+	size_t i, k = 0, n = unpred->count;
+	int j, reqBytesLength = unpred->reqLength/8, resiBitsLength = unpred->reqLength%8;
+	const uint64_t* words = unpred->words;
+	unsigned char* lead = (unsigned char*)malloc(n > 0 ? n : 1);
+	unsigned char* resi = (unsigned char*)malloc(n > 0 ? n : 1);
+	unsigned char* mid = (unsigned char*)malloc(n*reqBytesLength > 0 ? n*reqBytesLength : 1);
+
+	int resiShift = 64 - 8*reqBytesLength - resiBitsLength;
+	uint64_t resiMask = (1ull << resiBitsLength) - 1;
+	if(n > 0)
+	{
+		lead[0] = SZ_UNPRED_LEAD_DOUBLE(words[0]);
+		resi[0] = (unsigned char)((words[0] >> resiShift) & resiMask);
+	}
+	for(i = 1; i < n; i++)
+	{
+		uint64_t x = words[i] ^ words[i-1];
+		lead[i] = SZ_UNPRED_LEAD_DOUBLE(x);
+		resi[i] = (unsigned char)((words[i] >> resiShift) & resiMask);
+	}
+
+	for(i = 0; i < n; i++)
+		for(j = lead[i]; j < reqBytesLength; j++)
+			mid[k++] = (unsigned char)(words[i] >> (56 - 8*j));
+
+	free(unpred->words);
+	unpred->words = NULL;
+	*leadNum = lead;
+	*resiBits = resi;
+	*midBytes = mid;
+	return k;
+}
+
+static inline uint32_t sz_unpred_load_be32(const unsigned char* p)
+{
+	return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static inline uint64_t sz_unpred_load_be64(const unsigned char* p)
+{
+	return ((uint64_t)sz_unpred_load_be32(p) << 32) | sz_unpred_load_be32(p + 4);
+}
+
+/**
+ * Decode all the unpredictable values of a TightDataPointStorageF (see decompressExactDataArray_float).
+ * The mid bytes of a value are read at once and masked, so that the loop does not branch on its leading number;
+ * only the last values (whose reads would go past the end of the arrays) are decoded byte by byte.
+ *
+ * @param leadNumBytes the leading numbers, 2 bits each (leadNumArray)
+ * @param midBytesSize the number of mid bytes (exactMidBytes_size)
+ * @param resiBitsBytes the residual bits, resiBitsLength each (residualMidBits)
+ * */
+void sz_unpred_decode_float(const unsigned char* leadNumBytes, const unsigned char* midBytes, size_t midBytesSize,
+const unsigned char* resiBitsBytes, size_t nbEle, int reqLength, float medianValue, float* decData)
+{
+	//the leading bytes of a word, from 0 to 4 of them
+	static const uint32_t leadMask[5] = {0, 0xFF000000u, 0xFFFF0000u, 0xFFFFFF00u, 0xFFFFFFFFu};
+	size_t i, m = 0, k = 0;
+	int reqBytesLength = reqLength/8, resiBitsLength = reqLength%8;
+	int resiByteShift = resiBitsLength != 0 ? 24 - 8*reqBytesLength : 0; //of the byte holding the residual bits
+	size_t resiBitsSize = (nbEle*resiBitsLength + 7)/8;
+	uint32_t preWord = 0, resiMask = (1u << resiBitsLength) - 1;
+	uint32_t resiByteMask = resiBitsLength != 0 ? ~(0xFFu << resiByteShift) : 0xFFFFFFFFu;
+	for(i = 0; i < nbEle; i++, k += resiBitsLength)
+	{
+		int leadingNum = (leadNumBytes[i >> 2] >> (6 - 2*(i & 3))) & 0x03;
+		uint32_t word = preWord & leadMask[leadingNum];
+		int midNum = reqBytesLength - leadingNum;
+		if(m + 4 <= midBytesSize)
+			word |= (sz_unpred_load_be32(midBytes + m) >> (8*leadingNum)) & leadMask[reqBytesLength] & ~leadMask[leadingNum];
+		else
+		{
+			int j;
+			for(j = leadingNum; j < reqBytesLength; j++)
+				word |= (uint32_t)midBytes[m + j - leadingNum] << (24 - 8*j);
+		}
+		m += midNum > 0 ? midNum : 0;
+		//the residual bits of a value are within two bytes (resiBitsLength < 8)
+		size_t p = k >> 3;
+		uint32_t twoBytes = ((uint32_t)(resiBitsLength != 0 ? resiBitsBytes[p] : 0) << 8) | (p + 1 < resiBitsSize ? resiBitsBytes[p + 1] : 0);
+		uint32_t resiBits = (twoBytes >> (16 - (k & 7) - resiBitsLength)) & resiMask;
+		word = (word & resiByteMask) | ((resiBits << (8 - resiBitsLength)) << resiByteShift);
+		float value;
+		memcpy(&value, &word, sizeof(value));
+		decData[i] = value + medianValue;
+		preWord = word;
+	}
+}
+
+void sz_unpred_decode_double(const unsigned char* leadNumBytes, const unsigned char* midBytes, size_t midBytesSize,
+const unsigned char* resiBitsBytes, size_t nbEle, int reqLength, double medianValue, double* decData)
+{
+	static const uint64_t leadMask[9] = {0, 0xFF00000000000000ull, 0xFFFF000000000000ull, 0xFFFFFF0000000000ull, 0xFFFFFFFF00000000ull,
+		0xFFFFFFFFFF000000ull, 0xFFFFFFFFFFFF0000ull, 0xFFFFFFFFFFFFFF00ull, 0xFFFFFFFFFFFFFFFFull};
+	size_t i, m = 0, k = 0;
+	int reqBytesLength = reqLength/8, resiBitsLength = reqLength%8;
+	int resiByteShift = resiBitsLength != 0 ? 56 - 8*reqBytesLength : 0;
+	size_t resiBitsSize = (nbEle*resiBitsLength + 7)/8;
+	uint64_t preWord = 0;
+	uint64_t resiByteMask = resiBitsLength != 0 ? ~(0xFFull << resiByteShift) : 0xFFFFFFFFFFFFFFFFull;
+	uint32_t resiMask = (1u << resiBitsLength) - 1;
+	for(i = 0; i < nbEle; i++, k += resiBitsLength)
+	{
+		int leadingNum = (leadNumBytes[i >> 2] >> (6 - 2*(i & 3))) & 0x03;
+		uint64_t word = preWord & leadMask[leadingNum];
+		int midNum = reqBytesLength - leadingNum;
+		if(m + 8 <= midBytesSize)
+			word |= (sz_unpred_load_be64(midBytes + m) >> (8*leadingNum)) & leadMask[reqBytesLength] & ~leadMask[leadingNum];
+		else
+		{
+			int j;
+			for(j = leadingNum; j < reqBytesLength; j++)
+				word |= (uint64_t)midBytes[m + j - leadingNum] << (56 - 8*j);
+		}
+		m += midNum > 0 ? midNum : 0;
+		size_t p = k >> 3;
+		uint32_t twoBytes = ((uint32_t)(resiBitsLength != 0 ? resiBitsBytes[p] : 0) << 8) | (p + 1 < resiBitsSize ? resiBitsBytes[p + 1] : 0);
+		uint64_t resiBits = (twoBytes >> (16 - (k & 7) - resiBitsLength)) & resiMask;
+		word = (word & resiByteMask) | ((resiBits << (8 - resiBitsLength)) << resiByteShift);
+		double value;
+		memcpy(&value, &word, sizeof(value));
+		decData[i] = value + medianValue;
+		preWord = word;
+	}
+}
@@ -0,0 +1,180 @@
+/**
+ *  @file sz_zstd_dict.c
+ *  @brief Zstd dictionaries for the lossless stage: many small fields compress poorly one by one, because each
+ *  Zstd frame starts with empty statistics. A dictionary trained on samples of the SZ bytes of similar fields
+ *  primes the statistics of every frame, and is digested once for all the compressions and decompressions.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#define ZSTD_STATIC_LINKING_ONLY //for ZSTD_getDictID_fromFrame
+#include "zstd.h"
+#include "zdict.h"
+#include "sz.h"
+#include "sz_tctx.h"
+#include "sz_zstd_dict.h"
+
+//the dictionary of the threads that are not bound to a context (see SZ_setZstdDict)
+static sz_zstd_dict* sz_zstd_dict_global = NULL;
+
+/**
+ * Train a dictionary on samples of the bytes to be compressed by the lossless stage, e.g., the outputs of
+ * SZ_compress_args in the SZ_BEST_SPEED mode (which skips the lossless stage) for fields like those to come.
+ *
+ * @param dictCapacity the maximum size of the dictionary (0: SZ_ZSTD_DICT_CAPACITY)
+ * @param level the compression level the dictionary is digested for (the one of the lossless stage, 3 by default)
+ * @return the dictionary, or NULL if the samples are too few or too small to train one
+ * */
+sz_zstd_dict* SZ_trainZstdDict(unsigned char** samples, const size_t* sampleSizes, unsigned int nbSamples, size_t dictCapacity, int level)
+{
+	unsigned int i;
+	size_t totalSize = 0, offset = 0;
+	if(dictCapacity == 0)
+		dictCapacity = SZ_ZSTD_DICT_CAPACITY;
+	for(i = 0; i < nbSamples; i++)
+		totalSize += sampleSizes[i];
+	if(nbSamples == 0 || totalSize == 0)
+	{
+		printf("Error: no samples to train the zstd dictionary\n");
+		return NULL;
+	}
+
+	//ZDICT_trainFromBuffer takes the samples one after the other
+	unsigned char* buffer = (unsigned char*)malloc(totalSize);
+	for(i = 0; i < nbSamples; i++)
+	{
+		memcpy(buffer + offset, samples[i], sampleSizes[i]);
+		offset += sampleSizes[i];
+	}
+	unsigned char* dictBytes = (unsigned char*)malloc(dictCapacity);
+	size_t dictSize = ZDICT_trainFromBuffer(dictBytes, dictCapacity, buffer, sampleSizes, nbSamples);
+	free(buffer);
+	if(ZDICT_isError(dictSize))
+	{
+		printf("Error: failed to train the zstd dictionary (%s)\n", ZDICT_getErrorName(dictSize));
+		free(dictBytes);
+		return NULL;
+	}
+	sz_zstd_dict* dict = SZ_loadZstdDict(dictBytes, dictSize, level);
+	free(dictBytes);
+	return dict;
+}
+
+/**
+ * Load a dictionary stored with the compressed fields (the dictBytes of a trained dictionary), or any
+ * Zstd dictionary. The bytes are copied.
+ *
+ * @return the dictionary, or NULL if any errors
+ * */
+sz_zstd_dict* SZ_loadZstdDict(const unsigned char* dictBytes, size_t dictSize, int level)
+{
+	if(dictBytes == NULL || dictSize == 0)
+	{
+		printf("Error: empty zstd dictionary\n");
+		return NULL;
+	}
+	sz_zstd_dict* dict = (sz_zstd_dict*)malloc(sizeof(sz_zstd_dict));
+	memset(dict, 0, sizeof(sz_zstd_dict));
+	dict->dictBytes = (unsigned char*)malloc(dictSize);
+	memcpy(dict->dictBytes, dictBytes, dictSize);
+	dict->dictSize = dictSize;
+	dict->dictID = ZDICT_getDictID(dictBytes, dictSize);
+	dict->level = level;
+	dict->cdict = ZSTD_createCDict(dict->dictBytes, dictSize, level);
+	dict->ddict = ZSTD_createDDict(dict->dictBytes, dictSize);
+	if(dict->cdict == NULL || dict->ddict == NULL)
+	{
+		printf("Error: failed to load the zstd dictionary\n");
+		SZ_freeZstdDict(dict);
+		return NULL;
+	}
+	return dict;
+}
+
+void SZ_freeZstdDict(sz_zstd_dict* dict)
+{
+	if(dict == NULL)
+		return;
+	if(sz_zstd_dict_global == dict)
+		sz_zstd_dict_global = NULL;
+	ZSTD_freeCDict(dict->cdict);
+	ZSTD_freeDDict(dict->ddict);
+	free(dict->dictBytes);
+	free(dict);
+}
+
+/**
+ * Set the dictionary of the lossless stage (Zstd only) for the threads that are not bound to a context
+ * (the bound threads use the zstdDict of their context). NULL: no dictionary.
+ *
+ * @return the previous dictionary
+ * */
+sz_zstd_dict* SZ_setZstdDict(sz_zstd_dict* dict)
+{
+	sz_zstd_dict* previous = sz_zstd_dict_global;
+	sz_zstd_dict_global = dict;
+	return previous;
+}
+
+sz_zstd_dict* sz_zstd_dict_current()
+{
+	if(sz_tctx != NULL)
+		return sz_tctx->zstdDict;
+	return sz_zstd_dict_global;
+}
+
+/**
+ * Compress with the dictionary: with the digested one at its level, or the raw one at any other level.
+ *
+ * @return the compressed size, or 0 if any errors
+ * */
+size_t sz_zstd_dict_compress(sz_zstd_dict* dict, unsigned char* dst, size_t dstCapacity, const unsigned char* src, size_t srcSize, int level)
+{
+	size_t outSize;
+	ZSTD_CCtx* cctx = ZSTD_createCCtx();
+	if(level == dict->level)
+		outSize = ZSTD_compress_usingCDict(cctx, dst, dstCapacity, src, srcSize, dict->cdict);
+	else
+		outSize = ZSTD_compress_usingDict(cctx, dst, dstCapacity, src, srcSize, dict->dictBytes, dict->dictSize, level);
+	ZSTD_freeCCtx(cctx);
+	if(ZSTD_isError(outSize))
+	{
+		printf("Error: zstd compression with the dictionary failed (%s)\n", ZSTD_getErrorName(outSize));
+		return 0;
+	}
+	return outSize;
+}
+
+/**
+ * Decompress a frame. The frames compressed without dictionary are decompressed as usual, so that the
+ * fields of a file may be compressed with or without the dictionary.
+ *
+ * @return the decompressed size, or 0 if any errors (e.g., the frame needs another dictionary)
+ * */
+size_t sz_zstd_dict_decompress(sz_zstd_dict* dict, unsigned char* dst, size_t dstCapacity, const unsigned char* src, size_t srcSize)
+{
+	size_t outSize;
+	unsigned int dictID = ZSTD_getDictID_fromFrame(src, srcSize);
+	if(dictID == 0 && dict->dictID != 0)
+		outSize = ZSTD_decompress(dst, dstCapacity, src, srcSize);
+	else if(dictID != dict->dictID)
+	{
+		printf("Error: the zstd frame needs the dictionary %u, not %u\n", dictID, dict->dictID);
+		return 0;
+	}
+	else
+	{
+		ZSTD_DCtx* dctx = ZSTD_createDCtx();
+		outSize = ZSTD_decompress_usingDDict(dctx, dst, dstCapacity, src, srcSize, dict->ddict);
+		ZSTD_freeDCtx(dctx);
+	}
+	if(ZSTD_isError(outSize))
+	{
+		printf("Error: zstd decompression with the dictionary failed (%s)\n", ZSTD_getErrorName(outSize));
+		return 0;
+	}
+	return outSize;
+}
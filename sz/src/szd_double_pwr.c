@@ -14,6 +14,7 @@
 #include "TightDataPointStorageD.h"
 #include "CompressElement.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 #include "sz_double_pwr.h"
 #include "utility.h"
@@ -41,8 +42,16 @@ void decompressDataSeries_double_1D_pwr(double** data, size_t dataSeriesLength,
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 	
 	unsigned char preBytes[8];
 	unsigned char curBytes[8];
@@ -173,8 +182,16 @@ void decompressDataSeries_double_2D_pwr(double** data, size_t r1, size_t r2, Tig
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[8];
 	unsigned char curBytes[8];
@@ -553,8 +570,16 @@ void decompressDataSeries_double_3D_pwr(double** data, size_t r1, size_t r2, siz
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[8];
 	unsigned char curBytes[8];
@@ -1196,14 +1221,34 @@ void decompressDataSeries_double_1D_pwrgroup(double** data, size_t dataSeriesLen
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	createRangeGroups_double(&posGroups, &negGroups, &posFlags, &negFlags);
 	
 	double realGroupPrecision;
 	double realPrecision = tdps->realPrecision;
 	char* groupID = decompressGroupIDArray(tdps->pwrErrBoundBytes, tdps->dataSeriesLength);
+	if(groupID == NULL)
+	{
+		free(posGroups);
+		free(negGroups);
+		free(posFlags);
+		free(negFlags);
+		free(leadNum);
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 	
 	//note that the groupID values here are [1,2,3,....,18] or [-1,-2,...,-18]
 	
@@ -1355,6 +1400,8 @@ void decompressDataSeries_double_1D_pwrgroup(double** data, size_t dataSeriesLen
 void decompressDataSeries_double_1D_pwr_pre_log(double** data, size_t dataSeriesLength, TightDataPointStorageD* tdps) {
 
 	decompressDataSeries_double_1D(data, dataSeriesLength, NULL, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1380,6 +1427,8 @@ void decompressDataSeries_double_2D_pwr_pre_log(double** data, size_t r1, size_t
 
 	size_t dataSeriesLength = r1 * r2;
 	decompressDataSeries_double_2D(data, r1, r2, NULL, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1404,6 +1453,8 @@ void decompressDataSeries_double_3D_pwr_pre_log(double** data, size_t r1, size_t
 
 	size_t dataSeriesLength = r1 * r2 * r3;
 	decompressDataSeries_double_3D(data, r1, r2, r3, NULL, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1427,6 +1478,8 @@ void decompressDataSeries_double_3D_pwr_pre_log(double** data, size_t r1, size_t
 void decompressDataSeries_double_1D_pwr_pre_log_MSST19(double** data, size_t dataSeriesLength, TightDataPointStorageD* tdps) 
 {
 	decompressDataSeries_double_1D_MSST19(data, dataSeriesLength, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	uint64_t* ptr;
 
@@ -1462,6 +1515,8 @@ void decompressDataSeries_double_2D_pwr_pre_log_MSST19(double** data, size_t r1,
 
 	size_t dataSeriesLength = r1 * r2;
 	decompressDataSeries_double_2D_MSST19(data, r1, r2, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	uint64_t* ptr;
 
@@ -1497,6 +1552,8 @@ void decompressDataSeries_double_3D_pwr_pre_log_MSST19(double** data, size_t r1,
 
 	size_t dataSeriesLength = r1 * r2 * r3;
 	decompressDataSeries_double_3D_MSST19(data, r1, r2, r3, tdps);
+	if(*data == NULL)
+		return;
 	double threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs = NULL;
@@ -13,6 +13,7 @@
 #include "szd_double.h"
 #include "TightDataPointStorageD.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 #include "szd_double_ts.h"
 
@@ -33,8 +34,16 @@ void decompressDataSeries_double_1D_ts(double** data, size_t dataSeriesLength, d
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 	
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[8];
 	unsigned char curBytes[8];
@@ -106,8 +115,6 @@ void decompressDataSeries_double_1D_ts(double** data, size_t dataSeriesLength, d
 		//printf("%.30G\n",(*data)[i]);
 	}
 	
-	memcpy(hist_data, (*data), dataSeriesLength*sizeof(double));
-	
 	free(leadNum);
 	free(type);
 	return;
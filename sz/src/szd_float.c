@@ -13,6 +13,7 @@
 #include "szd_float.h"
 #include "TightDataPointStorageF.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 #include "szd_float_pwr.h"
 #include "szd_float_ts.h"
@@ -57,7 +58,7 @@ size_t cmpSize, int compressionType, float* hist_data)
 	size_t targetUncompressSize = dataLength <<2; //i.e., *4
 	//tmpSize must be "much" smaller than dataLength
 	size_t i, tmpSize = 8+MetaDataByteLength+exe_params->SZ_SIZE_TYPE;
-	unsigned char* szTmpBytes;	
+	unsigned char* szTmpBytes = NULL;	
 	
 	if(cmpSize!=8+4+MetaDataByteLength && cmpSize!=8+8+MetaDataByteLength) //4,8 means two posibilities of SZ_SIZE_TYPE
 	{
@@ -80,6 +81,8 @@ size_t cmpSize, int compressionType, float* hist_data)
 			if(targetUncompressSize<MIN_ZLIB_DEC_ALLOMEM_BYTES) //Considering the minimum size
 				targetUncompressSize = MIN_ZLIB_DEC_ALLOMEM_BYTES; 
 			tmpSize = sz_lossless_decompress(confparams_dec->losslessCompressor, cmpBytes, (unsigned long)cmpSize, &szTmpBytes, (unsigned long)targetUncompressSize+4+MetaDataByteLength+exe_params->SZ_SIZE_TYPE);//		(unsigned long)targetUncompressSize+8: consider the total length under lossless compression mode is actually 3+4+1+targetUncompressSize
+			if(szTmpBytes == NULL)
+				return SZ_DERR; //e.g., a section of the stream failed to decode
 			//szTmpBytes = (unsigned char*)malloc(sizeof(unsigned char)*tmpSize);
 			//memcpy(szTmpBytes, tmpBytes, tmpSize);
 			//free(tmpBytes); //release useless memory		
@@ -157,8 +160,11 @@ size_t cmpSize, int compressionType, float* hist_data)
 		}
 	}
 
-	//cost_start_();	
-	if(confparams_dec->protectValueRange)
+	if(status == SZ_SCES && *newData == NULL)
+		status = SZ_DERR; //e.g., the Huffman tree of the stream is not in the dictionary
+
+	//cost_start_();
+	if(status == SZ_SCES && confparams_dec->protectValueRange)
 	{
 		float* nd = *newData;
 		float min = confparams_dec->fmin;
@@ -185,81 +191,34 @@ size_t cmpSize, int compressionType, float* hist_data)
 void decompressDataSeries_float_1D(float** data, size_t dataSeriesLength, float* hist_data, TightDataPointStorageF* tdps) 
 {
 	updateQuantizationInfo(tdps->intervals);
-	size_t i, j, k = 0, p = 0, l = 0; // k is to track the location of residual_bit
-								// in resiMidBits, p is to track the
-								// byte_index of resiMidBits, l is for
-								// leadNum
-	unsigned char* leadNum;
+	size_t i, l = 0; // l is for the unpredictable data
 	float interval = tdps->realPrecision*2;
 	
-	convertByteArray2IntArray_fast_2b(tdps->exactDataNum, tdps->leadNumArray, tdps->leadNumArray_size, &leadNum);
+	float* unpredData = (float*)malloc(tdps->exactDataNum*sizeof(float));
+	sz_unpred_decode_float(tdps->leadNumArray, tdps->exactMidBytes, tdps->exactMidBytes_size, tdps->residualMidBits, tdps->exactDataNum, tdps->reqLength, tdps->medianValue, unpredData);
 	*data = (float*)malloc(sizeof(float)*dataSeriesLength);
 
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 	
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(unpredData);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
-	unsigned char preBytes[4];
-	unsigned char curBytes[4];
-	
-	memset(preBytes, 0, 4);
-
-	size_t curByteIndex = 0;
-	int reqBytesLength, resiBitsLength, resiBits; 
-	unsigned char leadingNum;	
-	float medianValue, exactData, predValue;
-	
-	reqBytesLength = tdps->reqLength/8;
-	resiBitsLength = tdps->reqLength%8;
-	medianValue = tdps->medianValue;
-	
+	float predValue;
 	int type_;
 	for (i = 0; i < dataSeriesLength; i++) {	
 		type_ = type[i];
 		switch (type_) {
 		case 0:
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data	
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-			
-			exactData = bytesToFloat(curBytes);
-			(*data)[i] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[i] = unpredData[l++];
 			break;
 		default:
 			//predValue = 2 * (*data)[i-1] - (*data)[i-2];
@@ -270,12 +229,8 @@ void decompressDataSeries_float_1D(float** data, size_t dataSeriesLength, float*
 		//printf("%.30G\n",(*data)[i]);
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif	
 	
-	free(leadNum);
+	free(unpredData);
 	free(type);
 	return;
 }
@@ -285,86 +240,38 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 	updateQuantizationInfo(tdps->intervals);
 	//printf("tdps->intervals=%d, exe_params->intvRadius=%d\n", tdps->intervals, exe_params->intvRadius);
 	
-	size_t j, k = 0, p = 0, l = 0; // k is to track the location of residual_bit
-	// in resiMidBits, p is to track the
-	// byte_index of resiMidBits, l is for
-	// leadNum
+	size_t l = 0; // l is for the unpredictable data
 	size_t dataSeriesLength = r1*r2;
 	//	printf ("%d %d\n", r1, r2);
 
-	unsigned char* leadNum;
 	float realPrecision = tdps->realPrecision;
 
-	convertByteArray2IntArray_fast_2b(tdps->exactDataNum, tdps->leadNumArray, tdps->leadNumArray_size, &leadNum);
+	float* unpredData = (float*)malloc(tdps->exactDataNum*sizeof(float));
+	sz_unpred_decode_float(tdps->leadNumArray, tdps->exactMidBytes, tdps->exactMidBytes_size, tdps->residualMidBits, tdps->exactDataNum, tdps->reqLength, tdps->medianValue, unpredData);
 
 	*data = (float*)malloc(sizeof(float)*dataSeriesLength);
 
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(unpredData);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
-	unsigned char preBytes[4];
-	unsigned char curBytes[4];
-
-	memset(preBytes, 0, 4);
-
-	size_t curByteIndex = 0;
-	int reqBytesLength, resiBitsLength, resiBits; 
-	unsigned char leadingNum;	
-	float medianValue, exactData;
 	int type_;
-
-	reqBytesLength = tdps->reqLength/8;
-	resiBitsLength = tdps->reqLength%8;
-	medianValue = tdps->medianValue;
-	
 	float pred1D, pred2D;
 	size_t ii, jj;
 
 	/* Process Row-0, data 0 */
 
-	// compute resiBits
-	resiBits = 0;
-	if (resiBitsLength != 0) {
-		int kMod8 = k % 8;
-		int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-		if (rightMovSteps > 0) {
-			int code = getRightMovingCode(kMod8, resiBitsLength);
-			resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-		} else if (rightMovSteps < 0) {
-			int code1 = getLeftMovingCode(kMod8);
-			int code2 = getRightMovingCode(kMod8, resiBitsLength);
-			int leftMovSteps = -rightMovSteps;
-			rightMovSteps = 8 - leftMovSteps;
-			resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-			p++;
-			resiBits = resiBits
-					| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-		} else // rightMovSteps == 0
-		{
-			int code = getRightMovingCode(kMod8, resiBitsLength);
-			resiBits = (tdps->residualMidBits[p] & code);
-			p++;
-		}
-		k += resiBitsLength;
-	}
-
-	// recover the exact data
-	memset(curBytes, 0, 4);
-	leadingNum = leadNum[l++];
-	memcpy(curBytes, preBytes, leadingNum);
-	for (j = leadingNum; j < reqBytesLength; j++)
-		curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-	if (resiBitsLength != 0) {
-		unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-		curBytes[reqBytesLength] = resiByte;
-	}
-
-	exactData = bytesToFloat(curBytes);
-	(*data)[0] = exactData + medianValue;
-	memcpy(preBytes,curBytes,4);
+	(*data)[0] = unpredData[l++];
 
 	/* Process Row-0, data 1 */
 	type_ = type[1]; 
@@ -375,46 +282,7 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 	}
 	else
 	{
-		// compute resiBits
-		resiBits = 0;
-		if (resiBitsLength != 0) {
-			int kMod8 = k % 8;
-			int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-			if (rightMovSteps > 0) {
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-			} else if (rightMovSteps < 0) {
-				int code1 = getLeftMovingCode(kMod8);
-				int code2 = getRightMovingCode(kMod8, resiBitsLength);
-				int leftMovSteps = -rightMovSteps;
-				rightMovSteps = 8 - leftMovSteps;
-				resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-				p++;
-				resiBits = resiBits
-						| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-			} else // rightMovSteps == 0
-			{
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code);
-				p++;
-			}
-			k += resiBitsLength;
-		}
-
-		// recover the exact data
-		memset(curBytes, 0, 4);
-		leadingNum = leadNum[l++];
-		memcpy(curBytes, preBytes, leadingNum);
-		for (j = leadingNum; j < reqBytesLength; j++)
-			curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-		if (resiBitsLength != 0) {
-			unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-			curBytes[reqBytesLength] = resiByte;
-		}
-
-		exactData = bytesToFloat(curBytes);
-		(*data)[1] = exactData + medianValue;
-		memcpy(preBytes,curBytes,4);
+		(*data)[1] = unpredData[l++];
 	}
 
 	/* Process Row-0, data 2 --> data r2-1 */
@@ -428,46 +296,7 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[jj] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[jj] = unpredData[l++];
 		}
 	}
 
@@ -486,46 +315,7 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[index] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[index] = unpredData[l++];
 		}
 
 		/* Process row-ii data 1 --> r2-1*/
@@ -541,56 +331,13 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 		}
 	}
 
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif	
 
-	free(leadNum);
+	free(unpredData);
 	free(type);
 	return;
 }
@@ -598,83 +345,37 @@ void decompressDataSeries_float_2D(float** data, size_t r1, size_t r2, float* hi
 void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3, float* hist_data, TightDataPointStorageF* tdps) 
 {
 	updateQuantizationInfo(tdps->intervals);
-	size_t j, k = 0, p = 0, l = 0; // k is to track the location of residual_bit
-	// in resiMidBits, p is to track the
-	// byte_index of resiMidBits, l is for
-	// leadNum
+	size_t l = 0; // l is for the unpredictable data
 	size_t dataSeriesLength = r1*r2*r3;
 	size_t r23 = r2*r3;
-	unsigned char* leadNum;
 	float realPrecision = tdps->realPrecision;
 
 	//TODO
-	convertByteArray2IntArray_fast_2b(tdps->exactDataNum, tdps->leadNumArray, tdps->leadNumArray_size, &leadNum);
+	float* unpredData = (float*)malloc(tdps->exactDataNum*sizeof(float));
+	sz_unpred_decode_float(tdps->leadNumArray, tdps->exactMidBytes, tdps->exactMidBytes_size, tdps->residualMidBits, tdps->exactDataNum, tdps->reqLength, tdps->medianValue, unpredData);
 
 	*data = (float*)malloc(sizeof(float)*dataSeriesLength);
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(unpredData);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
-	unsigned char preBytes[4];
-	unsigned char curBytes[4];
-
-	memset(preBytes, 0, 4);
-	size_t curByteIndex = 0;
-	int reqBytesLength, resiBitsLength, resiBits;
-	unsigned char leadingNum;
-	float medianValue, exactData;
 	int type_;
-
-	reqBytesLength = tdps->reqLength/8;
-	resiBitsLength = tdps->reqLength%8;
-	medianValue = tdps->medianValue;
-	
 	float pred1D, pred2D, pred3D;
 	size_t ii, jj, kk;
 
 	///////////////////////////	Process layer-0 ///////////////////////////
 	/* Process Row-0 data 0*/
-	// compute resiBits
-	resiBits = 0;
-	if (resiBitsLength != 0) {
-		int kMod8 = k % 8;
-		int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-		if (rightMovSteps > 0) {
-			int code = getRightMovingCode(kMod8, resiBitsLength);
-			resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-		} else if (rightMovSteps < 0) {
-			int code1 = getLeftMovingCode(kMod8);
-			int code2 = getRightMovingCode(kMod8, resiBitsLength);
-			int leftMovSteps = -rightMovSteps;
-			rightMovSteps = 8 - leftMovSteps;
-			resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-			p++;
-			resiBits = resiBits
-					| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-		} else // rightMovSteps == 0
-		{
-			int code = getRightMovingCode(kMod8, resiBitsLength);
-			resiBits = (tdps->residualMidBits[p] & code);
-			p++;
-		}
-		k += resiBitsLength;
-	}
-
-	// recover the exact data
-	memset(curBytes, 0, 4);
-	leadingNum = leadNum[l++];
-	memcpy(curBytes, preBytes, leadingNum);
-	for (j = leadingNum; j < reqBytesLength; j++)
-		curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-	if (resiBitsLength != 0) {
-		unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-		curBytes[reqBytesLength] = resiByte;
-	}
-	exactData = bytesToFloat(curBytes);
-	(*data)[0] = exactData + medianValue;
-	memcpy(preBytes,curBytes,4);
+	(*data)[0] = unpredData[l++];
 
 	/* Process Row-0, data 1 */
 	pred1D = (*data)[0];
@@ -686,46 +387,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 	}
 	else
 	{
-		// compute resiBits
-		resiBits = 0;
-		if (resiBitsLength != 0) {
-			int kMod8 = k % 8;
-			int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-			if (rightMovSteps > 0) {
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-			} else if (rightMovSteps < 0) {
-				int code1 = getLeftMovingCode(kMod8);
-				int code2 = getRightMovingCode(kMod8, resiBitsLength);
-				int leftMovSteps = -rightMovSteps;
-				rightMovSteps = 8 - leftMovSteps;
-				resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-				p++;
-				resiBits = resiBits
-						| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-			} else // rightMovSteps == 0
-			{
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code);
-				p++;
-			}
-			k += resiBitsLength;
-		}
-
-		// recover the exact data
-		memset(curBytes, 0, 4);
-		leadingNum = leadNum[l++];
-		memcpy(curBytes, preBytes, leadingNum);
-		for (j = leadingNum; j < reqBytesLength; j++)
-			curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-		if (resiBitsLength != 0) {
-			unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-			curBytes[reqBytesLength] = resiByte;
-		}
-
-		exactData = bytesToFloat(curBytes);
-		(*data)[1] = exactData + medianValue;
-		memcpy(preBytes,curBytes,4);
+		(*data)[1] = unpredData[l++];
 	}
 	/* Process Row-0, data 2 --> data r3-1 */
 	for (jj = 2; jj < r3; jj++)
@@ -739,46 +401,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[jj] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[jj] = unpredData[l++];
 		}
 	}
 
@@ -797,46 +420,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[index] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[index] = unpredData[l++];
 		}
 
 		/* Process row-ii data 1 --> r3-1*/
@@ -852,46 +436,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 		}
 	}
@@ -911,46 +456,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[index] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[index] = unpredData[l++];
 		}
 
 		/* Process Row-0 data 1 --> data r3-1 */
@@ -966,46 +472,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 		}
 
@@ -1023,46 +490,7 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 
 			/* Process Row-i data 1 --> data r3-1 */
@@ -1079,57 +507,14 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 				}
 				else
 				{
-					// compute resiBits
-					resiBits = 0;
-					if (resiBitsLength != 0) {
-						int kMod8 = k % 8;
-						int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-						if (rightMovSteps > 0) {
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-						} else if (rightMovSteps < 0) {
-							int code1 = getLeftMovingCode(kMod8);
-							int code2 = getRightMovingCode(kMod8, resiBitsLength);
-							int leftMovSteps = -rightMovSteps;
-							rightMovSteps = 8 - leftMovSteps;
-							resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-							p++;
-							resiBits = resiBits
-									| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-						} else // rightMovSteps == 0
-						{
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code);
-							p++;
-						}
-						k += resiBitsLength;
-					}
-
-					// recover the exact data
-					memset(curBytes, 0, 4);
-					leadingNum = leadNum[l++];
-					memcpy(curBytes, preBytes, leadingNum);
-					for (j = leadingNum; j < reqBytesLength; j++)
-						curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-					if (resiBitsLength != 0) {
-						unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-						curBytes[reqBytesLength] = resiByte;
-					}
-
-					exactData = bytesToFloat(curBytes);
-					(*data)[index] = exactData + medianValue;
-					memcpy(preBytes,curBytes,4);
+					(*data)[index] = unpredData[l++];
 				}
 			}
 		}
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif		
 
-	free(leadNum);
+	free(unpredData);
 	free(type);
 	return;
 }
@@ -1137,40 +522,32 @@ void decompressDataSeries_float_3D(float** data, size_t r1, size_t r2, size_t r3
 void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3, size_t r4, float* hist_data, TightDataPointStorageF* tdps)
 {
 	updateQuantizationInfo(tdps->intervals);
-	size_t j, k = 0, p = 0, l = 0; // k is to track the location of residual_bit
-	// in resiMidBits, p is to track the
-	// byte_index of resiMidBits, l is for
-	// leadNum
+	size_t l = 0; // l is for the unpredictable data
 	size_t dataSeriesLength = r1*r2*r3*r4;
 	size_t r234 = r2*r3*r4;
 	size_t r34 = r3*r4;
 //	printf ("%d %d %d %d\n", r1, r2, r3, r4);
-	unsigned char* leadNum;
 	double realPrecision = tdps->realPrecision;
 
-	convertByteArray2IntArray_fast_2b(tdps->exactDataNum, tdps->leadNumArray, tdps->leadNumArray_size, &leadNum);
+	float* unpredData = (float*)malloc(tdps->exactDataNum*sizeof(float));
+	sz_unpred_decode_float(tdps->leadNumArray, tdps->exactMidBytes, tdps->exactMidBytes_size, tdps->residualMidBits, tdps->exactDataNum, tdps->reqLength, tdps->medianValue, unpredData);
 
 	*data = (float*)malloc(sizeof(float)*dataSeriesLength);
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(unpredData);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
-	unsigned char preBytes[4];
-	unsigned char curBytes[4];
-
-	memset(preBytes, 0, 4);
-	size_t curByteIndex = 0;
-	int reqBytesLength, resiBitsLength, resiBits;
-	unsigned char leadingNum;
-	float medianValue, exactData;
 	int type_;
-
-	reqBytesLength = tdps->reqLength/8;
-	resiBitsLength = tdps->reqLength%8;
-	medianValue = tdps->medianValue;
-
 	float pred1D, pred2D, pred3D;
 	size_t ii, jj, kk, ll;
 	size_t index;
@@ -1182,45 +559,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 		/* Process Row-0 data 0*/
 		index = ll*r234;
 
-		// compute resiBits
-		resiBits = 0;
-		if (resiBitsLength != 0) {
-			int kMod8 = k % 8;
-			int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-			if (rightMovSteps > 0) {
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-			} else if (rightMovSteps < 0) {
-				int code1 = getLeftMovingCode(kMod8);
-				int code2 = getRightMovingCode(kMod8, resiBitsLength);
-				int leftMovSteps = -rightMovSteps;
-				rightMovSteps = 8 - leftMovSteps;
-				resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-				p++;
-				resiBits = resiBits
-						| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-			} else // rightMovSteps == 0
-			{
-				int code = getRightMovingCode(kMod8, resiBitsLength);
-				resiBits = (tdps->residualMidBits[p] & code);
-				p++;
-			}
-			k += resiBitsLength;
-		}
-
-		// recover the exact data
-		memset(curBytes, 0, 4);
-		leadingNum = leadNum[l++];
-		memcpy(curBytes, preBytes, leadingNum);
-		for (j = leadingNum; j < reqBytesLength; j++)
-			curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-		if (resiBitsLength != 0) {
-			unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-			curBytes[reqBytesLength] = resiByte;
-		}
-		exactData = bytesToFloat(curBytes);
-		(*data)[index] = exactData + medianValue;
-		memcpy(preBytes,curBytes,4);
+		(*data)[index] = unpredData[l++];
 
 		/* Process Row-0, data 1 */
 		index = ll*r234+1;
@@ -1234,46 +573,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 		}
 		else
 		{
-			// compute resiBits
-			resiBits = 0;
-			if (resiBitsLength != 0) {
-				int kMod8 = k % 8;
-				int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-				if (rightMovSteps > 0) {
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-				} else if (rightMovSteps < 0) {
-					int code1 = getLeftMovingCode(kMod8);
-					int code2 = getRightMovingCode(kMod8, resiBitsLength);
-					int leftMovSteps = -rightMovSteps;
-					rightMovSteps = 8 - leftMovSteps;
-					resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-					p++;
-					resiBits = resiBits
-							| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-				} else // rightMovSteps == 0
-				{
-					int code = getRightMovingCode(kMod8, resiBitsLength);
-					resiBits = (tdps->residualMidBits[p] & code);
-					p++;
-				}
-				k += resiBitsLength;
-			}
-
-			// recover the exact data
-			memset(curBytes, 0, 4);
-			leadingNum = leadNum[l++];
-			memcpy(curBytes, preBytes, leadingNum);
-			for (j = leadingNum; j < reqBytesLength; j++)
-				curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-			if (resiBitsLength != 0) {
-				unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-				curBytes[reqBytesLength] = resiByte;
-			}
-
-			exactData = bytesToFloat(curBytes);
-			(*data)[index] = exactData + medianValue;
-			memcpy(preBytes,curBytes,4);
+			(*data)[index] = unpredData[l++];
 		}
 
 		/* Process Row-0, data 2 --> data r4-1 */
@@ -1290,104 +590,26 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 		}
 
-		/* Process Row-1 --> Row-r3-1 */
-		for (ii = 1; ii < r3; ii++)
-		{
-			/* Process row-ii data 0 */
-			index = ll*r234+ii*r4;
-
-			pred1D = (*data)[index-r4];
-
-			type_ = type[index];
-			if (type_ != 0)
-			{
-				(*data)[index] = pred1D + 2 * (type_ - exe_params->intvRadius) * realPrecision;
-			}
-			else
-			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
+		/* Process Row-1 --> Row-r3-1 */
+		for (ii = 1; ii < r3; ii++)
+		{
+			/* Process row-ii data 0 */
+			index = ll*r234+ii*r4;
 
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+			pred1D = (*data)[index-r4];
+
+			type_ = type[index];
+			if (type_ != 0)
+			{
+				(*data)[index] = pred1D + 2 * (type_ - exe_params->intvRadius) * realPrecision;
+			}
+			else
+			{
+				(*data)[index] = unpredData[l++];
 			}
 
 			/* Process row-ii data 1 --> r4-1*/
@@ -1404,46 +626,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 				}
 				else
 				{
-					// compute resiBits
-					resiBits = 0;
-					if (resiBitsLength != 0) {
-						int kMod8 = k % 8;
-						int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-						if (rightMovSteps > 0) {
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-						} else if (rightMovSteps < 0) {
-							int code1 = getLeftMovingCode(kMod8);
-							int code2 = getRightMovingCode(kMod8, resiBitsLength);
-							int leftMovSteps = -rightMovSteps;
-							rightMovSteps = 8 - leftMovSteps;
-							resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-							p++;
-							resiBits = resiBits
-									| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-						} else // rightMovSteps == 0
-						{
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code);
-							p++;
-						}
-						k += resiBitsLength;
-					}
-
-					// recover the exact data
-					memset(curBytes, 0, 4);
-					leadingNum = leadNum[l++];
-					memcpy(curBytes, preBytes, leadingNum);
-					for (j = leadingNum; j < reqBytesLength; j++)
-						curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-					if (resiBitsLength != 0) {
-						unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-						curBytes[reqBytesLength] = resiByte;
-					}
-
-					exactData = bytesToFloat(curBytes);
-					(*data)[index] = exactData + medianValue;
-					memcpy(preBytes,curBytes,4);
+					(*data)[index] = unpredData[l++];
 				}
 			}
 		}
@@ -1464,46 +647,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 			}
 			else
 			{
-				// compute resiBits
-				resiBits = 0;
-				if (resiBitsLength != 0) {
-					int kMod8 = k % 8;
-					int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-					if (rightMovSteps > 0) {
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-					} else if (rightMovSteps < 0) {
-						int code1 = getLeftMovingCode(kMod8);
-						int code2 = getRightMovingCode(kMod8, resiBitsLength);
-						int leftMovSteps = -rightMovSteps;
-						rightMovSteps = 8 - leftMovSteps;
-						resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-						p++;
-						resiBits = resiBits
-								| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-					} else // rightMovSteps == 0
-					{
-						int code = getRightMovingCode(kMod8, resiBitsLength);
-						resiBits = (tdps->residualMidBits[p] & code);
-						p++;
-					}
-					k += resiBitsLength;
-				}
-
-				// recover the exact data
-				memset(curBytes, 0, 4);
-				leadingNum = leadNum[l++];
-				memcpy(curBytes, preBytes, leadingNum);
-				for (j = leadingNum; j < reqBytesLength; j++)
-					curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-				if (resiBitsLength != 0) {
-					unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-					curBytes[reqBytesLength] = resiByte;
-				}
-
-				exactData = bytesToFloat(curBytes);
-				(*data)[index] = exactData + medianValue;
-				memcpy(preBytes,curBytes,4);
+				(*data)[index] = unpredData[l++];
 			}
 
 			/* Process Row-0 data 1 --> data r4-1 */
@@ -1520,46 +664,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 				}
 				else
 				{
-					// compute resiBits
-					resiBits = 0;
-					if (resiBitsLength != 0) {
-						int kMod8 = k % 8;
-						int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-						if (rightMovSteps > 0) {
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-						} else if (rightMovSteps < 0) {
-							int code1 = getLeftMovingCode(kMod8);
-							int code2 = getRightMovingCode(kMod8, resiBitsLength);
-							int leftMovSteps = -rightMovSteps;
-							rightMovSteps = 8 - leftMovSteps;
-							resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-							p++;
-							resiBits = resiBits
-									| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-						} else // rightMovSteps == 0
-						{
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code);
-							p++;
-						}
-						k += resiBitsLength;
-					}
-
-					// recover the exact data
-					memset(curBytes, 0, 4);
-					leadingNum = leadNum[l++];
-					memcpy(curBytes, preBytes, leadingNum);
-					for (j = leadingNum; j < reqBytesLength; j++)
-						curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-					if (resiBitsLength != 0) {
-						unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-						curBytes[reqBytesLength] = resiByte;
-					}
-
-					exactData = bytesToFloat(curBytes);
-					(*data)[index] = exactData + medianValue;
-					memcpy(preBytes,curBytes,4);
+					(*data)[index] = unpredData[l++];
 				}
 			}
 
@@ -1578,46 +683,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 				}
 				else
 				{
-					// compute resiBits
-					resiBits = 0;
-					if (resiBitsLength != 0) {
-						int kMod8 = k % 8;
-						int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-						if (rightMovSteps > 0) {
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-						} else if (rightMovSteps < 0) {
-							int code1 = getLeftMovingCode(kMod8);
-							int code2 = getRightMovingCode(kMod8, resiBitsLength);
-							int leftMovSteps = -rightMovSteps;
-							rightMovSteps = 8 - leftMovSteps;
-							resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-							p++;
-							resiBits = resiBits
-									| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-						} else // rightMovSteps == 0
-						{
-							int code = getRightMovingCode(kMod8, resiBitsLength);
-							resiBits = (tdps->residualMidBits[p] & code);
-							p++;
-						}
-						k += resiBitsLength;
-					}
-
-					// recover the exact data
-					memset(curBytes, 0, 4);
-					leadingNum = leadNum[l++];
-					memcpy(curBytes, preBytes, leadingNum);
-					for (j = leadingNum; j < reqBytesLength; j++)
-						curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-					if (resiBitsLength != 0) {
-						unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-						curBytes[reqBytesLength] = resiByte;
-					}
-
-					exactData = bytesToFloat(curBytes);
-					(*data)[index] = exactData + medianValue;
-					memcpy(preBytes,curBytes,4);
+					(*data)[index] = unpredData[l++];
 				}
 
 				/* Process Row-i data 1 --> data r4-1 */
@@ -1636,46 +702,7 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 					}
 					else
 					{
-						// compute resiBits
-						resiBits = 0;
-						if (resiBitsLength != 0) {
-							int kMod8 = k % 8;
-							int rightMovSteps = getRightMovingSteps(kMod8, resiBitsLength);
-							if (rightMovSteps > 0) {
-								int code = getRightMovingCode(kMod8, resiBitsLength);
-								resiBits = (tdps->residualMidBits[p] & code) >> rightMovSteps;
-							} else if (rightMovSteps < 0) {
-								int code1 = getLeftMovingCode(kMod8);
-								int code2 = getRightMovingCode(kMod8, resiBitsLength);
-								int leftMovSteps = -rightMovSteps;
-								rightMovSteps = 8 - leftMovSteps;
-								resiBits = (tdps->residualMidBits[p] & code1) << leftMovSteps;
-								p++;
-								resiBits = resiBits
-										| ((tdps->residualMidBits[p] & code2) >> rightMovSteps);
-							} else // rightMovSteps == 0
-							{
-								int code = getRightMovingCode(kMod8, resiBitsLength);
-								resiBits = (tdps->residualMidBits[p] & code);
-								p++;
-							}
-							k += resiBitsLength;
-						}
-
-						// recover the exact data
-						memset(curBytes, 0, 4);
-						leadingNum = leadNum[l++];
-						memcpy(curBytes, preBytes, leadingNum);
-						for (j = leadingNum; j < reqBytesLength; j++)
-							curBytes[j] = tdps->exactMidBytes[curByteIndex++];
-						if (resiBitsLength != 0) {
-							unsigned char resiByte = (unsigned char) (resiBits << (8 - resiBitsLength));
-							curBytes[reqBytesLength] = resiByte;
-						}
-
-						exactData = bytesToFloat(curBytes);
-						(*data)[index] = exactData + medianValue;
-						memcpy(preBytes,curBytes,4);
+						(*data)[index] = unpredData[l++];
 					}
 				}
 			}
@@ -1683,13 +710,8 @@ void decompressDataSeries_float_4D(float** data, size_t r1, size_t r2, size_t r3
 		}
 	}
 
-//I didn't implement time-based compression for 4D actually. 
-//#ifdef HAVE_TIMECMPR	
-//	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-//		memcpy(multisteps->hist_data, (*data), dataSeriesLength*sizeof(float));
-//#endif	
 
-	free(leadNum);
+	free(unpredData);
 	free(type);
 	return;
 }
@@ -1711,8 +733,16 @@ void decompressDataSeries_float_1D_MSST19(float** data, size_t dataSeriesLength,
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 	
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
+	int treeStatus = decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
 	
@@ -1789,10 +819,6 @@ void decompressDataSeries_float_1D_MSST19(float** data, size_t dataSeriesLength,
 		//printf("%.30G\n",(*data)[i]);
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(multisteps->hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif	
 	free(precisionTable);
 	free(leadNum);
 	free(type);
@@ -1819,8 +845,16 @@ void decompressDataSeries_float_2D_MSST19(float** data, size_t r1, size_t r2, Ti
     int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
+	int treeStatus = decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
@@ -2108,10 +1142,6 @@ void decompressDataSeries_float_2D_MSST19(float** data, size_t r1, size_t r2, Ti
 		}
 	}
 
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(multisteps->hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif	
 
 	free(leadNum);
 	free(type);
@@ -2143,8 +1173,17 @@ void decompressDataSeries_float_3D_MSST19(float** data, size_t r1, size_t r2, si
 	}
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
+	int treeStatus = decode_withTree_MSST19(huffmanTree, tdps->typeArray, dataSeriesLength, type, tdps->max_bits);
 	SZ_ReleaseHuffman(huffmanTree);
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(precisionTable);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
@@ -2663,10 +1702,6 @@ void decompressDataSeries_float_3D_MSST19(float** data, size_t r1, size_t r2, si
 		}
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(multisteps->hist_data, (*data), dataSeriesLength*sizeof(float));
-#endif		
 
 	free(leadNum);
 	free(type);
@@ -3458,10 +2493,6 @@ void decompressDataSeries_float_2D_nonblocked_with_blocked_regression(float** da
 		}
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(hist_data, (*data), num_elements*sizeof(float));
-#endif	
 	
 	free(coeff_result_type);
 
@@ -5844,10 +4875,6 @@ void decompressDataSeries_float_3D_nonblocked_with_blocked_regression(float** da
 		}
 	}
 	
-#ifdef HAVE_TIMECMPR	
-	if(confparams_dec->szMode == SZ_TEMPORAL_COMPRESSION)
-		memcpy(hist_data, (*data), num_elements*sizeof(float));
-#endif	
 
 	free(coeff_result_type);
 
@@ -7708,3 +6735,128 @@ unsigned char* cmpBytes, size_t cmpSize)
 	return status;
 }
 #endif
+
+
+/**
+ * Decode only the regression coefficients of the 3D blocked-regression format (no residual is decoded).
+ *
+ * @param coeffs the 4 coefficients of every block (block by block, as in the stream)
+ * @param block_size the nominal block size of the stream
+ * @return SZ_SCES, or SZ_NSCS if some blocks are predicted by Lorenzo: their values need the whole decompression
+ * */
+int decompressDataSeries_float_3D_regression_coefficients(double** coeffs, size_t* block_size, size_t r1, size_t r2, size_t r3, unsigned char* comp_data)
+{
+	unsigned char * comp_data_pos = comp_data;
+
+	*block_size = bytesToInt_bigEndian(comp_data_pos);
+	comp_data_pos += sizeof(int);
+	size_t num_x, num_y, num_z;
+	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r1, num_x, *block_size);
+	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r2, num_y, *block_size);
+	SZ_COMPUTE_3D_NUMBER_OF_BLOCKS(r3, num_z, *block_size);
+	size_t num_blocks = num_x * num_y * num_z;
+
+	comp_data_pos += sizeof(float) + sizeof(int); //realPrecision, intervals
+	unsigned int tree_size = bytesToInt_bigEndian(comp_data_pos);
+	comp_data_pos += sizeof(int) + sizeof(int) + tree_size; //the Huffman tree of the residuals is not needed
+	comp_data_pos += sizeof(unsigned char) + sizeof(float); //use_mean, mean
+
+	unsigned char * indicator;
+	size_t indicator_bitlength = (num_blocks - 1)/8 + 1;
+	convertByteArray2IntArray_fast_1b(num_blocks, comp_data_pos, indicator_bitlength, &indicator);
+	comp_data_pos += indicator_bitlength;
+	for(size_t i=0; i<num_blocks; i++){
+		if(indicator[i]){
+			free(indicator);
+			return SZ_NSCS;
+		}
+	}
+	free(indicator);
+
+	int coeff_intvRadius[4];
+	int * coeff_result_type = (int *) malloc(num_blocks*4*sizeof(int));
+	int * coeff_type[4];
+	float precision[4];
+	float * coeff_unpred_data[4];
+	for(int i=0; i<4; i++){
+		precision[i] = bytesToFloat(comp_data_pos);
+		comp_data_pos += sizeof(float);
+		coeff_intvRadius[i] = bytesToInt_bigEndian(comp_data_pos);
+		comp_data_pos += sizeof(int);
+		unsigned int tree_size = bytesToInt_bigEndian(comp_data_pos);
+		comp_data_pos += sizeof(int);
+		int stateNum = 2*coeff_intvRadius[i]*2;
+		HuffmanTree* huffmanTree = createHuffmanTree(stateNum);
+		int nodeCount = bytesToInt_bigEndian(comp_data_pos);
+		node root = reconstruct_HuffTree_from_bytes_anyStates(huffmanTree, comp_data_pos+sizeof(int), nodeCount);
+		comp_data_pos += sizeof(int) + tree_size;
+
+		coeff_type[i] = coeff_result_type + i * num_blocks;
+		size_t typeArray_size = bytesToSize(comp_data_pos);
+		decode(comp_data_pos + sizeof(size_t), num_blocks, root, coeff_type[i]);
+		comp_data_pos += sizeof(size_t) + typeArray_size;
+		int coeff_unpred_count = bytesToInt_bigEndian(comp_data_pos);
+		comp_data_pos += sizeof(int);
+		coeff_unpred_data[i] = (float *) comp_data_pos;
+		comp_data_pos += coeff_unpred_count * sizeof(float);
+		SZ_ReleaseHuffman(huffmanTree);
+	}
+
+	//the same reconstruction as in decompressDataSeries_float_3D_nonblocked_with_blocked_regression()
+	*coeffs = (double *) malloc(num_blocks*4*sizeof(double));
+	float last_coefficients[4] = {0.0};
+	int coeff_unpred_data_count[4] = {0};
+	int type_;
+	for(size_t b=0; b<num_blocks; b++){
+		for(int e=0; e<4; e++){
+			type_ = coeff_type[e][b];
+			if (type_ != 0)
+				last_coefficients[e] = last_coefficients[e] + 2 * (type_ - coeff_intvRadius[e]) * precision[e];
+			else{
+				last_coefficients[e] = coeff_unpred_data[e][coeff_unpred_data_count[e]];
+				coeff_unpred_data_count[e] ++;
+			}
+			(*coeffs)[4*b+e] = last_coefficients[e];
+		}
+	}
+	free(coeff_result_type);
+	return SZ_SCES;
+}
+
+
+/**
+ * The regression coefficients of a 3D float stream, see decompressDataSeries_float_3D_regression_coefficients().
+ *
+ * @return SZ_SCES, or SZ_NSCS if the stream does not hold all its blocks as regression coefficients
+ * */
+int SZ_decompress_args_regression_coefficients_float(double** coeffs, size_t* blockSize, size_t r3, size_t r2, size_t r1, unsigned char* cmpBytes, size_t cmpSize)
+{
+	int status = SZ_NSCS;
+	size_t targetUncompressSize = r3*r2*r1*sizeof(float);
+	size_t tmpSize = cmpSize;
+	unsigned char* szTmpBytes = cmpBytes;
+
+	if(cmpSize!=8+4+MetaDataByteLength && cmpSize!=8+8+MetaDataByteLength) //4,8 means two posibilities of SZ_SIZE_TYPE
+	{
+		confparams_dec->losslessCompressor = is_lossless_compressed_data(cmpBytes, cmpSize);
+		confparams_dec->szMode = confparams_dec->losslessCompressor!=-1 ? SZ_BEST_COMPRESSION : SZ_BEST_SPEED;
+		if(confparams_dec->szMode==SZ_BEST_COMPRESSION)
+		{
+			if(targetUncompressSize<MIN_ZLIB_DEC_ALLOMEM_BYTES) //Considering the minimum size
+				targetUncompressSize = MIN_ZLIB_DEC_ALLOMEM_BYTES;
+			tmpSize = sz_lossless_decompress(confparams_dec->losslessCompressor, cmpBytes, (unsigned long)cmpSize, &szTmpBytes, (unsigned long)targetUncompressSize+4+MetaDataByteLength+exe_params->SZ_SIZE_TYPE);
+		}
+	}
+	else
+		return SZ_NSCS; //constant data
+
+	TightDataPointStorageF* tdps;
+	new_TightDataPointStorageF_fromFlatBytes(&tdps, szTmpBytes, tmpSize);
+	if(!tdps->isLossless && szTmpBytes[4+14]==SZ && tdps->raBytes_size > 0)
+		status = decompressDataSeries_float_3D_regression_coefficients(coeffs, blockSize, r3, r2, r1, tdps->raBytes);
+
+	free_TightDataPointStorageF2(tdps);
+	if(szTmpBytes != cmpBytes)
+		free(szTmpBytes);
+	return status;
+}
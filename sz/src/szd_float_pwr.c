@@ -14,6 +14,7 @@
 #include "TightDataPointStorageF.h"
 #include "CompressElement.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 #include "sz_float_pwr.h"
 #include "utility.h"
@@ -42,8 +43,16 @@ void decompressDataSeries_float_1D_pwr(float** data, size_t dataSeriesLength, Ti
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	//sdi:Debug
 	//writeUShortData(type, dataSeriesLength, "decompressStateBytes.sb");
@@ -178,8 +187,16 @@ void decompressDataSeries_float_2D_pwr(float** data, size_t r1, size_t r2, Tight
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
@@ -557,8 +574,16 @@ void decompressDataSeries_float_3D_pwr(float** data, size_t r1, size_t r2, size_
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
@@ -1197,14 +1222,34 @@ void decompressDataSeries_float_1D_pwrgroup(float** data, size_t dataSeriesLengt
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 	
 	createRangeGroups_float(&posGroups, &negGroups, &posFlags, &negFlags);
 	
 	float realGroupPrecision;
 	float realPrecision = tdps->realPrecision;
 	char* groupID = decompressGroupIDArray(tdps->pwrErrBoundBytes, tdps->dataSeriesLength);
+	if(groupID == NULL)
+	{
+		free(posGroups);
+		free(negGroups);
+		free(posFlags);
+		free(negFlags);
+		free(leadNum);
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 	
 	//note that the groupID values here are [1,2,3,....,18] or [-1,-2,...,-18]
 	
@@ -1354,6 +1399,8 @@ void decompressDataSeries_float_1D_pwrgroup(float** data, size_t dataSeriesLengt
 void decompressDataSeries_float_1D_pwr_pre_log(float** data, size_t dataSeriesLength, TightDataPointStorageF* tdps) {
 
 	decompressDataSeries_float_1D(data, dataSeriesLength, NULL, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1378,6 +1425,8 @@ void decompressDataSeries_float_2D_pwr_pre_log(float** data, size_t r1, size_t r
 
 	size_t dataSeriesLength = r1 * r2;
 	decompressDataSeries_float_2D(data, r1, r2, NULL, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1402,6 +1451,8 @@ void decompressDataSeries_float_3D_pwr_pre_log(float** data, size_t r1, size_t r
 
 	size_t dataSeriesLength = r1 * r2 * r3;
 	decompressDataSeries_float_3D(data, r1, r2, r3, NULL, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
@@ -1425,6 +1476,8 @@ void decompressDataSeries_float_3D_pwr_pre_log(float** data, size_t r1, size_t r
 void decompressDataSeries_float_1D_pwr_pre_log_MSST19(float** data, size_t dataSeriesLength, TightDataPointStorageF* tdps) 
 {
 	decompressDataSeries_float_1D_MSST19(data, dataSeriesLength, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	uint32_t* ptr;
 
@@ -1460,6 +1513,8 @@ void decompressDataSeries_float_2D_pwr_pre_log_MSST19(float** data, size_t r1, s
 
 	size_t dataSeriesLength = r1 * r2;
 	decompressDataSeries_float_2D_MSST19(data, r1, r2, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	uint32_t* ptr;
 
@@ -1495,6 +1550,8 @@ void decompressDataSeries_float_3D_pwr_pre_log_MSST19(float** data, size_t r1, s
 
 	size_t dataSeriesLength = r1 * r2 * r3;
 	decompressDataSeries_float_3D_MSST19(data, r1, r2, r3, tdps);
+	if(*data == NULL)
+		return;
 	float threshold = tdps->minLogValue;
 	if(tdps->pwrErrBoundBytes_size > 0){
 		unsigned char * signs;
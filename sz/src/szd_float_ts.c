@@ -13,6 +13,7 @@
 #include "szd_float.h"
 #include "TightDataPointStorageF.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "Huffman.h"
 #include "szd_float_ts.h"
 
@@ -34,8 +35,16 @@ void decompressDataSeries_float_1D_ts(float** data, size_t dataSeriesLength, flo
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 	
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(leadNum);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	unsigned char preBytes[4];
 	unsigned char curBytes[4];
@@ -107,8 +116,6 @@ void decompressDataSeries_float_1D_ts(float** data, size_t dataSeriesLength, flo
 		//printf("%.30G\n",(*data)[i]);
 	}
 	
-	memcpy(hist_data, (*data), dataSeriesLength*sizeof(float));
-	
 	free(leadNum);
 	free(type);
 	return;
@@ -13,6 +13,7 @@
 #include <math.h>
 #include "TightDataPointStorageI.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "szd_int16.h"
 #include "Huffman.h"
 #include "utility.h"
@@ -107,6 +108,9 @@ int SZ_decompress_args_int16(int16_t** newData, size_t r5, size_t r4, size_t r3,
 		}		
 	}	
 
+	if(status == SZ_SCES && *newData == NULL)
+		status = SZ_DERR; //e.g., the Huffman tree of the stream is not in the dictionary
+
 	free_TightDataPointStorageI2(tdps);
 	if(confparams_dec->szMode!=SZ_BEST_SPEED && cmpSize!=4+sizeof(int16_t)+exe_params->SZ_SIZE_TYPE+MetaDataByteLength)
 		free(szTmpBytes);
@@ -125,8 +129,15 @@ void decompressDataSeries_int16_1D(int16_t** data, size_t dataSeriesLength, Tigh
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	//sdi:Debug
 	//writeUShortData(type, dataSeriesLength, "decompressStateBytes.sb");
@@ -192,8 +203,15 @@ void decompressDataSeries_int16_2D(int16_t** data, size_t r1, size_t r2, TightDa
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int16_t minValue, exactData;
 
@@ -342,8 +360,15 @@ void decompressDataSeries_int16_3D(int16_t** data, size_t r1, size_t r2, size_t
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int16_t minValue, exactData;
 
@@ -602,8 +627,15 @@ void decompressDataSeries_int16_4D(int16_t** data, size_t r1, size_t r2, size_t
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int16_t minValue, exactData;
 
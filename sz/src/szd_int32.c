@@ -13,6 +13,7 @@
 #include <math.h>
 #include "TightDataPointStorageI.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "szd_int32.h"
 #include "Huffman.h"
 #include "utility.h"
@@ -99,6 +100,9 @@ int SZ_decompress_args_int32(int32_t** newData, size_t r5, size_t r4, size_t r3,
 		printf("Error: currently support only at most 4 dimensions!\n");
 		status = SZ_DERR;
 	}
+	if(status == SZ_SCES && *newData == NULL)
+		status = SZ_DERR; //e.g., the Huffman tree of the stream is not in the dictionary
+
 	free_TightDataPointStorageI2(tdps);
 	if(confparams_dec->szMode!=SZ_BEST_SPEED && cmpSize!=4+sizeof(int32_t)+exe_params->SZ_SIZE_TYPE+MetaDataByteLength)
 		free(szTmpBytes);
@@ -117,8 +121,15 @@ void decompressDataSeries_int32_1D(int32_t** data, size_t dataSeriesLength, Tigh
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	//sdi:Debug
 	//writeUShortData(type, dataSeriesLength, "decompressStateBytes.sb");
@@ -177,8 +188,15 @@ void decompressDataSeries_int32_2D(int32_t** data, size_t r1, size_t r2, TightDa
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int32_t minValue, exactData;
 
@@ -302,8 +320,15 @@ void decompressDataSeries_int32_3D(int32_t** data, size_t r1, size_t r2, size_t
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int32_t minValue, exactData;
 
@@ -515,8 +540,15 @@ void decompressDataSeries_int32_4D(int32_t** data, size_t r1, size_t r2, size_t
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int32_t minValue, exactData;
 
@@ -13,6 +13,7 @@
 #include <math.h>
 #include "TightDataPointStorageI.h"
 #include "sz.h"
+#include "sz_tctx.h"
 #include "szd_int8.h"
 #include "Huffman.h"
 #include "utility.h"
@@ -99,6 +100,9 @@ int SZ_decompress_args_int8(int8_t** newData, size_t r5, size_t r4, size_t r3, s
 		printf("Error: currently support only at most 4 dimensions!\n");
 		status = SZ_DERR;
 	}
+	if(status == SZ_SCES && *newData == NULL)
+		status = SZ_DERR; //e.g., the Huffman tree of the stream is not in the dictionary
+
 	free_TightDataPointStorageI2(tdps);
 	if(confparams_dec->szMode!=SZ_BEST_SPEED && cmpSize!=4+sizeof(int8_t)+exe_params->SZ_SIZE_TYPE+MetaDataByteLength)
 		free(szTmpBytes);
@@ -116,8 +120,15 @@ void decompressDataSeries_int8_1D(int8_t** data, size_t dataSeriesLength, TightD
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	//sdi:Debug
 	//writeUShortData(type, dataSeriesLength, "decompressStateBytes.sb");
@@ -183,8 +194,15 @@ void decompressDataSeries_int8_2D(int8_t** data, size_t r1, size_t r2, TightData
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int8_t minValue, exactData;
 
@@ -333,8 +351,15 @@ void decompressDataSeries_int8_3D(int8_t** data, size_t r1, size_t r2, size_t r3
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int8_t minValue, exactData;
 
@@ -593,8 +618,15 @@ void decompressDataSeries_int8_4D(int8_t** data, size_t r1, size_t r2, size_t r3
 	int* type = (int*)malloc(dataSeriesLength*sizeof(int));
 
 	HuffmanTree* huffmanTree = createHuffmanTree(tdps->stateNum);
-	decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
+	int treeStatus = decode_withTree(huffmanTree, tdps->typeArray, dataSeriesLength, type);
 	SZ_ReleaseHuffman(huffmanTree);	
+	if(treeStatus != SZ_SCES)
+	{
+		free(type);
+		free(*data);
+		*data = NULL;
+		return;
+	}
 
 	int8_t minValue, exactData;
 
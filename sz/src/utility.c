@@ -155,6 +155,8 @@ float calculate_delta_t(size_t size){
 
 int is_lossless_compressed_data(unsigned char* compressedBytes, size_t cmpSize)
 {
+	if(sz_sections_is_sectioned(compressedBytes, cmpSize))
+		return SECTIONED_COMPRESSOR;
 #if ZSTD_VERSION_NUMBER >= 10300
 	unsigned long long frameContentSize = ZSTD_getFrameContentSize(compressedBytes, cmpSize);
 	if(frameContentSize != ZSTD_CONTENTSIZE_ERROR)
@@ -173,8 +175,16 @@ int is_lossless_compressed_data(unsigned char* compressedBytes, size_t cmpSize)
 
 unsigned long sz_lossless_compress(int losslessCompressor, int level, unsigned char* data, unsigned long dataLength, unsigned char** compressBytes)
 {
+	double statsStart = sz_stats_clock();
 	unsigned long outSize = 0; 
 	size_t estimatedCompressedSize = 0;
+	sz_sections_layout* layout = sz_sections_find(data, dataLength);
+	if(layout != NULL && (losslessCompressor == GZIP_COMPRESSOR || losslessCompressor == ZSTD_COMPRESSOR))
+	{
+		outSize = sz_sections_compress(layout, losslessCompressor, level, data, dataLength, compressBytes);
+		sz_stats_add(SZ_STAGE_LOSSLESS, statsStart, dataLength, outSize);
+		return outSize;
+	}
 	switch(losslessCompressor)
 	{
 	case GZIP_COMPRESSOR:
@@ -186,14 +196,69 @@ unsigned long sz_lossless_compress(int losslessCompressor, int level, unsigned c
 		else
 			estimatedCompressedSize = dataLength*1.2;
 		*compressBytes = (unsigned char*)malloc(estimatedCompressedSize);
-		outSize = ZSTD_compress(*compressBytes, estimatedCompressedSize, data, dataLength, level); //default setting of level is 3
+		if(sz_zstd_dict_current() != NULL)
+			outSize = sz_zstd_dict_compress(sz_zstd_dict_current(), *compressBytes, estimatedCompressedSize, data, dataLength, level);
+		else
+			outSize = ZSTD_compress(*compressBytes, estimatedCompressedSize, data, dataLength, level); //default setting of level is 3
 		break;
 	default:
 		printf("Error: Unrecognized lossless compressor in sz_lossless_compress()\n");
 	}
+	sz_stats_add(SZ_STAGE_LOSSLESS, statsStart, dataLength, outSize);
 	return outSize;
 }
 
+/**
+ * Decide whether to skip the lossless stage of a compression: it is skipped if a trial compression of
+ * SZ_LOSSLESS_TRIAL_CHUNKS chunks spread over its input saves less than params->losslessMinGain of their
+ * size, which is common for the high-entropy Huffman codes of noisy data. The decision is recorded in
+ * the header of the SZ bytes, whose szMode becomes SZ_BEST_SPEED: the decompressors then take them as is
+ * (they tell them from the Zstd and Gzip streams by the magic numbers of the latter).
+ *
+ * @param data the SZ bytes (the input of the lossless stage), whose header is updated if the stage is skipped
+ * @return 1 if the lossless stage is skipped (only in the SZ_BEST_COMPRESSION and SZ_DEFAULT_COMPRESSION modes)
+ * */
+int sz_lossless_skip(struct sz_params* params, unsigned char* data, unsigned long dataLength)
+{
+	if(params->szMode != SZ_BEST_COMPRESSION && params->szMode != SZ_DEFAULT_COMPRESSION)
+		return 0;
+	//the small inputs are cheap to compress, a dictionary is trained for the gain it brings, and the
+	//sectioned lossless stage decides section by section
+	if(params->losslessMinGain <= 0 || dataLength < SZ_LOSSLESS_TRIAL_MIN_LENGTH || sz_zstd_dict_current() != NULL
+	|| sz_sections_find(data, dataLength) != NULL)
+		return 0;
+	double statsStart = sz_stats_clock();
+	size_t i, step = dataLength/SZ_LOSSLESS_TRIAL_CHUNKS, sampleSize = SZ_LOSSLESS_TRIAL_CHUNKS*SZ_LOSSLESS_TRIAL_CHUNK;
+	size_t bound = ZSTD_compressBound(SZ_LOSSLESS_TRIAL_CHUNK);
+	unsigned char* trialBytes = params->losslessCompressor == GZIP_COMPRESSOR ? NULL : (unsigned char*)malloc(bound);
+	unsigned long trialSize = 0;
+	/*Each chunk is compressed on its own: the sections of the SZ bytes (Huffman tree and codes, regression
+	 * coefficients, unpredictable data) differ in entropy, and the literals of a Zstd or Gzip block are coded
+	 * with the statistics of the whole block. The chunks are in the middle of the slices of the input.*/
+	for(i = 0; i < SZ_LOSSLESS_TRIAL_CHUNKS; i++)
+	{
+		unsigned char* chunk = data + i*step + (step - SZ_LOSSLESS_TRIAL_CHUNK)/2;
+		if(params->losslessCompressor == GZIP_COMPRESSOR)
+		{
+			trialSize += zlib_compress5(chunk, SZ_LOSSLESS_TRIAL_CHUNK, &trialBytes, params->gzipMode);
+			free(trialBytes);
+		}
+		else
+		{
+			size_t chunkSize = ZSTD_compress(trialBytes, bound, chunk, SZ_LOSSLESS_TRIAL_CHUNK, params->gzipMode);
+			trialSize += ZSTD_isError(chunkSize) ? SZ_LOSSLESS_TRIAL_CHUNK : chunkSize;
+		}
+	}
+	if(params->losslessCompressor != GZIP_COMPRESSOR)
+		free(trialBytes);
+	sz_stats_add(SZ_STAGE_LOSSLESS, statsStart, 0, 0);
+	if(trialSize <= sampleSize*(1 - params->losslessMinGain))
+		return 0;
+	//flag1 of the parameters (see convertSZParamsToBytes), after the version (3 bytes) and sameByte (1 byte)
+	data[4] = (data[4] & ~0x0c) | (SZ_BEST_SPEED << 2);
+	return 1;
+}
+
 unsigned long sz_lossless_decompress(int losslessCompressor, unsigned char* compressBytes, unsigned long cmpSize, unsigned char** oriData, unsigned long targetOriSize)
 {
 	unsigned long outSize = 0;
@@ -204,9 +269,15 @@ unsigned long sz_lossless_decompress(int losslessCompressor, unsigned char* comp
 		break;
 	case ZSTD_COMPRESSOR:
 		*oriData = (unsigned char*)malloc(targetOriSize);
-		ZSTD_decompress(*oriData, targetOriSize, compressBytes, cmpSize);
+		if(sz_zstd_dict_current() != NULL)
+			sz_zstd_dict_decompress(sz_zstd_dict_current(), *oriData, targetOriSize, compressBytes, cmpSize);
+		else
+			ZSTD_decompress(*oriData, targetOriSize, compressBytes, cmpSize);
 		outSize = targetOriSize;
 		break;
+	case SECTIONED_COMPRESSOR:
+		outSize = sz_sections_decompress(compressBytes, cmpSize, oriData);
+		break;
 	default:
 		printf("Error: Unrecognized lossless compressor in sz_lossless_decompress()\n");
 	}
@@ -224,428 +295,150 @@ unsigned long sz_lossless_decompress65536bytes(int losslessCompressor, unsigned
 	case ZSTD_COMPRESSOR:
 		*oriData = (unsigned char*)malloc(65536);
 		memset(*oriData, 0, 65536);
-		ZSTD_decompress(*oriData, 65536, compressBytes, cmpSize);	//the first 32768 bytes should be exact the same.
+		if(sz_zstd_dict_current() != NULL)
+			sz_zstd_dict_decompress(sz_zstd_dict_current(), *oriData, 65536, compressBytes, cmpSize);
+		else
+			ZSTD_decompress(*oriData, 65536, compressBytes, cmpSize);	//the first 32768 bytes should be exact the same.
+		outSize = 65536;
+		break;
+	case SECTIONED_COMPRESSOR:
+	{
+		unsigned char* bytes = NULL;
+		unsigned long size = sz_sections_decompress(compressBytes, cmpSize, &bytes);
+		*oriData = (unsigned char*)malloc(65536);
+		memset(*oriData, 0, 65536);
+		memcpy(*oriData, bytes, size < 65536 ? size : 65536);
+		free(bytes);
 		outSize = 65536;
 		break;
+	}
 	default:
 		printf("Error: Unrecognized lossless compressor\n");
 	}
 	return outSize;
 }
 
-void* detransposeData(void* data, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+#define SZ_TRANSPOSE_TILE 32 //tiles of 32x32 elements (at most 8 KB) stay in the L1 cache
+
+#ifdef _OPENMP
+#define SZ_TRANSPOSE_PARALLEL_FOR _Pragma("omp parallel for schedule(static)")
+#else
+#define SZ_TRANSPOSE_PARALLEL_FOR
+#endif
+
+/**
+ * Define the tiled transpose of the rows x cols matrix src (row-major) into dst (cols x rows) for the elements
+ * of one integer type: the tiles are independent and shared among the threads, and the inner loop writes a
+ * contiguous run of dst, which the compiler vectorizes.
+ * */
+#define SZ_DEFINE_TRANSPOSE_TILES(NAME, TYPE) \
+static void NAME(const TYPE* src, TYPE* dst, size_t rows, size_t cols) \
+{ \
+	long long tile; \
+	size_t rowTiles = (rows + SZ_TRANSPOSE_TILE - 1)/SZ_TRANSPOSE_TILE; \
+	size_t colTiles = (cols + SZ_TRANSPOSE_TILE - 1)/SZ_TRANSPOSE_TILE; \
+	SZ_TRANSPOSE_PARALLEL_FOR \
+	for(tile = 0; tile < (long long)(rowTiles*colTiles); tile++) \
+	{ \
+		size_t i, j; \
+		size_t i0 = (tile/colTiles)*SZ_TRANSPOSE_TILE, j0 = (tile%colTiles)*SZ_TRANSPOSE_TILE; \
+		size_t i1 = i0 + SZ_TRANSPOSE_TILE < rows ? i0 + SZ_TRANSPOSE_TILE : rows; \
+		size_t j1 = j0 + SZ_TRANSPOSE_TILE < cols ? j0 + SZ_TRANSPOSE_TILE : cols; \
+		for(j = j0; j < j1; j++) \
+			for(i = i0; i < i1; i++) \
+				dst[j*rows + i] = src[i*cols + j]; \
+	} \
+}
+
+SZ_DEFINE_TRANSPOSE_TILES(transpose_tiles_8, uint8_t)
+SZ_DEFINE_TRANSPOSE_TILES(transpose_tiles_16, uint16_t)
+SZ_DEFINE_TRANSPOSE_TILES(transpose_tiles_32, uint32_t)
+SZ_DEFINE_TRANSPOSE_TILES(transpose_tiles_64, uint64_t)
+
+static size_t transpose_typeSize(int dataType)
 {
-	size_t len = computeDataLength(r5, r4, r3, r2, r1);
-	int dim = computeDimension(r5, r4, r3, r2, r1);
-	if(dataType == SZ_FLOAT)
+	switch(dataType)
 	{
-		float* ori_data = data;
-		float* new_data = (float*)malloc(sizeof(float)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(float)*len);
-			return new_data;			
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					//size_t s = i*r1+j;
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];					
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;
-			size_t B = r1*r2;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-					for(k=0;k<r3;k++)
-					{
-						size_t t = k*B+i*r1+j;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t i, j, k, w, s = 0;
-			size_t C = r2*r1;
-			size_t B = r3*C;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-						for(w=0;w<r4;w++)
-						{
-							size_t t = w*B+i*C+j*r1+k;
-							new_data[t] = ori_data[s++];
-						}
-		}
-		return new_data;
-	}
-	else if(dataType == SZ_DOUBLE)
-	{
-		double* ori_data = data;
-		double* new_data = (double*)malloc(sizeof(double)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(double)*len);
-			return new_data;			
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					//size_t s = i*r1+j;
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];					
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;
-			size_t B = r1*r2;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-					for(k=0;k<r3;k++)
-					{
-						size_t t = k*B+i*r1+j;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t i, j, k, w, s = 0;
-			size_t C = r2*r1;
-			size_t B = r3*C;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-						for(w=0;w<r4;w++)
-						{
-							size_t t = w*B+i*C+j*r1+k;
-							new_data[t] = ori_data[s++];
-						}
-		}
-		return new_data;		
-	}
-	else if(dataType == SZ_UINT16)
-	{
-		uint16_t* ori_data = data;
-		uint16_t* new_data = (uint16_t*)malloc(sizeof(uint16_t)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(uint16_t)*len);
-			return new_data;			
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					//size_t s = i*r1+j;
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];					
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;
-			size_t B = r1*r2;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-					for(k=0;k<r3;k++)
-					{
-						size_t t = k*B+i*r1+j;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t i, j, k, w, s = 0;
-			size_t C = r2*r1;
-			size_t B = r3*C;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-						for(w=0;w<r4;w++)
-						{
-							size_t t = w*B+i*C+j*r1+k;
-							new_data[t] = ori_data[s++];
-						}
-		}
-		return new_data;				
+	case SZ_UINT8:
+	case SZ_INT8:
+		return 1;
+	case SZ_UINT16:
+	case SZ_INT16:
+		return 2;
+	case SZ_FLOAT:
+	case SZ_UINT32:
+	case SZ_INT32:
+		return 4;
+	case SZ_DOUBLE:
+	case SZ_UINT64:
+	case SZ_INT64:
+		return 8;
+	default:
+		return 0;
 	}
-	else if(dataType == SZ_INT16)
+}
+
+/**
+ * Transpose the rows x cols matrix of data into a new array (cols x rows); the elements are only moved,
+ * so any type is handled by an integer type of its size.
+ *
+ * @return the new array, or NULL if the data type is not supported
+ * */
+static void* transposeMatrix(void* data, int dataType, size_t rows, size_t cols)
+{
+	size_t typeSize = transpose_typeSize(dataType);
+	if(typeSize == 0)
 	{
-		int16_t* ori_data = data;
-		int16_t* new_data = (int16_t*)malloc(sizeof(int16_t)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(int16_t)*len);
-			return new_data;			
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					//size_t s = i*r1+j;
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];					
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;
-			size_t B = r1*r2;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-					for(k=0;k<r3;k++)
-					{
-						size_t t = k*B+i*r1+j;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t i, j, k, w, s = 0;
-			size_t C = r2*r1;
-			size_t B = r3*C;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-						for(w=0;w<r4;w++)
-						{
-							size_t t = w*B+i*C+j*r1+k;
-							new_data[t] = ori_data[s++];
-						}
-		}
-		return new_data;			
+		printf("Error. transpose data doesn't support data type %d\n", dataType);
+		return NULL;
 	}
+	void* new_data = malloc(typeSize*rows*cols);
+	if(rows == 1 || cols == 1)
+		memcpy(new_data, data, typeSize*rows*cols);
+	else if(typeSize == 1)
+		transpose_tiles_8((uint8_t*)data, (uint8_t*)new_data, rows, cols);
+	else if(typeSize == 2)
+		transpose_tiles_16((uint16_t*)data, (uint16_t*)new_data, rows, cols);
+	else if(typeSize == 4)
+		transpose_tiles_32((uint32_t*)data, (uint32_t*)new_data, rows, cols);
 	else
-	{
-		return NULL;
-	}	
+		transpose_tiles_64((uint64_t*)data, (uint64_t*)new_data, rows, cols);
+	return new_data;
 }
 
-void* transposeData(void* data, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+/**
+ * The SZ_Transpose layout moves the slowest dimension of the data to the fastest position, e.g.,
+ * r3 x r2 x r1 becomes r2 x r1 x r3: that is the transpose of the matrix outer x inner, where outer is the
+ * size of the slowest dimension and inner the product of the other ones.
+ * */
+static size_t transpose_outerSize(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
-	size_t len = computeDataLength(r5, r4, r3, r2, r1);
 	int dim = computeDimension(r5, r4, r3, r2, r1);
-	if(dataType == SZ_FLOAT)
-	{
-		float* ori_data = data;
-		float* new_data = (float*)malloc(sizeof(float)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(float)*len);
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;			
-			//size_t B = r2*r1;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-					{
-						size_t jk = j*r1+k;
-						//size_t s = i*B+jk;
-						size_t t = r3*jk+i;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t C = r2*r1;
-			//size_t B = r3*C;
-			size_t D = C*r4;
-			size_t i, j, k, w, s = 0;			
-			for(i=0;i<r4;i++)
-				for(j=0;j<r3;j++)
-					for(k=0;k<r2;k++)
-						for(w=0;w<r1;w++)
-						{
-							size_t kw = k*r1+w;
-							//size_t s = i*B+j*C+kw;
-							size_t t = j*D+r4*kw+i;
-							new_data[t] = ori_data[s++];
-						}
-		}
-		return new_data;
-	}
-	else if(dataType == SZ_DOUBLE)
-	{
-		double* ori_data = data;
-		double* new_data = (double*)malloc(sizeof(double)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(double)*len);
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;			
-			//size_t B = r2*r1;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-					{
-						size_t jk = j*r1+k;
-						//size_t s = i*B+jk;
-						size_t t = r3*jk+i;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t C = r2*r1;
-			//size_t B = r3*C;
-			size_t D = C*r4;
-			size_t i, j, k, w, s = 0;			
-			for(i=0;i<r4;i++)
-				for(j=0;j<r3;j++)
-					for(k=0;k<r2;k++)
-						for(w=0;w<r1;w++)
-						{
-							size_t kw = k*r1+w;
-							//size_t s = i*B+j*C+kw;
-							size_t t = j*D+r4*kw+i;
-							new_data[t] = ori_data[s++];	
-						}
-		}
-		return new_data;	
-	}
-	else if(dataType == SZ_UINT16)
+	switch(dim)
 	{
-		uint16_t* ori_data = data;
-		uint16_t* new_data = (uint16_t*)malloc(sizeof(uint16_t)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(uint16_t)*len);
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;			
-			//size_t B = r2*r1;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-					{
-						size_t jk = j*r1+k;
-						//size_t s = i*B+jk;
-						size_t t = r3*jk+i;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t C = r2*r1;
-			//size_t B = r3*C;
-			size_t D = C*r4;
-			size_t i, j, k, w, s = 0;			
-			for(i=0;i<r4;i++)
-				for(j=0;j<r3;j++)
-					for(k=0;k<r2;k++)
-						for(w=0;w<r1;w++)
-						{
-							size_t kw = k*r1+w;
-							//size_t s = i*B+j*C+kw;
-							size_t t = j*D+r4*kw+i;
-							new_data[t] = ori_data[s++];	
-						}
-		}
-		return new_data;		
-	}
-	else if(dataType == SZ_INT16)
-	{
-		int16_t* ori_data = data;
-		int16_t* new_data = (int16_t*)malloc(sizeof(int16_t)*len);
-		if(dim==1)
-		{
-			memcpy(new_data, ori_data, sizeof(int16_t)*len);
-		}
-		else if(dim==2)
-		{
-			size_t i, j, s = 0;
-			for(i=0;i<r2;i++)
-				for(j=0;j<r1;j++)
-				{
-					size_t t = j*r2+i;
-					new_data[t] = ori_data[s++];
-				}
-		}
-		else if(dim==3)
-		{
-			size_t i, j, k, s = 0;			
-			//size_t B = r2*r1;
-			for(i=0;i<r3;i++)
-				for(j=0;j<r2;j++)
-					for(k=0;k<r1;k++)
-					{
-						size_t jk = j*r1+k;
-						//size_t s = i*B+jk;
-						size_t t = r3*jk+i;
-						new_data[t] = ori_data[s++];
-					}
-		}
-		else if(dim==4)
-		{
-			size_t C = r2*r1;
-			//size_t B = r3*C;
-			size_t D = C*r4;
-			size_t i, j, k, w, s = 0;			
-			for(i=0;i<r4;i++)
-				for(j=0;j<r3;j++)
-					for(k=0;k<r2;k++)
-						for(w=0;w<r1;w++)
-						{
-							size_t kw = k*r1+w;
-							//size_t s = i*B+j*C+kw;
-							size_t t = j*D+r4*kw+i;
-							new_data[t] = ori_data[s++];	
-						}
-		}
-		return new_data;		
-	}	
-	else
-	{
-		printf("Error. transpose data doesn't support data type %d\n", dataType);
-		return NULL;
+	case 5:
+		return r5;
+	case 4:
+		return r4;
+	case 3:
+		return r3;
+	case 2:
+		return r2;
+	default:
+		return 1;
 	}
 }
+
+void* detransposeData(void* data, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t len = computeDataLength(r5, r4, r3, r2, r1);
+	size_t outer = transpose_outerSize(r5, r4, r3, r2, r1);
+	return transposeMatrix(data, dataType, len/outer, outer);
+}
+
+void* transposeData(void* data, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t len = computeDataLength(r5, r4, r3, r2, r1);
+	size_t outer = transpose_outerSize(r5, r4, r3, r2, r1);
+	return transposeMatrix(data, dataType, outer, len/outer);
+}
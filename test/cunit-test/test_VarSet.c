@@ -0,0 +1,128 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { SZ_freeVarSet(SZ_MAINTAIN_VAR_DATA); return 0; }
+
+/************* Test case functions ****************/
+
+void test_batchAddVar_many(void)
+{
+	//more variables than both the initial hash table size and the old 8-bit var_id range
+	static float data[16];
+	char varName[32];
+	int i;
+	for(i=0;i<1000;i++)
+	{
+		sprintf(varName, "var%d", i);
+		SZ_batchAddVar(100000+i, varName, SZ_FLOAT, data, ABS, 1E-3, 0, 0, 0, 0, 0, 0, 16);
+	}
+	CU_ASSERT_EQUAL(sz_varset->count, 1000);
+	
+	SZ_Variable* v = SZ_getVariable(100000+777);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_STRING_EQUAL(v->varName, "var777");
+	
+	v = SZ_searchVar("var999");
+	CU_ASSERT_PTR_NOT_NULL_FATAL(v);
+	CU_ASSERT_EQUAL(v->var_id, 100999);
+	CU_ASSERT_PTR_NULL(SZ_searchVar("var1000"));
+	CU_ASSERT_PTR_NULL(SZ_getVariable(1000));
+}
+
+void test_batchAddVar_duplicate(void)
+{
+	static float data[16];
+	unsigned int count = sz_varset->count;
+	SZ_batchAddVar(100000, "duplicate", SZ_FLOAT, data, ABS, 1E-3, 0, 0, 0, 0, 0, 0, 16);
+	CU_ASSERT_EQUAL(sz_varset->count, count);
+	CU_ASSERT_PTR_NULL(SZ_searchVar("duplicate"));
+	
+	//a registered name with a new id
+	SZ_batchAddVar(99999, "var5", SZ_FLOAT, data, ABS, 1E-3, 0, 0, 0, 0, 0, 0, 16);
+	CU_ASSERT_EQUAL(sz_varset->count, count);
+	CU_ASSERT_PTR_NULL(SZ_getVariable(99999));
+	CU_ASSERT_EQUAL(SZ_searchVar("var5")->var_id, 100005);
+}
+
+void test_batchDelVar(void)
+{
+	unsigned int count = sz_varset->count;
+	CU_ASSERT_EQUAL(SZ_batchDelVar("var10"), SZ_SCES);
+	CU_ASSERT_EQUAL(SZ_batchDelVar_ID(100000+999), SZ_SCES); //the last variable
+	CU_ASSERT_EQUAL(SZ_batchDelVar("var10"), SZ_NSCS);
+	CU_ASSERT_EQUAL(sz_varset->count, count-2);
+	CU_ASSERT_PTR_NULL(SZ_getVariable(100000+10));
+	CU_ASSERT_PTR_NULL(SZ_searchVar("var999"));
+	CU_ASSERT_STRING_EQUAL(sz_varset->lastVar->varName, "var998");
+	CU_ASSERT_PTR_NOT_NULL(SZ_searchVar("var11"));
+	
+	//the registration order is preserved
+	SZ_Variable* v = sz_varset->header->next;
+	CU_ASSERT_STRING_EQUAL(v->varName, "var0");
+	int i;
+	for(i=0;i<10;i++)
+		v = v->next;
+	CU_ASSERT_STRING_EQUAL(v->varName, "var11");
+}
+
+void test_checkSortedVarID(void)
+{
+	unsigned int var_ids[5] = {70000, 3, 256, 9, 1};
+	sortVarIDs(var_ids, 5);
+	unsigned int expected[5] = {1, 3, 9, 256, 70000};
+	CU_ASSERT_EQUAL(memcmp(var_ids, expected, sizeof(expected)), 0);
+	CU_ASSERT_TRUE(checkSortedVarID(256, var_ids, 5));
+	CU_ASSERT_TRUE(checkSortedVarID(70000, var_ids, 5));
+	CU_ASSERT_FALSE(checkSortedVarID(0, var_ids, 5));
+	CU_ASSERT_FALSE(checkSortedVarID(4, var_ids, 5));
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_VarSet_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_batchAddVar_many", test_batchAddVar_many)) ||
+        (NULL == CU_add_test(pSuite, "test_batchAddVar_duplicate", test_batchAddVar_duplicate)) ||
+        (NULL == CU_add_test(pSuite, "test_batchDelVar", test_batchDelVar)) ||
+        (NULL == CU_add_test(pSuite, "test_checkSortedVarID", test_checkSortedVarID))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
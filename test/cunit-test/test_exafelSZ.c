@@ -0,0 +1,163 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define EVENTS 5
+#define PANELS 4
+#define ROWS 37
+#define COLS 50
+#define PEAKS 3 //peaks per event
+#define EVENT_SIZE (PANELS*ROWS*COLS)
+#define EVENT_PEAKS_SIZE (8+PEAKS*6)
+
+static float* data = NULL;
+static uint8_t calibPanel[ROWS*COLS];
+static uint8_t peaks[EVENTS*EVENT_PEAKS_SIZE];
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, e, k;
+	data = (float*)malloc(EVENTS*EVENT_SIZE*sizeof(float));
+	for(i = 0; i < EVENTS*EVENT_SIZE; i++)
+		data[i] = sin(i*0.01) + 0.1*cos(i*0.37);
+	for(i = 0; i < ROWS*COLS; i++)
+		calibPanel[i] = i%17 != 0; //0 is in the ROI
+	for(e = 0; e < EVENTS; e++)
+	{
+		uint8_t* eventPeaks = peaks + e*EVENT_PEAKS_SIZE;
+		uint64_t nPeaks = PEAKS;
+		memcpy(eventPeaks, &nPeaks, 8);
+		for(k = 0; k < PEAKS; k++)
+		{
+			uint16_t peak[3] = {(uint16_t)((e+k)%PANELS), (uint16_t)(5+7*k), (uint16_t)(3+11*e)};
+			memcpy(eventPeaks + 8 + 6*k, peak, 6);
+		}
+	}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(data);
+	SZ_Finalize();
+	return 0;
+}
+
+static void init_params(exafelSZ_params* pr)
+{
+	memset(pr, 0, sizeof(exafelSZ_params));
+	pr->peaks = peaks;
+	pr->calibPanel = calibPanel;
+	pr->binSize = 2;
+	pr->tolerance = 1E-2;
+	pr->szDim = 3;
+	pr->peakSize = 3;
+}
+
+/************* Test case functions ****************/
+
+/*The ROI pixels come back exactly, the others within the binning and the error bound*/
+void test_exafel_roundtrip(void)
+{
+	exafelSZ_params pr;
+	size_t outSize, i, exact = 0;
+	init_params(&pr);
+	unsigned char* bytes = exafelSZ_Compress(&pr, data, EVENTS, PANELS, ROWS, COLS, &outSize);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	float* dec = (float*)exafelSZ_Decompress(&pr, bytes, EVENTS, PANELS, ROWS, COLS, outSize);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	for(i = 0; i < EVENTS*EVENT_SIZE; i++)
+	{
+		if(dec[i] == data[i])
+			exact++;
+		if(calibPanel[i%(ROWS*COLS)] == 0)
+			CU_ASSERT_EQUAL(dec[i], data[i]);
+	}
+	CU_ASSERT(exact >= EVENTS*EVENT_SIZE/17);
+	free(dec);
+	free(bytes);
+}
+
+/*The stream gives the same batches as exafelSZ_Compress on the events of every batch*/
+void test_exafel_stream(void)
+{
+	exafelSZ_params pr;
+	size_t e, first = 0, outSize, refSize, nEvents;
+	unsigned char *bytes, *ref;
+	init_params(&pr);
+	exafelSZ_stream* stream = exafelSZ_stream_open(&pr, 2, PANELS, ROWS, COLS);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(stream);
+	for(e = 0; e < EVENTS; e++)
+	{
+		CU_ASSERT_EQUAL(exafelSZ_stream_push(stream, data + e*EVENT_SIZE, peaks + e*EVENT_PEAKS_SIZE, &bytes, &outSize), SZ_SCES);
+		CU_ASSERT((bytes != NULL) == (e%2 == 1));
+		if(bytes == NULL)
+			continue;
+		pr.peaks = peaks + first*EVENT_PEAKS_SIZE;
+		ref = exafelSZ_Compress(&pr, data + first*EVENT_SIZE, 2, PANELS, ROWS, COLS, &refSize);
+		CU_ASSERT_EQUAL(outSize, refSize);
+		CU_ASSERT(memcmp(bytes, ref, refSize) == 0);
+		first = e + 1;
+		free(ref);
+		free(bytes);
+	}
+	CU_ASSERT_EQUAL(exafelSZ_stream_flush(stream, &bytes, &outSize, &nEvents), SZ_SCES);
+	CU_ASSERT_EQUAL(nEvents, 1);
+	pr.peaks = peaks + first*EVENT_PEAKS_SIZE;
+	ref = exafelSZ_Compress(&pr, data + first*EVENT_SIZE, 1, PANELS, ROWS, COLS, &refSize);
+	CU_ASSERT_EQUAL(outSize, refSize);
+	CU_ASSERT(memcmp(bytes, ref, refSize) == 0);
+	free(ref);
+	free(bytes);
+	CU_ASSERT_EQUAL(exafelSZ_stream_flush(stream, &bytes, &outSize, &nEvents), SZ_NSCS);
+	exafelSZ_stream_close(stream);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_exafelSZ_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_exafel_roundtrip", test_exafel_roundtrip)) ||
+        (NULL == CU_add_test(pSuite, "test_exafel_stream", test_exafel_stream))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,243 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define R1 40
+#define R2 32
+#define STEPS 4
+#define ERR_BOUND 1E-3
+
+static float* steps[STEPS];
+static unsigned char* bytes[STEPS];
+static size_t outSizes[STEPS];
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, t;
+	for(t = 0; t < STEPS; t++)
+	{
+		steps[t] = (float*)malloc(R2*R1*sizeof(float));
+		//time steps of the same field, with nearly the same distribution of the quantization codes
+		for(i = 0; i < R2; i++)
+			for(j = 0; j < R1; j++)
+				steps[t][i*R1+j] = sin(i*0.2)*cos(j*0.15) + 0.02*sin(i*j*0.7 + t*0.001);
+	}
+	memset(bytes, 0, sizeof(bytes));
+	if(SZ_Init(NULL) != SZ_SCES)
+		return 1;
+	//the trees of the blocked regression are stored in the streams: compress with the Lorenzo predictor
+	confparams_cpr->withRegression = SZ_NO_REGRESSION;
+	return 0;
+}
+
+int clean_suite(void)
+{
+	size_t t;
+	for(t = 0; t < STEPS; t++)
+	{
+		free(steps[t]);
+		free(bytes[t]);
+	}
+	SZ_Finalize();
+	return 0;
+}
+
+static double max_error(const float* data, const float* dec)
+{
+	size_t i;
+	double maxErr = 0;
+	for(i = 0; i < R2*R1; i++)
+		if(fabs(data[i] - dec[i]) > maxErr)
+			maxErr = fabs(data[i] - dec[i]);
+	return maxErr;
+}
+
+/************* Test case functions ****************/
+
+/*The first step compressed with an empty dictionary stores the optimal tree of its codes, as without the dictionary*/
+void test_dict_first(void)
+{
+	size_t plainSize, dictSize;
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	unsigned char* dictBytes = SZ_compress_args(SZ_FLOAT, steps[0], &dictSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	SZ_setHuffmanDict(NULL);
+	unsigned char* plain = SZ_compress_args(SZ_FLOAT, steps[0], &plainSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(dict->built, 1);
+	CU_ASSERT_EQUAL(dictSize, plainSize);
+	CU_ASSERT(dictSize == plainSize && memcmp(dictBytes, plain, plainSize) == 0);
+	free(dictBytes);
+	free(plain);
+	SZ_freeHuffmanDict(dict);
+}
+
+/*Time steps with nearly the same codes refer to the tree of an earlier step, and decompress in order with a dictionary of their own*/
+void test_dict_reuse(void)
+{
+	size_t t, plainSize;
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	for(t = 0; t < STEPS; t++)
+		bytes[t] = SZ_compress_args(SZ_FLOAT, steps[t], &outSizes[t], ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	SZ_setHuffmanDict(NULL);
+	//the number of intervals of the first step may differ from the next ones (then so does its tree)
+	CU_ASSERT_EQUAL(dict->built + dict->reused, STEPS);
+	CU_ASSERT(dict->reused >= STEPS-2);
+	unsigned char* plain = SZ_compress_args(SZ_FLOAT, steps[STEPS-1], &plainSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	CU_ASSERT(outSizes[STEPS-1] < plainSize);
+	free(plain);
+	SZ_freeHuffmanDict(dict);
+
+	dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	for(t = 0; t < STEPS; t++)
+	{
+		float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes[t], outSizes[t], 0, 0, 0, R2, R1);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+		CU_ASSERT(max_error(steps[t], dec) <= ERR_BOUND);
+		free(dec);
+	}
+	SZ_setHuffmanDict(NULL);
+	SZ_freeHuffmanDict(dict);
+}
+
+/*A dictionary exported by the compressor decompresses any time step on its own*/
+void test_dict_export(void)
+{
+	size_t t, dictSize;
+	unsigned char* dictBytes;
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	for(t = 0; t < STEPS; t++)
+	{
+		free(bytes[t]);
+		bytes[t] = SZ_compress_args(SZ_FLOAT, steps[t], &outSizes[t], ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	}
+	SZ_setHuffmanDict(NULL);
+	CU_ASSERT_EQUAL(SZ_exportHuffmanDict(dict, &dictBytes, &dictSize), SZ_SCES);
+	SZ_freeHuffmanDict(dict);
+
+	dict = SZ_importHuffmanDict(dictBytes, dictSize, 0);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dict);
+	CU_ASSERT(dict->nbTrees >= 1);
+	SZ_setHuffmanDict(dict);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes[STEPS-1], outSizes[STEPS-1], 0, 0, 0, R2, R1);
+	SZ_setHuffmanDict(NULL);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	CU_ASSERT(max_error(steps[STEPS-1], dec) <= ERR_BOUND);
+	free(dec);
+	SZ_freeHuffmanDict(dict);
+	CU_ASSERT_PTR_NULL(SZ_importHuffmanDict(dictBytes, 3, 0));
+	free(dictBytes);
+}
+
+/*A time step that refers to the tree of an earlier step fails to decompress without the dictionary*/
+void test_dict_missing(void)
+{
+	size_t t;
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	for(t = 0; t < STEPS; t++)
+	{
+		free(bytes[t]);
+		bytes[t] = SZ_compress_args(SZ_FLOAT, steps[t], &outSizes[t], ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	}
+	SZ_setHuffmanDict(NULL);
+	CU_ASSERT(dict->reused >= 1);
+	SZ_freeHuffmanDict(dict);
+
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes[STEPS-1], outSizes[STEPS-1], 0, 0, 0, R2, R1);
+	CU_ASSERT_PTR_NULL(dec);
+	free(dec);
+}
+
+/*Codes that drifted from the tree of the dictionary get a new tree*/
+void test_dict_drift(void)
+{
+	size_t i, outSize;
+	float* other = (float*)malloc(R2*R1*sizeof(float));
+	for(i = 0; i < R2*R1; i++)
+		other[i] = (float)((i*7919)%1000)/1000;
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	free(SZ_compress_args(SZ_FLOAT, steps[0], &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1));
+	free(SZ_compress_args(SZ_FLOAT, other, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1));
+	SZ_setHuffmanDict(NULL);
+	CU_ASSERT_EQUAL(dict->built, 2);
+	CU_ASSERT_EQUAL(dict->reused, 0);
+	CU_ASSERT_EQUAL(dict->nbTrees, 2);
+	SZ_freeHuffmanDict(dict);
+	free(other);
+}
+
+/*Time steps whose codes are almost all the same state, far below one bit of entropy per code, still reuse the tree*/
+void test_dict_peaked(void)
+{
+	size_t i, t, outSize;
+	float* peaked = (float*)malloc(100*R2*R1*sizeof(float));
+	sz_huffman_dict* dict = SZ_createHuffmanDict(0);
+	SZ_setHuffmanDict(dict);
+	for(t = 0; t < STEPS; t++)
+	{
+		for(i = 0; i < 100*R2*R1; i++)
+			peaked[i] = 1E-4*sin(i*0.01) + (i%23 == 0 ? 0.01*cos(i*0.3 + t*0.05) : 0);
+		free(SZ_compress_args(SZ_FLOAT, peaked, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 10*R2, 10*R1));
+	}
+	SZ_setHuffmanDict(NULL);
+	CU_ASSERT(dict->reused >= STEPS-2);
+	SZ_freeHuffmanDict(dict);
+	free(peaked);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_huffman_dict_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_dict_first", test_dict_first)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_reuse", test_dict_reuse)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_export", test_dict_export)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_missing", test_dict_missing)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_drift", test_dict_drift)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_peaked", test_dict_peaked))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
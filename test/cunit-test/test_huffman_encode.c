@@ -0,0 +1,208 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+
+#define LENGTH 20000
+#define STATE_NUM 128
+#define DEEP_STATES 80
+
+static int states[LENGTH];
+static int decoded[LENGTH];
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/*the encoder before the word-at-a-time one (valid for codes of up to 64 bits), which may write up to 8 bytes past
+ *the end of its output*/
+static void encode_baseline(HuffmanTree *huffmanTree, int *s, size_t length, unsigned char *out, size_t *outSize)
+{
+	size_t i = 0;
+	unsigned char bitSize = 0, byteSize, byteSizep;
+	unsigned char *p = out;
+	int lackBits = 0;
+	for (i = 0;i<length;i++)
+	{
+		int state = s[i];
+		bitSize = huffmanTree->cout[state];
+		if(lackBits==0)
+		{
+			byteSize = bitSize%8==0 ? bitSize/8 : bitSize/8+1;
+			byteSizep = bitSize/8;
+			longToBytes_bigEndian(p, (huffmanTree->code[state])[0]);
+			p += byteSizep;
+			*outSize += byteSize;
+			lackBits = bitSize%8==0 ? 0 : 8 - bitSize%8;
+		}
+		else
+		{
+			*p = (*p) | (unsigned char)((huffmanTree->code[state])[0] >> (64 - lackBits));
+			if(lackBits < bitSize)
+			{
+				p++;
+				long newCode = (huffmanTree->code[state])[0] << lackBits;
+				longToBytes_bigEndian(p, newCode);
+				bitSize -= lackBits;
+				byteSize = bitSize%8==0 ? bitSize/8 : bitSize/8+1;
+				byteSizep = bitSize/8;
+				p += byteSizep;
+				(*outSize)+=byteSize;
+				lackBits = bitSize%8==0 ? 0 : 8 - bitSize%8;
+			}
+			else
+			{
+				lackBits -= bitSize;
+				if(lackBits==0)
+					p++;
+			}
+		}
+	}
+}
+
+/*the codes written one bit at a time, from the first (left-aligned) word of the code, then the second one*/
+static size_t encode_bitwise(HuffmanTree *huffmanTree, int *s, size_t length, unsigned char *out)
+{
+	size_t i, bit = 0;
+	int j;
+	for(i = 0; i < length; i++)
+	{
+		unsigned long* code = huffmanTree->code[s[i]];
+		for(j = 0; j < huffmanTree->cout[s[i]]; j++, bit++)
+			if((code[j/64] >> (63 - j%64)) & 1)
+				out[bit/8] |= (unsigned char)(0x80 >> (bit%8));
+	}
+	return (bit + 7)/8;
+}
+
+static HuffmanTree* build_tree(int *s, size_t length)
+{
+	size_t i;
+	size_t freq[STATE_NUM];
+	memset(freq, 0, sizeof(freq));
+	for(i = 0; i < length; i++)
+		freq[s[i]]++;
+	HuffmanTree* huffmanTree = createHuffmanTree(STATE_NUM);
+	init_fromHistogram(huffmanTree, freq, 0, STATE_NUM-1);
+	return huffmanTree;
+}
+
+/*a tree as skewed as possible: state i has a code of i+1 bits (the last one, of DEEP_STATES-1 bits, like the one
+ *before it); the trees of SZ are built from the counts of the states, which hardly ever make codes of more than 64 bits*/
+static HuffmanTree* build_skewed_tree(void)
+{
+	int i;
+	HuffmanTree* huffmanTree = createHuffmanTree(STATE_NUM);
+	node root = new_node(huffmanTree, 1, DEEP_STATES-1, 0, 0);
+	for(i = DEEP_STATES-2; i >= 0; i--)
+		root = new_node(huffmanTree, 0, 0, new_node(huffmanTree, 1, i, 0, 0), root);
+	huffmanTree->qq[1] = root;
+	build_code(huffmanTree, root, 0, 0, 0);
+	return huffmanTree;
+}
+
+/************* Test case functions ****************/
+
+/*For a tree of ordinary quantization codes, the output is the same as that of the previous encoder*/
+void test_encode_same_bytes(void)
+{
+	size_t i, outSize = 0, baselineSize = 0;
+	unsigned int h = 1;
+	for(i = 0; i < LENGTH; i++)
+	{
+		//mostly around the center of the intervals, with tails of up to 20 states on each side
+		h = h*1103515245 + 12345;
+		int d = (int)((h >> 16)%41) - 20;
+		states[i] = STATE_NUM/2 + ((h >> 8)%4 == 0 ? d : d/8);
+	}
+	HuffmanTree* huffmanTree = build_tree(states, LENGTH);
+	unsigned char* out = (unsigned char*)calloc(LENGTH*sizeof(int), 1);
+	unsigned char* baseline = (unsigned char*)calloc(LENGTH*sizeof(int) + 8, 1);
+	unsigned char* bitwise = (unsigned char*)calloc(LENGTH*sizeof(int), 1);
+	encode(huffmanTree, states, LENGTH, out, &outSize);
+	encode_baseline(huffmanTree, states, LENGTH, baseline, &baselineSize);
+	CU_ASSERT_EQUAL(outSize, baselineSize);
+	CU_ASSERT_EQUAL(memcmp(out, baseline, outSize), 0);
+	CU_ASSERT_EQUAL(encode_bitwise(huffmanTree, states, LENGTH, bitwise), outSize);
+	CU_ASSERT_EQUAL(memcmp(out, bitwise, outSize), 0);
+	free(out);
+	free(baseline);
+	free(bitwise);
+	SZ_ReleaseHuffman(huffmanTree);
+}
+
+/*Codes of more than 64 bits at any bit offset round-trip through the tree stored with the stream*/
+void test_encode_long_codes(void)
+{
+	size_t i, outSize = 0;
+	int deep = 0;
+	HuffmanTree* huffmanTree = build_skewed_tree();
+	CU_ASSERT_EQUAL(huffmanTree->cout[DEEP_STATES-1], DEEP_STATES-1);
+
+	//every state in turn (the long codes start at every bit offset), between runs of the shortest code
+	for(i = 0; i < LENGTH; i++)
+		states[i] = i%7 == 0 ? (deep++)%DEEP_STATES : 0;
+	unsigned char* bitwise = (unsigned char*)calloc(LENGTH*sizeof(int), 1);
+	unsigned char* out = (unsigned char*)calloc(LENGTH*sizeof(int), 1);
+	size_t bitwiseSize = encode_bitwise(huffmanTree, states, LENGTH, bitwise);
+	encode(huffmanTree, states, LENGTH, out, &outSize);
+	CU_ASSERT_EQUAL(outSize, bitwiseSize);
+	CU_ASSERT_EQUAL(memcmp(out, bitwise, outSize), 0);
+	free(out);
+	free(bitwise);
+
+	unsigned char* bytes = NULL;
+	encode_withInitTree(huffmanTree, states, LENGTH, &bytes, &outSize, NULL);
+	SZ_ReleaseHuffman(huffmanTree);
+	huffmanTree = createHuffmanTree(STATE_NUM);
+	memset(decoded, 0, sizeof(decoded));
+	CU_ASSERT_EQUAL(decode_withTree(huffmanTree, bytes, LENGTH, decoded), SZ_SCES);
+	CU_ASSERT_EQUAL_ARRAY_INT(states, decoded, LENGTH);
+	SZ_ReleaseHuffman(huffmanTree);
+	free(bytes);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_huffman_encode_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_encode_same_bytes", test_encode_same_bytes)) ||
+        (NULL == CU_add_test(pSuite, "test_encode_long_codes", test_encode_long_codes))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,131 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N 1048576
+#define ERR_BOUND 1E-3
+
+static float* noisy = NULL;
+static float* smooth = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i;
+	unsigned int seed = 11;
+	noisy = (float*)malloc(N*sizeof(float));
+	smooth = (float*)malloc(N*sizeof(float));
+	for(i = 0; i < N; i++)
+	{
+		//white noise: the Huffman codes are nearly incompressible
+		seed = seed*1103515245 + 12345;
+		noisy[i] = (seed >> 8)%65536/65536.0;
+		smooth[i] = sin(i*0.001) + 0.3*cos(i*0.0007);
+	}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(noisy);
+	free(smooth);
+	SZ_Finalize();
+	return 0;
+}
+
+static double max_error(const float* data, const float* dec)
+{
+	size_t i;
+	double maxErr = 0;
+	for(i = 0; i < N; i++)
+		if(fabs(data[i] - dec[i]) > maxErr)
+			maxErr = fabs(data[i] - dec[i]);
+	return maxErr;
+}
+
+/************* Test case functions ****************/
+
+/*The lossless stage is skipped on white noise, and the stream decompresses without it*/
+void test_bypass_noisy(void)
+{
+	size_t outSize, plainSize;
+	double minGain = confparams_cpr->losslessMinGain;
+	confparams_cpr->losslessMinGain = 0.01;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, noisy, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 0, N);
+	confparams_cpr->losslessMinGain = 0;
+	unsigned char* plain = SZ_compress_args(SZ_FLOAT, noisy, &plainSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 0, N);
+	confparams_cpr->losslessMinGain = minGain;
+	CU_ASSERT_EQUAL(is_lossless_compressed_data(bytes, outSize), -1);
+	CU_ASSERT_EQUAL(is_lossless_compressed_data(plain, plainSize), ZSTD_COMPRESSOR);
+	CU_ASSERT(outSize <= plainSize*1.01);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	CU_ASSERT(max_error(noisy, dec) <= ERR_BOUND);
+	free(dec);
+	free(bytes);
+	free(plain);
+}
+
+/*The lossless stage is kept where it pays off*/
+void test_bypass_smooth(void)
+{
+	size_t outSize;
+	double minGain = confparams_cpr->losslessMinGain;
+	confparams_cpr->losslessMinGain = 0.01;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, smooth, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 0, N);
+	confparams_cpr->losslessMinGain = minGain;
+	CU_ASSERT_EQUAL(is_lossless_compressed_data(bytes, outSize), ZSTD_COMPRESSOR);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	CU_ASSERT(max_error(smooth, dec) <= ERR_BOUND);
+	free(dec);
+	free(bytes);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_lossless_bypass_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_bypass_noisy", test_bypass_noisy)) ||
+        (NULL == CU_add_test(pSuite, "test_bypass_smooth", test_bypass_smooth))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,146 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define NUM_BLOCKS 300
+
+static pastri_params params;
+static double* data = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	int b, i;
+	memset(&params, 0, sizeof(pastri_params));
+	params.bf[0] = params.bf[1] = params.bf[2] = params.bf[3] = 2;
+	params.originalEb = 1E-6;
+	params.dataSize = 8;
+	params.numBlocks = NUM_BLOCKS;
+	SZ_pastriPreprocessParameters(&params);
+	data = (double*)malloc((size_t)NUM_BLOCKS*params.bSize*sizeof(double));
+	//zero, sparse and patterned blocks
+	for(b = 0; b < NUM_BLOCKS; b++)
+		for(i = 0; i < params.bSize; i++)
+			data[(size_t)b*params.bSize+i] = b%7 == 0 ? 0 : (b%5 == 0 ? (i%13 == 0)*1E-4*b : 1E-3*sin(i%params.sbSize*0.3+b)*cos(i/params.sbSize*0.2));
+	return 0;
+}
+
+int clean_suite(void)
+{
+	free(data);
+	return 0;
+}
+
+/************* Test case functions ****************/
+
+/*The indexed batch holds the same compressed blocks as the sequential batch, after the block index*/
+void test_pastri_indexed_batch(void)
+{
+	unsigned char *serial, *indexed, *dec, *decIndexed;
+	size_t serialBytes, indexedBytes, decBytes, decIndexedBytes;
+	size_t headerBytes = sizeof(pastri_params) + NUM_BLOCKS*sizeof(uint64_t);
+	pastri_params p;
+	SZ_pastriCompressBatch(&params, (unsigned char*)data, &serial, &serialBytes);
+	CU_ASSERT_EQUAL(SZ_pastriCompressBatchIndexed(&params, (unsigned char*)data, &indexed, &indexedBytes), 0);
+	CU_ASSERT_EQUAL(indexedBytes - headerBytes, serialBytes - sizeof(pastri_params));
+	CU_ASSERT(memcmp(indexed + headerBytes, serial + sizeof(pastri_params), serialBytes - sizeof(pastri_params)) == 0);
+
+	SZ_pastriDecompressBatch(serial, &p, &dec, &decBytes);
+	CU_ASSERT_EQUAL(SZ_pastriDecompressBatchIndexed(indexed, &p, &decIndexed, &decIndexedBytes), 0);
+	CU_ASSERT_EQUAL(p.numBlocks, NUM_BLOCKS);
+	CU_ASSERT_EQUAL(decIndexedBytes, decBytes);
+	CU_ASSERT(memcmp(dec, decIndexed, decBytes) == 0);
+	free(serial);
+	free(indexed);
+	free(dec);
+	free(decIndexed);
+}
+
+/*A block decompressed alone is the same as in the whole batch*/
+void test_pastri_block_access(void)
+{
+	unsigned char *indexed, *dec;
+	size_t indexedBytes, decBytes, blockBytes = (size_t)params.bSize*params.dataSize;
+	pastri_params p;
+	int b;
+	SZ_pastriCompressBatchIndexed(&params, (unsigned char*)data, &indexed, &indexedBytes);
+	SZ_pastriDecompressBatchIndexed(indexed, &p, &dec, &decBytes);
+	unsigned char* block = (unsigned char*)malloc(blockBytes);
+	for(b = NUM_BLOCKS-1; b >= 0; b -= 23)
+	{
+		CU_ASSERT_EQUAL(SZ_pastriDecompressBlock(indexed, b, &p, block), 0);
+		CU_ASSERT(memcmp(block, dec + b*blockBytes, blockBytes) == 0);
+	}
+	CU_ASSERT_EQUAL(SZ_pastriDecompressBlock(indexed, NUM_BLOCKS, &p, block), -1);
+	free(block);
+	free(indexed);
+	free(dec);
+}
+
+/*Only the float and double kernels exist: other data sizes are rejected*/
+void test_pastri_data_size(void)
+{
+	unsigned char *indexed, *dec;
+	size_t indexedBytes, decBytes;
+	pastri_params p, bad = params;
+	bad.dataSize = 2;
+	CU_ASSERT_EQUAL(SZ_pastriCompressBatchIndexed(&bad, (unsigned char*)data, &indexed, &indexedBytes), -1);
+	CU_ASSERT_PTR_NULL(indexed);
+	CU_ASSERT_EQUAL(indexedBytes, 0);
+
+	CU_ASSERT_EQUAL(SZ_pastriCompressBatchIndexed(&params, (unsigned char*)data, &indexed, &indexedBytes), 0);
+	((pastri_params*)indexed)->dataSize = 2;
+	CU_ASSERT_EQUAL(SZ_pastriDecompressBatchIndexed(indexed, &p, &dec, &decBytes), -1);
+	CU_ASSERT_PTR_NULL(dec);
+	CU_ASSERT_EQUAL(SZ_pastriDecompressBlock(indexed, 0, &p, (unsigned char*)data), -1);
+	free(indexed);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_pastri_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_pastri_indexed_batch", test_pastri_indexed_batch)) ||
+        (NULL == CU_add_test(pSuite, "test_pastri_block_access", test_pastri_block_access)) ||
+        (NULL == CU_add_test(pSuite, "test_pastri_data_size", test_pastri_data_size))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,208 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N 262144
+#define R1 64
+#define R2 64
+#define R3 64
+#define ERR_BOUND 1E-3
+
+static float* data1D = NULL;
+static float* data3D = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, k;
+	unsigned int seed = 5;
+	data1D = (float*)malloc(N*sizeof(float));
+	data3D = (float*)malloc(R3*R2*R1*sizeof(float));
+	for(i = 0; i < N; i++)
+	{
+		//smooth, with some spikes for the unpredictable data
+		seed = seed*1103515245 + 12345;
+		data1D[i] = sin(i*0.001) + ((seed >> 8)%64 == 0 ? (seed >> 16)%100*0.01 : 0);
+	}
+	for(i = 0; i < R3; i++)
+		for(j = 0; j < R2; j++)
+			for(k = 0; k < R1; k++)
+				data3D[(i*R2+j)*R1+k] = sin(i*0.1)*cos(j*0.07) + 0.5*sin(k*0.05 + i*0.02);
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(data1D);
+	free(data3D);
+	SZ_Finalize();
+	return 0;
+}
+
+static int has_section(sz_section_info* sections, int count, int id)
+{
+	int i;
+	for(i = 0; i < count; i++)
+		if(sections[i].id == id)
+			return 1;
+	return 0;
+}
+
+static unsigned char* compress_sectioned(float* data, size_t* outSize, size_t r3, size_t r2, size_t r1)
+{
+	confparams_cpr->losslessSections = 1;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, data, outSize, ABS, ERR_BOUND, 0, 0, 0, 0, r3, r2, r1);
+	confparams_cpr->losslessSections = 0;
+	return bytes;
+}
+
+/************* Test case functions ****************/
+
+/*The sections of a 1D stream are listed in its table of contents, and the stream decompresses within the error bound*/
+void test_sections_1D(void)
+{
+	size_t i, outSize;
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	unsigned char* bytes = compress_sectioned(data1D, &outSize, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	int count = SZ_getSections(bytes, outSize, sections, SZ_SECTIONS_MAX);
+	CU_ASSERT_FATAL(count >= 3);
+	CU_ASSERT_EQUAL(sections[0].id, SZ_SECTION_HEADER);
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_CODES));
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_LEADNUM));
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	for(i = 0; i < N; i++)
+		CU_ASSERT(fabs(dec[i] - data1D[i]) <= ERR_BOUND);
+	free(dec);
+	free(bytes);
+}
+
+/*The 3D regression stream separates the Huffman tree, the coefficients, the unpredictable data and the codes*/
+void test_sections_3D(void)
+{
+	size_t i, outSize;
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	unsigned char* bytes = compress_sectioned(data3D, &outSize, R3, R2, R1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	int count = SZ_getSections(bytes, outSize, sections, SZ_SECTIONS_MAX);
+	CU_ASSERT_FATAL(count > 0);
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_TREE));
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_COEFFICIENTS));
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_UNPREDICTABLE));
+	CU_ASSERT(has_section(sections, count, SZ_SECTION_CODES));
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	for(i = 0; i < R3*R2*R1; i++)
+		CU_ASSERT(fabs(dec[i] - data3D[i]) <= ERR_BOUND);
+	free(dec);
+	free(bytes);
+}
+
+/*A section decompressed alone is the same as in the SZ bytes without the lossless stage*/
+void test_section_access(void)
+{
+	size_t outSize, rawSize, sectionSize = 0;
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	unsigned char* bytes = compress_sectioned(data1D, &outSize, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	int i, count = SZ_getSections(bytes, outSize, sections, SZ_SECTIONS_MAX);
+	for(i = 0; i < count && sections[i].id != SZ_SECTION_CODES; i++);
+	CU_ASSERT_FATAL(i < count);
+	unsigned char* codes = SZ_decompressSection(bytes, outSize, SZ_SECTION_CODES, &sectionSize);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(codes);
+	CU_ASSERT_EQUAL(sectionSize, sections[i].rawSize);
+
+	confparams_cpr->szMode = SZ_BEST_SPEED;
+	unsigned char* raw = SZ_compress_args(SZ_FLOAT, data1D, &rawSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 0, N);
+	confparams_cpr->szMode = SZ_BEST_COMPRESSION;
+	CU_ASSERT_EQUAL_FATAL(rawSize, sections[count-1].rawOffset + sections[count-1].rawSize);
+	CU_ASSERT(memcmp(codes, raw + sections[i].rawOffset, sectionSize) == 0);
+	CU_ASSERT_PTR_NULL(SZ_decompressSection(bytes, outSize, SZ_SECTION_COEFFICIENTS, &sectionSize));
+	free(raw);
+	free(codes);
+	free(bytes);
+}
+
+/*A section that fails to decode fails the whole stream, without leaving any SZ bytes behind*/
+void test_sections_corrupt(void)
+{
+	size_t i, outSize;
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	unsigned char* bytes = compress_sectioned(data1D, &outSize, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	int count = SZ_getSections(bytes, outSize, sections, SZ_SECTIONS_MAX);
+	for(i = 0; i < (size_t)count && sections[i].codec == SZ_SECTION_RAW; i++);
+	CU_ASSERT_FATAL(i < (size_t)count);
+	memset(bytes + sections[i].cmpOffset, 0xFF, sections[i].cmpSize/2 + 1);
+
+	unsigned char* szBytes = bytes; //any non-NULL pointer
+	CU_ASSERT_EQUAL(sz_sections_decompress(bytes, outSize, &szBytes), 0);
+	CU_ASSERT_PTR_NULL(szBytes);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, 0, N);
+	CU_ASSERT_PTR_NULL(dec);
+	free(dec);
+	free(bytes);
+}
+
+/*The sectioned stage is off by default*/
+void test_sections_off(void)
+{
+	size_t outSize;
+	sz_section_info sections[SZ_SECTIONS_MAX];
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, data1D, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, 0, N);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	CU_ASSERT_EQUAL(SZ_getSections(bytes, outSize, sections, SZ_SECTIONS_MAX), -1);
+	free(bytes);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sections_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_sections_1D", test_sections_1D)) ||
+        (NULL == CU_add_test(pSuite, "test_sections_3D", test_sections_3D)) ||
+        (NULL == CU_add_test(pSuite, "test_section_access", test_section_access)) ||
+        (NULL == CU_add_test(pSuite, "test_sections_corrupt", test_sections_corrupt)) ||
+        (NULL == CU_add_test(pSuite, "test_sections_off", test_sections_off))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,198 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define R1 48
+#define R2 40
+#define R3 32
+
+static float* data = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, k;
+	data = (float*)malloc(R3*R2*R1*sizeof(float));
+	for(i = 0; i < R3; i++)
+		for(j = 0; j < R2; j++)
+			for(k = 0; k < R1; k++)
+				data[(i*R2+j)*R1+k] = sin(i*0.1)*cos(j*0.07) + 0.5*sin(k*0.05 + i*0.02);
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(data);
+	SZ_Finalize();
+	return 0;
+}
+
+/************* Test case functions ****************/
+
+/*The estimation must be in the ballpark of the actual compression*/
+void test_estimate_float_3D(void)
+{
+	sz_estimation est;
+	size_t outSize, i, n = R3*R2*R1;
+	double err = 0;
+	confparams_cpr->errorBoundMode = REL;
+	confparams_cpr->relBoundRatio = 1E-4;
+	CU_ASSERT_EQUAL(SZ_estimate(SZ_FLOAT, data, 0, 0, R3, R2, R1, NULL, &est), SZ_SCES);
+	unsigned char* bytes = SZ_compress(SZ_FLOAT, data, &outSize, 0, 0, R3, R2, R1);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1);
+	for(i = 0; i < n; i++)
+		err += (data[i] - dec[i])*(data[i] - dec[i]);
+	double ratio = (double)n*sizeof(float)/outSize;
+	CU_ASSERT(est.ratio > ratio/2 && est.ratio < ratio*2);
+	CU_ASSERT(est.sampleCount > 0 && est.sampleCount < n);
+	CU_ASSERT(est.intervals >= 32);
+	CU_ASSERT_DOUBLE_EQUAL(est.psnr, 20*log10(est.errorBound/1E-4) - 10*log10(err/n), 3);
+	free(bytes);
+	free(dec);
+}
+
+void test_estimate_error_bound(void)
+{
+	sz_estimation loose, tight;
+	sz_params params;
+	memcpy(&params, confparams_cpr, sizeof(sz_params));
+	params.errorBoundMode = ABS;
+	params.absErrBound = 1E-2;
+	CU_ASSERT_EQUAL(SZ_estimate(SZ_FLOAT, data, 0, 0, R3, R2, R1, &params, &loose), SZ_SCES);
+	params.absErrBound = 1E-5;
+	CU_ASSERT_EQUAL(SZ_estimate(SZ_FLOAT, data, 0, 0, R3, R2, R1, &params, &tight), SZ_SCES);
+	CU_ASSERT_DOUBLE_EQUAL(loose.errorBound, 1E-2, 1E-9);
+	CU_ASSERT(loose.ratio > tight.ratio);
+	CU_ASSERT(loose.psnr < tight.psnr);
+}
+
+void test_estimate_unsupported(void)
+{
+	sz_estimation est;
+	sz_params params;
+	memcpy(&params, confparams_cpr, sizeof(sz_params));
+	params.errorBoundMode = PW_REL;
+	CU_ASSERT_EQUAL(SZ_estimate(SZ_FLOAT, data, 0, 0, R3, R2, R1, &params, &est), SZ_NSCS);
+	CU_ASSERT_EQUAL(SZ_estimate(SZ_INT32, data, 0, 0, R3, R2, R1, NULL, &est), SZ_NSCS);
+}
+
+/*The tuned settings must be valid ones and the compression with them must keep the error bound*/
+void test_autotune(void)
+{
+	sz_estimation est;
+	sz_params params, saved;
+	size_t outSize, i, n = R3*R2*R1;
+	double maxErr = 0;
+	memcpy(&saved, confparams_cpr, sizeof(sz_params));
+	memcpy(&params, confparams_cpr, sizeof(sz_params));
+	params.errorBoundMode = ABS;
+	params.absErrBound = 1E-3;
+	params.autotune = SZ_TUNE_MAX_RATIO;
+	CU_ASSERT_EQUAL(SZ_autotune(SZ_FLOAT, data, 0, 0, R3, R2, R1, &params, &est), SZ_SCES);
+	CU_ASSERT(est.ratio > 1);
+	CU_ASSERT(params.regressionBlockSize == 0 || (params.regressionBlockSize >= 2 && params.regressionBlockSize <= 40));
+	CU_ASSERT(params.predThreshold > 0 && params.predThreshold < 1);
+	CU_ASSERT(params.szMode == SZ_BEST_SPEED || params.szMode == SZ_BEST_COMPRESSION);
+
+	//the compression tunes itself when autotune is set, without changing the parameters
+	confparams_cpr->autotune = SZ_TUNE_MAX_SPEED;
+	confparams_cpr->tuneMinRatio = 2;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, data, &outSize, ABS, 1E-3, 0, 0, 0, 0, R3, R2, R1);
+	CU_ASSERT_EQUAL(confparams_cpr->withRegression, saved.withRegression);
+	CU_ASSERT_EQUAL(confparams_cpr->szMode, saved.szMode);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1);
+	for(i = 0; i < n; i++)
+		if(fabs(data[i] - dec[i]) > maxErr)
+			maxErr = fabs(data[i] - dec[i]);
+	CU_ASSERT(maxErr <= 1E-3);
+	memcpy(confparams_cpr, &saved, sizeof(sz_params));
+	free(bytes);
+	free(dec);
+}
+
+/*The FIXED_RATIO mode must land within SZ_FIXED_RATIO_TOLERANCE of the target size, with an error bound found on the estimations*/
+void test_fixed_ratio(void)
+{
+	sz_estimation est;
+	sz_params saved;
+	size_t outSize, n = R3*R2*R1;
+	double absErrBound = 0, targetSize = (double)n*sizeof(float)/32;
+	memcpy(&saved, confparams_cpr, sizeof(sz_params));
+	CU_ASSERT_EQUAL(SZ_estimate_errorBound(SZ_FLOAT, data, 0, 0, R3, R2, R1, NULL, 32, &absErrBound, &est), SZ_SCES);
+	CU_ASSERT(absErrBound > 0);
+	CU_ASSERT_DOUBLE_EQUAL(est.errorBound, absErrBound, absErrBound*1E-6);
+	CU_ASSERT(fabs(32/est.ratio - 1) <= SZ_FIXED_RATIO_TOLERANCE);
+
+	confparams_cpr->errorBoundMode = FIXED_RATIO;
+	confparams_cpr->fixedRatio = 32;
+	unsigned char* bytes = SZ_compress(SZ_FLOAT, data, &outSize, 0, 0, R3, R2, R1);
+	CU_ASSERT(fabs(outSize/targetSize - 1) <= SZ_FIXED_RATIO_TOLERANCE);
+	CU_ASSERT_EQUAL(confparams_cpr->errorBoundMode, FIXED_RATIO);
+	free(bytes);
+
+	//a bit rate instead of a ratio
+	confparams_cpr->fixedRatio = 0;
+	confparams_cpr->fixedBitRate = 1;
+	bytes = SZ_compress(SZ_FLOAT, data, &outSize, 0, 0, R3, R2, R1);
+	CU_ASSERT(fabs(outSize/targetSize - 1) <= SZ_FIXED_RATIO_TOLERANCE);
+	free(bytes);
+
+	//the typed entry point (used by sz.hpp) searches the error bound too
+	bytes = NULL;
+	CU_ASSERT_EQUAL(SZ_compress_args_float(-1, &bytes, data, 0, 0, R3, R2, R1, &outSize, FIXED_RATIO, 0, 0, 0), SZ_SCES);
+	CU_ASSERT_PTR_NOT_NULL(bytes);
+	CU_ASSERT(fabs(outSize/targetSize - 1) <= SZ_FIXED_RATIO_TOLERANCE);
+	memcpy(confparams_cpr, &saved, sizeof(sz_params));
+	free(bytes);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sz_estimate_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_estimate_float_3D", test_estimate_float_3D)) ||
+        (NULL == CU_add_test(pSuite, "test_estimate_error_bound", test_estimate_error_bound)) ||
+        (NULL == CU_add_test(pSuite, "test_estimate_unsupported", test_estimate_unsupported)) ||
+        (NULL == CU_add_test(pSuite, "test_autotune", test_autotune)) ||
+        (NULL == CU_add_test(pSuite, "test_fixed_ratio", test_fixed_ratio))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
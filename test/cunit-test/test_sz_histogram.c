@@ -0,0 +1,116 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+
+#define NB_STATES 1024
+#define LENGTH (1 << 20)
+
+static int* states = NULL;
+static size_t* expected = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i;
+	unsigned int seed = 11;
+	states = (int*)malloc(LENGTH*sizeof(int));
+	expected = (size_t*)malloc(NB_STATES*sizeof(size_t));
+	memset(expected, 0, NB_STATES*sizeof(size_t));
+	//around the middle state, with runs of the same state, like the quantization codes
+	for(i = 0; i < LENGTH; i++)
+	{
+		seed = seed*1103515245 + 12345;
+		states[i] = (i/8)%5 == 0 ? NB_STATES/2 : NB_STATES/2 - 40 + (int)((seed >> 16)%100);
+		expected[states[i]]++;
+	}
+	return 0;
+}
+
+int clean_suite(void)
+{
+	free(states);
+	free(expected);
+	return 0;
+}
+
+/************* Test case functions ****************/
+
+void test_histogram_range(void)
+{
+	int i, minState = -1, maxState = -1;
+	size_t* freq = SZ_histogram(states, LENGTH, NB_STATES, &minState, &maxState);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(freq);
+	CU_ASSERT_EQUAL(minState, NB_STATES/2 - 40);
+	CU_ASSERT_EQUAL(maxState, NB_STATES/2 + 59);
+	for(i = minState; i <= maxState; i++)
+		CU_ASSERT_EQUAL(freq[i - minState], expected[i]);
+	free(freq);
+	CU_ASSERT_PTR_NULL(SZ_histogram(states, 0, NB_STATES, &minState, &maxState));
+}
+
+/*The short inputs are counted without the interleaved tables*/
+void test_histogram_short(void)
+{
+	int minState, maxState;
+	size_t i, freq[NB_STATES];
+	SZ_histogram_full(states + 3, 7, freq, NB_STATES);
+	for(i = 0; i < NB_STATES; i++)
+	{
+		size_t j, count = 0;
+		for(j = 3; j < 10; j++)
+			count += states[j] == (int)i;
+		CU_ASSERT_EQUAL(freq[i], count);
+	}
+	size_t* counts = SZ_histogram(states + 100, 1, NB_STATES, &minState, &maxState);
+	CU_ASSERT_EQUAL(minState, states[100]);
+	CU_ASSERT_EQUAL(maxState, states[100]);
+	CU_ASSERT_EQUAL(counts[0], 1);
+	free(counts);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sz_histogram_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_histogram_range", test_histogram_range)) ||
+        (NULL == CU_add_test(pSuite, "test_histogram_short", test_histogram_short))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,189 @@
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.hpp"
+
+template<class T>
+std::vector<T> make_field(std::size_t n)
+{
+	std::vector<T> data(n);
+	for(std::size_t i = 0; i < n; i++)
+		data[i] = static_cast<T>(100*std::sin(i*0.01) + i%7);
+	return data;
+}
+
+template<class T>
+double max_error(const std::vector<T>& a, const std::vector<T>& b)
+{
+	double err = 0;
+	for(std::size_t i = 0; i < a.size(); i++)
+		err = std::fmax(err, std::fabs(static_cast<double>(a[i]) - static_cast<double>(b[i])));
+	return err;
+}
+
+extern "C" {
+int init_suite()
+{
+	return 0;
+}
+
+int clean_suite()
+{
+	return 0;
+}
+
+void test_compress_float_3d()
+{
+	std::vector<float> data = make_field<float>(16*20*24);
+	sz::Compressor<float, 3> compressor;
+	compressor.params().errorBoundMode = ABS;
+	compressor.params().absErrBound = 1E-3;
+
+	std::vector<unsigned char> bytes = compressor.compress(sz::make_view(data.data(), 16, 20, 24));
+	CU_ASSERT(bytes.size() > 0);
+	CU_ASSERT(bytes.size() < data.size()*sizeof(float));
+
+	sz_perf_stats stats;
+	CU_ASSERT(SZ_get_last_stats(nullptr, &stats) == SZ_SCES);
+	CU_ASSERT_EQUAL(stats.dataType, SZ_FLOAT);
+	CU_ASSERT_EQUAL(stats.bytesIn, data.size()*sizeof(float));
+	CU_ASSERT_EQUAL(stats.bytesOut, bytes.size());
+	CU_ASSERT(stats.stage[SZ_STAGE_RANGE_SCAN].calls > 0);
+	CU_ASSERT(stats.stage[SZ_STAGE_HUFFMAN_BUILD].calls > 0);
+	CU_ASSERT(stats.stage[SZ_STAGE_LOSSLESS].bytesOut > 0);
+	CU_ASSERT(stats.totalTime >= stats.stage[SZ_STAGE_ENCODE].time);
+
+	std::vector<float> values = compressor.decompress(sz::make_view(bytes), {{16, 20, 24}});
+	CU_ASSERT_EQUAL(values.size(), data.size());
+	CU_ASSERT(max_error(data, values) <= 1E-3);
+}
+
+void test_compress_preallocated_double_2d()
+{
+	std::vector<double> data = make_field<double>(64*50);
+	sz::Compressor<double, 2> compressor;
+	compressor.params().errorBoundMode = ABS;
+	compressor.params().absErrBound = 1E-5;
+
+	std::array<std::size_t, 2> extents = {{64, 50}};
+	std::vector<unsigned char> bytes(sz::Compressor<double, 2>::compress_bound(extents));
+	std::size_t outSize = 0;
+	CU_ASSERT(compressor.compress(sz::make_view(data.data(), 64, 50), sz::make_view(bytes), outSize) == sz::status::ok);
+	CU_ASSERT(outSize > 0 && outSize <= bytes.size());
+
+	std::vector<double> values(data.size());
+	CU_ASSERT(compressor.decompress(sz::span<const unsigned char>(bytes.data(), outSize), sz::make_view(values.data(), 64, 50)) == sz::status::ok);
+	CU_ASSERT(max_error(data, values) <= 1E-5);
+
+	//too small an output buffer is reported, not overrun
+	std::vector<unsigned char> small(8);
+	CU_ASSERT(compressor.compress(sz::make_view(data.data(), 64, 50), sz::make_view(small), outSize) == sz::status::buffer_too_small);
+	CU_ASSERT(compressor.compress(sz::make_view(data.data(), 64, 0), sz::make_view(bytes), outSize) == sz::status::invalid_argument);
+}
+
+void test_compress_int32_1d()
+{
+	std::vector<int32_t> data = make_field<int32_t>(1000);
+	sz::Compressor<int32_t, 1> compressor;
+	compressor.params().errorBoundMode = ABS;
+	compressor.params().absErrBound = 2;
+
+	std::vector<unsigned char> bytes = compressor.compress(sz::make_view(data.data(), data.size()));
+	std::vector<int32_t> values = compressor.decompress(sz::make_view(bytes), {{data.size()}});
+	CU_ASSERT(max_error(data, values) <= 2);
+}
+
+//a compressor binds its own context: the dictionaries set for the unbound threads are not used
+void test_compress_with_global_dicts()
+{
+	std::vector<float> data = make_field<float>(32*40);
+	std::vector<unsigned char> content(4096);
+	for(std::size_t i = 0; i < content.size(); i++)
+		content[i] = static_cast<unsigned char>(i*31 + i/7);
+	sz_zstd_dict* dict = SZ_loadZstdDict(content.data(), content.size(), 3);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dict);
+	sz_zstd_dict* previous = SZ_setZstdDict(dict);
+
+	sz::Compressor<float, 2> compressor;
+	compressor.params().errorBoundMode = ABS;
+	compressor.params().absErrBound = 1E-3;
+	std::vector<unsigned char> bytes = compressor.compress(sz::make_view(data.data(), 32, 40));
+	CU_ASSERT(bytes.size() > 0);
+
+	SZ_setZstdDict(previous);
+	SZ_freeZstdDict(dict);
+	std::vector<float> values = compressor.decompress(sz::make_view(bytes), {{32, 40}});
+	CU_ASSERT_EQUAL(values.size(), data.size());
+	CU_ASSERT(max_error(data, values) <= 1E-3);
+}
+
+//the FIXED_RATIO mode searches the error bound for the target ratio on the parameters of the compressor
+void test_compress_fixed_ratio()
+{
+	//a smooth field: the ratio of make_field() (with its i%7 steps) jumps with the error bound
+	std::vector<float> data(32*40*48);
+	for(std::size_t i = 0; i < 32; i++)
+		for(std::size_t j = 0; j < 40; j++)
+			for(std::size_t k = 0; k < 48; k++)
+				data[(i*40+j)*48+k] = std::sin(i*0.1)*std::cos(j*0.07) + 0.5*std::sin(k*0.05 + i*0.02);
+	double targetSize = data.size()*sizeof(float)/32.0;
+	sz::Compressor<float, 3> compressor;
+	compressor.params().errorBoundMode = FIXED_RATIO;
+	compressor.params().fixedRatio = 32;
+
+	std::vector<unsigned char> bytes = compressor.compress(sz::make_view(data.data(), 32, 40, 48));
+	CU_ASSERT(std::fabs(bytes.size()/targetSize - 1) <= SZ_FIXED_RATIO_TOLERANCE);
+	CU_ASSERT_EQUAL(compressor.params().errorBoundMode, FIXED_RATIO);
+	std::vector<float> values = compressor.decompress(sz::make_view(bytes), {{32, 40, 48}});
+	CU_ASSERT_EQUAL(values.size(), data.size());
+}
+
+//creating a compressor does not reset the byte order of the data chosen in the configuration of SZ
+void test_compressor_keeps_data_endianness()
+{
+	int saved = dataEndianType;
+	dataEndianType = BIG_ENDIAN_DATA;
+	sz::Compressor<float, 1> compressor;
+	CU_ASSERT_EQUAL(dataEndianType, BIG_ENDIAN_DATA);
+	CU_ASSERT_EQUAL(compressor.params().errorBoundMode, PSNR);
+	dataEndianType = saved;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned int num_failures = 0;
+	if (CUE_SUCCESS != CU_initialize_registry())
+	{
+		return CU_get_error();
+	}
+
+	CU_pSuite suite = CU_add_suite("test_sz_hpp_suite", init_suite, clean_suite);
+	if(suite == nullptr) {
+		goto error;
+	}
+
+	if(CU_add_test(suite, "test_compress_float_3d", test_compress_float_3d) == nullptr ||
+		CU_add_test(suite, "test_compress_preallocated_double_2d", test_compress_preallocated_double_2d) == nullptr ||
+		CU_add_test(suite, "test_compress_int32_1d", test_compress_int32_1d) == nullptr ||
+		CU_add_test(suite, "test_compress_with_global_dicts", test_compress_with_global_dicts) == nullptr ||
+		CU_add_test(suite, "test_compress_fixed_ratio", test_compress_fixed_ratio) == nullptr ||
+		CU_add_test(suite, "test_compressor_keeps_data_endianness", test_compressor_keeps_data_endianness) == nullptr) {
+		goto error;
+	}
+
+	CU_basic_set_mode(CU_BRM_VERBOSE);
+	CU_basic_run_tests();
+	CU_basic_show_failures(CU_get_failure_list());
+	num_failures = CU_get_number_of_failures();
+
+error:
+	CU_cleanup_registry();
+	return  num_failures ||  CU_get_error();
+}
+
+}
@@ -0,0 +1,150 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define R1 48
+#define R2 40
+#define R3 32
+#define STRIDE 4
+
+static float* data = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, k;
+	unsigned int seed = 7;
+	data = (float*)malloc(R3*R2*R1*sizeof(float));
+	//noisy enough for the linear regression to win in every block at a loose error bound
+	for(i = 0; i < R3; i++)
+		for(j = 0; j < R2; j++)
+			for(k = 0; k < R1; k++)
+			{
+				seed = seed*1103515245 + 12345;
+				data[(i*R2+j)*R1+k] = sin(i*0.1)*cos(j*0.07) + 0.5*sin(k*0.05 + i*0.02) + 0.05*((seed >> 16)%1000/1000.0 - 0.5);
+			}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(data);
+	SZ_Finalize();
+	return 0;
+}
+
+/*Average of the decompressed data over the cell (a, b, c) of the low-resolution grid*/
+static double cell_average(const float* dec, size_t a, size_t b, size_t c)
+{
+	size_t i, j, k, count = 0;
+	double sum = 0;
+	for(i = a*STRIDE; i < (a+1)*STRIDE && i < R3; i++)
+		for(j = b*STRIDE; j < (b+1)*STRIDE && j < R2; j++)
+			for(k = c*STRIDE; k < (c+1)*STRIDE && k < R1; k++, count++)
+				sum += dec[(i*R2+j)*R1+k];
+	return sum/count;
+}
+
+/************* Test case functions ****************/
+
+/*With regression in every block, the low-resolution field comes from the coefficients and is close to the data*/
+void test_lowres_regression(void)
+{
+	size_t outSize, a, b, c, m3 = SZ_LOWRES_DIM(R3, STRIDE), m2 = SZ_LOWRES_DIM(R2, STRIDE), m1 = SZ_LOWRES_DIM(R1, STRIDE);
+	int fromCoefficients = 0;
+	double maxDiff = 0;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, data, &outSize, ABS, 1E-2, 0, 0, 0, 0, R3, R2, R1);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1);
+	float* low = (float*)SZ_decompress_lowres(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1, SZ_LOWRES_AVERAGED, STRIDE, &fromCoefficients);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(low);
+	CU_ASSERT_EQUAL(fromCoefficients, 1);
+	for(a = 0; a < m3; a++)
+		for(b = 0; b < m2; b++)
+			for(c = 0; c < m1; c++)
+				if(fabs(low[(a*m2+b)*m1+c] - cell_average(dec, a, b, c)) > maxDiff)
+					maxDiff = fabs(low[(a*m2+b)*m1+c] - cell_average(dec, a, b, c));
+	CU_ASSERT(maxDiff < 2E-2);
+	free(low);
+
+	low = (float*)SZ_decompress_lowres(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1, SZ_LOWRES_STRIDED, STRIDE, &fromCoefficients);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(low);
+	CU_ASSERT_EQUAL(fromCoefficients, 1);
+	CU_ASSERT(fabs(low[(2*m2+3)*m1+5] - data[(2*STRIDE*R2+3*STRIDE)*R1+5*STRIDE]) < 0.1);
+	free(low);
+	free(dec);
+	free(bytes);
+}
+
+/*Without regression, the low-resolution field is reduced from the whole decompression*/
+void test_lowres_lorenzo(void)
+{
+	size_t outSize, a, b, c, m3 = SZ_LOWRES_DIM(R3, STRIDE), m2 = SZ_LOWRES_DIM(R2, STRIDE), m1 = SZ_LOWRES_DIM(R1, STRIDE);
+	int fromCoefficients = 1, withRegression = confparams_cpr->withRegression;
+	confparams_cpr->withRegression = SZ_NO_REGRESSION;
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, data, &outSize, ABS, 1E-3, 0, 0, 0, 0, R3, R2, R1);
+	confparams_cpr->withRegression = withRegression;
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1);
+	float* low = (float*)SZ_decompress_lowres(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1, SZ_LOWRES_AVERAGED, STRIDE, &fromCoefficients);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(low);
+	CU_ASSERT_EQUAL(fromCoefficients, 0);
+	for(a = 0; a < m3; a++)
+		for(b = 0; b < m2; b++)
+			for(c = 0; c < m1; c++)
+				CU_ASSERT_DOUBLE_EQUAL(low[(a*m2+b)*m1+c], cell_average(dec, a, b, c), 1E-6);
+	free(low);
+
+	low = (float*)SZ_decompress_lowres(SZ_FLOAT, bytes, outSize, 0, 0, R3, R2, R1, SZ_LOWRES_STRIDED, STRIDE, NULL);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(low);
+	CU_ASSERT_EQUAL(low[(m2+2)*m1+3], dec[(STRIDE*R2+2*STRIDE)*R1+3*STRIDE]);
+	free(low);
+	free(dec);
+	free(bytes);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sz_lowres_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_lowres_regression", test_lowres_regression)) ||
+        (NULL == CU_add_test(pSuite, "test_lowres_lorenzo", test_lowres_lorenzo))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,151 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define R1 48
+#define R2 40
+#define R3 32
+#define LAYERS 3
+
+static float* data = NULL;
+static double* ddata = NULL;
+static const double errBounds[LAYERS] = {1E-2, 1E-3, 1E-5};
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, k;
+	data = (float*)malloc(R3*R2*R1*sizeof(float));
+	ddata = (double*)malloc(R3*R2*R1*sizeof(double));
+	for(i = 0; i < R3; i++)
+		for(j = 0; j < R2; j++)
+			for(k = 0; k < R1; k++)
+			{
+				data[(i*R2+j)*R1+k] = sin(i*0.1)*cos(j*0.07) + 0.5*sin(k*0.05 + i*0.02);
+				ddata[(i*R2+j)*R1+k] = data[(i*R2+j)*R1+k] + 1E-3*cos(k*0.7);
+			}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(data);
+	free(ddata);
+	SZ_Finalize();
+	return 0;
+}
+
+static double max_error_float(const float* dec)
+{
+	size_t i;
+	double maxErr = 0;
+	for(i = 0; i < R3*R2*R1; i++)
+		if(fabs(data[i] - dec[i]) > maxErr)
+			maxErr = fabs(data[i] - dec[i]);
+	return maxErr;
+}
+
+/************* Test case functions ****************/
+
+/*Every prefix of layers must decode within the error bound of its last layer*/
+void test_progressive_float(void)
+{
+	size_t outSize, layerEnds[SZ_PROGRESSIVE_MAX_LAYERS];
+	double bounds[SZ_PROGRESSIVE_MAX_LAYERS];
+	int k, nbLayers = 0;
+	unsigned char* bytes = SZ_compress_progressive(SZ_FLOAT, data, &outSize, LAYERS, errBounds, 0, 0, R3, R2, R1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	CU_ASSERT_EQUAL(SZ_progressive_info(bytes, outSize, &nbLayers, bounds, layerEnds), SZ_SCES);
+	CU_ASSERT_EQUAL(nbLayers, LAYERS);
+	CU_ASSERT_EQUAL(layerEnds[LAYERS-1], outSize);
+	for(k = 0; k < LAYERS; k++)
+	{
+		CU_ASSERT_EQUAL(bounds[k], errBounds[k]);
+		//only the bytes of the first k+1 layers
+		float* dec = (float*)SZ_decompress_progressive(SZ_FLOAT, bytes, layerEnds[k], k+1, 0, 0, R3, R2, R1);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+		CU_ASSERT(max_error_float(dec) <= errBounds[k]);
+		free(dec);
+	}
+	//not enough bytes for the last layer
+	CU_ASSERT_PTR_NULL(SZ_decompress_progressive(SZ_FLOAT, bytes, layerEnds[LAYERS-1]-1, LAYERS, 0, 0, R3, R2, R1));
+	free(bytes);
+}
+
+/*Refining a preview layer by layer gives the same data as decoding all the layers at once*/
+void test_progressive_refine(void)
+{
+	size_t outSize, n = R3*R2*R1;
+	unsigned char* bytes = SZ_compress_progressive(SZ_DOUBLE, ddata, &outSize, LAYERS, errBounds, 0, 0, R3, R2, R1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+	double* preview = (double*)SZ_decompress_progressive(SZ_DOUBLE, bytes, outSize, 1, 0, 0, R3, R2, R1);
+	double* full = (double*)SZ_decompress_progressive(SZ_DOUBLE, bytes, outSize, 0, 0, 0, R3, R2, R1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(preview);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(full);
+	CU_ASSERT_EQUAL(SZ_refine_progressive(SZ_DOUBLE, bytes, outSize, 1, 2, preview, 0, 0, R3, R2, R1), SZ_SCES);
+	CU_ASSERT_EQUAL(SZ_refine_progressive(SZ_DOUBLE, bytes, outSize, 2, 3, preview, 0, 0, R3, R2, R1), SZ_SCES);
+	CU_ASSERT(memcmp(preview, full, n*sizeof(double)) == 0);
+	CU_ASSERT_EQUAL(SZ_refine_progressive(SZ_DOUBLE, bytes, outSize, 2, 4, preview, 0, 0, R3, R2, R1), SZ_NSCS);
+	CU_ASSERT_EQUAL(SZ_refine_progressive(SZ_FLOAT, bytes, outSize, 0, 1, preview, 0, 0, R3, R2, R1), SZ_NSCS);
+	free(preview);
+	free(full);
+	free(bytes);
+}
+
+void test_progressive_invalid(void)
+{
+	size_t outSize;
+	double increasing[2] = {1E-3, 1E-2};
+	CU_ASSERT_PTR_NULL(SZ_compress_progressive(SZ_FLOAT, data, &outSize, 2, increasing, 0, 0, R3, R2, R1));
+	CU_ASSERT_PTR_NULL(SZ_compress_progressive(SZ_FLOAT, data, &outSize, 0, errBounds, 0, 0, R3, R2, R1));
+	CU_ASSERT_PTR_NULL(SZ_compress_progressive(SZ_INT32, data, &outSize, 1, errBounds, 0, 0, R3, R2, R1));
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sz_progressive_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_progressive_float", test_progressive_float)) ||
+        (NULL == CU_add_test(pSuite, "test_progressive_refine", test_progressive_refine)) ||
+        (NULL == CU_add_test(pSuite, "test_progressive_invalid", test_progressive_invalid))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,103 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+#include "utility.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+/*The slowest dimension becomes the fastest one: r3 x r2 x r1 is transposed into r2 x r1 x r3*/
+void test_transpose_layout(void)
+{
+	size_t i, j, k, r3 = 37, r2 = 45, r1 = 51, errors = 0;
+	float* data = (float*)malloc(r3*r2*r1*sizeof(float));
+	for(i = 0; i < r3*r2*r1; i++)
+		data[i] = i;
+	float* trans = (float*)transposeData(data, SZ_FLOAT, 0, 0, r3, r2, r1);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(trans);
+	for(i = 0; i < r3; i++)
+		for(j = 0; j < r2; j++)
+			for(k = 0; k < r1; k++)
+				if(trans[(j*r1+k)*r3+i] != data[(i*r2+j)*r1+k])
+					errors++;
+	CU_ASSERT_EQUAL(errors, 0);
+	free(trans);
+	free(data);
+}
+
+/*detransposeData inverts transposeData for every data type and for 2D to 5D*/
+void test_transpose_roundtrip(void)
+{
+	size_t dims[4][5] = {{0,0,0,33,70}, {0,0,9,40,33}, {0,5,3,34,31}, {3,4,5,6,7}};
+	int dataTypes[10] = {SZ_FLOAT, SZ_DOUBLE, SZ_UINT8, SZ_INT8, SZ_UINT16, SZ_INT16, SZ_UINT32, SZ_INT32, SZ_UINT64, SZ_INT64};
+	size_t typeSizes[10] = {4, 8, 1, 1, 2, 2, 4, 4, 8, 8};
+	int d, t;
+	size_t i;
+	for(d = 0; d < 4; d++)
+		for(t = 0; t < 10; t++)
+		{
+			size_t* r = dims[d];
+			size_t nbBytes = computeDataLength(r[0], r[1], r[2], r[3], r[4])*typeSizes[t];
+			unsigned char* data = (unsigned char*)malloc(nbBytes);
+			for(i = 0; i < nbBytes; i++)
+				data[i] = (unsigned char)(i*131 + i/7);
+			unsigned char* trans = (unsigned char*)transposeData(data, dataTypes[t], r[0], r[1], r[2], r[3], r[4]);
+			CU_ASSERT_PTR_NOT_NULL_FATAL(trans);
+			unsigned char* back = (unsigned char*)detransposeData(trans, dataTypes[t], r[0], r[1], r[2], r[3], r[4]);
+			CU_ASSERT_PTR_NOT_NULL_FATAL(back);
+			CU_ASSERT(memcmp(back, data, nbBytes) == 0);
+			free(back);
+			free(trans);
+			free(data);
+		}
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_transpose_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_transpose_layout", test_transpose_layout)) ||
+        (NULL == CU_add_test(pSuite, "test_transpose_roundtrip", test_transpose_roundtrip))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,445 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define STEPS 4
+#define NB_VARS 6
+#define ERR_BOUND 1E-3
+
+/*float 3D, double 2D, float 1D, double 3D, float 4D and double 4D variables, all compressed in the same batch*/
+static const int var_ids[NB_VARS] = {1, 2, 3, 4, 5, 6};
+static char* var_names[NB_VARS] = {"pressure", "density", "velocity", "energy", "temperature", "vorticity"};
+static const int var_types[NB_VARS] = {SZ_FLOAT, SZ_DOUBLE, SZ_FLOAT, SZ_DOUBLE, SZ_FLOAT, SZ_DOUBLE};
+static const size_t var_dims[NB_VARS][4] = {{0, 32, 32, 32}, {0, 0, 96, 96}, {0, 0, 0, 20000}, {0, 16, 24, 40}, {6, 10, 12, 14}, {5, 8, 12, 16}};
+
+static size_t var_lengths[NB_VARS];
+static void* var_data[NB_VARS]; //the buffers registered to SZ
+static void* ori_data[STEPS][NB_VARS]; //the original data of each step
+static unsigned char* ts_bytes[STEPS];
+static size_t ts_sizes[STEPS];
+static unsigned char* dict_bytes[STEPS]; //the same steps, compressed with reuseHuffmanTrees
+static size_t dict_sizes[STEPS];
+static size_t cmpr_reused[STEPS][NB_VARS]; //streams encoded with a tree of the dictionary of the variable, after each step
+static int cmpr_trees[NB_VARS]; //trees in the dictionary of the variable, after the last step
+
+/*smooth in space, with a noise that persists across the steps, and a slow change in time: the steps after the first one
+ *are predicted better by the previous step than by the Lorenzo predictor*/
+static double value_at(int var, int step, size_t i)
+{
+	unsigned int h = (unsigned int)(i*2654435761u) ^ (unsigned int)(var*40503u);
+	h = (h ^ (h >> 15))*2246822519u;
+	double noise = ((h >> 8)%1000)*1E-4;
+	return sin(i*0.01*(var+1)) + 0.3*cos(i*0.003 + var) + noise + step*5E-4*cos(i*0.002);
+}
+
+static void register_vars(void)
+{
+	int v;
+	for(v = 0; v < NB_VARS; v++)
+	{
+		size_t elemSize = var_types[v]==SZ_FLOAT ? sizeof(float) : sizeof(double);
+		memset(var_data[v], 0, var_lengths[v]*elemSize);
+		SZ_registerVar(var_ids[v], var_names[v], var_types[v], var_data[v], ABS, ERR_BOUND, 0, 0,
+			0, var_dims[v][0], var_dims[v][1], var_dims[v][2], var_dims[v][3]);
+	}
+}
+
+/*the maximum error between the registered data of variable v and its original data at the step*/
+static double max_error(int v, int step)
+{
+	size_t i;
+	double err, maxErr = 0;
+	for(i = 0; i < var_lengths[v]; i++)
+	{
+		if(var_types[v]==SZ_FLOAT)
+			err = fabs(((float*)var_data[v])[i] - ((float*)ori_data[step][v])[i]);
+		else
+			err = fabs(((double*)var_data[v])[i] - ((double*)ori_data[step][v])[i]);
+		if(err > maxErr)
+			maxErr = err;
+	}
+	return maxErr;
+}
+
+static int is_zero(int v)
+{
+	size_t i;
+	for(i = 0; i < var_lengths[v]; i++)
+		if(var_types[v]==SZ_FLOAT ? ((float*)var_data[v])[i] != 0 : ((double*)var_data[v])[i] != 0)
+			return 0;
+	return 1;
+}
+
+/*the compression type (0: snapshot, 1: based on the previous step) of the i-th variable of a stream*/
+static unsigned char ts_compress_type(unsigned char* bytes, int i)
+{
+	return bytes[9 + i*(6+sizeof(size_t)) + 4];
+}
+
+/*compress STEPS steps of the batch, starting from step 0 with a new registration*/
+static int compress_steps(int cmprType, unsigned char** bytes, size_t* sizes)
+{
+	int v, step;
+	register_vars();
+	sz_tsc->currentStep = 0;
+	for(step = 0; step < STEPS; step++)
+	{
+		for(v = 0; v < NB_VARS; v++)
+			memcpy(var_data[v], ori_data[step][v], var_lengths[v]*(var_types[v]==SZ_FLOAT ? sizeof(float) : sizeof(double)));
+		if(SZ_compress_ts(cmprType, &bytes[step], &sizes[step]) != SZ_SCES)
+			return SZ_NSCS;
+		if(bytes == dict_bytes)
+			for(v = 0; v < NB_VARS; v++)
+				cmpr_reused[step][v] = SZ_getVariable(var_ids[v])->multisteps->cmprHuffmanDict->reused;
+	}
+	if(bytes == dict_bytes)
+		for(v = 0; v < NB_VARS; v++)
+			cmpr_trees[v] = SZ_getVariable(var_ids[v])->multisteps->cmprHuffmanDict->nbTrees;
+	SZ_deregisterAllVars();
+	return SZ_SCES;
+}
+
+/*rewrite a stream in the layout before the format version byte (version 0): step, # variables (2 bytes), and
+ *{var_id (1 byte), compressType, dataType, size_t size, compressed bytes} per variable*/
+static unsigned char* to_version0(unsigned char* bytes, size_t* size)
+{
+	unsigned int i, nbVars = bytesToInt_bigEndian(bytes+5);
+	unsigned char* toc = bytes+9;
+	unsigned char* cmpBytes = toc + nbVars*(6+sizeof(size_t));
+	unsigned char* out = (unsigned char*)malloc(*size);
+	unsigned char* p = out;
+	memcpy(p, bytes+1, 4);
+	shortToBytes(p+4, (short)nbVars);
+	p += 6;
+	for(i = 0; i < nbVars; i++, toc += 6+sizeof(size_t))
+	{
+		size_t cmpSize = bytesToSize(toc+6);
+		*(p++) = (unsigned char)bytesToInt_bigEndian(toc);
+		memcpy(p, toc+4, 2+sizeof(size_t));
+		p += 2+sizeof(size_t);
+		memcpy(p, cmpBytes, cmpSize);
+		p += cmpSize;
+		cmpBytes += cmpSize;
+	}
+	*size = p - out;
+	return out;
+}
+
+/* Test Suite setup and cleanup functions: */
+
+/*compress STEPS time steps of the batch (the first one as a snapshot, with the blocked regression, the others based
+ *on the previous step), without and with reuseHuffmanTrees*/
+int init_suite(void)
+{
+	int v, step;
+	size_t i;
+	if(SZ_Init(NULL) != SZ_SCES)
+		return 1;
+	confparams_cpr->snapshotCmprStep = STEPS;
+#ifdef _OPENMP
+	omp_set_num_threads(4);
+#endif
+	for(v = 0; v < NB_VARS; v++)
+	{
+		size_t elemSize = var_types[v]==SZ_FLOAT ? sizeof(float) : sizeof(double);
+		var_lengths[v] = computeDataLength(0, var_dims[v][0], var_dims[v][1], var_dims[v][2], var_dims[v][3]);
+		var_data[v] = malloc(var_lengths[v]*elemSize);
+		for(step = 0; step < STEPS; step++)
+		{
+			ori_data[step][v] = malloc(var_lengths[v]*elemSize);
+			for(i = 0; i < var_lengths[v]; i++)
+			{
+				if(var_types[v]==SZ_FLOAT)
+					((float*)ori_data[step][v])[i] = (float)value_at(v, step, i);
+				else
+					((double*)ori_data[step][v])[i] = value_at(v, step, i);
+			}
+		}
+	}
+
+	if(compress_steps(SZ_PERIO_TEMPORAL_COMPRESSION, ts_bytes, ts_sizes) != SZ_SCES)
+		return 1;
+	confparams_cpr->reuseHuffmanTrees = 1;
+	int status = compress_steps(SZ_PERIO_TEMPORAL_COMPRESSION, dict_bytes, dict_sizes);
+	confparams_cpr->reuseHuffmanTrees = 0;
+	return status == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	int v, step;
+	for(step = 0; step < STEPS; step++)
+	{
+		free(ts_bytes[step]);
+		free(dict_bytes[step]);
+		for(v = 0; v < NB_VARS; v++)
+			free(ori_data[step][v]);
+	}
+	for(v = 0; v < NB_VARS; v++)
+		free(var_data[v]);
+	SZ_Finalize();
+	return 0;
+}
+
+/************* Test case functions ****************/
+
+/*All the variables of all the steps decompress within the error bound*/
+void test_ts_round_trip(void)
+{
+	int v, step;
+	register_vars();
+	for(step = 0; step < STEPS; step++)
+	{
+		CU_ASSERT_EQUAL(SZ_decompress_ts(ts_bytes[step], ts_sizes[step]), SZ_SCES);
+		for(v = 0; v < NB_VARS; v++)
+		{
+			CU_ASSERT_EQUAL(ts_compress_type(ts_bytes[step], v), step > 0);
+			CU_ASSERT(max_error(v, step) <= ERR_BOUND);
+		}
+	}
+	//the decompressor kept the parameters of the next compressions
+	CU_ASSERT_EQUAL(exe_params->SZ_SIZE_TYPE, sizeof(size_t));
+	CU_ASSERT_EQUAL(exe_params->intvRadius, confparams_cpr->maxRangeRadius);
+	SZ_deregisterAllVars();
+}
+
+/*The streams start with the format version, and the streams without it are still read*/
+void test_ts_version0(void)
+{
+	int v, step;
+	CU_ASSERT_EQUAL(ts_bytes[0][0], SZ_TS_FORMAT_FLAG|SZ_TS_FORMAT_VERSION);
+	register_vars();
+	for(step = 0; step < STEPS; step++)
+	{
+		size_t size = ts_sizes[step];
+		unsigned char* bytes = to_version0(ts_bytes[step], &size);
+		CU_ASSERT_EQUAL(SZ_decompress_ts(bytes, size), SZ_SCES);
+		for(v = 0; v < NB_VARS; v++)
+			CU_ASSERT(max_error(v, step) <= ERR_BOUND);
+		free(bytes);
+	}
+	SZ_deregisterAllVars();
+	
+	//a newer version is rejected
+	unsigned char version = ts_bytes[0][0];
+	ts_bytes[0][0] = SZ_TS_FORMAT_FLAG|(SZ_TS_FORMAT_VERSION+1);
+	register_vars();
+	CU_ASSERT_NOT_EQUAL(SZ_decompress_ts(ts_bytes[0], ts_sizes[0]), SZ_SCES);
+	CU_ASSERT(is_zero(0));
+	SZ_deregisterAllVars();
+	ts_bytes[0][0] = version;
+}
+
+/*With reuseHuffmanTrees, each variable has its own Huffman tree dictionary: the snapshot (step 0) and the first
+ * step based on it store their trees, as their codes differ, and the next steps reuse the tree of the previous step.
+ * The steps decompress in order, and the decompressor rebuilds the dictionaries of the compressor.*/
+void test_ts_huffman_dict(void)
+{
+	int v, step;
+	size_t plainSize = 0, dictSize = 0;
+	for(v = 0; v < NB_VARS; v++)
+	{
+		CU_ASSERT_EQUAL(cmpr_reused[0][v], 0);
+		CU_ASSERT(cmpr_trees[v] > 0);
+	}
+	for(step = 2; step < STEPS; step++)
+		for(v = 0; v < NB_VARS; v++)
+			CU_ASSERT(cmpr_reused[step][v] > cmpr_reused[step-1][v]);
+	//the snapshot stores the tree of its own codes, as without the dictionary
+	CU_ASSERT(dict_sizes[0] == ts_sizes[0] && memcmp(dict_bytes[0], ts_bytes[0], ts_sizes[0]) == 0);
+	for(step = 0; step < STEPS; step++)
+	{
+		plainSize += ts_sizes[step];
+		dictSize += dict_sizes[step];
+	}
+	CU_ASSERT(dictSize < plainSize);
+
+	register_vars();
+	for(step = 0; step < STEPS; step++)
+	{
+		CU_ASSERT_EQUAL(SZ_decompress_ts(dict_bytes[step], dict_sizes[step]), SZ_SCES);
+		for(v = 0; v < NB_VARS; v++)
+			CU_ASSERT(max_error(v, step) <= ERR_BOUND);
+	}
+	for(v = 0; v < NB_VARS; v++)
+		CU_ASSERT_EQUAL(SZ_getVariable(var_ids[v])->multisteps->decHuffmanDict->nbTrees, cmpr_trees[v]);
+	SZ_deregisterAllVars();
+}
+
+/*With reuseHuffmanTrees, a step whose stream refers to a tree of a step that was not decompressed fails, and keeps the data*/
+void test_ts_missing_step(void)
+{
+	int v;
+	register_vars();
+	CU_ASSERT_EQUAL(SZ_decompress_ts(dict_bytes[0], dict_sizes[0]), SZ_SCES);
+	CU_ASSERT_NOT_EQUAL(SZ_decompress_ts(dict_bytes[2], dict_sizes[2]), SZ_SCES);
+	for(v = 0; v < NB_VARS; v++)
+		CU_ASSERT(max_error(v, 0) <= ERR_BOUND);
+	SZ_deregisterAllVars();
+}
+
+/*SZ_ADAPTIVE_TEMPORAL_COMPRESSION compresses the first step as a snapshot (without the regression here), and the
+ *next ones, which the previous step predicts better, based on it*/
+void test_ts_adaptive(void)
+{
+	int v, step;
+	unsigned char* bytes[STEPS];
+	size_t sizes[STEPS];
+	confparams_cpr->withRegression = SZ_NO_REGRESSION;
+	int status = compress_steps(SZ_ADAPTIVE_TEMPORAL_COMPRESSION, bytes, sizes);
+	confparams_cpr->withRegression = SZ_WITH_LINEAR_REGRESSION;
+	CU_ASSERT_EQUAL_FATAL(status, SZ_SCES);
+	
+	register_vars();
+	for(step = 0; step < STEPS; step++)
+	{
+		CU_ASSERT_EQUAL(SZ_decompress_ts(bytes[step], sizes[step]), SZ_SCES);
+		for(v = 0; v < NB_VARS; v++)
+		{
+			CU_ASSERT_EQUAL(ts_compress_type(bytes[step], v), step > 0);
+			CU_ASSERT(max_error(v, step) <= ERR_BOUND);
+		}
+		free(bytes[step]);
+	}
+	SZ_deregisterAllVars();
+}
+
+/*Only the selected variables are decompressed; the others keep their data*/
+void test_ts_select_var(void)
+{
+	int step;
+	unsigned int selected[2] = {4, 2};
+	register_vars();
+	for(step = 0; step < STEPS; step++)
+	{
+		CU_ASSERT_EQUAL(SZ_decompress_ts_select_var(selected, 2, ts_bytes[step], ts_sizes[step]), SZ_SCES);
+		CU_ASSERT(max_error(1, step) <= ERR_BOUND);
+		CU_ASSERT(max_error(3, step) <= ERR_BOUND);
+		CU_ASSERT(is_zero(0));
+		CU_ASSERT(is_zero(2));
+	}
+	SZ_deregisterAllVars();
+}
+
+/*FIXED_RATIO keeps the compression type of the caller, and its search passes leave the previous step as the
+ *decompressor sees it: the step based on it decompresses to the values the compressor recorded*/
+void test_ts_fixed_ratio(void)
+{
+	int step;
+	size_t i, sizes[2], histSize = var_lengths[0]*sizeof(float);
+	unsigned char* bytes[2];
+	float* hist = (float*)malloc(histSize);
+	confparams_cpr->fixedRatio = 8;
+	SZ_registerVar(var_ids[0], var_names[0], var_types[0], var_data[0], FIXED_RATIO, 0, 0, 0,
+		0, var_dims[0][0], var_dims[0][1], var_dims[0][2], var_dims[0][3]);
+	sz_tsc->currentStep = 0;
+	for(step = 0; step < 2; step++)
+	{
+		memcpy(var_data[0], ori_data[step][0], histSize);
+		CU_ASSERT_EQUAL_FATAL(SZ_compress_ts(SZ_FORCE_TEMPORAL_COMPRESSION, &bytes[step], &sizes[step]), SZ_SCES);
+		CU_ASSERT_EQUAL(ts_compress_type(bytes[step], 0), 1);
+	}
+	memcpy(hist, SZ_getVariable(var_ids[0])->multisteps->hist_data, histSize);
+	SZ_deregisterAllVars();
+	confparams_cpr->fixedRatio = 0;
+
+	SZ_registerVar(var_ids[0], var_names[0], var_types[0], var_data[0], ABS, ERR_BOUND, 0, 0,
+		0, var_dims[0][0], var_dims[0][1], var_dims[0][2], var_dims[0][3]);
+	for(step = 0; step < 2; step++)
+	{
+		CU_ASSERT_EQUAL(SZ_decompress_ts(bytes[step], sizes[step]), SZ_SCES);
+		free(bytes[step]);
+	}
+	for(i = 0; i < var_lengths[0] && hist[i] == ((float*)var_data[0])[i]; i++);
+	CU_ASSERT_EQUAL(i, var_lengths[0]);
+	SZ_deregisterAllVars();
+	free(hist);
+}
+
+/*A snapshot step decompresses on its own, alone or with only some of its variables, with or without reuseHuffmanTrees*/
+void test_ts_snapshot_alone(void)
+{
+	int v, step, reuse;
+	unsigned int selected[1] = {3};
+	unsigned char* bytes[STEPS];
+	size_t sizes[STEPS];
+	for(reuse = 0; reuse <= 1; reuse++)
+	{
+		confparams_cpr->reuseHuffmanTrees = reuse;
+		int status = compress_steps(SZ_FORCE_SNAPSHOT_COMPRESSION, bytes, sizes);
+		confparams_cpr->reuseHuffmanTrees = 0;
+		CU_ASSERT_EQUAL_FATAL(status, SZ_SCES);
+
+		register_vars();
+		CU_ASSERT_EQUAL(SZ_decompress_ts(bytes[2], sizes[2]), SZ_SCES);
+		for(v = 0; v < NB_VARS; v++)
+		{
+			CU_ASSERT_EQUAL(ts_compress_type(bytes[2], v), 0);
+			CU_ASSERT(max_error(v, 2) <= ERR_BOUND);
+		}
+		SZ_deregisterAllVars();
+
+		register_vars();
+		CU_ASSERT_EQUAL(SZ_decompress_ts_select_var(selected, 1, bytes[STEPS-1], sizes[STEPS-1]), SZ_SCES);
+		CU_ASSERT(max_error(2, STEPS-1) <= ERR_BOUND);
+		CU_ASSERT(is_zero(0));
+		SZ_deregisterAllVars();
+		for(step = 0; step < STEPS; step++)
+			free(bytes[step]);
+	}
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_ts_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_ts_round_trip", test_ts_round_trip)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_select_var", test_ts_select_var)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_adaptive", test_ts_adaptive)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_version0", test_ts_version0)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_huffman_dict", test_ts_huffman_dict)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_missing_step", test_ts_missing_step)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_snapshot_alone", test_ts_snapshot_alone)) ||
+        (NULL == CU_add_test(pSuite, "test_ts_fixed_ratio", test_ts_fixed_ratio))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,240 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define N 65536
+#define R1 40
+#define R2 40
+#define R3 40
+#define ERR_BOUND 1E-4
+
+static float* fdata = NULL;
+static double* ddata = NULL;
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i;
+	unsigned int seed = 11;
+	fdata = (float*)malloc(N*sizeof(float));
+	ddata = (double*)malloc(N*sizeof(double));
+	for(i = 0; i < N; i++)
+	{
+		//noisy, so that most of the values are unpredictable
+		seed = seed*1103515245 + 12345;
+		ddata[i] = sin(i*0.01) + (seed >> 8)%100000*0.01;
+		fdata[i] = (float)ddata[i];
+	}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	free(fdata);
+	free(ddata);
+	SZ_Finalize();
+	return 0;
+}
+
+/************* Test case functions ****************/
+
+/*The batched coding gives the same bytes and values as the coding of the values one by one, for any reqLength*/
+void test_unpred_float(void)
+{
+	int reqLength;
+	size_t i;
+	float medianValue = 1.5;
+	for(reqLength = 9; reqLength <= 32; reqLength++)
+	{
+		int reqBytesLength = reqLength/8, resiBitsLength = reqLength%8;
+		DynamicIntArray *leadNumArray, *resiBitArray;
+		DynamicByteArray *midByteArray;
+		new_DIA(&leadNumArray, N);
+		new_DBA(&midByteArray, N);
+		new_DIA(&resiBitArray, N);
+		unsigned char preBytes[4] = {0};
+		FloatValueCompressElement vce;
+		LossyCompressionElement lce;
+		sz_unpred_float unpred;
+		sz_unpred_init_float(&unpred, N, reqLength, medianValue);
+		int sameValues = 1;
+		for(i = 0; i < N; i++)
+		{
+			compressSingleFloatValue(&vce, fdata[i], 0, medianValue, reqLength, reqBytesLength, resiBitsLength);
+			updateLossyCompElement_Float(vce.curBytes, preBytes, reqBytesLength, resiBitsLength, &lce);
+			memcpy(preBytes, vce.curBytes, 4);
+			addExactData(midByteArray, leadNumArray, resiBitArray, &lce);
+			float value = sz_unpred_add_float(&unpred, fdata[i]);
+			sameValues = sameValues && memcmp(&value, &vce.data, sizeof(float)) == 0;
+		}
+		CU_ASSERT(sameValues);
+
+		unsigned char *leadNum, *midBytes, *resiBits;
+		size_t midBytesSize = sz_unpred_encode_float(&unpred, &leadNum, &midBytes, &resiBits);
+		CU_ASSERT_EQUAL_FATAL(midBytesSize, midByteArray->size);
+		CU_ASSERT(memcmp(midBytes, midByteArray->array, midBytesSize) == 0);
+		CU_ASSERT(memcmp(leadNum, leadNumArray->array, N) == 0);
+		if(resiBitsLength != 0)
+			CU_ASSERT(memcmp(resiBits, resiBitArray->array, N) == 0);
+
+		unsigned char *leadNumBytes, *resiBitsBytes;
+		float *expected, *decData = (float*)malloc(N*sizeof(float));
+		convertIntArray2ByteArray_fast_2b(leadNum, N, &leadNumBytes);
+		convertIntArray2ByteArray_fast_dynamic(resiBits, resiBitsLength, N, &resiBitsBytes);
+		decompressExactDataArray_float(leadNum, midBytes, resiBitsBytes, N, reqLength, medianValue, &expected);
+		sz_unpred_decode_float(leadNumBytes, midBytes, midBytesSize, resiBitsBytes, N, reqLength, medianValue, decData);
+		CU_ASSERT(memcmp(decData, expected, N*sizeof(float)) == 0);
+
+		free(decData);
+		free(expected);
+		free(leadNumBytes);
+		free(resiBitsBytes);
+		free(leadNum);
+		free(midBytes);
+		free(resiBits);
+		free_DIA(leadNumArray);
+		free_DBA(midByteArray);
+		free_DIA(resiBitArray);
+	}
+}
+
+void test_unpred_double(void)
+{
+	int reqLength;
+	size_t i;
+	double medianValue = 1.5;
+	for(reqLength = 12; reqLength <= 64; reqLength++)
+	{
+		int reqBytesLength = reqLength/8, resiBitsLength = reqLength%8;
+		DynamicIntArray *leadNumArray, *resiBitArray;
+		DynamicByteArray *midByteArray;
+		new_DIA(&leadNumArray, N);
+		new_DBA(&midByteArray, N);
+		new_DIA(&resiBitArray, N);
+		unsigned char preBytes[8] = {0};
+		DoubleValueCompressElement vce;
+		LossyCompressionElement lce;
+		sz_unpred_double unpred;
+		sz_unpred_init_double(&unpred, N, reqLength, medianValue);
+		int sameValues = 1;
+		for(i = 0; i < N; i++)
+		{
+			compressSingleDoubleValue(&vce, ddata[i], 0, medianValue, reqLength, reqBytesLength, resiBitsLength);
+			updateLossyCompElement_Double(vce.curBytes, preBytes, reqBytesLength, resiBitsLength, &lce);
+			memcpy(preBytes, vce.curBytes, 8);
+			addExactData(midByteArray, leadNumArray, resiBitArray, &lce);
+			double value = sz_unpred_add_double(&unpred, ddata[i]);
+			sameValues = sameValues && memcmp(&value, &vce.data, sizeof(double)) == 0;
+		}
+		CU_ASSERT(sameValues);
+
+		unsigned char *leadNum, *midBytes, *resiBits;
+		size_t midBytesSize = sz_unpred_encode_double(&unpred, &leadNum, &midBytes, &resiBits);
+		CU_ASSERT_EQUAL_FATAL(midBytesSize, midByteArray->size);
+		CU_ASSERT(memcmp(midBytes, midByteArray->array, midBytesSize) == 0);
+		CU_ASSERT(memcmp(leadNum, leadNumArray->array, N) == 0);
+		if(resiBitsLength != 0)
+			CU_ASSERT(memcmp(resiBits, resiBitArray->array, N) == 0);
+
+		unsigned char *leadNumBytes, *resiBitsBytes;
+		double *expected, *decData = (double*)malloc(N*sizeof(double));
+		convertIntArray2ByteArray_fast_2b(leadNum, N, &leadNumBytes);
+		convertIntArray2ByteArray_fast_dynamic(resiBits, resiBitsLength, N, &resiBitsBytes);
+		decompressExactDataArray_double(leadNum, midBytes, resiBitsBytes, N, reqLength, medianValue, &expected);
+		sz_unpred_decode_double(leadNumBytes, midBytes, midBytesSize, resiBitsBytes, N, reqLength, medianValue, decData);
+		CU_ASSERT(memcmp(decData, expected, N*sizeof(double)) == 0);
+
+		free(decData);
+		free(expected);
+		free(leadNumBytes);
+		free(resiBitsBytes);
+		free(leadNum);
+		free(midBytes);
+		free(resiBits);
+		free_DIA(leadNumArray);
+		free_DBA(midByteArray);
+		free_DIA(resiBitArray);
+	}
+}
+
+/*Mostly unpredictable data decompresses within the error bound, in 1D, 2D and 3D*/
+void test_unpred_roundtrip(void)
+{
+	size_t i, outSize;
+	int d;
+	size_t dims[3][3] = {{0, 0, N}, {0, N/256, 256}, {R3, R2, R1}};
+	for(d = 0; d < 3; d++)
+	{
+		size_t nbEle = (dims[d][0] > 0 ? dims[d][0] : 1)*(dims[d][1] > 0 ? dims[d][1] : 1)*dims[d][2];
+		unsigned char* bytes = SZ_compress_args(SZ_FLOAT, fdata, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, dims[d][0], dims[d][1], dims[d][2]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+		float* fdec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, dims[d][0], dims[d][1], dims[d][2]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(fdec);
+		int withinBound = 1;
+		for(i = 0; i < nbEle; i++)
+			withinBound = withinBound && fabs(fdec[i] - fdata[i]) <= ERR_BOUND;
+		CU_ASSERT(withinBound);
+		free(fdec);
+		free(bytes);
+
+		bytes = SZ_compress_args(SZ_DOUBLE, ddata, &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, dims[d][0], dims[d][1], dims[d][2]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(bytes);
+		double* ddec = (double*)SZ_decompress(SZ_DOUBLE, bytes, outSize, 0, 0, dims[d][0], dims[d][1], dims[d][2]);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(ddec);
+		withinBound = 1;
+		for(i = 0; i < nbEle; i++)
+			withinBound = withinBound && fabs(ddec[i] - ddata[i]) <= ERR_BOUND;
+		CU_ASSERT(withinBound);
+		free(ddec);
+		free(bytes);
+	}
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_unpred_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_unpred_float", test_unpred_float)) ||
+        (NULL == CU_add_test(pSuite, "test_unpred_double", test_unpred_double)) ||
+        (NULL == CU_add_test(pSuite, "test_unpred_roundtrip", test_unpred_roundtrip))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}
@@ -0,0 +1,160 @@
+
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+#include "CUnit_Array.h"
+
+#include "sz.h"
+
+#include <stdio.h>  // for printf
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define R1 16
+#define R2 16
+#define SAMPLES 64
+#define FIELDS 8
+#define ERR_BOUND 1E-3
+
+static float* fields[SAMPLES+FIELDS];
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void)
+{
+	size_t i, j, f;
+	for(f = 0; f < SAMPLES+FIELDS; f++)
+	{
+		fields[f] = (float*)malloc(R2*R1*sizeof(float));
+		//many small fields of the same kind (e.g., the variables of the cells of a mesh)
+		for(i = 0; i < R2; i++)
+			for(j = 0; j < R1; j++)
+				fields[f][i*R1+j] = sin(i*0.3 + f*0.1)*cos(j*0.25) + 0.05*sin(i*j*0.9 + f);
+	}
+	return SZ_Init(NULL) == SZ_SCES ? 0 : 1;
+}
+
+int clean_suite(void)
+{
+	size_t f;
+	for(f = 0; f < SAMPLES+FIELDS; f++)
+		free(fields[f]);
+	SZ_Finalize();
+	return 0;
+}
+
+/*Train on the bytes before the lossless stage (the SZ_BEST_SPEED outputs) of the sample fields*/
+static sz_zstd_dict* train(void)
+{
+	size_t f, sampleSizes[SAMPLES];
+	unsigned char* samples[SAMPLES];
+	int szMode = confparams_cpr->szMode;
+	confparams_cpr->szMode = SZ_BEST_SPEED;
+	for(f = 0; f < SAMPLES; f++)
+		samples[f] = SZ_compress_args(SZ_FLOAT, fields[f], &sampleSizes[f], ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	confparams_cpr->szMode = szMode;
+	sz_zstd_dict* dict = SZ_trainZstdDict(samples, sampleSizes, SAMPLES, 4096, 3);
+	for(f = 0; f < SAMPLES; f++)
+		free(samples[f]);
+	return dict;
+}
+
+/************* Test case functions ****************/
+
+/*The other fields compress better with the dictionary, and decompress with it within the error bound*/
+void test_dict_compress(void)
+{
+	size_t f, i, outSize, plainSize, withDict = 0, without = 0;
+	sz_zstd_dict* dict = train();
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dict);
+	CU_ASSERT(dict->dictSize > 0 && dict->dictSize <= 4096);
+	for(f = SAMPLES; f < SAMPLES+FIELDS; f++)
+	{
+		unsigned char* plain = SZ_compress_args(SZ_FLOAT, fields[f], &plainSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+		SZ_setZstdDict(dict);
+		unsigned char* bytes = SZ_compress_args(SZ_FLOAT, fields[f], &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+		float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, R2, R1);
+		SZ_setZstdDict(NULL);
+		CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+		for(i = 0; i < R2*R1; i++)
+			CU_ASSERT(fabs(dec[i] - fields[f][i]) <= ERR_BOUND);
+		withDict += outSize;
+		without += plainSize;
+		free(dec);
+		free(bytes);
+		free(plain);
+	}
+	CU_ASSERT(withDict < without);
+	SZ_freeZstdDict(dict);
+}
+
+/*A dictionary stored with the fields and loaded back decompresses them; the fields without dictionary still decompress*/
+void test_dict_load(void)
+{
+	size_t i, outSize, plainSize;
+	sz_zstd_dict* dict = train();
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dict);
+	SZ_setZstdDict(dict);
+	unsigned char* bytes = SZ_compress_args(SZ_FLOAT, fields[SAMPLES], &outSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+	SZ_setZstdDict(NULL);
+	unsigned char* plain = SZ_compress_args(SZ_FLOAT, fields[SAMPLES], &plainSize, ABS, ERR_BOUND, 0, 0, 0, 0, 0, R2, R1);
+
+	sz_zstd_dict* loaded = SZ_loadZstdDict(dict->dictBytes, dict->dictSize, 3);
+	SZ_freeZstdDict(dict);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(loaded);
+	SZ_setZstdDict(loaded);
+	float* dec = (float*)SZ_decompress(SZ_FLOAT, bytes, outSize, 0, 0, 0, R2, R1);
+	float* decPlain = (float*)SZ_decompress(SZ_FLOAT, plain, plainSize, 0, 0, 0, R2, R1);
+	SZ_setZstdDict(NULL);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(dec);
+	CU_ASSERT_PTR_NOT_NULL_FATAL(decPlain);
+	for(i = 0; i < R2*R1; i++)
+	{
+		CU_ASSERT(fabs(dec[i] - fields[SAMPLES][i]) <= ERR_BOUND);
+		CU_ASSERT_EQUAL(dec[i], decPlain[i]);
+	}
+	free(dec);
+	free(decPlain);
+	free(bytes);
+	free(plain);
+	SZ_freeZstdDict(loaded);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_zstd_dict_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ( (NULL == CU_add_test(pSuite, "test_dict_compress", test_dict_compress)) ||
+        (NULL == CU_add_test(pSuite, "test_dict_load", test_dict_load))
+      )
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+	 unsigned int num_failures = CU_get_number_of_failures();
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return num_failures || CU_get_error();
+}